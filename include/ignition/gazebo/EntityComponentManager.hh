@@ -27,14 +27,17 @@
 #include <string>
 #include <typeinfo>
 #include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <ignition/common/Console.hh>
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/graph/Graph.hh>
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/Export.hh"
+#include "ignition/gazebo/SpatialIndex.hh"
 #include "ignition/gazebo/Types.hh"
 
 #include "ignition/gazebo/components/Component.hh"
@@ -464,6 +467,83 @@ namespace ignition
       /// empty if the entity doesn't exist.
       public: std::unordered_set<Entity> Descendants(Entity _entity) const;
 
+      /// \brief Get the pose of an entity in the world frame. That's the
+      /// composition of the Pose components of the entity and its ancestors,
+      /// following ParentEntity components up to the first ancestor without
+      /// a Pose.
+      ///
+      /// World poses are cached across iterations, so poses shared by many
+      /// entities, such as those of their models, are only composed once
+      /// per change. An entity's pose is computed again once the Pose or
+      /// ParentEntity of the entity or of one of its ancestors is created,
+      /// removed or marked as changed through SetChanged. So Pose components
+      /// modified in place must be marked as changed to be taken into
+      /// account, as for state streaming.
+      ///
+      /// Poses which changed are computed again before PostUpdate, on the
+      /// simulation thread, and the cache isn't modified during PostUpdate,
+      /// so the PostUpdate threads read it without locks. Poses computed on
+      /// those threads are cached once PostUpdate is over.
+      /// \param[in] _entity Entity whose world pose we want.
+      /// \return The world pose, or identity if the entity has no Pose.
+      public: math::Pose3d WorldPose(const Entity _entity) const;
+
+      /// \brief Get an index of the world positions of all models, so
+      /// systems can find the models within a region without iterating over
+      /// all of them. Each model is stored as an empty box at the position
+      /// given by WorldPose.
+      ///
+      /// Once this has been called, the index is kept up to date: models are
+      /// moved when their world pose changes, following the same rules as
+      /// WorldPose, and added or removed when their Model component is. It's
+      /// updated before PostUpdate and isn't modified until PostUpdate is
+      /// over, so it can be read from the PostUpdate threads. Worlds which
+      /// don't use the index don't pay for it.
+      /// \return Index of model entities.
+      public: const gazebo::SpatialIndex &ModelSpatialIndex() const;
+
+      /// \brief Take a read-only snapshot of the ECM, which other threads can
+      /// read while this ECM keeps being updated.
+      ///
+      /// The snapshot is a separate ECM with copies of all entities and
+      /// components, including their change states. The entity graph, the
+      /// components of each entity and the change states are copied in full
+      /// on each call. Copies of component storages are kept between calls
+      /// and shared among snapshots:
+      /// * A type's storage is copied again if components of that type were
+      /// created or removed since the previous snapshot.
+      /// * Otherwise, only the components marked as changed through
+      /// SetChanged are copied, into the previous copy, if no snapshot uses
+      /// it anymore. If one does, the storage is copied again.
+      /// * Types whose components didn't change aren't copied.
+      ///
+      /// Components modified in place must be marked as changed to be seen
+      /// by later snapshots, as for state streaming.
+      ///
+      /// This must be called from the thread updating the ECM, such as from
+      /// PreUpdate or Update, but not from PostUpdate, whose threads run in
+      /// parallel. The snapshot can then be read without locks by
+      /// one thread at a time, following the same rules as a const ECM.
+      /// Threads reading concurrently should take their own snapshots, which
+      /// share their copies.
+      /// \return Snapshot of the ECM.
+      public: std::shared_ptr<const EntityComponentManager> Snapshot() const;
+
+      /// \brief Move all entities of another ECM into this one. This lets
+      /// entities be created away from this ECM, for example on other
+      /// threads, and then added in a single batch: components are moved
+      /// instead of copied, storage grows at most once per component type,
+      /// and views are updated once.
+      ///
+      /// Entities get new ids, in the order in which they were created in
+      /// _other, and keep the parents they had in _other, also in their
+      /// components::ParentEntity. Entity ids held by other components aren't
+      /// updated.
+      /// \param[in, out] _other ECM to move entities from. It's left empty.
+      /// \return Map from the entities of _other to their new ids.
+      public: std::unordered_map<Entity, Entity> MergeEntities(
+                  EntityComponentManager &_other);
+
       /// \brief Get a message with the serialized state of the given entities
       /// and components.
       /// \detail The header of the message will not be populated, it is the
@@ -503,6 +583,17 @@ namespace ignition
       /// \return True if there are any components with one-time changes.
       public: bool HasOneTimeComponentChanges() const;
 
+      /// \brief Get the entities which had components created, modified or
+      /// removed in the current iteration. Newly created entities and
+      /// entities marked for removal are not included, use `EachNew` and
+      /// `EachRemoved` for those.
+      /// \detail This is useful for consumers that only need to process
+      /// entities whose state changed, such as rendering, which can then
+      /// check each entity's `ComponentState` instead of iterating over all
+      /// entities.
+      /// \return Entities which have modified components.
+      public: const std::unordered_set<Entity> &ModifiedEntities() const;
+
       /// \brief Get the components types that are marked as periodic changes.
       /// \return All the components that at least one entity marked as
       /// periodic changes.
@@ -598,6 +689,16 @@ namespace ignition
       /// \brief Mark all components as not changed.
       protected: void SetAllComponentsUnchanged();
 
+      /// \brief Mark the ECM as read-only until EndReadOnly is called, so
+      /// caches such as that of WorldPose are brought up to date and can be
+      /// read without locks in between. The ECM must not be modified until
+      /// EndReadOnly, which is the case during PostUpdate.
+      protected: void BeginReadOnly();
+
+      /// \brief Mark the ECM as modifiable again, caching the results
+      /// computed since BeginReadOnly.
+      protected: void EndReadOnly();
+
       /// \brief Get whether an Entity exists and is new.
       ///
       /// Entities are considered new in the time between their creation and a
@@ -18,6 +18,7 @@
 #define IGNITION_GAZEBO_CREATEREMOVE_HH_
 
 #include <memory>
+#include <vector>
 
 #include <sdf/Actor.hh>
 #include <sdf/Collision.hh>
@@ -98,6 +99,18 @@ namespace ignition
       /// \return Model entity.
       public: Entity CreateEntities(const sdf::Model *_model);
 
+      /// \brief Create all entities that exist in several sdf::Model objects
+      /// and load their plugins, such as all the models of a world.
+      /// Entities get the same ids as if each model was passed to
+      /// CreateEntities(const sdf::Model *) in order. Large batches are
+      /// created in parallel, with each thread creating a range of models
+      /// into its own EntityComponentManager, which are then merged. Plugins
+      /// are loaded once all entities have been created.
+      /// \param[in] _models SDF model objects.
+      /// \return Model entities, in the same order as _models.
+      public: std::vector<Entity> CreateEntities(
+          const std::vector<const sdf::Model *> &_models);
+
       /// \brief Create all entities that exist in the sdf::Actor object and
       /// load their plugins.
       /// \param[in] _actor SDF actor object.
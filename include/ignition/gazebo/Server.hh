@@ -18,8 +18,10 @@
 #define IGNITION_GAZEBO_SERVER_HH_
 
 #include <cstdint>
+#include <istream>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
@@ -120,7 +122,8 @@ namespace ignition
       /// between ECS updates.
       /// Note that this is different from the simulation update rate. ECS
       /// systems will be updated even while sim time is paused.
-      /// \param[in] _updatePeriod Duration between updates.
+      /// \param[in] _updatePeriod Duration between updates. Zero runs
+      /// simulation as fast as possible, ignoring the real time factor.
       /// \param[in] _worldIndex Index of the world to query.
       public: void SetUpdatePeriod(
                   const std::chrono::steady_clock::duration &_updatePeriod,
@@ -219,6 +222,31 @@ namespace ignition
                   const SystemPluginPtr &_system,
                   const unsigned int _worldIndex = 0);
 
+      /// \brief Save the state of a world to a binary checkpoint, which can
+      /// be restored with RestoreCheckpoint. Checkpoints hold the state of
+      /// all entities and components, the simulation time, the random seed,
+      /// and the state of systems implementing ISystemCheckpoint, such as
+      /// physics. The server must not be running when calling this.
+      /// \param[out] _out Stream to write the checkpoint to. It may be a
+      /// file or a string stream opened in binary mode.
+      /// \param[in] _worldIndex Index of the world.
+      /// \return Whether the checkpoint was saved, or std::nullopt if
+      /// _worldIndex is invalid.
+      public: std::optional<bool> SaveCheckpoint(std::ostream &_out,
+                  const unsigned int _worldIndex = 0);
+
+      /// \brief Restore a world to a checkpoint saved with SaveCheckpoint,
+      /// without reloading it. The checkpoint must come from the same world,
+      /// loaded with the same systems, on the same machine. Systems
+      /// implementing ISystemReset are told about the jump in time. The
+      /// server must not be running when calling this.
+      /// \param[in] _in Stream to read the checkpoint from.
+      /// \param[in] _worldIndex Index of the world.
+      /// \return Whether the checkpoint was restored, or std::nullopt if
+      /// _worldIndex is invalid.
+      public: std::optional<bool> RestoreCheckpoint(std::istream &_in,
+                  const unsigned int _worldIndex = 0);
+
       /// \brief Get an Entity based on a name.
       /// \details If multiple entities with the same name exist, the first
       /// entity found will be returned.
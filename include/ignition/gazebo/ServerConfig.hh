@@ -275,6 +275,18 @@ namespace ignition
       /// \param[in] _playbackPath Path to recorded states
       public: void SetLogPlaybackPath(const std::string &_playbackPath);
 
+      /// \brief Get path to a checkpoint restored once the world is loaded.
+      /// \return Path to a file saved with Server::SaveCheckpoint, empty if
+      /// none.
+      /// \sa SetCheckpointPath
+      public: const std::string &CheckpointPath() const;
+
+      /// \brief Set path to a checkpoint to be restored once the world is
+      /// loaded, so a server can start from a saved simulation state. The
+      /// checkpoint must have been saved from the same world and systems.
+      /// \param[in] _path Path to a file saved with Server::SaveCheckpoint.
+      public: void SetCheckpointPath(const std::string &_path);
+
       /// \brief Get whether meshes and material files are recorded
       /// \return True if resources should be recorded.
       public: bool LogRecordResources() const;
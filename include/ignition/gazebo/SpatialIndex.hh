@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SPATIALINDEX_HH_
+#define IGNITION_GAZEBO_SPATIALINDEX_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class IGNITION_GAZEBO_HIDDEN SpatialIndexPrivate;
+    //
+    /// \class SpatialIndex SpatialIndex.hh ignition/gazebo/SpatialIndex.hh
+    /// \brief Dynamic bounding volume tree of entities. It finds the
+    /// entities which overlap a box, a sphere or a frustum without testing
+    /// each of them.
+    ///
+    /// Each entity is stored with an axis aligned box. The tree keeps that
+    /// box enlarged by a margin, so small motions don't change the tree.
+    ///
+    /// The entity component manager keeps an index of all models, see
+    /// EntityComponentManager::ModelSpatialIndex. Systems can also keep
+    /// their own indices of other entities.
+    class IGNITION_GAZEBO_VISIBLE SpatialIndex
+    {
+      /// \brief Constructor
+      /// \param[in] _margin Distance by which the boxes kept in the tree
+      /// are enlarged on each side.
+      public: explicit SpatialIndex(double _margin = 0.1);
+
+      /// \brief Move constructor
+      /// \param[in] _index Index to move.
+      public: SpatialIndex(SpatialIndex &&_index) noexcept;
+
+      /// \brief Move assignment operator.
+      /// \param[in] _index Index to move.
+      /// \return Reference to this.
+      public: SpatialIndex &operator=(SpatialIndex &&_index) noexcept;
+
+      /// \brief Destructor
+      public: ~SpatialIndex();
+
+      /// \brief Add an entity, or update the box of an entity which has
+      /// already been added.
+      /// \param[in] _entity Entity
+      /// \param[in] _box Box containing the entity.
+      public: void Update(const Entity _entity,
+                          const math::AxisAlignedBox &_box);
+
+      /// \brief Remove an entity.
+      /// \param[in] _entity Entity
+      /// \return True if the entity had been added.
+      public: bool Remove(const Entity _entity);
+
+      /// \brief Remove all entities.
+      public: void Clear();
+
+      /// \brief Get whether an entity has been added.
+      /// \param[in] _entity Entity
+      /// \return True if the entity has been added.
+      public: bool Contains(const Entity _entity) const;
+
+      /// \brief Get the box of an entity.
+      /// \param[in] _entity Entity
+      /// \return The entity's box, or an invalid box if the entity hasn't
+      /// been added.
+      public: math::AxisAlignedBox Box(const Entity _entity) const;
+
+      /// \brief Get the number of entities.
+      /// \return Number of entities.
+      public: size_t Size() const;
+
+      /// \brief Get the entities whose boxes overlap a box.
+      /// \param[in] _box Box
+      /// \return Entities in no particular order.
+      public: std::vector<Entity> Query(const math::AxisAlignedBox &_box)
+          const;
+
+      /// \brief Get the entities whose boxes overlap a sphere.
+      /// \param[in] _center Center of the sphere
+      /// \param[in] _radius Radius of the sphere
+      /// \return Entities in no particular order.
+      public: std::vector<Entity> Query(const math::Vector3d &_center,
+                                        double _radius) const;
+
+      /// \brief Get the entities whose boxes may overlap a frustum. Boxes
+      /// close to the frustum's corners may be reported even if they're
+      /// outside it.
+      /// \param[in] _frustum Frustum
+      /// \return Entities in no particular order.
+      public: std::vector<Entity> Query(const math::Frustum &_frustum) const;
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SpatialIndexPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
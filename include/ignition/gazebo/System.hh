@@ -17,7 +17,9 @@
 #ifndef IGNITION_GAZEBO_SYSTEM_HH_
 #define IGNITION_GAZEBO_SYSTEM_HH_
 
+#include <istream>
 #include <memory>
+#include <ostream>
 
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
@@ -120,6 +122,41 @@ namespace ignition
       public: virtual void PostUpdate(const UpdateInfo &_info,
                                       const EntityComponentManager &_ecm) = 0;
     };
+
+    /// \class ISystemCheckpoint ISystem.hh ignition/gazebo/System.hh
+    /// \brief Interface for a system with internal state which isn't held in
+    /// components, so it can be saved to and restored from simulation
+    /// checkpoints. Both functions are called between iterations.
+    class ISystemCheckpoint {
+      /// \brief Save the system's state.
+      /// \param[in] _ecm The EntityComponentManager, in the state being saved.
+      /// \param[out] _out Stream to write the state to, in any format.
+      public: virtual void SaveCheckpoint(const EntityComponentManager &_ecm,
+                                          std::ostream &_out) = 0;
+
+      /// \brief Restore the system's state. This is called after the
+      /// EntityComponentManager has been restored. Entities created since
+      /// the checkpoint are only removed at the end of the next iteration,
+      /// and entities removed since then are created again as new entities.
+      /// \param[in] _ecm The restored EntityComponentManager.
+      /// \param[in] _in Stream with the state written by SaveCheckpoint.
+      public: virtual void RestoreCheckpoint(EntityComponentManager &_ecm,
+                                             std::istream &_in) = 0;
+    };
+
+    /// \class ISystemReset ISystem.hh ignition/gazebo/System.hh
+    /// \brief Interface for a system which keeps track of simulation time,
+    /// such as when it last published, and must be told when time jumps,
+    /// for example when a checkpoint is restored. Reset is called between
+    /// iterations.
+    class ISystemReset {
+      /// \brief Reset the system's time keeping.
+      /// \param[in] _info Update info at the new time. Its dt is the jump,
+      /// negative when time went back.
+      /// \param[in] _ecm The EntityComponentManager, at the new time.
+      public: virtual void Reset(const UpdateInfo &_info,
+                                 EntityComponentManager &_ecm) = 0;
+    };
   }
   }
 }
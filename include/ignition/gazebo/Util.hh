@@ -17,6 +17,7 @@
 #ifndef IGNITION_GAZEBO_UTIL_HH_
 #define IGNITION_GAZEBO_UTIL_HH_
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -34,7 +35,9 @@ namespace ignition
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     //
-    /// \brief Helper function to compute world pose of an entity
+    /// \brief Helper function to compute world pose of an entity. During
+    /// PostUpdate, poses are cached by the ECM, see
+    /// EntityComponentManager::WorldPose.
     /// \param[in] _entity Entity to get the world pose for
     /// \param[in] _ecm Immutable reference to ECM.
     /// \return World pose of entity
@@ -175,6 +178,13 @@ namespace ignition
         const EntityComponentManager &_ecm,
         bool _excludeWorld = true);
 
+    /// \brief Get the mutex which must be locked while using
+    /// common::MeshManager, which isn't thread-safe. The same mutex is used
+    /// by rendering, the GUI and all systems, so meshes can be loaded from
+    /// any thread.
+    /// \return Mutex guarding common::MeshManager.
+    std::mutex IGNITION_GAZEBO_VISIBLE &meshManagerMutex();
+
     /// \brief Environment variable holding resource paths.
     const std::string kResourcePathEnv{"IGN_GAZEBO_RESOURCE_PATH"};
 
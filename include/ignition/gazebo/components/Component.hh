@@ -325,9 +325,28 @@ namespace components
     /// \param[in] _data Data to copy
     public: explicit Component(DataType _data);
 
+    /// \brief Copy constructor
+    /// \param[in] _component Component to copy
+    public: Component(const Component &_component) = default;
+
+    /// \brief Move constructor. The destructor would otherwise make moves
+    /// copy the data.
+    /// \param[in] _component Component to move
+    public: Component(Component &&_component) = default;
+
     /// \brief Destructor.
     public: ~Component() override = default;
 
+    /// \brief Copy assignment operator
+    /// \param[in] _component Component to copy
+    /// \return Reference to this component
+    public: Component &operator=(const Component &_component) = default;
+
+    /// \brief Move assignment operator
+    /// \param[in] _component Component to move
+    /// \return Reference to this component
+    public: Component &operator=(Component &&_component) = default;
+
     /// \brief Equality operator.
     /// \param[in] _component Component to compare to.
     /// \return True if equal.
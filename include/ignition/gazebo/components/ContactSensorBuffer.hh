@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_COMPONENTS_CONTACTSENSORBUFFER_HH_
+#define IGNITION_GAZEBO_COMPONENTS_CONTACTSENSORBUFFER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <ignition/msgs/contacts.pb.h>
+#include <ignition/msgs/Utility.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <ignition/gazebo/components/Component.hh>
+#include <ignition/gazebo/components/Factory.hh>
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Entity.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+  /// \brief Contacts of one collision, stored in flat arrays so they can be
+  /// filled every step without allocating. Contacts are grouped by the
+  /// other collision of the pair, and each pair has one or more points.
+  ///
+  /// Normals, depths and forces are only given by some physics engines. Each
+  /// of those arrays is either empty or as long as the positions array.
+  struct ContactBuffer
+  {
+    /// \brief Collision which owns the contacts, the first collision of
+    /// every pair.
+    Entity collision{kNullEntity};
+
+    /// \brief Second collision of each pair.
+    std::vector<Entity> collisions2;
+
+    /// \brief Index of the first point of each pair. The points of a pair
+    /// end where the points of the next pair start.
+    std::vector<uint32_t> pairStart;
+
+    /// \brief Position of each point in the world frame.
+    std::vector<math::Vector3d> positions;
+
+    /// \brief Normal of each point in the world frame.
+    std::vector<math::Vector3d> normals;
+
+    /// \brief Penetration depth of each point.
+    std::vector<double> depths;
+
+    /// \brief Force applied on the first collision at each point, in the
+    /// world frame.
+    std::vector<math::Vector3d> forces;
+
+    /// \brief Remove all contacts, keeping the memory for reuse.
+    public: void Clear()
+    {
+      this->collisions2.clear();
+      this->pairStart.clear();
+      this->positions.clear();
+      this->normals.clear();
+      this->depths.clear();
+      this->forces.clear();
+    }
+
+    /// \brief Get the number of pairs.
+    /// \return Number of collisions in contact with the owner.
+    public: std::size_t PairCount() const
+    {
+      return this->collisions2.size();
+    }
+
+    /// \brief Get the number of points.
+    /// \return Number of points across all pairs.
+    public: std::size_t PointCount() const
+    {
+      return this->positions.size();
+    }
+
+    /// \brief Get the index past the last point of a pair.
+    /// \param[in] _pair Index of the pair.
+    /// \return Index past the last point.
+    public: std::size_t PairEnd(std::size_t _pair) const
+    {
+      return _pair + 1 < this->pairStart.size() ?
+          this->pairStart[_pair + 1] : this->positions.size();
+    }
+
+    /// \brief Start a new pair. Points added after this belong to it.
+    /// \param[in] _collision2 Second collision of the pair.
+    public: void AddPair(Entity _collision2)
+    {
+      this->collisions2.push_back(_collision2);
+      this->pairStart.push_back(static_cast<uint32_t>(this->positions.size()));
+    }
+
+    /// \brief Fill a message with the contacts.
+    /// \param[out] _msg Message to fill. Existing contacts are replaced.
+    public: void ToMsg(msgs::Contacts &_msg) const
+    {
+      _msg.clear_contact();
+      this->AppendToMsg(_msg);
+    }
+
+    /// \brief Add the contacts to a message, one contact per pair.
+    /// \param[out] _msg Message to add contacts to.
+    public: void AppendToMsg(msgs::Contacts &_msg) const
+    {
+      for (std::size_t p = 0; p < this->PairCount(); ++p)
+      {
+        auto *contactMsg = _msg.add_contact();
+        contactMsg->mutable_collision1()->set_id(this->collision);
+        contactMsg->mutable_collision2()->set_id(this->collisions2[p]);
+        for (std::size_t i = this->pairStart[p]; i < this->PairEnd(p); ++i)
+        {
+          msgs::Set(contactMsg->add_position(), this->positions[i]);
+          if (!this->normals.empty())
+            msgs::Set(contactMsg->add_normal(), this->normals[i]);
+          if (!this->depths.empty())
+            contactMsg->add_depth(this->depths[i]);
+          if (!this->forces.empty())
+          {
+            auto *wrench = contactMsg->add_wrench();
+            msgs::Set(wrench->mutable_body_1_wrench()->mutable_force(),
+                this->forces[i]);
+            msgs::Set(wrench->mutable_body_2_wrench()->mutable_force(),
+                -this->forces[i]);
+          }
+        }
+      }
+    }
+
+    /// \brief Fill the buffer from a message. Contacts whose first
+    /// collision isn't the owner of the buffer are skipped.
+    /// \param[in] _msg Message holding contacts.
+    public: void FromMsg(const msgs::Contacts &_msg)
+    {
+      this->Clear();
+      for (const auto &contactMsg : _msg.contact())
+      {
+        if (this->collision == kNullEntity)
+          this->collision = contactMsg.collision1().id();
+        else if (this->collision != contactMsg.collision1().id())
+          continue;
+
+        this->AddPair(contactMsg.collision2().id());
+        for (int i = 0; i < contactMsg.position_size(); ++i)
+        {
+          this->positions.push_back(msgs::Convert(contactMsg.position(i)));
+          if (contactMsg.normal_size() > i)
+            this->normals.push_back(msgs::Convert(contactMsg.normal(i)));
+          if (contactMsg.depth_size() > i)
+            this->depths.push_back(contactMsg.depth(i));
+          if (contactMsg.wrench_size() > i)
+          {
+            this->forces.push_back(msgs::Convert(
+                contactMsg.wrench(i).body_1_wrench().force()));
+          }
+        }
+      }
+
+      // Keep the optional arrays consistent with the positions
+      if (this->normals.size() != this->positions.size())
+        this->normals.clear();
+      if (this->depths.size() != this->positions.size())
+        this->depths.clear();
+      if (this->forces.size() != this->positions.size())
+        this->forces.clear();
+    }
+
+    /// \brief Equality operator.
+    /// \param[in] _buffer Buffer to compare to.
+    /// \return True if both hold the same contacts.
+    public: bool operator==(const ContactBuffer &_buffer) const
+    {
+      return this->collision == _buffer.collision &&
+          this->collisions2 == _buffer.collisions2 &&
+          this->pairStart == _buffer.pairStart &&
+          this->positions == _buffer.positions &&
+          this->normals == _buffer.normals &&
+          this->depths == _buffer.depths &&
+          this->forces == _buffer.forces;
+    }
+
+    /// \brief Inequality operator.
+    /// \param[in] _buffer Buffer to compare to.
+    /// \return True if the buffers hold different contacts.
+    public: bool operator!=(const ContactBuffer &_buffer) const
+    {
+      return !(*this == _buffer);
+    }
+  };
+
+namespace serializers
+{
+  /// \brief Serializer for components::ContactSensorBuffer. The buffer is
+  /// streamed as an ignition::msgs::Contacts message, so it's only
+  /// converted to a message when it's sent out.
+  class ContactBufferSerializer
+  {
+    /// \brief Serialization
+    /// \param[out] _out Output stream.
+    /// \param[in] _buffer Buffer to stream
+    /// \return The stream.
+    public: static std::ostream &Serialize(std::ostream &_out,
+                const ContactBuffer &_buffer)
+    {
+      msgs::Contacts msg;
+      _buffer.ToMsg(msg);
+      msg.SerializeToOstream(&_out);
+      return _out;
+    }
+
+    /// \brief Deserialization
+    /// \param[in] _in Input stream.
+    /// \param[out] _buffer Buffer to populate
+    /// \return The stream.
+    public: static std::istream &Deserialize(std::istream &_in,
+                ContactBuffer &_buffer)
+    {
+      msgs::Contacts msg;
+      msg.ParseFromIstream(&_in);
+      _buffer.collision = kNullEntity;
+      _buffer.FromMsg(msg);
+      return _in;
+    }
+  };
+}
+
+namespace components
+{
+  /// \brief A component that holds the contacts of a collision. Physics
+  /// fills it on collisions which have it. It replaces ContactSensorData
+  /// for consumers which read contacts every step.
+  using ContactSensorBuffer = Component<ContactBuffer,
+      class ContactSensorBufferTag, serializers::ContactBufferSerializer>;
+  IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.ContactSensorBuffer",
+                                ContactSensorBuffer)
+}
+}
+}
+}
+
+#endif
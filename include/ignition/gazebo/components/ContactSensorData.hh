@@ -33,6 +33,9 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
 namespace components
 {
   /// \brief A component type that contains a list of contacts.
+  /// \deprecated Use ContactSensorBuffer, which in-tree systems create
+  /// instead. The Physics system still fills this component on collisions
+  /// which have it, until it's removed in the next major release.
   using ContactSensorData =
       Component<msgs::Contacts,
       class ContactSensorDataTag, serializers::MsgSerializer>;
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_COMPONENTS_STEPTIMES_HH_
+#define IGNITION_GAZEBO_COMPONENTS_STEPTIMES_HH_
+
+#include <ignition/msgs/header.pb.h>
+#include <ignition/gazebo/components/Component.hh>
+#include <ignition/gazebo/components/Factory.hh>
+#include <ignition/gazebo/components/Serialization.hh>
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace components
+{
+  /// \brief A component on the world entity with the wall time spent in
+  /// each part of the recent simulation steps, such as each system's
+  /// PreUpdate, Update and PostUpdate. It's updated about once per second.
+  /// Each entry of the header's data has the part's name as key, and
+  /// statistics such as "mean_us=12.5" as values. The same data is
+  /// published on the `/world/<name>/performance` topic.
+  using StepTimes = Component<msgs::Header, class StepTimesTag,
+      serializers::MsgSerializer>;
+  IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.StepTimes", StepTimes)
+}
+}
+}
+}
+
+#endif
@@ -17,7 +17,9 @@
 #ifndef IGNITION_GAZEBO_DETAIL_COMPONENTSTORAGEBASE_HH_
 #define IGNITION_GAZEBO_DETAIL_COMPONENTSTORAGEBASE_HH_
 
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 #include "ignition/gazebo/components/Component.hh"
@@ -80,9 +82,50 @@ namespace ignition
       protected: mutable std::mutex mutex;
     };
 
+    /// \brief Operations of component storages which aren't part of
+    /// ComponentStorageBase. Storages may be created by plugins built
+    /// against an earlier version, whose ComponentStorageBase vtable doesn't
+    /// have them, so the ECM checks that a storage implements this
+    /// interface before using them, and falls back otherwise.
+    class IGNITION_GAZEBO_VISIBLE ComponentStorageExtension
+    {
+      /// \brief Destructor
+      public: virtual ~ComponentStorageExtension() = default;
+
+      /// \brief Make room for a number of components, so creating them
+      /// doesn't expand the components array.
+      /// \param[in] _count Number of components the array should fit.
+      /// \return True if the components array was expanded.
+      public: virtual bool Reserve(const std::size_t _count) = 0;
+
+      /// \brief Get the number of components.
+      /// \return Number of components.
+      public: virtual std::size_t Size() const = 0;
+
+      /// \brief Create a new component by moving the given data into the
+      /// storage, instead of copying it.
+      /// \param[in, out] _data Data of the component's type, left in a valid
+      /// but unspecified state.
+      /// \return See ComponentStorageBase::Create.
+      public: virtual std::pair<ComponentId, bool> Create(
+                  components::BaseComponent &&_data) = 0;
+
+      /// \brief Copy the storage, keeping the ids of all components.
+      /// \return New storage with copies of all components.
+      public: virtual std::unique_ptr<ComponentStorageBase> Clone() const = 0;
+
+      /// \brief Copy data into an existing component.
+      /// \param[in] _id Id of the component to overwrite.
+      /// \param[in] _data Data of the component's type.
+      /// \return True if the component exists.
+      public: virtual bool Copy(const ComponentId _id,
+                  const components::BaseComponent &_data) = 0;
+    };
+
     /// \brief Templated implementation of component storage.
     template<typename ComponentTypeT>
-    class IGNITION_GAZEBO_HIDDEN ComponentStorage : public ComponentStorageBase
+    class IGNITION_GAZEBO_HIDDEN ComponentStorage
+      : public ComponentStorageBase, public ComponentStorageExtension
     {
       /// \brief Constructor
       public: explicit ComponentStorage()
@@ -151,9 +194,45 @@ namespace ignition
         this->components.clear();
       }
 
+      // Documentation inherited.
+      public: bool Reserve(const std::size_t _count) final
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (_count <= this->components.capacity())
+          return false;
+
+        // Keep the spare room Create would leave
+        this->components.reserve(_count + 100);
+        return true;
+      }
+
+      // Documentation inherited.
+      public: std::size_t Size() const final
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->components.size();
+      }
+
       // Documentation inherited.
       public: std::pair<ComponentId, bool> Create(
                   const components::BaseComponent *_data) final
+      {
+        // Copy the component
+        return this->Add(
+            ComponentTypeT(*static_cast<const ComponentTypeT *>(_data)));
+      }
+
+      // Documentation inherited.
+      public: std::pair<ComponentId, bool> Create(
+                  components::BaseComponent &&_data) final
+      {
+        return this->Add(std::move(static_cast<ComponentTypeT &>(_data)));
+      }
+
+      /// \brief Add a component to the storage.
+      /// \param[in] _component Component to move into the storage.
+      /// \return See Create.
+      private: std::pair<ComponentId, bool> Add(ComponentTypeT &&_component)
       {
         ComponentId result;  // = kComponentIdInvalid;
         bool expanded = false;
@@ -168,9 +247,7 @@ namespace ignition
         // cppcheck-suppress postfixOperator
         result = this->idCounter++;
         this->idMap[result] = this->components.size();
-        // Copy the component
-        this->components.push_back(std::move(
-              ComponentTypeT(*static_cast<const ComponentTypeT *>(_data))));
+        this->components.push_back(std::move(_component));
 
         return {result, expanded};
       }
@@ -207,6 +284,29 @@ namespace ignition
         return nullptr;
       }
 
+      // Documentation inherited.
+      public: std::unique_ptr<ComponentStorageBase> Clone() const final
+      {
+        auto clone = std::make_unique<ComponentStorage<ComponentTypeT>>();
+        std::lock_guard<std::mutex> lock(this->mutex);
+        clone->idCounter = this->idCounter;
+        clone->idMap = this->idMap;
+        clone->components = this->components;
+        return clone;
+      }
+
+      // Documentation inherited.
+      public: bool Copy(const ComponentId _id,
+                  const components::BaseComponent &_data) final
+      {
+        auto comp = static_cast<ComponentTypeT *>(this->Component(_id));
+        if (nullptr == comp)
+          return false;
+
+        *comp = static_cast<const ComponentTypeT &>(_data);
+        return true;
+      }
+
       /// \brief The id counter is used to get unique ids within this
       /// storage class.
       private: ComponentId idCounter = 0;
@@ -41,12 +41,18 @@ namespace gazebo
   /// GUI systems are different from `ignition::gazebo::System`s because they
   /// don't run in the same process as the physics. Instead, they run in a
   /// separate process that is stepped by updates coming through the network
+  ///
+  /// A system can limit how often it's updated by setting an `updateRate`
+  /// property, in Hz, before it's added to the GUI, for example with
+  /// `this->setProperty("updateRate", 10.0)`. Updates which only change
+  /// component values may then be skipped. Updates which create or remove
+  /// entities, or which carry one-time component changes, are never skipped.
   class IGNITION_GAZEBO_GUI_VISIBLE GuiSystem : public ignition::gui::Plugin
   {
     Q_OBJECT
 
     /// \brief Update callback called every time the system is stepped.
-    /// This is called at an Ignition transport thread, so any interaction
+    /// This is called at the GUI runner's update thread, so any interaction
     /// with Qt should be done through signals and slots.
     /// \param[in] _info Current simulation information, such as time.
     /// \param[in] _ecm Mutable reference to the ECM, so the system can read
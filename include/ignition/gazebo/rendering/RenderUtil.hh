@@ -107,6 +107,24 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     /// \brief Show grid view in the scene
     public: void ShowGrid();
 
+    /// \brief Set whether to cull pose updates. When enabled, Update holds
+    /// back the pose updates of top level models which can't be seen by any
+    /// of the culling sensors, according to each sensor's far clip distance
+    /// and, for cameras, field of view. Held back updates are applied once
+    /// the models may be seen. Models with lights, and models whose parts
+    /// moved relative to each other, are never culled.
+    /// Disabled by default.
+    /// \param[in] _enabled True to enable culling
+    /// \sa SetCullingSensors
+    public: void SetCullingEnabled(bool _enabled);
+
+    /// \brief Set the sensors which will render after the next Update. This
+    /// should be called from the rendering thread, before Update.
+    /// \param[in] _sensorNames Names of the rendering sensors
+    /// \sa SetCullingEnabled
+    public: void SetCullingSensors(
+        const std::vector<std::string> &_sensorNames);
+
     /// \brief Set whether to use the current GL context
     /// \param[in] _enable True to use the current GL context
     public: void SetUseCurrentGLContext(bool _enable);
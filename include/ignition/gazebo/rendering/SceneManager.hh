@@ -21,6 +21,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <sdf/Geometry.hh>
 #include <sdf/Actor.hh>
@@ -32,6 +34,7 @@
 
 #include <ignition/common/KeyFrame.hh>
 #include <ignition/common/Animation.hh>
+#include <ignition/common/Mesh.hh>
 #include <ignition/common/graphics/Types.hh>
 
 #include <ignition/msgs/particle_emitter.pb.h>
@@ -134,6 +137,40 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     public: rendering::VisualPtr CreateVisual(Entity _id,
         const sdf::Visual &_visual, Entity _parentId = 0);
 
+    /// \brief Create multiple visuals at once. Visuals which share the same
+    /// geometry and material are created back to back, reusing the
+    /// resolved mesh and the loaded material instead of loading them once
+    /// per visual.
+    /// \param[in] _visuals Visuals to create. The elements in the tuple are:
+    /// [0] unique visual id, [1] visual sdf dom, [2] parent id
+    /// \return Visual objects created, in the same order as _visuals. Null
+    /// for visuals which couldn't be created.
+    public: std::vector<rendering::VisualPtr> CreateVisuals(
+        const std::vector<std::tuple<Entity, sdf::Visual, Entity>> &_visuals);
+
+    /// \brief Set whether visuals which look the same share a single
+    /// material. Render engines such as ogre2 can then draw all visuals
+    /// sharing a mesh and a material as instances of each other, which
+    /// greatly reduces the rendering cost of repetitive worlds. Modifying
+    /// the material of one of these visuals affects all of them, so this
+    /// should only be enabled by users which don't edit materials.
+    /// Only affects visuals created after this call. Disabled by default.
+    /// \param[in] _enabled True to enable instancing
+    public: void SetInstancingEnabled(bool _enabled);
+
+    /// \brief Get whether visuals which look the same share a material.
+    /// \return True if instancing is enabled
+    /// \sa SetInstancingEnabled
+    public: bool InstancingEnabled() const;
+
+    /// \brief Load a mesh into the common::MeshManager, so that creating
+    /// visuals which use it doesn't need to load it again. Unlike the rest of
+    /// this class, this function can be called from any thread, which allows
+    /// meshes to be loaded in the background. It locks meshManagerMutex.
+    /// \param[in] _fullPath Full path to the mesh file.
+    /// \return The loaded mesh, or nullptr if it failed to load.
+    public: static const common::Mesh *LoadMesh(const std::string &_fullPath);
+
     /// \brief Create a collision visual
     /// \param[in] _id Unique visual id
     /// \param[in] _collision Collision sdf dom
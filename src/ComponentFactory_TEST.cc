@@ -16,6 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+
+#include <utility>
+
 #include "ignition/gazebo/test_config.hh"
 #include "ignition/gazebo/components/Component.hh"
 #include "ignition/gazebo/components/Factory.hh"
@@ -125,6 +128,26 @@ TEST_F(ComponentFactoryTest, New)
 
     EXPECT_NE(nullptr, static_cast<ComponentStorage<components::Pose> *>(
         storage.get()));
+
+    // Operations which aren't part of ComponentStorageBase
+    auto extension =
+        dynamic_cast<ComponentStorageExtension *>(storage.get());
+    ASSERT_NE(nullptr, extension);
+    EXPECT_EQ(0u, extension->Size());
+    EXPECT_TRUE(extension->Reserve(1000u));
+    EXPECT_FALSE(extension->Reserve(1000u));
+
+    components::Pose pose(math::Pose3d(1, 2, 3, 0, 0, 0));
+    auto created = storage->Create(&pose);
+    EXPECT_FALSE(created.second);
+    EXPECT_EQ(1u, extension->Size());
+
+    auto moved = extension->Create(std::move(pose));
+    EXPECT_NE(created.first, moved.first);
+    EXPECT_EQ(2u, extension->Size());
+    EXPECT_EQ(math::Pose3d(1, 2, 3, 0, 0, 0),
+        static_cast<components::Pose *>(
+        storage->Component(moved.first))->Data());
   }
 }
 
@@ -15,21 +15,220 @@
  *
 */
 
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <set>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/graph/GraphAlgorithms.hh>
 #include "ignition/gazebo/components/Component.hh"
 #include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Change state of components since the last reset.
+///
+/// The state of each component is stored in a vector per component type,
+/// indexed by component id, together with the epoch in which it was set.
+/// Component ids are allocated sequentially per type, so the vectors are
+/// dense. States from previous epochs mean NoChange, so resetting only
+/// bumps the epoch. The components marked in the current epoch are also
+/// listed, so changes can be visited without going over all components.
+class ComponentChanges
+{
+  /// \brief A component marked in the current epoch.
+  public: struct Change
+  {
+    /// \brief Entity which has the component.
+    Entity entity;
+
+    /// \brief Component key.
+    ComponentKey key;
+  };
+
+  /// \brief Set the change state of a component.
+  /// \param[in] _entity Entity which has the component.
+  /// \param[in] _key Component key.
+  /// \param[in] _state New state.
+  public: void Set(const Entity _entity, const ComponentKey &_key,
+      ComponentState _state)
+  {
+    if (_key.second < 0)
+      return;
+
+    auto &stamps = this->types[_key.first];
+    auto index = static_cast<std::size_t>(_key.second);
+    if (index >= stamps.size())
+    {
+      if (_state == ComponentState::NoChange)
+        return;
+      stamps.resize(index + 1, 0u);
+    }
+
+    // Components are listed the first time they're marked in an epoch.
+    // Setting them back to NoChange keeps the epoch, so they aren't listed
+    // twice.
+    auto &stamp = stamps[index];
+    if ((stamp >> 2) == this->epoch)
+    {
+      this->Count(_key.first, this->StateFromStamp(stamp), false);
+    }
+    else
+    {
+      if (_state == ComponentState::NoChange)
+        return;
+      this->changes.push_back({_entity, _key});
+    }
+    this->Count(_key.first, _state, true);
+    stamp = (this->epoch << 2) | static_cast<uint64_t>(_state);
+  }
+
+  /// \brief Get the change state of a component.
+  /// \param[in] _key Component key.
+  /// \return Its state.
+  public: ComponentState State(const ComponentKey &_key) const
+  {
+    auto typeIt = this->types.find(_key.first);
+    if (typeIt == this->types.end() || _key.second < 0 ||
+        static_cast<std::size_t>(_key.second) >= typeIt->second.size())
+    {
+      return ComponentState::NoChange;
+    }
+    return this->StateFromStamp(typeIt->second[_key.second]);
+  }
+
+  /// \brief Get the components marked in the current epoch. Some of them
+  /// may have been set back to NoChange, or removed, since.
+  /// \return Marked components, in the order they were first marked.
+  public: const std::vector<Change> &Changes() const
+  {
+    return this->changes;
+  }
+
+  /// \brief Forget the states of all components.
+  public: void Clear()
+  {
+    this->types.clear();
+    this->changes.clear();
+    this->oneTimeCount = 0;
+    this->periodicCounts.clear();
+  }
+
+  /// \brief Mark all components as unchanged.
+  public: void Reset()
+  {
+    ++this->epoch;
+    this->changes.clear();
+    this->oneTimeCount = 0;
+    this->periodicCounts.clear();
+  }
+
+  /// \brief Check if any component has a one-time change.
+  /// \return True if so.
+  public: bool HasOneTimeChanges() const
+  {
+    return this->oneTimeCount > 0;
+  }
+
+  /// \brief Get the types of components with periodic changes.
+  /// \return Component types.
+  public: std::unordered_set<ComponentTypeId> PeriodicTypes() const
+  {
+    std::unordered_set<ComponentTypeId> result;
+    for (const auto &count : this->periodicCounts)
+      result.insert(count.first);
+    return result;
+  }
+
+  /// \brief Get the state stored in a stamp.
+  /// \param[in] _stamp Stamp
+  /// \return The state, NoChange if it was set in a previous epoch.
+  private: ComponentState StateFromStamp(uint64_t _stamp) const
+  {
+    if ((_stamp >> 2) != this->epoch)
+      return ComponentState::NoChange;
+    return static_cast<ComponentState>(_stamp & 3);
+  }
+
+  /// \brief Update the number of components in a state.
+  /// \param[in] _type Component type.
+  /// \param[in] _state State.
+  /// \param[in] _enter True for a component entering the state, false for
+  /// one leaving it.
+  private: void Count(ComponentTypeId _type, ComponentState _state,
+      bool _enter)
+  {
+    if (_state == ComponentState::OneTimeChange)
+    {
+      if (_enter)
+        ++this->oneTimeCount;
+      else
+        --this->oneTimeCount;
+    }
+    else if (_state == ComponentState::PeriodicChange)
+    {
+      auto &count = this->periodicCounts[_type];
+      if (_enter)
+        ++count;
+      else if (--count == 0)
+        this->periodicCounts.erase(_type);
+    }
+  }
+
+  /// \brief Stamps of components per type, indexed by component id. A
+  /// stamp is the epoch shifted left by 2 bits, plus the state.
+  private: std::unordered_map<ComponentTypeId, std::vector<uint64_t>> types;
+
+  /// \brief Components marked in the current epoch.
+  private: std::vector<Change> changes;
+
+  /// \brief Current epoch, starting at 1 so zeroed stamps mean NoChange.
+  private: uint64_t epoch{1};
+
+  /// \brief Number of components with a one-time change.
+  private: std::size_t oneTimeCount{0};
+
+  /// \brief Number of components with a periodic change, per type. Only
+  /// types with such components are present.
+  private: std::unordered_map<ComponentTypeId, std::size_t> periodicCounts;
+};
+
+/// \brief Get the operations of a storage which aren't part of
+/// ComponentStorageBase.
+/// \param[in] _storage Storage
+/// \return The storage's extension, or nullptr if the storage was created by
+/// a plugin built against a version without it.
+static ComponentStorageExtension *storageExtension(
+    const std::shared_ptr<ComponentStorageBase> &_storage)
+{
+  return dynamic_cast<ComponentStorageExtension *>(_storage.get());
+}
+
+/// \brief World pose of an entity, as cached by the ECM.
+struct CachedWorldPose
+{
+  /// \brief Pose in the world frame.
+  math::Pose3d pose;
+
+  /// \brief Parent entity, given by the ParentEntity component, or
+  /// kNullEntity.
+  Entity parent{kNullEntity};
+};
+
 class ignition::gazebo::EntityComponentManagerPrivate
 {
   /// \brief Implementation of the CreateEntity function, which takes a specific
@@ -50,6 +249,12 @@ class ignition::gazebo::EntityComponentManagerPrivate
   /// \return True if created successfully.
   public: bool CreateComponentStorage(const ComponentTypeId _typeId);
 
+  /// \brief Associate a component with an entity, once the component has
+  /// been created in its storage. Views aren't updated.
+  /// \param[in] _entity Entity
+  /// \param[in] _key Key of the new component
+  public: void AddComponent(const Entity _entity, const ComponentKey &_key);
+
   /// \brief Allots the work for multiple threads prior to running
   /// `AddEntityToMessage`.
   public: void CalculateStateThreadLoad();
@@ -72,6 +277,13 @@ class ignition::gazebo::EntityComponentManagerPrivate
       msgs::SerializedStateMap &_msg,
       const std::unordered_set<ComponentTypeId> &_types = {});
 
+  /// \brief Add a component marked as changed to a state message, unless
+  /// it was set back to NoChange or removed since.
+  /// \param[in, out] _msg State message
+  /// \param[in] _change Changed component
+  public: void AddChangeToMessage(msgs::SerializedStateMap &_msg,
+      const ComponentChanges::Change &_change) const;
+
   /// \brief Add newly modified (created/modified/removed) components to
   /// modifiedComponents list. The entity is added to the list when it is not
   /// a newly created entity or is not an entity to be removed
@@ -81,17 +293,15 @@ class ignition::gazebo::EntityComponentManagerPrivate
   /// \brief Map of component storage classes. The key is a component
   /// type id, and the value is a pointer to the component storage.
   public: std::unordered_map<ComponentTypeId,
-          std::unique_ptr<ComponentStorageBase>> components;
+          std::shared_ptr<ComponentStorageBase>> components;
 
   /// \brief A graph holding all entities, arranged according to their
   /// parenting.
   public: EntityGraph entities;
 
-  /// \brief Components that have been changed through a peridic change.
-  public: std::set<ComponentKey> periodicChangedComponents;
-
-  /// \brief Components that have been changed through a one-time change.
-  public: std::set<ComponentKey> oneTimeChangedComponents;
+  /// \brief Components that have been changed through a periodic or
+  /// one-time change.
+  public: ComponentChanges changedComponents;
 
   /// \brief Entities that have just been created
   public: std::unordered_set<Entity> newlyCreatedEntities;
@@ -149,9 +359,126 @@ class ignition::gazebo::EntityComponentManagerPrivate
   public: mutable std::unordered_map<Entity, std::unordered_set<Entity>>
           descendantCache;
 
+  /// \brief True between BeginReadOnly and EndReadOnly.
+  public: bool readOnly{false};
+
+  /// \brief World poses computed so far, see WorldPose. An entity's pose is
+  /// kept until the Pose or ParentEntity of the entity or of one of its
+  /// ancestors changes.
+  public: mutable std::unordered_map<Entity, CachedWorldPose> worldPoses;
+
+  /// \brief Entities in worldPoses, per parent entity. Their poses depend on
+  /// their parent's, so they're invalidated along with it.
+  public: mutable std::unordered_map<Entity, std::unordered_set<Entity>>
+          worldPoseChildren;
+
+  /// \brief Entities whose cached pose was invalidated. They're computed
+  /// again before the ECM becomes read-only, so the PostUpdate threads find
+  /// the poses they used in the previous iteration in the cache.
+  public: std::unordered_set<Entity> refreshPoses;
+
+  /// \brief Poses computed while read-only, when worldPoses can't be
+  /// modified. They're cached once the ECM can be modified again.
+  public: mutable std::vector<std::pair<Entity, CachedWorldPose>>
+          pendingWorldPoses;
+
+  /// \brief Protects pendingWorldPoses, which is filled from the PostUpdate
+  /// threads on cache misses.
+  public: mutable std::mutex pendingWorldPosesMutex;
+
+  /// \brief Get the world pose of an entity, using and filling the cache.
+  /// \param[in] _ecm ECM which owns this.
+  /// \param[in] _entity Entity
+  /// \return World pose.
+  public: math::Pose3d ComputeWorldPose(const EntityComponentManager &_ecm,
+              const Entity _entity) const;
+
+  /// \brief Add a pose to worldPoses.
+  /// \param[in] _entity Entity
+  /// \param[in] _pose World pose of the entity and its parent.
+  public: void CacheWorldPose(const Entity _entity,
+              const CachedWorldPose &_pose) const;
+
+  /// \brief Drop the cached world pose of an entity and its descendants,
+  /// after its Pose or ParentEntity changed.
+  /// \param[in] _entity Entity
+  public: void InvalidateWorldPose(const Entity _entity);
+
+  /// \brief Drop the cached world pose of an entity if a component of the
+  /// given type affects it.
+  /// \param[in] _entity Entity
+  /// \param[in] _typeId Type of a component of the entity which changed.
+  public: void InvalidateWorldPose(const Entity _entity,
+              const ComponentTypeId _typeId);
+
+  /// \brief Index of the world positions of models, see ModelSpatialIndex.
+  public: mutable SpatialIndex modelIndex;
+
+  /// \brief Models in modelIndex. Their world poses are either cached or
+  /// they're in dirtyModels, so they're marked as dirty when their pose
+  /// changes.
+  public: mutable std::unordered_set<Entity> indexedModels;
+
+  /// \brief Entities whose position in modelIndex must be updated, because
+  /// their pose changed, or they became or stopped being models.
+  public: mutable std::unordered_set<Entity> dirtyModels;
+
+  /// \brief True once the index has been requested. From then on, it's
+  /// kept up to date.
+  public: mutable bool modelIndexUsed{false};
+
+  /// \brief Protects the model index while it's built on request.
+  public: mutable std::mutex modelIndexMutex;
+
+  /// \brief Add all models to modelIndex.
+  /// \param[in] _ecm ECM which owns this.
+  public: void BuildModelIndex(const EntityComponentManager &_ecm) const;
+
+  /// \brief Update the position of the models in dirtyModels, and remove
+  /// the entities which aren't models anymore.
+  /// \param[in] _ecm ECM which owns this.
+  public: void UpdateModelIndex(const EntityComponentManager &_ecm) const;
+
+  /// \brief Mark an entity as dirty in the model index if its Model
+  /// component was created or removed.
+  /// \param[in] _entity Entity
+  /// \param[in] _typeId Type of the component created or removed.
+  public: void ModelComponentChanged(const Entity _entity,
+              const ComponentTypeId _typeId);
+
+  /// \brief Copies of component storages shared by snapshots, per type.
+  /// Types without a copy are copied on the next snapshot.
+  public: mutable std::unordered_map<ComponentTypeId,
+          std::shared_ptr<ComponentStorageBase>> snapshotStorages;
+
+  /// \brief Components marked as changed since their type's copy in
+  /// snapshotStorages was made, per type.
+  public: mutable std::unordered_map<ComponentTypeId,
+          std::unordered_set<ComponentId>> snapshotChanges;
+
+  /// \brief Drop the copy of a type's storage shared by snapshots, after
+  /// components of that type were created or removed.
+  /// \param[in] _typeId Component type
+  public: void InvalidateSnapshotStorage(const ComponentTypeId _typeId);
+
+  /// \brief Note that a component was marked as changed, so its value is
+  /// copied again by the next snapshot.
+  /// \param[in] _key Component key
+  public: void SnapshotComponentChanged(const ComponentKey &_key);
+
   /// \brief Keep track of entities already used to ensure uniqueness.
   public: uint64_t entityCount{0};
 
+  /// \brief True while creating components in a batch, in which case views
+  /// are updated once the batch is done, instead of after each component.
+  public: bool batchingViews{false};
+
+  /// \brief True if all views must be rebuilt once the batch is done.
+  public: bool batchRebuildViews{false};
+
+  /// \brief Entities whose views must be updated once the batch is done.
+  public: std::unordered_set<Entity> batchViewEntities;
+
   /// \brief Unordered multimap of removed components. The key is the entity to
   /// which belongs the component, and the value is the component being
   /// removed.
@@ -288,9 +615,17 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
     this->dataPtr->entityComponents.clear();
     this->dataPtr->toRemoveEntities.clear();
     this->dataPtr->entityComponentsDirty = true;
+    this->dataPtr->snapshotStorages.clear();
+    this->dataPtr->snapshotChanges.clear();
+    this->dataPtr->changedComponents.Clear();
+    this->dataPtr->worldPoses.clear();
+    this->dataPtr->worldPoseChildren.clear();
+    this->dataPtr->refreshPoses.clear();
+    this->dataPtr->dirtyModels.insert(this->dataPtr->indexedModels.begin(),
+        this->dataPtr->indexedModels.end());
 
     for (std::pair<const ComponentTypeId,
-        std::unique_ptr<ComponentStorageBase>> &comp: this->dataPtr->components)
+        std::shared_ptr<ComponentStorageBase>> &comp: this->dataPtr->components)
     {
       comp.second->RemoveAll();
     }
@@ -311,6 +646,10 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
       // Remove from graph
       this->dataPtr->entities.RemoveVertex(entity);
 
+      // Children which aren't removed now depend on another pose
+      this->dataPtr->InvalidateWorldPose(entity);
+      this->dataPtr->refreshPoses.erase(entity);
+
       auto entityIter = this->dataPtr->entityComponents.find(entity);
       // Remove the components, if any.
       if (entityIter != this->dataPtr->entityComponents.end())
@@ -318,6 +657,9 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
         for (const auto &key : entityIter->second)
         {
           this->dataPtr->components.at(key.first)->Remove(key.second);
+          this->dataPtr->InvalidateSnapshotStorage(key.first);
+          this->dataPtr->changedComponents.Set(entity, key,
+              ComponentState::NoChange);
         }
 
         // Remove the entry in the entityComponent map
@@ -359,9 +701,12 @@ bool EntityComponentManager::RemoveComponent(
 
   this->dataPtr->components.at(_key.first)->Remove(_key.second);
   this->dataPtr->entityComponents[_entity].erase(_key.first);
-  this->dataPtr->oneTimeChangedComponents.erase(_key);
-  this->dataPtr->periodicChangedComponents.erase(_key);
+  this->dataPtr->changedComponents.Set(_entity, _key,
+      ComponentState::NoChange);
   this->dataPtr->entityComponentsDirty = true;
+  this->dataPtr->InvalidateSnapshotStorage(_key.first);
+  this->dataPtr->InvalidateWorldPose(_entity, _key.first);
+  this->dataPtr->ModelComponentChanged(_entity, _key.first);
 
   this->UpdateViews(_entity);
 
@@ -437,20 +782,7 @@ ComponentState EntityComponentManager::ComponentState(const Entity _entity,
   if (typeKey == ecIter->second.end())
     return result;
 
-  ComponentKey key{_typeId, typeKey->second};
-
-  if (this->dataPtr->oneTimeChangedComponents.find(key) !=
-      this->dataPtr->oneTimeChangedComponents.end())
-  {
-    result = ComponentState::OneTimeChange;
-  }
-  else if (this->dataPtr->periodicChangedComponents.find(key) !=
-      this->dataPtr->periodicChangedComponents.end())
-  {
-    result = ComponentState::PeriodicChange;
-  }
-
-  return result;
+  return this->dataPtr->changedComponents.State({_typeId, typeKey->second});
 }
 
 /////////////////////////////////////////////////
@@ -471,19 +803,21 @@ bool EntityComponentManager::HasEntitiesMarkedForRemoval() const
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasOneTimeComponentChanges() const
 {
-  return !this->dataPtr->oneTimeChangedComponents.empty();
+  return this->dataPtr->changedComponents.HasOneTimeChanges();
+}
+
+/////////////////////////////////////////////////
+const std::unordered_set<Entity> &EntityComponentManager::ModifiedEntities()
+    const
+{
+  return this->dataPtr->modifiedComponents;
 }
 
 /////////////////////////////////////////////////
 std::unordered_set<ComponentTypeId>
     EntityComponentManager::ComponentTypesWithPeriodicChanges() const
 {
-  std::unordered_set<ComponentTypeId> periodicComponents;
-  for (const auto& compPair : this->dataPtr->periodicChangedComponents)
-  {
-    periodicComponents.insert(compPair.first);
-  }
-  return periodicComponents;
+  return this->dataPtr->changedComponents.PeriodicTypes();
 }
 
 /////////////////////////////////////////////////
@@ -544,27 +878,47 @@ ComponentKey EntityComponentManager::CreateComponentImplementation(
     }
   }
 
-  this->dataPtr->AddModifiedComponent(_entity);
-
   // Instantiate the new component.
   std::pair<ComponentId, bool> componentIdPair =
     this->dataPtr->components[_componentTypeId]->Create(_data);
 
   ComponentKey componentKey{_componentTypeId, componentIdPair.first};
+  this->dataPtr->AddComponent(_entity, componentKey);
 
-  this->dataPtr->entityComponents[_entity].insert(
-      {_componentTypeId, componentIdPair.first});
-  this->dataPtr->oneTimeChangedComponents.insert(componentKey);
-  this->dataPtr->entityComponentsDirty = true;
-
-  if (componentIdPair.second)
+  if (this->dataPtr->batchingViews)
+  {
+    if (componentIdPair.second)
+      this->dataPtr->batchRebuildViews = true;
+    else
+      this->dataPtr->batchViewEntities.insert(_entity);
+  }
+  else if (componentIdPair.second)
+  {
     this->RebuildViews();
+  }
   else
+  {
     this->UpdateViews(_entity);
+  }
 
   return componentKey;
 }
 
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::AddComponent(const Entity _entity,
+    const ComponentKey &_key)
+{
+  this->AddModifiedComponent(_entity);
+
+  this->entityComponents[_entity].insert({_key.first, _key.second});
+  this->changedComponents.Set(_entity, _key,
+      ComponentState::OneTimeChange);
+  this->entityComponentsDirty = true;
+  this->InvalidateSnapshotStorage(_key.first);
+  this->InvalidateWorldPose(_entity, _key.first);
+  this->ModelComponentChanged(_entity, _key.first);
+}
+
 /////////////////////////////////////////////////
 bool EntityComponentManager::EntityMatches(Entity _entity,
     const std::set<ComponentTypeId> &_types) const
@@ -632,10 +986,10 @@ components::BaseComponent *EntityComponentManager::ComponentImplementation(
     return nullptr;
 
   auto typeIter = ecIter->second.find(_type);
-  if (typeIter != ecIter->second.end())
-    return this->dataPtr->components.at(_type)->Component(typeIter->second);
+  if (typeIter == ecIter->second.end())
+    return nullptr;
 
-  return nullptr;
+  return this->dataPtr->components.at(_type)->Component(typeIter->second);
 }
 
 /////////////////////////////////////////////////
@@ -972,11 +1326,8 @@ void EntityComponentManager::AddEntityToMessage(msgs::SerializedStateMap &_msg,
     ComponentKey comp = {type, typeIter->second};
 
     // If not sending full state, skip unchanged components
-    if (!_full &&
-        this->dataPtr->oneTimeChangedComponents.find(comp) ==
-        this->dataPtr->oneTimeChangedComponents.end() &&
-        this->dataPtr->periodicChangedComponents.find(comp) ==
-        this->dataPtr->periodicChangedComponents.end())
+    if (!_full && this->dataPtr->changedComponents.State(comp) ==
+        ComponentState::NoChange)
     {
       continue;
     }
@@ -1060,13 +1411,64 @@ void EntityComponentManager::ChangedState(
     this->AddEntityToMessage(_state, entity);
   }
 
-  // New / removed / changed components
-  for (const auto &entity : this->dataPtr->modifiedComponents)
+  // New / changed components of other entities, only visiting the
+  // components marked in this iteration
+  for (const auto &change : this->dataPtr->changedComponents.Changes())
   {
-    this->AddEntityToMessage(_state, entity);
+    if (this->dataPtr->newlyCreatedEntities.find(change.entity) !=
+        this->dataPtr->newlyCreatedEntities.end() ||
+        this->dataPtr->toRemoveEntities.find(change.entity) !=
+        this->dataPtr->toRemoveEntities.end())
+    {
+      continue;
+    }
+    this->dataPtr->AddChangeToMessage(_state, change);
+  }
+
+  // Removed components
+  for (auto entity : this->dataPtr->modifiedComponents)
+  {
+    this->dataPtr->SetRemovedComponentsMsgs(entity, _state);
   }
 }
 
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::AddChangeToMessage(
+    msgs::SerializedStateMap &_msg,
+    const ComponentChanges::Change &_change) const
+{
+  if (this->changedComponents.State(_change.key) == ComponentState::NoChange)
+    return;
+
+  auto entityIt = this->entityComponents.find(_change.entity);
+  if (entityIt == this->entityComponents.end())
+    return;
+
+  auto typeIt = entityIt->second.find(_change.key.first);
+  if (typeIt == entityIt->second.end() ||
+      typeIt->second != _change.key.second)
+  {
+    return;
+  }
+
+  const components::BaseComponent *compBase =
+      this->components.at(_change.key.first)->Component(_change.key.second);
+  if (nullptr == compBase)
+    return;
+
+  auto &entityMsg =
+      (*_msg.mutable_entities())[static_cast<uint64_t>(_change.entity)];
+  entityMsg.set_id(_change.entity);
+
+  auto &compMsg = (*entityMsg.mutable_components())[
+      static_cast<int64_t>(_change.key.first)];
+  compMsg.set_type(compBase->TypeId());
+
+  std::ostringstream ostr;
+  compBase->Serialize(ostr);
+  compMsg.set_component(ostr.str());
+}
+
 //////////////////////////////////////////////////
 void EntityComponentManagerPrivate::CalculateStateThreadLoad()
 {
@@ -1140,6 +1542,51 @@ void EntityComponentManager::State(
     const std::unordered_set<ComponentTypeId> &_types,
     bool _full) const
 {
+  // Only changed components are serialized, so only the components marked
+  // in this iteration are visited
+  if (!_full)
+  {
+    auto wanted = [&](Entity _entity)
+    {
+      return (_entities.empty() ||
+          _entities.find(_entity) != _entities.end()) &&
+          this->dataPtr->entityComponents.find(_entity) !=
+          this->dataPtr->entityComponents.end();
+    };
+
+    for (const auto &entity : this->dataPtr->toRemoveEntities)
+    {
+      if (!wanted(entity))
+        continue;
+      auto &entityMsg =
+          (*_state.mutable_entities())[static_cast<uint64_t>(entity)];
+      entityMsg.set_id(entity);
+      entityMsg.set_remove(true);
+    }
+
+    for (const auto &change : this->dataPtr->changedComponents.Changes())
+    {
+      if ((_types.empty() || _types.find(change.key.first) != _types.end()) &&
+          wanted(change.entity))
+      {
+        this->dataPtr->AddChangeToMessage(_state, change);
+      }
+    }
+
+    std::unordered_set<Entity> removed;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->removedComponentsMutex);
+      for (const auto &removedComp : this->dataPtr->removedComponents)
+        removed.insert(removedComp.first);
+    }
+    for (auto entity : removed)
+    {
+      if (wanted(entity))
+        this->dataPtr->SetRemovedComponentsMsgs(entity, _state, _types);
+    }
+    return;
+  }
+
   std::mutex stateMapMutex;
   std::vector<std::thread> workers;
 
@@ -1288,94 +1735,216 @@ void EntityComponentManager::SetState(
   }
 }
 
-//////////////////////////////////////////////////
-void EntityComponentManager::SetState(
-    const ignition::msgs::SerializedStateMap &_stateMsg)
+/// \brief A component of a state message waiting to be deserialized.
+struct StateComponent
 {
-  IGN_PROFILE("EntityComponentManager::SetState Map");
-  // Create / remove / update entities
-  for (const auto &iter : _stateMsg.entities())
-  {
-    const auto &entityMsg = iter.second;
+  /// \brief Entity which has the component.
+  Entity entity;
 
-    Entity entity{entityMsg.id()};
+  /// \brief Component type.
+  ComponentTypeId type;
 
-    // Remove entity
-    if (entityMsg.remove())
+  /// \brief Serialized component.
+  const std::string *data;
+
+  /// \brief Existing component to update, null for a new component.
+  components::BaseComponent *existing;
+
+  /// \brief New component, deserialized before being added to the ECM.
+  std::unique_ptr<components::BaseComponent> created;
+};
+
+/// \brief Minimum number of components deserialized by each thread of
+/// SetState. Smaller states are deserialized on the calling thread.
+static constexpr std::size_t kSetStateComponentsPerThread{512};
+
+//////////////////////////////////////////////////
+/// \brief Deserialize a range of components.
+/// \param[in] _begin First component.
+/// \param[in] _end One past the last component.
+static void deserializeStateComponents(
+    std::vector<StateComponent>::iterator _begin,
+    std::vector<StateComponent>::iterator _end)
+{
+  for (auto it = _begin; it != _end; ++it)
+  {
+    std::istringstream istr(*it->data);
+    if (nullptr != it->existing)
     {
-      this->RequestRemoveEntity(entity);
+      it->existing->Deserialize(istr);
       continue;
     }
 
-    // Create entity if it doesn't exist
-    if (!this->HasEntity(entity))
-    {
-      this->dataPtr->CreateEntityImplementation(entity);
-    }
+    it->created = components::Factory::Instance()->New(it->type);
+    if (nullptr == it->created)
+      continue;
+    it->created->Deserialize(istr);
+  }
+}
 
-    // Create / remove / update components
-    for (const auto &compIter : iter.second.components())
+//////////////////////////////////////////////////
+void EntityComponentManager::SetState(
+    const ignition::msgs::SerializedStateMap &_stateMsg)
+{
+  IGN_PROFILE("EntityComponentManager::SetState Map");
+  // Components to be deserialized. Structure changes are made before and
+  // after deserializing, so pointers to existing components stay valid
+  // while components are deserialized in parallel.
+  std::vector<StateComponent> stateComps;
+
+  // Create / remove entities and remove components
+  {
+    IGN_PROFILE("Structure");
+    for (const auto &iter : _stateMsg.entities())
     {
-      const auto &compMsg = compIter.second;
+      const auto &entityMsg = iter.second;
 
-      uint64_t type = compMsg.type();
+      Entity entity{entityMsg.id()};
 
-      // Components which haven't been registered in this process, such as 3rd
-      // party components streamed to other secondaries and the GUI.
-      if (!components::Factory::Instance()->HasType(type))
+      // Remove entity
+      if (entityMsg.remove())
       {
-        static std::unordered_set<unsigned int> printedComps;
-        if (printedComps.find(type) == printedComps.end())
-        {
-          printedComps.insert(type);
-          ignwarn << "Component type [" << type << "] has not been "
-                  << "registered in this process, so it can't be deserialized."
-                  << std::endl;
-        }
+        this->RequestRemoveEntity(entity);
         continue;
       }
 
-      // Remove component
-      if (compMsg.remove())
+      // Create entity if it doesn't exist
+      if (!this->HasEntity(entity))
       {
-        this->RemoveComponent(entity, compIter.first);
-        continue;
+        this->dataPtr->CreateEntityImplementation(entity);
       }
 
-      // Get Component
-      components::BaseComponent *comp =
-        this->ComponentImplementation(entity, compIter.first);
-
-      // Create if new
-      if (nullptr == comp)
+      // Remove components
+      for (const auto &compIter : iter.second.components())
       {
-        // Create component
-        auto newComp = components::Factory::Instance()->New(compMsg.type());
+        const auto &compMsg = compIter.second;
+
+        uint64_t type = compMsg.type();
 
-        if (nullptr == newComp)
+        // Components which haven't been registered in this process, such as
+        // 3rd party components streamed to other secondaries and the GUI.
+        if (!components::Factory::Instance()->HasType(type))
         {
-          ignerr << "Failed to create component of type [" << compMsg.type()
-            << "]" << std::endl;
+          static std::unordered_set<unsigned int> printedComps;
+          if (printedComps.find(type) == printedComps.end())
+          {
+            printedComps.insert(type);
+            ignwarn << "Component type [" << type << "] has not been "
+                    << "registered in this process, so it can't be "
+                    << "deserialized." << std::endl;
+          }
           continue;
         }
 
-        std::istringstream istr(compMsg.component());
-        newComp->Deserialize(istr);
+        if (compMsg.remove())
+        {
+          this->RemoveComponent(entity, compIter.first);
+          continue;
+        }
 
-        this->CreateComponentImplementation(entity,
-            newComp->TypeId(), newComp.get());
+        stateComps.push_back({entity, compIter.first, &compMsg.component(),
+            nullptr, nullptr});
       }
-      // Update component value
-      else
+    }
+  }
+
+  // Group components by type, so each thread mostly deserializes a single
+  // type, and look up the components which already exist
+  std::stable_sort(stateComps.begin(), stateComps.end(),
+      [](const StateComponent &_a, const StateComponent &_b)
+      {
+        return _a.type < _b.type;
+      });
+  for (auto &stateComp : stateComps)
+  {
+    stateComp.existing =
+        this->ComponentImplementation(stateComp.entity, stateComp.type);
+  }
+
+  // Deserialize
+  {
+    IGN_PROFILE("Deserialize");
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t numThreads = std::min(maxThreads,
+        stateComps.size() / kSetStateComponentsPerThread);
+    if (numThreads <= 1)
+    {
+      deserializeStateComponents(stateComps.begin(), stateComps.end());
+    }
+    else
+    {
+      std::size_t perThread = (stateComps.size() + numThreads - 1) /
+          numThreads;
+      std::vector<std::thread> workers;
+      for (std::size_t begin = 0; begin < stateComps.size();
+          begin += perThread)
+      {
+        auto end = std::min(begin + perThread, stateComps.size());
+        workers.push_back(std::thread(deserializeStateComponents,
+            stateComps.begin() + begin, stateComps.begin() + end));
+      }
+      for (auto &worker : workers)
+        worker.join();
+    }
+  }
+
+  // Add new components and mark updated ones as changed
+  {
+    IGN_PROFILE("Commit");
+
+    // Make room for all new components of each type at once, so storage is
+    // expanded and views are rebuilt at most once
+    for (auto it = stateComps.begin(); it != stateComps.end();)
+    {
+      auto typeEnd = std::find_if(it, stateComps.end(),
+          [&](const StateComponent &_c) { return _c.type != it->type; });
+      auto newCount = static_cast<std::size_t>(std::count_if(it, typeEnd,
+          [](const StateComponent &_c) { return nullptr != _c.created; }));
+
+      if (newCount > 0 && (this->HasComponentType(it->type) ||
+          this->dataPtr->CreateComponentStorage(it->type)))
+      {
+        auto *storage = storageExtension(this->dataPtr->components[it->type]);
+        if (nullptr != storage && storage->Reserve(storage->Size() + newCount))
+          this->dataPtr->batchRebuildViews = true;
+      }
+      it = typeEnd;
+    }
+
+    this->dataPtr->batchingViews = true;
+    for (auto &stateComp : stateComps)
+    {
+      if (nullptr != stateComp.existing)
       {
-        std::istringstream istr(compMsg.component());
-        comp->Deserialize(istr);
-        this->SetChanged(entity, compIter.first,
+        this->SetChanged(stateComp.entity, stateComp.type,
             _stateMsg.has_one_time_component_changes() ?
             ComponentState::OneTimeChange :
             ComponentState::PeriodicChange);
       }
+      else if (nullptr != stateComp.created)
+      {
+        this->CreateComponentImplementation(stateComp.entity,
+            stateComp.created->TypeId(), stateComp.created.get());
+      }
+      else
+      {
+        ignerr << "Failed to create component of type [" << stateComp.type
+          << "]" << std::endl;
+      }
     }
+    this->dataPtr->batchingViews = false;
+
+    if (this->dataPtr->batchRebuildViews)
+    {
+      this->RebuildViews();
+    }
+    else
+    {
+      for (const auto &entity : this->dataPtr->batchViewEntities)
+        this->UpdateViews(entity);
+    }
+    this->dataPtr->batchRebuildViews = false;
+    this->dataPtr->batchViewEntities.clear();
   }
 }
 
@@ -1404,11 +1973,397 @@ std::unordered_set<Entity> EntityComponentManager::Descendants(Entity _entity)
   return descendants;
 }
 
+//////////////////////////////////////////////////
+math::Pose3d EntityComponentManager::WorldPose(const Entity _entity) const
+{
+  return this->dataPtr->ComputeWorldPose(*this, _entity);
+}
+
+//////////////////////////////////////////////////
+math::Pose3d EntityComponentManagerPrivate::ComputeWorldPose(
+    const EntityComponentManager &_ecm, const Entity _entity) const
+{
+  // The cache isn't modified while read-only, so hits don't need a lock
+  auto it = this->worldPoses.find(_entity);
+  if (it != this->worldPoses.end())
+    return it->second.pose;
+
+  auto pose = _ecm.Component<components::Pose>(_entity);
+  if (!pose)
+    return math::Pose3d::Zero;
+
+  // work out pose in world frame, up to the first ancestor without a pose
+  CachedWorldPose result{pose->Data(), kNullEntity};
+  auto parent = _ecm.Component<components::ParentEntity>(_entity);
+  if (parent)
+  {
+    result.parent = parent->Data();
+    if (_ecm.Component<components::Pose>(result.parent))
+      result.pose = result.pose + this->ComputeWorldPose(_ecm, result.parent);
+  }
+
+  if (this->readOnly)
+  {
+    std::lock_guard<std::mutex> lock(this->pendingWorldPosesMutex);
+    this->pendingWorldPoses.emplace_back(_entity, result);
+  }
+  else
+  {
+    this->CacheWorldPose(_entity, result);
+  }
+  return result.pose;
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::CacheWorldPose(const Entity _entity,
+    const CachedWorldPose &_pose) const
+{
+  if (!this->worldPoses.emplace(_entity, _pose).second)
+    return;
+
+  // Children are tracked even if their parent has no pose, in case it gets
+  // one later
+  if (_pose.parent != kNullEntity)
+    this->worldPoseChildren[_pose.parent].insert(_entity);
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::InvalidateWorldPose(const Entity _entity)
+{
+  if (this->indexedModels.find(_entity) != this->indexedModels.end())
+    this->dirtyModels.insert(_entity);
+
+  auto it = this->worldPoses.find(_entity);
+  if (it != this->worldPoses.end())
+  {
+    auto siblings = this->worldPoseChildren.find(it->second.parent);
+    if (siblings != this->worldPoseChildren.end())
+      siblings->second.erase(_entity);
+    this->worldPoses.erase(it);
+    this->refreshPoses.insert(_entity);
+  }
+
+  auto childrenIt = this->worldPoseChildren.find(_entity);
+  if (childrenIt == this->worldPoseChildren.end())
+    return;
+
+  auto children = std::move(childrenIt->second);
+  this->worldPoseChildren.erase(childrenIt);
+  for (const auto &child : children)
+    this->InvalidateWorldPose(child);
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::InvalidateWorldPose(const Entity _entity,
+    const ComponentTypeId _typeId)
+{
+  if (_typeId == components::Pose::typeId ||
+      _typeId == components::ParentEntity::typeId)
+  {
+    this->InvalidateWorldPose(_entity);
+  }
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManager::BeginReadOnly()
+{
+  // Compute the poses which were invalidated on this thread, instead of
+  // on the PostUpdate threads
+  {
+    IGN_PROFILE("EntityComponentManager::BeginReadOnly WorldPoses");
+    for (const auto &entity : this->dataPtr->refreshPoses)
+      this->dataPtr->ComputeWorldPose(*this, entity);
+    this->dataPtr->refreshPoses.clear();
+  }
+
+  // Update the index here, so it's only read from the PostUpdate threads
+  if (this->dataPtr->modelIndexUsed)
+    this->dataPtr->UpdateModelIndex(*this);
+
+  this->dataPtr->readOnly = true;
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManager::EndReadOnly()
+{
+  this->dataPtr->readOnly = false;
+
+  // Cache the poses computed on the PostUpdate threads. The same pose may
+  // have been computed more than once.
+  for (const auto &pending : this->dataPtr->pendingWorldPoses)
+    this->dataPtr->CacheWorldPose(pending.first, pending.second);
+  this->dataPtr->pendingWorldPoses.clear();
+}
+
+//////////////////////////////////////////////////
+const SpatialIndex &EntityComponentManager::ModelSpatialIndex() const
+{
+  IGN_PROFILE("EntityComponentManager::ModelSpatialIndex");
+  std::lock_guard<std::mutex> lock(this->dataPtr->modelIndexMutex);
+
+  // While read-only, the index was updated by BeginReadOnly, unless this is
+  // the first request, which builds it before anyone else can read it
+  if (!this->dataPtr->modelIndexUsed)
+    this->dataPtr->BuildModelIndex(*this);
+  else if (!this->dataPtr->readOnly)
+    this->dataPtr->UpdateModelIndex(*this);
+
+  return this->dataPtr->modelIndex;
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::BuildModelIndex(
+    const EntityComponentManager &_ecm) const
+{
+  IGN_PROFILE("EntityComponentManagerPrivate::BuildModelIndex");
+  _ecm.Each<components::Model>(
+      [&](const Entity &_entity, const components::Model *) -> bool
+      {
+        auto pos = _ecm.WorldPose(_entity).Pos();
+        this->modelIndex.Update(_entity, math::AxisAlignedBox(pos, pos));
+        this->indexedModels.insert(_entity);
+        return true;
+      });
+  this->dirtyModels.clear();
+  this->modelIndexUsed = true;
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::UpdateModelIndex(
+    const EntityComponentManager &_ecm) const
+{
+  IGN_PROFILE("EntityComponentManagerPrivate::UpdateModelIndex");
+
+  // Models which didn't leave their margin aren't moved in the tree
+  for (const auto &entity : this->dirtyModels)
+  {
+    if (nullptr != _ecm.Component<components::Model>(entity))
+    {
+      auto pos = _ecm.WorldPose(entity).Pos();
+      this->modelIndex.Update(entity, math::AxisAlignedBox(pos, pos));
+      this->indexedModels.insert(entity);
+    }
+    else if (this->indexedModels.erase(entity) > 0)
+    {
+      this->modelIndex.Remove(entity);
+    }
+  }
+  this->dirtyModels.clear();
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::ModelComponentChanged(
+    const Entity _entity, const ComponentTypeId _typeId)
+{
+  if (this->modelIndexUsed && _typeId == components::Model::typeId)
+    this->dirtyModels.insert(_entity);
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const EntityComponentManager>
+    EntityComponentManager::Snapshot() const
+{
+  IGN_PROFILE("EntityComponentManager::Snapshot");
+  auto snapshot = std::make_shared<EntityComponentManager>();
+  auto &data = *snapshot->dataPtr;
+
+  // Storages are copied again after components of their type were created
+  // or removed. Otherwise, the components marked as changed are copied into
+  // the previous copy, unless a snapshot still uses it. Copies used by
+  // snapshots are never modified, so they can be shared.
+  std::vector<ComponentTypeId> skippedTypes;
+  for (const auto &comp : this->dataPtr->components)
+  {
+    auto &copy = this->dataPtr->snapshotStorages[comp.first];
+    auto changesIt = this->dataPtr->snapshotChanges.find(comp.first);
+    if (nullptr != copy && changesIt != this->dataPtr->snapshotChanges.end())
+    {
+      auto copyExtension = storageExtension(copy);
+      if (copy.use_count() > 1 || nullptr == copyExtension)
+      {
+        copy.reset();
+      }
+      else
+      {
+        for (const auto &id : changesIt->second)
+        {
+          auto compData = comp.second->Component(id);
+          if (nullptr != compData)
+            copyExtension->Copy(id, *compData);
+        }
+      }
+      this->dataPtr->snapshotChanges.erase(changesIt);
+    }
+
+    if (nullptr == copy)
+    {
+      auto extension = storageExtension(comp.second);
+      if (nullptr == extension)
+      {
+        static std::unordered_set<ComponentTypeId> printedComps;
+        if (printedComps.insert(comp.first).second)
+        {
+          ignwarn << "Component type [" << comp.first << "] was registered "
+                  << "by a library built against an earlier version, so it "
+                  << "can't be copied into snapshots." << std::endl;
+        }
+        skippedTypes.push_back(comp.first);
+        continue;
+      }
+      copy = extension->Clone();
+    }
+    data.components[comp.first] = copy;
+  }
+
+  data.entities = this->dataPtr->entities;
+  data.entityComponents = this->dataPtr->entityComponents;
+  for (const auto &typeId : skippedTypes)
+  {
+    this->dataPtr->snapshotStorages.erase(typeId);
+    for (auto &entityComps : data.entityComponents)
+      entityComps.second.erase(typeId);
+  }
+  data.entityCount = this->dataPtr->entityCount;
+  data.changedComponents = this->dataPtr->changedComponents;
+  data.modifiedComponents = this->dataPtr->modifiedComponents;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->entityCreatedMutex);
+    data.newlyCreatedEntities = this->dataPtr->newlyCreatedEntities;
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->entityRemoveMutex);
+    data.toRemoveEntities = this->dataPtr->toRemoveEntities;
+    data.removeAllEntities = this->dataPtr->removeAllEntities;
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->removedComponentsMutex);
+    data.removedComponents = this->dataPtr->removedComponents;
+  }
+
+  return snapshot;
+}
+
+//////////////////////////////////////////////////
+std::unordered_map<Entity, Entity> EntityComponentManager::MergeEntities(
+    EntityComponentManager &_other)
+{
+  IGN_PROFILE("EntityComponentManager::MergeEntities");
+
+  // Ids only grow, so they give the creation order
+  std::vector<Entity> entities;
+  entities.reserve(_other.dataPtr->entities.Vertices().size());
+  for (const auto &vertex : _other.dataPtr->entities.Vertices())
+    entities.push_back(vertex.first);
+  std::sort(entities.begin(), entities.end());
+
+  std::unordered_map<Entity, Entity> newEntities;
+  newEntities.reserve(entities.size());
+  for (const auto &entity : entities)
+    newEntities[entity] = this->CreateEntity();
+
+  for (const auto &entity : entities)
+  {
+    auto parentIt = newEntities.find(_other.ParentEntity(entity));
+    if (parentIt != newEntities.end())
+      this->SetParentEntity(newEntities[entity], parentIt->second);
+  }
+
+  // Make room for all new components of each type at once, so storage is
+  // expanded and views are rebuilt at most once
+  std::unordered_map<ComponentTypeId, std::size_t> counts;
+  for (const auto &entityComps : _other.dataPtr->entityComponents)
+  {
+    for (const auto &comp : entityComps.second)
+      ++counts[comp.first];
+  }
+
+  bool rebuildViews{false};
+  for (const auto &[typeId, count] : counts)
+  {
+    if (!this->HasComponentType(typeId) &&
+        !this->dataPtr->CreateComponentStorage(typeId))
+    {
+      continue;
+    }
+
+    auto *ours = storageExtension(this->dataPtr->components[typeId]);
+    if (nullptr != ours && ours->Reserve(ours->Size() + count))
+      rebuildViews = true;
+  }
+
+  // _other is left empty, so its components can be moved
+  for (const auto &entity : entities)
+  {
+    auto compsIt = _other.dataPtr->entityComponents.find(entity);
+    if (compsIt == _other.dataPtr->entityComponents.end())
+      continue;
+
+    Entity newEntity = newEntities[entity];
+    for (const auto &[typeId, compId] : compsIt->second)
+    {
+      auto typeIt = this->dataPtr->components.find(typeId);
+      auto *data = _other.dataPtr->components[typeId]->Component(compId);
+      if (typeIt == this->dataPtr->components.end() || nullptr == data)
+        continue;
+
+      // Storages built against an earlier version can only copy
+      auto extension = storageExtension(typeIt->second);
+      auto componentIdPair = nullptr != extension ?
+          extension->Create(std::move(*data)) : typeIt->second->Create(data);
+      this->dataPtr->AddComponent(newEntity, {typeId, componentIdPair.first});
+      rebuildViews = rebuildViews || componentIdPair.second;
+    }
+
+    auto parentComp = this->Component<components::ParentEntity>(newEntity);
+    if (nullptr != parentComp)
+    {
+      auto parentIt = newEntities.find(parentComp->Data());
+      if (parentIt != newEntities.end())
+        parentComp->Data() = parentIt->second;
+    }
+  }
+
+  if (rebuildViews)
+  {
+    this->RebuildViews();
+  }
+  else
+  {
+    for (const auto &entity : newEntities)
+      this->UpdateViews(entity.second);
+  }
+
+  _other.dataPtr.reset(new EntityComponentManagerPrivate);
+
+  return newEntities;
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::InvalidateSnapshotStorage(
+    const ComponentTypeId _typeId)
+{
+  // Nothing to track until a snapshot has been taken
+  if (this->snapshotStorages.empty())
+    return;
+
+  this->snapshotStorages.erase(_typeId);
+  this->snapshotChanges.erase(_typeId);
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::SnapshotComponentChanged(
+    const ComponentKey &_key)
+{
+  if (this->snapshotStorages.find(_key.first) == this->snapshotStorages.end())
+    return;
+
+  this->snapshotChanges[_key.first].insert(_key.second);
+}
+
 //////////////////////////////////////////////////
 void EntityComponentManager::SetAllComponentsUnchanged()
 {
-  this->dataPtr->periodicChangedComponents.clear();
-  this->dataPtr->oneTimeChangedComponents.clear();
+  this->dataPtr->changedComponents.Reset();
   this->dataPtr->modifiedComponents.clear();
 }
 
@@ -1426,22 +2381,13 @@ void EntityComponentManager::SetChanged(
   if (typeIter == ecIter->second.end())
     return;
 
-  ComponentKey key{_type, typeIter->second};
+  this->dataPtr->changedComponents.Set(_entity, {_type, typeIter->second},
+      _c);
 
-  if (_c == ComponentState::PeriodicChange)
-  {
-    this->dataPtr->periodicChangedComponents.insert(key);
-    this->dataPtr->oneTimeChangedComponents.erase(key);
-  }
-  else if (_c == ComponentState::OneTimeChange)
-  {
-    this->dataPtr->periodicChangedComponents.erase(key);
-    this->dataPtr->oneTimeChangedComponents.insert(key);
-  }
-  else
+  if (_c != ComponentState::NoChange)
   {
-    this->dataPtr->periodicChangedComponents.erase(key);
-    this->dataPtr->oneTimeChangedComponents.erase(key);
+    this->dataPtr->SnapshotComponentChanged({_type, typeIter->second});
+    this->dataPtr->InvalidateWorldPose(_entity, _type);
   }
 
   this->dataPtr->AddModifiedComponent(_entity);
@@ -17,12 +17,17 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Util.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Rand.hh>
 
 #include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/config.hh"
@@ -96,6 +101,14 @@ class EntityCompMgrTest : public EntityComponentManager
   {
     this->ClearRemovedComponents();
   }
+  public: void RunBeginReadOnly()
+  {
+    this->BeginReadOnly();
+  }
+  public: void RunEndReadOnly()
+  {
+    this->EndReadOnly();
+  }
 };
 
 class EntityComponentManagerFixture : public ::testing::TestWithParam<int>
@@ -1958,6 +1971,64 @@ TEST_P(EntityComponentManagerFixture, ChangedStateComponents)
   EXPECT_EQ(1, changedStateMsg.entities_size());
 }
 
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ChangedStateMapComponents)
+{
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  auto e1c0 = manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  manager.CreateComponent<DoubleComponent>(e1, DoubleComponent(2.0));
+  auto e2c0 = manager.CreateComponent<IntComponent>(e2, IntComponent(3));
+  manager.CreateComponent<StringComponent>(e2, StringComponent("e2"));
+
+  // New entities have all their components
+  msgs::SerializedStateMap stateMsg;
+  manager.ChangedState(stateMsg);
+  ASSERT_EQ(2, stateMsg.entities_size());
+  EXPECT_EQ(2, stateMsg.entities().at(e1).components_size());
+  EXPECT_EQ(2, stateMsg.entities().at(e2).components_size());
+
+  manager.RunClearNewlyCreatedEntities();
+  manager.RunSetAllComponentsUnchanged();
+  stateMsg.Clear();
+  manager.ChangedState(stateMsg);
+  EXPECT_EQ(0, stateMsg.entities_size());
+
+  // Only changed components are serialized
+  manager.Component<IntComponent>(e1)->Data() = 10;
+  manager.SetChanged(e1, e1c0.first, ComponentState::PeriodicChange);
+  manager.SetChanged(e1, e1c0.first, ComponentState::OneTimeChange);
+  manager.SetChanged(e2, e2c0.first, ComponentState::OneTimeChange);
+  manager.SetChanged(e2, e2c0.first, ComponentState::NoChange);
+  manager.ChangedState(stateMsg);
+  ASSERT_EQ(1, stateMsg.entities_size());
+  const auto &e1Msg = stateMsg.entities().at(e1);
+  ASSERT_EQ(1, e1Msg.components_size());
+  EXPECT_EQ("10", e1Msg.components().at(e1c0.first).component());
+  EXPECT_TRUE(manager.HasOneTimeComponentChanges());
+
+  // So are removed components, but not changes to them
+  manager.RunSetAllComponentsUnchanged();
+  EXPECT_FALSE(manager.HasOneTimeComponentChanges());
+  manager.SetChanged(e2, e2c0.first, ComponentState::OneTimeChange);
+  EXPECT_TRUE(manager.RemoveComponent<IntComponent>(e2));
+  EXPECT_FALSE(manager.HasOneTimeComponentChanges());
+  stateMsg.Clear();
+  manager.ChangedState(stateMsg);
+  ASSERT_EQ(1, stateMsg.entities_size());
+  const auto &e2Msg = stateMsg.entities().at(e2);
+  ASSERT_EQ(1, e2Msg.components_size());
+  EXPECT_TRUE(e2Msg.components().at(e2c0.first).remove());
+
+  // The same applies to the state of changed components
+  stateMsg.Clear();
+  manager.State(stateMsg, {e1}, {}, false);
+  EXPECT_EQ(0, stateMsg.entities_size());
+  manager.State(stateMsg, {e2}, {}, false);
+  ASSERT_EQ(1, stateMsg.entities_size());
+  EXPECT_EQ(1, stateMsg.entities().at(e2).components_size());
+}
+
 /////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture, Descendants)
 {
@@ -2247,6 +2318,480 @@ TEST_P(EntityComponentManagerFixture, SetChanged)
       manager.ComponentState(e2, c2.first));
 }
 
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, SetChangedAcrossSteps)
+{
+  std::vector<std::pair<Entity, ComponentTypeId>> comps;
+  for (int i = 0; i < 300; ++i)
+  {
+    Entity e = manager.CreateEntity();
+    auto c = manager.CreateComponent<IntComponent>(e, IntComponent(i));
+    comps.push_back({e, c.first});
+  }
+  manager.RunSetAllComponentsUnchanged();
+
+  for (int step = 0; step < 3; ++step)
+  {
+    // Mark every other component as periodic, and the last one as one-time
+    for (std::size_t i = 0; i < comps.size(); i += 2)
+    {
+      manager.SetChanged(comps[i].first, comps[i].second,
+          ComponentState::PeriodicChange);
+    }
+    manager.SetChanged(comps.back().first, comps.back().second,
+        ComponentState::OneTimeChange);
+
+    EXPECT_TRUE(manager.HasOneTimeComponentChanges());
+    EXPECT_EQ(1u, manager.ComponentTypesWithPeriodicChanges().size());
+    for (std::size_t i = 0; i + 1 < comps.size(); ++i)
+    {
+      EXPECT_EQ(i % 2 == 0 ? ComponentState::PeriodicChange :
+          ComponentState::NoChange,
+          manager.ComponentState(comps[i].first, comps[i].second));
+    }
+    EXPECT_EQ(ComponentState::OneTimeChange,
+        manager.ComponentState(comps.back().first, comps.back().second));
+
+    // Only changed components are serialized
+    msgs::SerializedStateMap stateMsg;
+    manager.State(stateMsg);
+    EXPECT_EQ(static_cast<int>(comps.size() / 2 + 1),
+        stateMsg.entities_size());
+
+    // Unmark the one-time change
+    manager.SetChanged(comps.back().first, comps.back().second,
+        ComponentState::NoChange);
+    EXPECT_FALSE(manager.HasOneTimeComponentChanges());
+
+    manager.RunSetAllComponentsUnchanged();
+    EXPECT_FALSE(manager.HasOneTimeComponentChanges());
+    EXPECT_TRUE(manager.ComponentTypesWithPeriodicChanges().empty());
+    EXPECT_EQ(ComponentState::NoChange,
+        manager.ComponentState(comps[0].first, comps[0].second));
+  }
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, SetChangedRemovedComponents)
+{
+  Entity e = manager.CreateEntity();
+
+  // Components added and removed every step, like commands, get new ids
+  // each time. Removing them drops their states.
+  for (int step = 0; step < 1000; ++step)
+  {
+    auto c = manager.CreateComponent<IntComponent>(e, IntComponent(step));
+    EXPECT_TRUE(manager.HasOneTimeComponentChanges());
+    EXPECT_EQ(ComponentState::OneTimeChange,
+        manager.ComponentState(e, c.first));
+
+    EXPECT_TRUE(manager.RemoveComponent<IntComponent>(e));
+    EXPECT_FALSE(manager.HasOneTimeComponentChanges());
+    EXPECT_EQ(ComponentState::NoChange, manager.ComponentState(e, c.first));
+
+    manager.RunSetAllComponentsUnchanged();
+  }
+
+  // Removing an entity drops the states of its components
+  auto c = manager.CreateComponent<IntComponent>(e, IntComponent(1));
+  manager.SetChanged(e, c.first, ComponentState::PeriodicChange);
+  EXPECT_EQ(1u, manager.ComponentTypesWithPeriodicChanges().size());
+
+  manager.RequestRemoveEntity(e);
+  manager.ProcessEntityRemovals();
+  EXPECT_FALSE(manager.HasOneTimeComponentChanges());
+  EXPECT_TRUE(manager.ComponentTypesWithPeriodicChanges().empty());
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ModifiedEntities)
+{
+  // Create entities
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  auto c1 = manager.CreateComponent<IntComponent>(e1, IntComponent(123));
+  auto c2 = manager.CreateComponent<IntComponent>(e2, IntComponent(456));
+
+  // New entities aren't reported as modified
+  EXPECT_TRUE(manager.ModifiedEntities().empty());
+
+  manager.RunClearNewlyCreatedEntities();
+  manager.RunSetAllComponentsUnchanged();
+  EXPECT_TRUE(manager.ModifiedEntities().empty());
+
+  // Mark a component as changed
+  manager.SetChanged(e1, c1.first, ComponentState::PeriodicChange);
+  ASSERT_EQ(1u, manager.ModifiedEntities().size());
+  EXPECT_EQ(e1, *manager.ModifiedEntities().begin());
+
+  // Adding a component also counts as a modification
+  manager.CreateComponent<DoubleComponent>(e2, DoubleComponent(0.1));
+  EXPECT_EQ(2u, manager.ModifiedEntities().size());
+  EXPECT_EQ(ComponentState::NoChange, manager.ComponentState(e2, c2.first));
+
+  manager.RunSetAllComponentsUnchanged();
+  EXPECT_TRUE(manager.ModifiedEntities().empty());
+
+  // Entities marked for removal aren't reported as modified
+  manager.RequestRemoveEntity(e2);
+  manager.SetChanged(e2, c2.first, ComponentState::OneTimeChange);
+  EXPECT_TRUE(manager.ModifiedEntities().empty());
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, WorldPose)
+{
+  Entity parent = manager.CreateEntity();
+  Entity child = manager.CreateEntity();
+  Entity noPose = manager.CreateEntity();
+  manager.CreateComponent(parent,
+      components::Pose(math::Pose3d(1, 0, 0, 0, 0, IGN_PI_2)));
+  manager.CreateComponent(child,
+      components::Pose(math::Pose3d(1, 0, 0, 0, 0, 0)));
+  manager.CreateComponent(child, components::ParentEntity(parent));
+
+  EXPECT_EQ(math::Pose3d::Zero, manager.WorldPose(noPose));
+  EXPECT_EQ(math::Pose3d(1, 0, 0, 0, 0, IGN_PI_2), manager.WorldPose(parent));
+  EXPECT_EQ(math::Pose3d(1, 1, 0, 0, 0, IGN_PI_2), manager.WorldPose(child));
+
+  // Poses are cached until they're marked as changed, which invalidates
+  // descendants too
+  manager.Component<components::Pose>(parent)->Data() =
+      math::Pose3d(2, 0, 0, 0, 0, 0);
+  EXPECT_EQ(math::Pose3d(1, 1, 0, 0, 0, IGN_PI_2), manager.WorldPose(child));
+  manager.SetChanged(parent, components::Pose::typeId,
+      ComponentState::PeriodicChange);
+  EXPECT_EQ(math::Pose3d(2, 0, 0, 0, 0, 0), manager.WorldPose(parent));
+  EXPECT_EQ(math::Pose3d(3, 0, 0, 0, 0, 0), manager.WorldPose(child));
+
+  // Unchanged components don't invalidate the cache
+  manager.Component<components::Pose>(child)->Data() =
+      math::Pose3d(7, 0, 0, 0, 0, 0);
+  manager.SetChanged(child, components::Pose::typeId,
+      ComponentState::NoChange);
+  EXPECT_EQ(math::Pose3d(3, 0, 0, 0, 0, 0), manager.WorldPose(child));
+  manager.Component<components::Pose>(child)->Data() =
+      math::Pose3d(1, 0, 0, 0, 0, 0);
+
+  // Without a parent, the child's pose is in the world frame
+  EXPECT_TRUE(manager.RemoveComponent<components::ParentEntity>(child));
+  EXPECT_EQ(math::Pose3d(1, 0, 0, 0, 0, 0), manager.WorldPose(child));
+  manager.CreateComponent(child, components::ParentEntity(parent));
+
+  // A parent which gets a pose is taken into account
+  Entity grandChild = manager.CreateEntity();
+  manager.CreateComponent(grandChild,
+      components::Pose(math::Pose3d(0, 1, 0, 0, 0, 0)));
+  manager.CreateComponent(grandChild, components::ParentEntity(noPose));
+  EXPECT_EQ(math::Pose3d(0, 1, 0, 0, 0, 0), manager.WorldPose(grandChild));
+  manager.CreateComponent(noPose,
+      components::Pose(math::Pose3d(0, 0, 1, 0, 0, 0)));
+  EXPECT_EQ(math::Pose3d(0, 1, 1, 0, 0, 0), manager.WorldPose(grandChild));
+
+  // Poses are read from any number of threads while read-only. Invalidated
+  // poses are computed again when the ECM becomes read-only, and others are
+  // cached once it's over.
+  manager.Component<components::Pose>(parent)->Data() =
+      math::Pose3d(2, 0, 0, 0, 0, 0);
+  manager.SetChanged(parent, components::Pose::typeId,
+      ComponentState::OneTimeChange);
+  manager.RunBeginReadOnly();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    threads.push_back(std::thread([&]
+    {
+      for (int j = 0; j < 100; ++j)
+      {
+        EXPECT_EQ(math::Pose3d(3, 0, 0, 0, 0, 0), manager.WorldPose(child));
+        EXPECT_EQ(math::Pose3d(2, 0, 0, 0, 0, 0),
+            manager.WorldPose(parent));
+        EXPECT_EQ(math::Pose3d(0, 0, 1, 0, 0, 0), manager.WorldPose(noPose));
+      }
+    }));
+  }
+  for (auto &thread : threads)
+    thread.join();
+  manager.RunEndReadOnly();
+
+  manager.Component<components::Pose>(parent)->Data() =
+      math::Pose3d(4, 0, 0, 0, 0, 0);
+  manager.SetChanged(parent, components::Pose::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_EQ(math::Pose3d(5, 0, 0, 0, 0, 0), manager.WorldPose(child));
+
+  // Removing an entity invalidates the poses of its children
+  manager.RequestRemoveEntity(parent, false);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(math::Pose3d(1, 0, 0, 0, 0, 0), manager.WorldPose(child));
+
+  // So does changing their parent
+  manager.Component<components::ParentEntity>(child)->Data() = noPose;
+  manager.SetChanged(child, components::ParentEntity::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_EQ(math::Pose3d(1, 0, 1, 0, 0, 0), manager.WorldPose(child));
+
+  manager.RequestRemoveEntities();
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(math::Pose3d::Zero, manager.WorldPose(child));
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ModelSpatialIndex)
+{
+  Entity model = manager.CreateEntity();
+  manager.CreateComponent(model, components::Model());
+  manager.CreateComponent(model,
+      components::Pose(math::Pose3d(10, 0, 0, 0, 0, 0)));
+
+  Entity nested = manager.CreateEntity();
+  manager.SetParentEntity(nested, model);
+  manager.CreateComponent(nested, components::Model());
+  manager.CreateComponent(nested,
+      components::Pose(math::Pose3d(0, 5, 0, 0, 0, 0)));
+  manager.CreateComponent(nested, components::ParentEntity(model));
+
+  // Entities which aren't models aren't indexed
+  Entity link = manager.CreateEntity();
+  manager.SetParentEntity(link, model);
+  manager.CreateComponent(link, components::Pose(math::Pose3d::Zero));
+  manager.CreateComponent(link, components::ParentEntity(model));
+
+  const auto &index = manager.ModelSpatialIndex();
+  EXPECT_EQ(2u, index.Size());
+  EXPECT_FALSE(index.Contains(link));
+  EXPECT_EQ(std::vector<Entity>{model},
+      index.Query(math::Vector3d(10, 0, 0), 1.0));
+  EXPECT_EQ(std::vector<Entity>{nested},
+      index.Query(math::Vector3d(10, 5, 0), 1.0));
+
+  // Nested models follow their parent
+  manager.Component<components::Pose>(model)->Data() =
+      math::Pose3d(-10, 0, 0, 0, 0, 0);
+  manager.SetChanged(model, components::Pose::typeId,
+      ComponentState::PeriodicChange);
+  EXPECT_TRUE(manager.ModelSpatialIndex().Query(
+      math::Vector3d(10, 0, 0), 6.0).empty());
+  EXPECT_EQ(std::vector<Entity>{nested}, manager.ModelSpatialIndex().Query(
+      math::Vector3d(-10, 5, 0), 1.0));
+
+  // New models are added
+  Entity other = manager.CreateEntity();
+  manager.CreateComponent(other, components::Model());
+  manager.CreateComponent(other,
+      components::Pose(math::Pose3d(0, 0, 3, 0, 0, 0)));
+  EXPECT_EQ(std::vector<Entity>{other}, manager.ModelSpatialIndex().Query(
+      math::Vector3d::Zero, 4.0));
+
+  // Removed models are dropped
+  manager.RequestRemoveEntity(other);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(2u, manager.ModelSpatialIndex().Size());
+  EXPECT_FALSE(manager.ModelSpatialIndex().Contains(other));
+
+  EXPECT_TRUE(manager.RemoveComponent<components::Model>(nested));
+  EXPECT_EQ(1u, manager.ModelSpatialIndex().Size());
+
+  // Poses marked as changed are taken into account
+  manager.Component<components::Pose>(model)->Data() =
+      math::Pose3d(0, 0, 20, 0, 0, 0);
+  manager.SetChanged(model, components::Pose::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_EQ(std::vector<Entity>{model}, manager.ModelSpatialIndex().Query(
+      math::Vector3d(0, 0, 20), 1.0));
+
+  // While read-only, the index is updated once and then only read
+  manager.RunBeginReadOnly();
+  const auto *readOnlyIndex = &manager.ModelSpatialIndex();
+  EXPECT_EQ(readOnlyIndex, &manager.ModelSpatialIndex());
+  EXPECT_EQ(std::vector<Entity>{model},
+      readOnlyIndex->Query(math::Vector3d(0, 0, 20), 1.0));
+  manager.RunEndReadOnly();
+
+  manager.RequestRemoveEntities();
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(0u, manager.ModelSpatialIndex().Size());
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, Snapshot)
+{
+  Entity parent = manager.CreateEntity();
+  manager.CreateComponent(parent, IntComponent(1));
+  manager.CreateComponent(parent, StringComponent("parent"));
+
+  Entity child = manager.CreateEntity();
+  manager.SetParentEntity(child, parent);
+  manager.CreateComponent(child, IntComponent(2));
+
+  auto snapshot = manager.Snapshot();
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ(2u, snapshot->EntityCount());
+  EXPECT_EQ(parent, snapshot->ParentEntity(child));
+  EXPECT_EQ(1, snapshot->Component<IntComponent>(parent)->Data());
+  EXPECT_EQ(2, snapshot->Component<IntComponent>(child)->Data());
+  EXPECT_EQ("parent", snapshot->Component<StringComponent>(parent)->Data());
+  EXPECT_TRUE(snapshot->HasNewEntities());
+
+  // Changes to the ECM aren't seen by the snapshot
+  manager.Component<IntComponent>(parent)->Data() = 10;
+  manager.SetChanged(parent, IntComponent::typeId);
+  manager.RemoveComponent<StringComponent>(parent);
+  Entity other = manager.CreateEntity();
+  manager.CreateComponent(other, DoubleComponent(0.5));
+  manager.RequestRemoveEntity(child);
+  manager.ProcessEntityRemovals();
+
+  EXPECT_EQ(2u, snapshot->EntityCount());
+  EXPECT_TRUE(snapshot->HasEntity(child));
+  EXPECT_FALSE(snapshot->HasEntity(other));
+  EXPECT_EQ(1, snapshot->Component<IntComponent>(parent)->Data());
+  ASSERT_NE(nullptr, snapshot->Component<StringComponent>(parent));
+
+  int count{0};
+  snapshot->Each<IntComponent>(
+      [&](const Entity &, const IntComponent *_int) -> bool
+      {
+        count += _int->Data();
+        return true;
+      });
+  EXPECT_EQ(3, count);
+
+  // A new snapshot has the changes
+  auto newSnapshot = manager.Snapshot();
+  EXPECT_EQ(2u, newSnapshot->EntityCount());
+  EXPECT_FALSE(newSnapshot->HasEntity(child));
+  EXPECT_EQ(10, newSnapshot->Component<IntComponent>(parent)->Data());
+  EXPECT_EQ(nullptr, newSnapshot->Component<StringComponent>(parent));
+  EXPECT_DOUBLE_EQ(0.5,
+      newSnapshot->Component<DoubleComponent>(other)->Data());
+
+  // Unchanged types are shared, changed ones aren't
+  auto latest = manager.Snapshot();
+  EXPECT_EQ(newSnapshot->Component<DoubleComponent>(other),
+      latest->Component<DoubleComponent>(other));
+  EXPECT_EQ(newSnapshot->Component<IntComponent>(parent),
+      latest->Component<IntComponent>(parent));
+
+  manager.SetChanged(parent, IntComponent::typeId,
+      ComponentState::PeriodicChange);
+  auto changed = manager.Snapshot();
+  EXPECT_NE(latest->Component<IntComponent>(parent),
+      changed->Component<IntComponent>(parent));
+  EXPECT_EQ(latest->Component<DoubleComponent>(other),
+      changed->Component<DoubleComponent>(other));
+  EXPECT_EQ(ComponentState::PeriodicChange,
+      changed->ComponentState(parent, IntComponent::typeId));
+
+  // The ECM's components are never shared
+  EXPECT_NE(manager.Component<DoubleComponent>(other),
+      changed->Component<DoubleComponent>(other));
+
+  // Once no snapshot uses a copy, marked components are copied into it
+  const IntComponent *intCopy = changed->Component<IntComponent>(parent);
+  changed.reset();
+  manager.Component<IntComponent>(parent)->Data() = 20;
+  manager.SetChanged(parent, IntComponent::typeId,
+      ComponentState::OneTimeChange);
+  auto reused = manager.Snapshot();
+  EXPECT_EQ(intCopy, reused->Component<IntComponent>(parent));
+  EXPECT_EQ(20, reused->Component<IntComponent>(parent)->Data());
+  EXPECT_EQ(10, latest->Component<IntComponent>(parent)->Data());
+
+  // Components written in place without being marked aren't copied
+  manager.Component<DoubleComponent>(other)->Data() = 0.75;
+  manager.Each<IntComponent>(
+      [&](const Entity &, IntComponent *_int) -> bool
+      {
+        _int->Data() = 30;
+        return true;
+      });
+  auto afterEach = manager.Snapshot();
+  EXPECT_DOUBLE_EQ(0.5,
+      afterEach->Component<DoubleComponent>(other)->Data());
+  EXPECT_EQ(20, afterEach->Component<IntComponent>(parent)->Data());
+  EXPECT_EQ(reused->Component<IntComponent>(parent),
+      afterEach->Component<IntComponent>(parent));
+
+  // Read-only access doesn't copy again
+  const auto &constManager = manager;
+  constManager.Each<IntComponent>(
+      [&](const Entity &, const IntComponent *) -> bool
+      {
+        return true;
+      });
+  EXPECT_EQ(afterEach->Component<IntComponent>(parent),
+      manager.Snapshot()->Component<IntComponent>(parent));
+}
+
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, MergeEntities)
+{
+  Entity existing = manager.CreateEntity();
+  manager.CreateComponent(existing, IntComponent(1));
+
+  // Entities staged in another ECM
+  EntityComponentManager other;
+  Entity otherParent = other.CreateEntity();
+  other.CreateComponent(otherParent, IntComponent(2));
+  other.CreateComponent(otherParent, StringComponent("parent"));
+
+  Entity otherChild = other.CreateEntity();
+  other.SetParentEntity(otherChild, otherParent);
+  other.CreateComponent(otherChild, IntComponent(3));
+  other.CreateComponent(otherChild, components::ParentEntity(otherParent));
+
+  // Populate a view before merging
+  int sum{0};
+  manager.Each<IntComponent>(
+      [&](const Entity &, const IntComponent *_int) -> bool
+      {
+        sum += _int->Data();
+        return true;
+      });
+  EXPECT_EQ(1, sum);
+
+  auto entityMap = manager.MergeEntities(other);
+  ASSERT_EQ(2u, entityMap.size());
+  EXPECT_EQ(0u, other.EntityCount());
+  EXPECT_FALSE(other.HasComponentType(IntComponent::typeId));
+
+  // New IDs are given in the staged order
+  Entity parent = entityMap[otherParent];
+  Entity child = entityMap[otherChild];
+  EXPECT_EQ(existing + 1, parent);
+  EXPECT_EQ(existing + 2, child);
+  EXPECT_EQ(3u, manager.EntityCount());
+
+  // Components and parents are kept, with entity references remapped
+  EXPECT_EQ(2, manager.Component<IntComponent>(parent)->Data());
+  EXPECT_EQ("parent", manager.Component<StringComponent>(parent)->Data());
+  EXPECT_EQ(3, manager.Component<IntComponent>(child)->Data());
+  EXPECT_EQ(parent, manager.ParentEntity(child));
+  EXPECT_EQ(parent, manager.Component<components::ParentEntity>(child)->Data());
+  EXPECT_EQ(kNullEntity, manager.ParentEntity(parent));
+
+  // Merged entities are new and show up in views
+  EXPECT_TRUE(manager.HasNewEntities());
+  sum = 0;
+  manager.Each<IntComponent>(
+      [&](const Entity &, const IntComponent *_int) -> bool
+      {
+        sum += _int->Data();
+        return true;
+      });
+  EXPECT_EQ(6, sum);
+
+  int newCount{0};
+  manager.EachNew<IntComponent>(
+      [&](const Entity &, const IntComponent *) -> bool
+      {
+        ++newCount;
+        return true;
+      });
+  EXPECT_EQ(3, newCount);
+}
+
 //////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture, SetEntityCreateOffset)
 {
@@ -2469,6 +3014,94 @@ TEST_P(EntityComponentManagerFixture, SetRemovedComponentsMsgTypesFilter)
   }
 }
 
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, SetStateLarge)
+{
+  // Enough components to be deserialized by multiple threads
+  const int count{5000};
+  for (int i = 0; i < count; ++i)
+  {
+    Entity e = manager.CreateEntity();
+    manager.CreateComponent<IntComponent>(e, IntComponent(i));
+    manager.CreateComponent<DoubleComponent>(e, DoubleComponent(i * 0.5));
+    if (i % 2 == 0)
+      manager.CreateComponent<StringComponent>(e, StringComponent("even"));
+  }
+
+  msgs::SerializedStateMap stateMsg;
+  manager.State(stateMsg);
+
+  // Create the other ECM's view before its components exist
+  EntityCompMgrTest otherManager;
+  int viewCount{0};
+  otherManager.Each<IntComponent, StringComponent>(
+      [&](const Entity &, const IntComponent *, const StringComponent *)
+      {
+        ++viewCount;
+        return true;
+      });
+  EXPECT_EQ(0, viewCount);
+
+  otherManager.SetState(stateMsg);
+  EXPECT_EQ(static_cast<std::size_t>(count), otherManager.EntityCount());
+
+  viewCount = 0;
+  otherManager.Each<IntComponent, DoubleComponent>(
+      [&](const Entity &_entity, const IntComponent *_int,
+          const DoubleComponent *_double)
+      {
+        EXPECT_EQ(manager.Component<IntComponent>(_entity)->Data(),
+            _int->Data());
+        EXPECT_DOUBLE_EQ(_int->Data() * 0.5, _double->Data());
+        ++viewCount;
+        return true;
+      });
+  EXPECT_EQ(count, viewCount);
+
+  viewCount = 0;
+  otherManager.Each<IntComponent, StringComponent>(
+      [&](const Entity &, const IntComponent *_int,
+          const StringComponent *_string)
+      {
+        EXPECT_EQ(0, _int->Data() % 2);
+        EXPECT_EQ("even", _string->Data());
+        ++viewCount;
+        return true;
+      });
+  EXPECT_EQ(count / 2, viewCount);
+
+  // Update existing components in place
+  manager.Each<IntComponent>(
+      [&](const Entity &, IntComponent *_int)
+      {
+        _int->Data() += 1;
+        return true;
+      });
+  manager.RunSetAllComponentsUnchanged();
+  manager.Each<IntComponent>(
+      [&](const Entity &_entity, IntComponent *)
+      {
+        manager.SetChanged(_entity, IntComponent::typeId,
+            ComponentState::PeriodicChange);
+        return true;
+      });
+
+  msgs::SerializedStateMap updateMsg;
+  manager.State(updateMsg);
+  otherManager.RunSetAllComponentsUnchanged();
+  otherManager.SetState(updateMsg);
+
+  otherManager.Each<IntComponent>(
+      [&](const Entity &_entity, const IntComponent *_int)
+      {
+        EXPECT_EQ(manager.Component<IntComponent>(_entity)->Data(),
+            _int->Data());
+        EXPECT_EQ(ComponentState::PeriodicChange,
+            otherManager.ComponentState(_entity, IntComponent::typeId));
+        return true;
+      });
+}
+
 //////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture, RemovedComponentsSyncBetweenServerAndGUI)
 {
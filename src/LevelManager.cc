@@ -18,6 +18,7 @@
 #include "LevelManager.hh"
 
 #include <algorithm>
+#include <vector>
 
 #include <sdf/Actor.hh>
 #include <sdf/Atmosphere.hh>
@@ -586,6 +587,34 @@ void LevelManager::UpdateLevelsState()
   // If levels are not being used, we only process the default level.
   if (this->useLevels)
   {
+    if (!this->levelIndexBuilt)
+    {
+      IGN_PROFILE("BuildLevelIndex");
+      this->runner->entityCompMgr.Each<components::Level, components::Pose,
+        components::Geometry, components::LevelBuffer>(
+            [&](const Entity &_entity, const components::Level *,
+              const components::Pose *_pose,
+              const components::Geometry *_levelGeometry,
+              const components::LevelBuffer *_levelBuffer) -> bool
+            {
+              // assume a box for now
+              auto box = _levelGeometry->Data().BoxShape();
+              if (nullptr == box)
+              {
+                ignerr << "Level [" << _entity
+                       << "]'s geometry is not a box." << std::endl;
+                return true;
+              }
+              auto buffer = _levelBuffer->Data();
+              auto center = _pose->Data().Pos();
+              this->levelIndex.Update(_entity, math::AxisAlignedBox{
+                  center - (box->Size() / 2 + buffer),
+                  center + (box->Size() / 2 + buffer)});
+              return true;
+            });
+      this->levelIndexBuilt = true;
+    }
+
     this->runner->entityCompMgr.Each<
       components::Performer,
       components::PerformerLevels,
@@ -617,59 +646,42 @@ void LevelManager::UpdateLevelsState()
 
           std::set<Entity> newPerfLevels;
 
-          // loop through levels and check for intersections
-          // Add all levels with intersections to the levelsToLoad even if they
-          // are currently active.
-          this->runner->entityCompMgr.Each<components::Level, components::Pose,
-            components::Geometry,
-            components::LevelBuffer >(
-                [&](const Entity &_entity, const components::Level *,
-                  const components::Pose *_pose,
-                  const components::Geometry *_levelGeometry,
-                  const components::LevelBuffer *_levelBuffer) -> bool
-                {
-                IGN_PROFILE("CheckPerformerAgainstLevel");
-                // Check if the performer is in this level
-                // assume a box for now
-                auto box = _levelGeometry->Data().BoxShape();
-                if (nullptr == box)
-                {
-                ignerr << "Level [" << _entity
-                << "]'s geometry is not a box." << std::endl;
-                return true;
-                }
-                auto buffer = _levelBuffer->Data();
-                auto center = _pose->Data().Pos();
-                math::AxisAlignedBox region{center - box->Size() / 2,
-                center + box->Size() / 2};
+          // Only levels whose buffer intersects the performer need to be
+          // checked. Add all levels with intersections to the levelsToLoad
+          // even if they are currently active.
+          auto nearbyLevels = this->levelIndex.Query(performerVolume);
+          for (const auto &level : nearbyLevels)
+          {
+            IGN_PROFILE("CheckPerformerAgainstLevel");
+            // Check if the performer is in this level
+            auto box = this->runner->entityCompMgr.Component<
+                components::Geometry>(level)->Data().BoxShape();
+            auto center = this->runner->entityCompMgr.Component<
+                components::Pose>(level)->Data().Pos();
+            math::AxisAlignedBox region{center - box->Size() / 2,
+              center + box->Size() / 2};
+
+            // If the level isn't active, the performer has to be within the
+            // level to load it. Otherwise, being within the buffer keeps it.
+            if (region.Intersects(performerVolume) ||
+                this->IsLevelActive(level))
+            {
+              newPerfLevels.insert(level);
+              levelsToLoad.push_back(level);
+            }
+          }
 
-                math::AxisAlignedBox outerRegion{
-                  center - (box->Size() / 2 + buffer),
-                         center + (box->Size() / 2 + buffer)};
-
-                if (region.Intersects(performerVolume))
-                {
-                  newPerfLevels.insert(_entity);
-                  levelsToLoad.push_back(_entity);
-                }
-                else
-                {
-                  // If the level is active, check if the performer is
-                  // outside of the buffer of this level
-                  if (this->IsLevelActive(_entity))
-                  {
-                    if (outerRegion.Intersects(performerVolume))
-                    {
-                      newPerfLevels.insert(_entity);
-                      levelsToLoad.push_back(_entity);
-                      return true;
-                    }
-                    // Otherwise, mark the level to be unloaded
-                    levelsToUnload.push_back(_entity);
-                  }
-                }
-                return true;
-                });
+          // Active levels whose buffer the performer is outside of are
+          // marked to be unloaded
+          for (const auto &level : this->activeLevels)
+          {
+            if (this->levelIndex.Contains(level) &&
+                std::find(nearbyLevels.begin(), nearbyLevels.end(), level) ==
+                nearbyLevels.end())
+            {
+              levelsToUnload.push_back(level);
+            }
+          }
 
           *_perfLevels = components::PerformerLevels(newPerfLevels);
 
@@ -784,7 +796,8 @@ void LevelManager::LoadActiveEntities(const std::set<std::string> &_namesToLoad)
     return;
   }
 
-  // Models
+  // Models, created in a single batch
+  std::vector<const sdf::Model *> models;
   for (uint64_t modelIndex = 0;
        modelIndex < this->runner->sdfWorld->ModelCount(); ++modelIndex)
   {
@@ -793,11 +806,13 @@ void LevelManager::LoadActiveEntities(const std::set<std::string> &_namesToLoad)
     auto model = this->runner->sdfWorld->ModelByIndex(modelIndex);
     if (_namesToLoad.find(model->Name()) != _namesToLoad.end())
     {
-      Entity modelEntity = this->entityCreator->CreateEntities(model);
-
-      this->entityCreator->SetParent(modelEntity, this->worldEntity);
+      models.push_back(model);
     }
   }
+  for (const auto &modelEntity : this->entityCreator->CreateEntities(models))
+  {
+    this->entityCreator->SetParent(modelEntity, this->worldEntity);
+  }
 
   // Actors
   for (uint64_t actorIndex = 0;
@@ -36,6 +36,7 @@
 #include "ignition/gazebo/config.hh"
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/SdfEntityCreator.hh"
+#include "ignition/gazebo/SpatialIndex.hh"
 #include "ignition/gazebo/Types.hh"
 
 namespace ignition
@@ -148,6 +149,14 @@ namespace ignition
       /// \brief List of currently active levels
       private: std::vector<Entity> activeLevels;
 
+      /// \brief Index of the levels' regions grown by their buffers, so
+      /// each performer is only checked against the levels it's close to.
+      /// Levels don't move, so it's built once.
+      private: SpatialIndex levelIndex{0.0};
+
+      /// \brief Whether levelIndex has been built.
+      private: bool levelIndexBuilt{false};
+
       /// \brief Names of entities that are currently active (loaded).
       private: std::set<std::string> activeEntityNames;
 
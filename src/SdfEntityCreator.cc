@@ -15,6 +15,12 @@
  *
 */
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <thread>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
 #include <sdf/Types.hh>
@@ -93,11 +99,23 @@ class ignition::gazebo::SdfEntityCreatorPrivate
   /// \brief Keep track of new visuals being added, so we load their plugins
   /// only after we have their scoped name.
   public: std::map<Entity, sdf::ElementPtr> newVisuals;
+
+  /// \brief Load the plugins of the new models, sensors and visuals within
+  /// a range of entities, and stop keeping track of them. Models are loaded
+  /// first, then sensors and visuals, so they all have their scoped name.
+  /// \param[in] _begin First entity of the range.
+  /// \param[in] _end Entity after the last one of the range.
+  public: void LoadPlugins(Entity _begin = kNullEntity,
+      Entity _end = std::numeric_limits<Entity>::max());
 };
 
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Minimum number of models created by each thread when creating
+/// models in parallel. Smaller batches are created on the calling thread.
+static const std::size_t kCreateModelsPerThread{128};
+
 /////////////////////////////////////////////////
 /// \brief Resolve the pose of an SDF DOM object with respect to its relative_to
 /// frame. If that fails, return the raw pose
@@ -237,12 +255,15 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
   }
 
   // Models
+  std::vector<const sdf::Model *> models;
+  models.reserve(_world->ModelCount());
   for (uint64_t modelIndex = 0; modelIndex < _world->ModelCount();
       ++modelIndex)
   {
-    auto model = _world->ModelByIndex(modelIndex);
-    auto modelEntity = this->CreateEntities(model);
-
+    models.push_back(_world->ModelByIndex(modelIndex));
+  }
+  for (const auto &modelEntity : this->CreateEntities(models))
+  {
     this->SetParent(modelEntity, worldEntity);
   }
 
@@ -326,28 +347,109 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Model *_model)
 
   auto ent = this->CreateEntities(_model, false);
 
-  // Load all model plugins afterwards, so we get scoped name for nested models.
-  for (const auto &[entity, element] : this->dataPtr->newModels)
+  // Load all plugins afterwards, so we get scoped names.
+  this->dataPtr->LoadPlugins();
+
+  return ent;
+}
+
+//////////////////////////////////////////////////
+std::vector<Entity> SdfEntityCreator::CreateEntities(
+    const std::vector<const sdf::Model *> &_models)
+{
+  IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Model batch)");
+
+  std::vector<Entity> modelEntities;
+  modelEntities.reserve(_models.size());
+
+  std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t numThreads = std::min(maxThreads,
+      _models.size() / kCreateModelsPerThread);
+  if (numThreads <= 1)
+  {
+    for (const auto *model : _models)
+      modelEntities.push_back(this->CreateEntities(model));
+    return modelEntities;
+  }
+
+  // Each thread creates a contiguous range of models into its own ECM.
+  // Entities are only read from the SDF DOM, which isn't modified.
+  struct StagedModels
+  {
+    EntityComponentManager ecm;
+    EventManager eventManager;
+    std::vector<Entity> models;
+    std::map<Entity, sdf::ElementPtr> newModels;
+    std::map<Entity, sdf::ElementPtr> newSensors;
+    std::map<Entity, sdf::ElementPtr> newVisuals;
+  };
+
+  std::size_t perThread = (_models.size() + numThreads - 1) / numThreads;
+  std::vector<StagedModels> staged((_models.size() + perThread - 1) /
+      perThread);
   {
-    this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    IGN_PROFILE("Stage");
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < staged.size(); ++i)
+    {
+      auto begin = i * perThread;
+      auto end = std::min(begin + perThread, _models.size());
+      workers.push_back(std::thread([this, &_models, &staged, i, begin, end]
+      {
+        auto &stage = staged[i];
+        SdfEntityCreator creator(stage.ecm, stage.eventManager);
+        for (auto m = begin; m < end; ++m)
+          stage.models.push_back(creator.CreateEntities(_models[m], false));
+        stage.newModels = std::move(creator.dataPtr->newModels);
+        stage.newSensors = std::move(creator.dataPtr->newSensors);
+        stage.newVisuals = std::move(creator.dataPtr->newVisuals);
+      }));
+    }
+    for (auto &worker : workers)
+      worker.join();
   }
-  this->dataPtr->newModels.clear();
 
-  // Load sensor plugins after model, so we get scoped name.
-  for (const auto &[entity, element] : this->dataPtr->newSensors)
+  // Merge in order, so ids are the same as if models were created here
   {
-    this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    IGN_PROFILE("Merge");
+    for (auto &stage : staged)
+    {
+      auto newEntities = this->dataPtr->ecm->MergeEntities(stage.ecm);
+      for (const auto &model : stage.models)
+        modelEntities.push_back(newEntities[model]);
+
+      for (const auto &[entity, element] : stage.newModels)
+      {
+        auto modelEntity = newEntities[entity];
+        this->dataPtr->newModels[modelEntity] = element;
+
+        // The canonical link was found within the staging ECM
+        auto canonicalLinkComp =
+            this->dataPtr->ecm->Component<components::ModelCanonicalLink>(
+            modelEntity);
+        if (nullptr != canonicalLinkComp)
+        {
+          canonicalLinkComp->Data() =
+              newEntities[canonicalLinkComp->Data()];
+        }
+      }
+      for (const auto &[entity, element] : stage.newSensors)
+        this->dataPtr->newSensors[newEntities[entity]] = element;
+      for (const auto &[entity, element] : stage.newVisuals)
+        this->dataPtr->newVisuals[newEntities[entity]] = element;
+    }
   }
-  this->dataPtr->newSensors.clear();
 
-  // Load visual plugins after model, so we get scoped name.
-  for (const auto &[entity, element] : this->dataPtr->newVisuals)
+  // Each model's entities have consecutive ids, so plugins are loaded in the
+  // same order as when creating models one by one
+  for (std::size_t i = 0; i < modelEntities.size(); ++i)
   {
-    this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    auto end = i + 1 < modelEntities.size() ? modelEntities[i + 1] :
+        std::numeric_limits<Entity>::max();
+    this->dataPtr->LoadPlugins(modelEntities[i], end);
   }
-  this->dataPtr->newVisuals.clear();
 
-  return ent;
+  return modelEntities;
 }
 
 //////////////////////////////////////////////////
@@ -455,6 +557,20 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Model *_model,
   return modelEntity;
 }
 
+//////////////////////////////////////////////////
+void SdfEntityCreatorPrivate::LoadPlugins(Entity _begin, Entity _end)
+{
+  for (auto *newEntities : {&this->newModels, &this->newSensors,
+      &this->newVisuals})
+  {
+    auto begin = newEntities->lower_bound(_begin);
+    auto end = newEntities->lower_bound(_end);
+    for (auto it = begin; it != end; ++it)
+      this->eventManager->Emit<events::LoadPlugins>(it->first, it->second);
+    newEntities->erase(begin, end);
+  }
+}
+
 //////////////////////////////////////////////////
 Entity SdfEntityCreator::CreateEntities(const sdf::Actor *_actor)
 {
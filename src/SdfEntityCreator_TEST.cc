@@ -16,6 +16,10 @@
 */
 
 #include <gtest/gtest.h>
+
+#include <sstream>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <sdf/Box.hh>
 #include <sdf/Capsule.hh>
@@ -51,6 +55,7 @@
 #include "ignition/gazebo/components/Visibility.hh"
 #include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/SdfEntityCreator.hh"
 
 using namespace ignition;
@@ -1273,3 +1278,112 @@ TEST_F(SdfEntityCreatorTest, EachRemovedRecursiveRemoved)
   EXPECT_EQ(0u, removedCount<components::Collision>(ecm));
   EXPECT_EQ(0u, removedCount<components::Visual>(ecm));
 }
+
+/////////////////////////////////////////////////
+TEST_F(SdfEntityCreatorTest, CreateModelBatch)
+{
+  // Enough models to be created in parallel
+  const int modelCount{600};
+  std::ostringstream sdfStr;
+  sdfStr << "<?xml version='1.0'?><sdf version='1.7'><world name='batch'>";
+  for (int i = 0; i < modelCount; ++i)
+  {
+    sdfStr
+      << "<model name='model_" << i << "'>"
+      << "  <pose>" << i << " 0 0 0 0 0</pose>"
+      << "  <link name='link'>"
+      << "    <collision name='collision'>"
+      << "      <geometry><box><size>1 1 1</size></box></geometry>"
+      << "    </collision>"
+      << "    <visual name='visual'>"
+      << "      <geometry><box><size>1 1 1</size></box></geometry>"
+      << "    </visual>"
+      << "  </link>"
+      << "  <model name='nested'>"
+      << "    <link name='nested_link'/>"
+      << "  </model>"
+      << "</model>";
+  }
+  sdfStr << "</world></sdf>";
+
+  sdf::Root root;
+  ASSERT_TRUE(root.LoadSdfString(sdfStr.str()).empty());
+  ASSERT_EQ(1u, root.WorldCount());
+  const auto *world = root.WorldByIndex(0);
+  ASSERT_EQ(static_cast<uint64_t>(modelCount), world->ModelCount());
+
+  std::vector<const sdf::Model *> models;
+  for (uint64_t i = 0; i < world->ModelCount(); ++i)
+    models.push_back(world->ModelByIndex(i));
+
+  // Create models one at a time
+  EntityCompMgrTest serialEcm;
+  EventManager serialEvm;
+  std::vector<Entity> serialPlugins;
+  auto serialConn = serialEvm.Connect<events::LoadPlugins>(
+      [&](const Entity _entity, const sdf::ElementPtr &)
+      {
+        serialPlugins.push_back(_entity);
+      });
+  SdfEntityCreator serialCreator(serialEcm, serialEvm);
+  std::vector<Entity> serialModels;
+  for (const auto *model : models)
+    serialModels.push_back(serialCreator.CreateEntities(model));
+
+  // Create models in a batch
+  std::vector<Entity> batchPlugins;
+  auto batchConn = this->evm.Connect<events::LoadPlugins>(
+      [&](const Entity _entity, const sdf::ElementPtr &)
+      {
+        batchPlugins.push_back(_entity);
+      });
+  SdfEntityCreator creator(this->ecm, this->evm);
+  auto batchModels = creator.CreateEntities(models);
+
+  // Same entities, plugins loaded in the same order
+  EXPECT_EQ(serialModels, batchModels);
+  EXPECT_EQ(serialPlugins, batchPlugins);
+  EXPECT_EQ(serialEcm.EntityCount(), this->ecm.EntityCount());
+
+  // Same components, with the same entity references
+  unsigned int entityCount{0};
+  serialEcm.Each<components::Name>(
+    [&](const Entity &_entity, const components::Name *_name)->bool
+    {
+      ++entityCount;
+      auto name = this->ecm.Component<components::Name>(_entity);
+      EXPECT_NE(nullptr, name);
+      if (nullptr == name)
+        return true;
+
+      EXPECT_EQ(_name->Data(), name->Data());
+      EXPECT_EQ(serialEcm.ComponentTypes(_entity),
+          this->ecm.ComponentTypes(_entity));
+      EXPECT_EQ(serialEcm.ParentEntity(_entity),
+          this->ecm.ParentEntity(_entity));
+
+      auto serialParent =
+          serialEcm.Component<components::ParentEntity>(_entity);
+      auto parent = this->ecm.Component<components::ParentEntity>(_entity);
+      EXPECT_EQ(nullptr == serialParent, nullptr == parent);
+      if (nullptr != serialParent && nullptr != parent)
+      {
+        EXPECT_EQ(serialParent->Data(), parent->Data());
+      }
+
+      auto serialCanonical =
+          serialEcm.Component<components::ModelCanonicalLink>(_entity);
+      auto canonical =
+          this->ecm.Component<components::ModelCanonicalLink>(_entity);
+      EXPECT_EQ(nullptr == serialCanonical, nullptr == canonical);
+      if (nullptr != serialCanonical && nullptr != canonical)
+      {
+        EXPECT_EQ(serialCanonical->Data(), canonical->Data());
+      }
+      return true;
+    });
+  EXPECT_EQ(serialEcm.EntityCount(), entityCount);
+
+  // 2 x model + 2 x link + 1 x collision + 1 x visual per model
+  EXPECT_EQ(static_cast<size_t>(modelCount * 6), this->ecm.EntityCount());
+}
@@ -19,6 +19,8 @@
 
 #include <ctype.h>
 #include <memory>
+#include <sstream>
+#include <utility>
 #include <vector>
 
 #include <sdf/sdf.hh>
@@ -44,23 +46,6 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 {
 namespace sdf_generator
 {
-  /////////////////////////////////////////////////
-  /// \brief Copy sdf::Element from component
-  /// \param[in] _comp Component containing an sdf::Element. The component has
-  /// to be a DOM object
-  /// \param[out] _elem Output sdf::Element
-  /// \returns False if the component is nullptr
-  template <typename ComponentT>
-  static bool copySdf(ComponentT *_comp, const sdf::ElementPtr &_elem)
-  {
-    if (nullptr != _comp)
-    {
-      _elem->Copy(_comp->Data().Element());
-      return true;
-    }
-    return false;
-  }
-
   /////////////////////////////////////////////////
   /// \brief Remove version number from Fuel URI
   /// \param[in, out] _uri The URI from which the version number is removed.
@@ -244,19 +229,297 @@ namespace sdf_generator
     }
   }
 
+  /////////////////////////////////////////////////
+  /// \brief Take a snapshot of a model.
+  /// \param[in] _ecm Immutable reference to the Entity Component Manager
+  /// \param[in] _entity Model entity
+  /// \returns Snapshot if the model has an SDFormat element. Otherwise,
+  /// nullopt
+  static std::optional<ModelSnapshot> snapshotModel(
+      const EntityComponentManager &_ecm, const Entity &_entity)
+  {
+    const auto *modelSdf = _ecm.Component<components::ModelSdf>(_entity);
+    if (nullptr == modelSdf || nullptr == modelSdf->Data().Element())
+      return std::nullopt;
+
+    ModelSnapshot model;
+    model.sdf = modelSdf->Data().Element();
+    model.name = _ecm.Component<components::Name>(_entity)->Data();
+    model.scopedName = scopedName(_entity, _ecm, "::", false);
+    model.pose = _ecm.Component<components::Pose>(_entity)->Data();
+
+    const auto *pathComp =
+      _ecm.Component<components::SourceFilePath>(_entity);
+    if (nullptr != pathComp)
+      model.sourceFilePath = pathComp->Data();
+
+    return model;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Set a pose element, dropping its frame, as poses in the ECM are
+  /// relative to the parent.
+  /// \param[in] _poseElem Pose element
+  /// \param[in] _pose Pose
+  static void setPoseElement(const sdf::ElementPtr &_poseElem,
+                             const math::Pose3d &_pose)
+  {
+    // Remove all attributes of poseElem
+    sdf::ParamPtr relativeTo = _poseElem->GetAttribute("relative_to");
+    if (nullptr != relativeTo)
+    {
+      relativeTo->Reset();
+    }
+    _poseElem->Set(_pose);
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Update a sdf::Element of an inlined model from a snapshot.
+  /// \param[in, out] _elem sdf::Element to update
+  /// \param[in] _model Model snapshot
+  static void setModelElement(const sdf::ElementPtr &_elem,
+                              const ModelSnapshot &_model)
+  {
+    _elem->Copy(_model.sdf);
+
+    // Update sdf based current components. Here are the list of components to
+    // be updated:
+    // - Name
+    // - Pose
+    // This list is to be updated as other components become updateable during
+    // simulation
+    _elem->GetAttribute("name")->Set(_model.name);
+    setPoseElement(_elem->GetElement("pose"), _model.pose);
+
+    if (_elem->HasElement("link") && !_model.sourceFilePath.empty())
+    {
+      // Update relative URIs to use absolute paths. Relative URIs work fine in
+      // included models, but they have to be converted to absolute URIs when
+      // the included model is expanded.
+      relativeToAbsoluteUri(_elem, common::parentPath(_model.sourceFilePath));
+    }
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Update a sdf::Element of an included resource.
+  /// \param[in, out] _elem sdf::Element to update
+  /// \param[in] _name Name of the resource
+  /// \param[in] _pose Pose of the resource
+  /// \param[in] _uri Uri of the resource
+  static void setIncludeElement(const sdf::ElementPtr &_elem,
+                                const std::string &_name,
+                                const math::Pose3d &_pose,
+                                const std::string &_uri)
+  {
+    _elem->GetElement("uri")->Set(_uri);
+    _elem->GetElement("name")->Set(_name);
+    setPoseElement(_elem->GetElement("pose"), _pose);
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Add a top-level model to a world element, either expanded or as
+  /// an `<include>`, depending on the configuration.
+  /// \param[in, out] _worldElem World element
+  /// \param[in] _model Model snapshot
+  /// \param[in] _worldDir Directory containing the world
+  /// \param[in] _includeUriMap Map from file paths to URIs used to preserve
+  /// included Fuel models
+  /// \param[in] _config Configuration for the world generator
+  /// \returns The added element
+  static sdf::ElementPtr addTopLevelModel(const sdf::ElementPtr &_worldElem,
+      const ModelSnapshot &_model, const std::string &_worldDir,
+      const IncludeUriMap &_includeUriMap,
+      const msgs::SdfGeneratorConfig &_config)
+  {
+    auto modelDir = common::parentPath(_model.sdf->FilePath());
+
+    bool modelFromInclude = isModelFromInclude(modelDir, _worldDir);
+
+    auto uriMapIt = _includeUriMap.find(modelDir);
+
+    auto modelConfig = _config.global_entity_gen_config();
+    auto modelConfigIt =
+        _config.override_entity_gen_configs().find(_model.scopedName);
+    if (modelConfigIt != _config.override_entity_gen_configs().end())
+    {
+      mergeWithOverride(modelConfig, modelConfigIt->second);
+    }
+
+    if (modelConfig.expand_include_tags().data() || !modelFromInclude)
+    {
+      auto modelElem = _worldElem->AddElement("model");
+      setModelElement(modelElem, _model);
+
+      // Check & update possible //model/include(s)
+      if (!modelConfig.expand_include_tags().data())
+      {
+        updateModelElementWithNestedInclude(modelElem,
+              modelConfig.save_fuel_version().data(), _includeUriMap);
+      }
+      return modelElem;
+    }
+
+    if (uriMapIt != _includeUriMap.end())
+    {
+      // The fuel URI might have a version number. If it does, we remove
+      // it unless saveFuelModelVersion is set to true.
+      // Check if this is a fuel URI. We assume that it is a fuel URI if
+      // the scheme is http or https.
+      common::URI uri(uriMapIt->second);
+      if (uri.Scheme() == "http" || uri.Scheme() == "https")
+      {
+        removeVersionFromUri(uri);
+      }
+
+      if (modelConfig.save_fuel_version().data())
+      {
+        // Find out the model version from the file path. Note that we
+        // do this from the file path instead of the Fuel URI because the
+        // URI may not contain version information.
+        //
+        // We are assuming here that, for Fuel models, the directory
+        // containing the sdf file has the same name as the model version.
+        // For example, if the uri is
+        // https://example.org/1.0/test/models/Backpack
+        // the path to the directory containing the sdf file (modelDir)
+        // will be:
+        // $HOME/.ignition/fuel/example.org/test/models/Backpack/2/
+        // and the basename of the directory is "1", which is the model
+        // version.
+        //
+        // However, if symlinks (or other types of indirection) are used,
+        // the pattern of modelDir will be different. The assumption here
+        // is that regardless of the indirection, the name of the
+        // directory containing the sdf file can be used as the version
+        // number
+        //
+        uri.Path() /= common::basename(modelDir);
+      }
+
+      auto includeElem = _worldElem->AddElement("include");
+      setIncludeElement(includeElem, _model.name, _model.pose, uri.Str());
+      return includeElem;
+    }
+
+    // The model is not in the includeUriMap, but expandIncludeTags =
+    // false, so we will assume that its uri is the file path of the
+    // model on the local machine
+    auto includeElem = _worldElem->AddElement("include");
+    setIncludeElement(includeElem, _model.name, _model.pose,
+        "file://" + modelDir);
+    return includeElem;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Write the opening tag of an element, formatted like
+  /// sdf::Element::ToString does.
+  /// \param[in, out] _out Output stream
+  /// \param[in] _elem Element
+  /// \param[in] _prefix Indentation
+  static void writeOpeningTag(std::ostream &_out, const sdf::ElementPtr &_elem,
+                              const std::string &_prefix)
+  {
+    _out << _prefix << "<" << _elem->GetName();
+    for (std::size_t i = 0; i < _elem->GetAttributeCount(); ++i)
+    {
+      auto attribute = _elem->GetAttribute(i);
+      if (attribute->GetSet() || attribute->GetRequired())
+      {
+        _out << " " << attribute->GetKey() << "='"
+             << attribute->GetAsString() << "'";
+      }
+    }
+    _out << ">\n";
+  }
+
+  /////////////////////////////////////////////////
+  std::optional<WorldSnapshot> snapshotWorld(
+      const EntityComponentManager &_ecm, const Entity &_entity)
+  {
+    const auto *worldSdf = _ecm.Component<components::WorldSdf>(_entity);
+    if (nullptr == worldSdf || nullptr == worldSdf->Data().Element())
+      return std::nullopt;
+
+    WorldSnapshot snapshot;
+    snapshot.sdf = worldSdf->Data().Element();
+
+    _ecm.Each<components::Model, components::ModelSdf>(
+        [&](const Entity &_modelEntity, const components::Model *,
+            const components::ModelSdf *)
+        {
+          // skip nested models as they are not direct children of world
+          auto parentComp = _ecm.Component<components::ParentEntity>(
+              _modelEntity);
+          if (parentComp && parentComp->Data() != _entity)
+            return true;
+
+          auto model = snapshotModel(_ecm, _modelEntity);
+          if (model)
+            snapshot.models.push_back(std::move(*model));
+          return true;
+        });
+
+    return snapshot;
+  }
+
+  /////////////////////////////////////////////////
+  bool writeWorld(std::ostream &_out, const WorldSnapshot &_snapshot,
+                  const IncludeUriMap &_includeUriMap,
+                  const msgs::SdfGeneratorConfig &_config)
+  {
+    if (nullptr == _snapshot.sdf)
+      return false;
+
+    const std::string worldPrefix{"  "};
+    const std::string childPrefix{"    "};
+
+    _out << "<sdf version='" << sdf::SDF::Version() << "'>\n";
+    writeOpeningTag(_out, _snapshot.sdf, worldPrefix);
+
+    // Child entities of <world> whose names can be changed during simulation
+    // (eg. models) are written from the snapshot instead.
+    // TODO(addisu) Remove actors and lights
+    for (auto child = _snapshot.sdf->GetFirstElement(); child;
+         child = child->GetNextElement())
+    {
+      if (child->GetName() != "model")
+        _out << child->ToString(childPrefix);
+    }
+
+    // Models are generated one at a time in a scratch world, so they're
+    // created from the world's description without the world ever holding
+    // more than one of them
+    auto scratchWorld = std::make_shared<sdf::Element>();
+    sdf::initFile("world.sdf", scratchWorld);
+    auto worldDir = common::parentPath(_snapshot.sdf->FilePath());
+    for (const auto &model : _snapshot.models)
+    {
+      auto elem = addTopLevelModel(scratchWorld, model, worldDir,
+          _includeUriMap, _config);
+      _out << elem->ToString(childPrefix);
+      scratchWorld->RemoveChild(elem);
+    }
+
+    _out << worldPrefix << "</" << _snapshot.sdf->GetName() << ">\n";
+    _out << "</sdf>\n";
+    return _out.good();
+  }
+
   /////////////////////////////////////////////////
   std::optional<std::string> generateWorld(
       const EntityComponentManager &_ecm, const Entity &_entity,
       const IncludeUriMap &_includeUriMap,
       const msgs::SdfGeneratorConfig &_config)
   {
-    sdf::ElementPtr elem = std::make_shared<sdf::Element>();
-    sdf::initFile("root.sdf", elem);
-    auto worldElem = elem->AddElement("world");
-    if (!updateWorldElement(worldElem, _ecm, _entity, _includeUriMap, _config))
+    auto snapshot = snapshotWorld(_ecm, _entity);
+    if (!snapshot)
+      return std::nullopt;
+
+    std::ostringstream out;
+    if (!writeWorld(out, *snapshot, _includeUriMap, _config))
       return std::nullopt;
 
-    return elem->ToString("");
+    return out.str();
   }
 
   /////////////////////////////////////////////////
@@ -266,13 +529,11 @@ namespace sdf_generator
                           const IncludeUriMap &_includeUriMap,
                           const msgs::SdfGeneratorConfig &_config)
   {
-    const auto *worldSdf = _ecm.Component<components::WorldSdf>(_entity);
-
-    if (nullptr == worldSdf)
+    auto snapshot = snapshotWorld(_ecm, _entity);
+    if (!snapshot)
       return false;
 
-    if (!copySdf(_ecm.Component<components::WorldSdf>(_entity), _elem))
-      return false;
+    _elem->Copy(snapshot->sdf);
 
     // First remove child entities of <world> whose names can be changed during
     // simulation (eg. models). Then we add them back from the data in the
@@ -292,99 +553,11 @@ namespace sdf_generator
       _elem->RemoveChild(e);
     }
 
-    auto worldDir = common::parentPath(worldSdf->Data().Element()->FilePath());
-
-    _ecm.Each<components::Model, components::ModelSdf>(
-        [&](const Entity &_modelEntity, const components::Model *,
-            const components::ModelSdf *_modelSdf)
-        {
-          // skip nested models as they are not direct children of world
-          auto parentComp = _ecm.Component<components::ParentEntity>(
-              _modelEntity);
-          if (parentComp && parentComp->Data() != _entity)
-            return true;
-
-          auto modelDir =
-              common::parentPath(_modelSdf->Data().Element()->FilePath());
-
-          const std::string modelName =
-              scopedName(_modelEntity, _ecm, "::", false);
-
-          bool modelFromInclude = isModelFromInclude(modelDir, worldDir);
-
-          auto uriMapIt = _includeUriMap.find(modelDir);
-
-          auto modelConfig = _config.global_entity_gen_config();
-          auto modelConfigIt =
-              _config.override_entity_gen_configs().find(modelName);
-          if (modelConfigIt != _config.override_entity_gen_configs().end())
-          {
-            mergeWithOverride(modelConfig, modelConfigIt->second);
-          }
-
-          if (modelConfig.expand_include_tags().data() || !modelFromInclude)
-          {
-            auto modelElem = _elem->AddElement("model");
-            updateModelElement(modelElem, _ecm, _modelEntity);
-
-            // Check & update possible //model/include(s)
-            if (!modelConfig.expand_include_tags().data())
-            {
-              updateModelElementWithNestedInclude(modelElem,
-                    modelConfig.save_fuel_version().data(), _includeUriMap);
-            }
-          }
-          else if (uriMapIt != _includeUriMap.end())
-          {
-            // The fuel URI might have a version number. If it does, we remove
-            // it unless saveFuelModelVersion is set to true.
-            // Check if this is a fuel URI. We assume that it is a fuel URI if
-            // the scheme is http or https.
-            common::URI uri(uriMapIt->second);
-            if (uri.Scheme() == "http" || uri.Scheme() == "https")
-            {
-              removeVersionFromUri(uri);
-            }
-
-            if (modelConfig.save_fuel_version().data())
-            {
-              // Find out the model version from the file path. Note that we
-              // do this from the file path instead of the Fuel URI because the
-              // URI may not contain version information.
-              //
-              // We are assuming here that, for Fuel models, the directory
-              // containing the sdf file has the same name as the model version.
-              // For example, if the uri is
-              // https://example.org/1.0/test/models/Backpack
-              // the path to the directory containing the sdf file (modelDir)
-              // will be:
-              // $HOME/.ignition/fuel/example.org/test/models/Backpack/2/
-              // and the basename of the directory is "1", which is the model
-              // version.
-              //
-              // However, if symlinks (or other types of indirection) are used,
-              // the pattern of modelDir will be different. The assumption here
-              // is that regardless of the indirection, the name of the
-              // directory containing the sdf file can be used as the version
-              // number
-              //
-              uri.Path() /= common::basename(modelDir);
-            }
-
-            auto includeElem = _elem->AddElement("include");
-            updateIncludeElement(includeElem, _ecm, _modelEntity, uri.Str());
-          }
-          else
-          {
-            // The model is not in the includeUriMap, but expandIncludeTags =
-            // false, so we will assume that its uri is the file path of the
-            // model on the local machine
-            auto includeElem = _elem->AddElement("include");
-            const std::string uri = "file://" + modelDir;
-            updateIncludeElement(includeElem, _ecm, _modelEntity, uri);
-          }
-          return true;
-        });
+    auto worldDir = common::parentPath(snapshot->sdf->FilePath());
+    for (const auto &model : snapshot->models)
+    {
+      addTopLevelModel(_elem, model, worldDir, _includeUriMap, _config);
+    }
 
     return true;
   }
@@ -394,40 +567,11 @@ namespace sdf_generator
                           const EntityComponentManager &_ecm,
                           const Entity &_entity)
   {
-    if (!copySdf(_ecm.Component<components::ModelSdf>(_entity), _elem))
+    auto model = snapshotModel(_ecm, _entity);
+    if (!model)
       return false;
 
-    // Update sdf based current components. Here are the list of components to
-    // be updated:
-    // - Name
-    // - Pose
-    // This list is to be updated as other components become updateable during
-    // simulation
-    auto *nameComp = _ecm.Component<components::Name>(_entity);
-    _elem->GetAttribute("name")->Set(nameComp->Data());
-
-    auto *poseComp = _ecm.Component<components::Pose>(_entity);
-
-    auto poseElem = _elem->GetElement("pose");
-
-    // Remove all attributes of poseElem
-    sdf::ParamPtr relativeTo = poseElem->GetAttribute("relative_to");
-    if (nullptr != relativeTo)
-    {
-      relativeTo->Reset();
-    }
-    poseElem->Set(poseComp->Data());
-
-    const auto *pathComp =
-      _ecm.Component<components::SourceFilePath>(_entity);
-
-    if (_elem->HasElement("link") && nullptr != pathComp)
-    {
-      // Update relative URIs to use absolute paths. Relative URIs work fine in
-      // included models, but they have to be converted to absolute URIs when
-      // the included model is expanded.
-      relativeToAbsoluteUri(_elem, common::parentPath(pathComp->Data()));
-    }
+    setModelElement(_elem, *model);
     return true;
   }
 
@@ -495,22 +639,9 @@ namespace sdf_generator
                             const EntityComponentManager &_ecm,
                             const Entity &_entity, const std::string &_uri)
   {
-    _elem->GetElement("uri")->Set(_uri);
-
     auto *nameComp = _ecm.Component<components::Name>(_entity);
-    _elem->GetElement("name")->Set(nameComp->Data());
-
     auto *poseComp = _ecm.Component<components::Pose>(_entity);
-
-    auto poseElem = _elem->GetElement("pose");
-
-    // Remove all attributes of poseElem
-    sdf::ParamPtr relativeTo = poseElem->GetAttribute("relative_to");
-    if (nullptr != relativeTo)
-    {
-      relativeTo->Reset();
-    }
-    poseElem->Set(poseComp->Data());
+    setIncludeElement(_elem, nameComp->Data(), poseComp->Data(), _uri);
     return true;
   }
 }
@@ -21,8 +21,12 @@
 
 #include <sdf/Element.hh>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
 
 #include "ignition/gazebo/EntityComponentManager.hh"
 
@@ -37,6 +41,63 @@ namespace sdf_generator
 {
   using IncludeUriMap = std::unordered_map<std::string, std::string>;
 
+  /// \brief State of a top-level model needed to generate its SDFormat.
+  struct ModelSnapshot
+  {
+    /// \brief Current name.
+    std::string name;
+
+    /// \brief Scoped name, used to look up per-model configurations.
+    std::string scopedName;
+
+    /// \brief Current pose.
+    math::Pose3d pose;
+
+    /// \brief Element the model was loaded from. It's shared with the ECM,
+    /// so it must not be modified.
+    sdf::ElementPtr sdf;
+
+    /// \brief Path of the file the model was loaded from, empty if unknown.
+    std::string sourceFilePath;
+  };
+
+  /// \brief State of a world needed to generate its SDFormat. Taking a
+  /// snapshot only copies names, poses and pointers, so it's quick enough
+  /// for the simulation thread, and the snapshot can then be written from
+  /// any thread without accessing the ECM.
+  struct WorldSnapshot
+  {
+    /// \brief Element the world was loaded from. It's shared with the ECM,
+    /// so it must not be modified.
+    sdf::ElementPtr sdf;
+
+    /// \brief Top-level models.
+    std::vector<ModelSnapshot> models;
+  };
+
+  /// \brief Take a snapshot of a world for generating its SDFormat.
+  /// \input[in] _ecm Immutable reference to the Entity Component Manager
+  /// \input[in] _entity World entity
+  /// \returns Snapshot if the world has an SDFormat element. Otherwise,
+  /// nullopt
+  IGNITION_GAZEBO_VISIBLE
+  std::optional<WorldSnapshot> snapshotWorld(
+      const EntityComponentManager &_ecm, const Entity &_entity);
+
+  /// \brief Write the SDFormat representation of a world snapshot to a
+  /// stream. Models are written one at a time, so the whole world is never
+  /// held as a DOM or a string.
+  /// \input[in, out] _out Output stream, such as a file
+  /// \input[in] _snapshot World snapshot
+  /// \input[in] _includeUriMap Map from file paths to URIs used to preserve
+  /// included Fuel models
+  /// \input[in] _config Configuration for the world generator
+  /// \returns True if the stream is still good after writing.
+  IGNITION_GAZEBO_VISIBLE
+  bool writeWorld(std::ostream &_out, const WorldSnapshot &_snapshot,
+      const IncludeUriMap &_includeUriMap = IncludeUriMap(),
+      const msgs::SdfGeneratorConfig &_config = msgs::SdfGeneratorConfig());
+
   /// \brief Generate the SDFormat representation of a world
   /// \input[in] _ecm Immutable reference to the Entity Component Manager
   /// \input[in] _entity World entity
@@ -18,6 +18,8 @@
 #include <gtest/gtest.h>
 #include <tinyxml2.h>
 
+#include <sstream>
+
 #include <ignition/common/Console.hh>
 #include <ignition/fuel_tools/ClientConfig.hh>
 #include <ignition/fuel_tools/Interface.hh>
@@ -877,6 +879,47 @@ TEST_F(GenerateWorldFixture, ModelsInline)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(GenerateWorldFixture, WriteSnapshot)
+{
+  const std::string worldFile{"test/worlds/shapes.sdf"};
+  this->LoadWorld(worldFile);
+  Entity worldEntity = this->ecm.EntityByComponents(components::World());
+
+  auto snapshot = sdf_generator::snapshotWorld(this->ecm, worldEntity);
+  ASSERT_TRUE(snapshot.has_value());
+  EXPECT_FALSE(snapshot->models.empty());
+
+  // Changes made after the snapshot was taken aren't written
+  Entity modelEntity = this->ecm.EntityByComponents(
+      components::Model(), components::Name("box"));
+  auto *poseComp = this->ecm.Component<components::Pose>(modelEntity);
+  math::Pose3d origPose = poseComp->Data();
+  *poseComp = components::Pose(math::Pose3d{0.1, 0.2, 0.3, 0, 0, 0});
+
+  std::ostringstream out;
+  EXPECT_TRUE(sdf_generator::writeWorld(out, *snapshot));
+
+  sdf::Root newRoot;
+  EXPECT_TRUE(newRoot.LoadSdfString(out.str()).empty());
+  EXPECT_TRUE(isSubset(newRoot.Element(), this->root.Element()));
+  EXPECT_TRUE(isSubset(this->root.Element(), newRoot.Element()));
+
+  const auto *world = newRoot.WorldByIndex(0);
+  ASSERT_NE(nullptr, world);
+  ASSERT_TRUE(world->ModelNameExists("box"));
+  EXPECT_EQ(origPose, world->ModelByName("box")->RawPose());
+
+  // The stream's output matches the generated string
+  auto worldStr = sdf_generator::generateWorld(this->ecm, worldEntity);
+  ASSERT_TRUE(worldStr.has_value());
+  std::ostringstream newOut;
+  auto newSnapshot = sdf_generator::snapshotWorld(this->ecm, worldEntity);
+  ASSERT_TRUE(newSnapshot.has_value());
+  EXPECT_TRUE(sdf_generator::writeWorld(newOut, *newSnapshot));
+  EXPECT_EQ(*worldStr, newOut.str());
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int _argc, char **_argv)
@@ -15,6 +15,8 @@
  *
 */
 
+#include <chrono>
+#include <fstream>
 #include <numeric>
 
 #include <ignition/common/SystemPaths.hh>
@@ -97,6 +99,7 @@ Server::Server(const ServerConfig &_config)
   addResourcePaths();
 
   sdf::Errors errors;
+  auto loadStart = std::chrono::steady_clock::now();
 
   // Load a world if specified. Check SDF string first, then SDF file
   if (!_config.SdfString().empty())
@@ -184,6 +187,11 @@ Server::Server(const ServerConfig &_config)
     return;
   }
 
+  ignmsg << "Loaded SDF in ["
+         << std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - loadStart).count()
+         << "] ms." << std::endl;
+
   // Add record plugin
   if (_config.UseLogRecord())
   {
@@ -199,6 +207,18 @@ Server::Server(const ServerConfig &_config)
     this->SetUpdatePeriod(_config.UpdatePeriod().value());
   }
 
+  // Restore a checkpoint on top of the loaded world
+  if (!_config.CheckpointPath().empty() && !this->dataPtr->simRunners.empty())
+  {
+    std::ifstream checkpoint(_config.CheckpointPath(), std::ios::binary);
+    if (!checkpoint ||
+        !this->dataPtr->simRunners[0]->RestoreCheckpoint(checkpoint))
+    {
+      ignerr << "Failed to restore checkpoint [" << _config.CheckpointPath()
+             << "]." << std::endl;
+    }
+  }
+
   // Establish publishers and subscribers.
   this->dataPtr->SetupTransport();
 }
@@ -356,6 +376,40 @@ std::optional<bool> Server::AddSystem(const SystemPluginPtr &_system,
   return std::nullopt;
 }
 
+//////////////////////////////////////////////////
+std::optional<bool> Server::SaveCheckpoint(std::ostream &_out,
+                                           const unsigned int _worldIndex)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+  if (this->dataPtr->running)
+  {
+    ignerr << "Cannot save a checkpoint while the server is running.\n";
+    return false;
+  }
+
+  if (_worldIndex < this->dataPtr->simRunners.size())
+    return this->dataPtr->simRunners[_worldIndex]->SaveCheckpoint(_out);
+
+  return std::nullopt;
+}
+
+//////////////////////////////////////////////////
+std::optional<bool> Server::RestoreCheckpoint(std::istream &_in,
+                                              const unsigned int _worldIndex)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+  if (this->dataPtr->running)
+  {
+    ignerr << "Cannot restore a checkpoint while the server is running.\n";
+    return false;
+  }
+
+  if (_worldIndex < this->dataPtr->simRunners.size())
+    return this->dataPtr->simRunners[_worldIndex]->RestoreCheckpoint(_in);
+
+  return std::nullopt;
+}
+
 //////////////////////////////////////////////////
 bool Server::HasEntity(const std::string &_name,
                        const unsigned int _worldIndex) const
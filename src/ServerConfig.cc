@@ -226,6 +226,7 @@ class ignition::gazebo::ServerConfigPrivate
             logRecordPath(_cfg->logRecordPath),
             logIgnoreSdfPath(_cfg->logIgnoreSdfPath),
             logPlaybackPath(_cfg->logPlaybackPath),
+            checkpointPath(_cfg->checkpointPath),
             logRecordResources(_cfg->logRecordResources),
             logRecordCompressPath(_cfg->logRecordCompressPath),
             resourceCache(_cfg->resourceCache),
@@ -263,6 +264,9 @@ class ignition::gazebo::ServerConfigPrivate
   /// \brief Path to recorded states to play back using logging system
   public: std::string logPlaybackPath = "";
 
+  /// \brief Path to a checkpoint restored once the world is loaded
+  public: std::string checkpointPath = "";
+
   /// \brief Record meshes and material files
   public: bool logRecordResources{false};
 
@@ -489,6 +493,18 @@ void ServerConfig::SetLogRecordCompressPath(const std::string &_path)
   this->dataPtr->logRecordCompressPath = _path;
 }
 
+/////////////////////////////////////////////////
+const std::string &ServerConfig::CheckpointPath() const
+{
+  return this->dataPtr->checkpointPath;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetCheckpointPath(const std::string &_path)
+{
+  this->dataPtr->checkpointPath = _path;
+}
+
 /////////////////////////////////////////////////
 unsigned int ServerConfig::Seed() const
 {
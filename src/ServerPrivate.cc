@@ -434,17 +434,33 @@ bool ServerPrivate::ResourcePathsService(
 //////////////////////////////////////////////////
 std::string ServerPrivate::FetchResource(const std::string &_uri)
 {
+  {
+    std::lock_guard<std::mutex> lock(this->fetchedResourcesMutex);
+    auto fetchedIt = this->fetchedResources.find(_uri);
+    if (fetchedIt != this->fetchedResources.end())
+      return fetchedIt->second;
+  }
+
+  // Download without the lock, so other resources can be fetched meanwhile.
+  // A URI requested from several threads at once may be looked up more
+  // than once, fuel-tools' own cache makes the later lookups cheap.
   auto path =
       fuel_tools::fetchResourceWithClient(_uri, *this->fuelClient.get());
 
-  if (!path.empty())
+  // Failures aren't cached, so they're retried
+  if (path.empty())
+    return path;
+
+  std::lock_guard<std::mutex> lock(this->fetchedResourcesMutex);
+  auto inserted = this->fetchedResources.emplace(_uri, path);
+  if (!inserted.second)
+    return inserted.first->second;
+
+  for (auto &runner : this->simRunners)
   {
-    for (auto &runner : this->simRunners)
-    {
-      runner->AddToFuelUriMap(path, _uri);
-    }
-    fuelUriMap[path] = _uri;
+    runner->AddToFuelUriMap(path, _uri);
   }
+  fuelUriMap[path] = _uri;
   return path;
 }
 
@@ -86,7 +86,8 @@ namespace ignition
       /// this function.
       public: void SetupTransport();
 
-      /// \brief Fetch a resource from Fuel using fuel-tools.
+      /// \brief Fetch a resource from Fuel using fuel-tools. Resources
+      /// which were found are cached, so each URI is only looked up once.
       /// \param[in] _uri The resource URI to fetch.
       /// \return Path to the downloaded resource, empty on error.
       public: std::string FetchResource(const std::string &_uri);
@@ -152,6 +153,15 @@ namespace ignition
       /// Server. It is used in the SDFormat world generator when saving worlds
       public: std::unordered_map<std::string, std::string> fuelUriMap;
 
+      /// \brief Paths of the resources fetched so far, keyed by URI. Worlds
+      /// often include the same models and meshes many times.
+      private: std::unordered_map<std::string, std::string> fetchedResources;
+
+      /// \brief Protects fetchedResources and the fuel URI maps updated
+      /// with it, since resources may be fetched from several threads. It
+      /// isn't held while downloading.
+      private: std::mutex fetchedResourcesMutex;
+
       /// \brief List of names for all worlds loaded in this server.
       private: std::vector<std::string> worldNames;
 
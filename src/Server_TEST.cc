@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 #include <csignal>
+#include <cstring>
+#include <optional>
+#include <sstream>
 #include <vector>
 #include <ignition/common/StringUtils.hh>
 #include <ignition/common/Util.hh>
@@ -27,6 +30,8 @@
 #include "ignition/gazebo/components/AxisAlignedBox.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/System.hh"
@@ -701,6 +706,100 @@ TEST_P(ServerFixture, Seed)
   EXPECT_EQ(mySeed, ignition::math::Rand::Seed());
 }
 
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, Checkpoint)
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+  gazebo::Server server(serverConfig);
+
+  // Keep track of the falling box
+  test::Relay testSystem;
+  math::Pose3d boxPose;
+  testSystem.OnPostUpdate([&boxPose](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      auto box = _ecm.EntityByComponents(components::Model(),
+          components::Name("box"));
+      auto poseComp = _ecm.Component<components::Pose>(box);
+      ASSERT_NE(nullptr, poseComp);
+      boxPose = poseComp->Data();
+    });
+
+  // Systems are told about the jump back in time
+  std::optional<gazebo::UpdateInfo> resetInfo;
+  testSystem.OnReset([&resetInfo](const gazebo::UpdateInfo &_info,
+    gazebo::EntityComponentManager &)
+    {
+      resetInfo = _info;
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  server.Run(true, 100, false);
+  EXPECT_EQ(100u, *server.IterationCount());
+  auto checkpointPose = boxPose;
+  EXPECT_LT(checkpointPose.Pos().Z(), 3.0);
+
+  ignition::math::Rand::Seed(1234u);
+  std::stringstream checkpoint(std::ios::in | std::ios::out |
+      std::ios::binary);
+  auto result = server.SaveCheckpoint(checkpoint);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result.value());
+
+  server.Run(true, 100, false);
+  EXPECT_EQ(200u, *server.IterationCount());
+  auto finalPose = boxPose;
+  EXPECT_LT(finalPose.Pos().Z(), checkpointPose.Pos().Z());
+
+  // Remove an entity after the checkpoint, it should be brought back
+  auto entityCount = *server.EntityCount();
+  EXPECT_TRUE(server.RequestRemoveEntity("sphere"));
+  server.RunOnce(true);
+  EXPECT_FALSE(server.HasEntity("sphere"));
+  EXPECT_LT(*server.EntityCount(), entityCount);
+
+  ignition::math::Rand::Seed(42u);
+  result = server.RestoreCheckpoint(checkpoint);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result.value());
+  EXPECT_EQ(100u, *server.IterationCount());
+  EXPECT_EQ(1234u, ignition::math::Rand::Seed());
+  ASSERT_TRUE(resetInfo.has_value());
+  EXPECT_EQ(100ms, resetInfo->simTime);
+  EXPECT_EQ(-100ms, resetInfo->dt);
+  EXPECT_EQ(100u, resetInfo->iterations);
+  EXPECT_EQ(entityCount, *server.EntityCount());
+  EXPECT_TRUE(server.HasEntity("sphere"));
+
+  // Running again from the checkpoint gives the same result
+  server.Run(true, 100, false);
+  EXPECT_EQ(200u, *server.IterationCount());
+  EXPECT_NEAR(finalPose.Pos().Z(), boxPose.Pos().Z(), 1e-6);
+
+  // Truncated checkpoints are rejected
+  std::stringstream truncated(checkpoint.str().substr(0, 16),
+      std::ios::in | std::ios::binary);
+  result = server.RestoreCheckpoint(truncated);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_FALSE(result.value());
+  EXPECT_EQ(200u, *server.IterationCount());
+
+  // A corrupt size is rejected without allocating it. The ECM state's size
+  // follows the magic, sim time, iterations and seed.
+  std::string corruptData = checkpoint.str();
+  const uint64_t hugeSize{1ull << 62};
+  std::memcpy(&corruptData[8 + 8 + 8 + 4], &hugeSize, sizeof(hugeSize));
+  std::stringstream corrupt(corruptData, std::ios::in | std::ios::binary);
+  result = server.RestoreCheckpoint(corrupt);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_FALSE(result.value());
+  EXPECT_EQ(200u, *server.IterationCount());
+
+  EXPECT_FALSE(server.SaveCheckpoint(checkpoint, 1).has_value());
+}
+
 /////////////////////////////////////////////////
 TEST_P(ServerFixture, ResourcePath)
 {
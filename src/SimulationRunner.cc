@@ -18,17 +18,24 @@
 #include "SimulationRunner.hh"
 
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <sstream>
+#include <vector>
 
+#include <ignition/math/Rand.hh>
 #include <sdf/Root.hh>
 
 #include "ignition/common/Profiler.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Sensor.hh"
 #include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/components/Physics.hh"
 #include "ignition/gazebo/components/PhysicsCmd.hh"
+#include "ignition/gazebo/components/StepTimes.hh"
 #include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/SdfEntityCreator.hh"
 #include "ignition/gazebo/Util.hh"
@@ -41,6 +48,83 @@ using namespace gazebo;
 
 using StringSet = std::unordered_set<std::string>;
 
+/// \brief First bytes of a checkpoint, including the format version.
+static const char kCheckpointMagic[8] =
+    {'I', 'G', 'N', 'C', 'K', 'P', 'T', '1'};
+
+//////////////////////////////////////////////////
+/// \brief Write a value to a checkpoint. Checkpoints use the host's byte
+/// order, since they're meant to be restored on the same machine.
+/// \param[in, out] _out Checkpoint stream.
+/// \param[in] _value Value.
+template <typename T>
+static void writeCheckpointValue(std::ostream &_out, const T &_value)
+{
+  _out.write(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a value written with writeCheckpointValue.
+/// \param[in, out] _in Checkpoint stream.
+/// \param[out] _value Value.
+/// \return True if successful.
+template <typename T>
+static bool readCheckpointValue(std::istream &_in, T &_value)
+{
+  _in.read(reinterpret_cast<char *>(&_value), sizeof(T));
+  return _in.good();
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a size-prefixed string to a checkpoint.
+/// \param[in, out] _out Checkpoint stream.
+/// \param[in] _str String.
+static void writeCheckpointString(std::ostream &_out, const std::string &_str)
+{
+  writeCheckpointValue<uint64_t>(_out, _str.size());
+  _out.write(_str.data(), _str.size());
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a string written with writeCheckpointString.
+/// \param[in, out] _in Checkpoint stream.
+/// \param[out] _str String.
+/// \return True if successful.
+static bool readCheckpointString(std::istream &_in, std::string &_str)
+{
+  uint64_t size{0};
+  if (!readCheckpointValue(_in, size))
+    return false;
+
+  // The size isn't trusted. The string only grows as data is actually read,
+  // so a corrupt size fails at the end of the stream instead of allocating.
+  _str.clear();
+  char chunk[4096];
+  uint64_t remaining = size;
+  while (remaining > 0)
+  {
+    auto count = std::min<uint64_t>(remaining, sizeof(chunk));
+    _in.read(chunk, static_cast<std::streamsize>(count));
+    if (static_cast<uint64_t>(_in.gcount()) != count)
+      return false;
+
+    _str.append(chunk, count);
+    remaining -= count;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the update period which gives a real time factor.
+/// \param[in] _stepSize Step size.
+/// \param[in] _rtf Desired real time factor, must be positive.
+/// \return Update period.
+static std::chrono::steady_clock::duration updatePeriodForRtf(
+    const std::chrono::steady_clock::duration &_stepSize, double _rtf)
+{
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      _stepSize / _rtf);
+}
 
 //////////////////////////////////////////////////
 SimulationRunner::SimulationRunner(const sdf::World *_world,
@@ -78,7 +162,17 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
       dur);
 
   // Desired real time factor
-  this->desiredRtf = physics->RealTimeFactor();
+  if (physics->RealTimeFactor() > 0.0)
+  {
+    this->desiredRtf = physics->RealTimeFactor();
+  }
+  else
+  {
+    ignwarn << "Ignoring non-positive real time factor ["
+            << physics->RealTimeFactor() << "], using ["
+            << this->desiredRtf << "]. Set a zero update period to run as "
+            << "fast as possible." << std::endl;
+  }
 
   // The instantaneous real time factor is given as:
   //
@@ -103,8 +197,7 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
   // So to get a given RTF, our desired period is:
   //
   // period = step_size / RTF
-  this->updatePeriod = std::chrono::nanoseconds(
-      static_cast<int>(this->stepSize.count() / this->desiredRtf));
+  this->updatePeriod = updatePeriodForRtf(this->stepSize, this->desiredRtf);
 
   this->pauseConn = this->eventMgr.Connect<events::Pause>(
       std::bind(&SimulationRunner::SetPaused, this, std::placeholders::_1));
@@ -116,9 +209,19 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
       std::bind(&SimulationRunner::LoadPlugins, this, std::placeholders::_1,
       std::placeholders::_2));
 
+  // Entities are created by the level manager
+  auto creationStart = std::chrono::steady_clock::now();
+
   // Create the level manager
   this->levelMgr = std::make_unique<LevelManager>(this, _config.UseLevels());
 
+  // Parts of the step which are timed. Systems add their own parts.
+  this->stepSection = this->stepStats.AddSection("Step");
+  this->levelsSection = this->stepStats.AddSection("LevelManager");
+  this->messagesSection = this->stepStats.AddSection("ProcessMessages");
+  this->removalSection = this->stepStats.AddSection("EntityRemoval");
+  this->stepStatsStart = StepStatistics::Clock::now();
+
   // Check if this is going to be a distributed runner
   // Attempt to create the manager based on environment variables.
   // If the configuration is invalid, then networkMgr will be `nullptr`.
@@ -158,6 +261,7 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
 
   // Load the active levels
   this->levelMgr->UpdateLevelsState();
+  auto creationTime = std::chrono::steady_clock::now() - creationStart;
 
   // Load any additional plugins from the Server Configuration
   this->LoadServerPlugins(this->serverConfig.Plugins());
@@ -173,6 +277,8 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
   }
 
   this->LoadLoggingPlugins(this->serverConfig);
+  this->loadingWorld = false;
+  this->LogLoadTimes(creationTime);
 
   // World control
   transport::NodeOptions opts;
@@ -244,6 +350,7 @@ void SimulationRunner::UpdateCurrentInfo()
     this->realTimes.clear();
     this->simTimes.clear();
     this->realTimeFactor = 0;
+    this->realTimeFactorVariance = 0;
 
     this->currentInfo.dt = -this->currentInfo.simTime;
     this->currentInfo.simTime = std::chrono::steady_clock::duration::zero();
@@ -267,6 +374,7 @@ void SimulationRunner::UpdateCurrentInfo()
     this->realTimes.clear();
     this->simTimes.clear();
     this->realTimeFactor = 0;
+    this->realTimeFactorVariance = 0;
 
     this->currentInfo.dt = this->requestedSeek - this->currentInfo.simTime;
     this->currentInfo.simTime = this->requestedSeek;
@@ -317,6 +425,42 @@ void SimulationRunner::UpdateCurrentInfo()
           static_cast<double>(simAvg.count()) / realAvg.count(), 4);
   }
 
+  // Variance of the RTF between consecutive samples, which shows how
+  // steadily simulation is paced
+  std::vector<double> sampleRtfs;
+  sampleRtfs.reserve(this->realTimes.size());
+  simIter = this->simTimes.begin();
+  realIter = this->realTimes.begin();
+  while (simIter != this->simTimes.end() && realIter != this->realTimes.end())
+  {
+    auto nextSim = std::next(simIter);
+    auto nextReal = std::next(realIter);
+    if (nextSim == this->simTimes.end() || nextReal == this->realTimes.end())
+      break;
+
+    auto realDelta = *nextReal - *realIter;
+    if (realDelta.count() > 0)
+    {
+      sampleRtfs.push_back(
+          static_cast<double>((*nextSim - *simIter).count()) /
+          realDelta.count());
+    }
+    simIter = nextSim;
+    realIter = nextReal;
+  }
+  this->realTimeFactorVariance = 0.0;
+  if (sampleRtfs.size() > 1)
+  {
+    double mean{0.0};
+    for (auto rtf : sampleRtfs)
+      mean += rtf;
+    mean /= sampleRtfs.size();
+
+    for (auto rtf : sampleRtfs)
+      this->realTimeFactorVariance += (rtf - mean) * (rtf - mean);
+    this->realTimeFactorVariance /= sampleRtfs.size() - 1;
+  }
+
   // Fill the current update info
   this->currentInfo.realTime = this->realTimeWatch.ElapsedRunTime();
   this->currentInfo.dt = std::chrono::steady_clock::duration::zero();
@@ -365,11 +509,15 @@ void SimulationRunner::UpdatePhysicsParams()
       physicsComp->Data().SetMaxStepSize(physicsParams.max_step_size());
       updated = true;
     }
+    // Zero is an unset field, it doesn't change the real time factor
     if (newRTF > 0.0)
     {
       this->desiredRtf = newRTF;
-      this->updatePeriod = std::chrono::nanoseconds(
-          static_cast<int>(this->stepSize.count() / this->desiredRtf));
+      if (!this->asFastAsPossible)
+      {
+        this->updatePeriod = updatePeriodForRtf(this->stepSize,
+            this->desiredRtf);
+      }
       physicsComp->Data().SetRealTimeFactor(newRTF);
       updated = true;
     }
@@ -410,6 +558,20 @@ void SimulationRunner::PublishStats()
 
   msg.set_paused(this->currentInfo.paused);
 
+  // The header is stamped with this step's time. Its data holds the time
+  // spent in each part of the step during the last window.
+  msg.mutable_header()->mutable_stamp()->set_sec(simTimeSecNsec.first);
+  msg.mutable_header()->mutable_stamp()->set_nsec(simTimeSecNsec.second);
+  msg.mutable_header()->mutable_data()->CopyFrom(this->stepStatsMsg.data());
+
+  // Add how steadily simulation is paced
+  auto rtfData = msg.mutable_header()->add_data();
+  rtfData->set_key("RealTimeFactor");
+  rtfData->add_value("variance=" +
+      std::to_string(this->realTimeFactorVariance));
+  rtfData->add_value("dropped_steps=" +
+      std::to_string(this->stepPacer.DroppedSteps()));
+
   // Publish the stats message. The stats message is throttled.
   this->statsPub.Publish(msg);
 
@@ -446,15 +608,28 @@ void SimulationRunner::AddSystemToRunner(const SystemPluginPtr &_system)
   this->systems.push_back(SystemInternal(_system));
 
   const auto &system = this->systems.back();
+  const std::string name = _system->GetName();
 
   if (system.preupdate)
+  {
     this->systemsPreupdate.push_back(system.preupdate);
+    this->preupdateSections.push_back(
+        this->stepStats.AddSection("PreUpdate/" + name));
+  }
 
   if (system.update)
+  {
     this->systemsUpdate.push_back(system.update);
+    this->updateSections.push_back(
+        this->stepStats.AddSection("Update/" + name));
+  }
 
   if (system.postupdate)
+  {
     this->systemsPostupdate.push_back(system.postupdate);
+    this->postupdateSections.push_back(
+        this->stepStats.AddSection("PostUpdate/" + name));
+  }
 }
 
 /////////////////////////////////////////////////
@@ -494,7 +669,8 @@ void SimulationRunner::ProcessSystemQueue()
     {
       igndbg << "Creating postupdate worker thread (" << id << ")" << std::endl;
 
-      this->postUpdateThreads.push_back(std::thread([&, id]()
+      const std::size_t section = this->postupdateSections[id];
+      this->postUpdateThreads.push_back(std::thread([&, id, section]()
       {
         std::stringstream ss;
         ss << "PostUpdateThread: " << id;
@@ -504,7 +680,12 @@ void SimulationRunner::ProcessSystemQueue()
           this->postUpdateStartBarrier->Wait();
           if (this->postUpdateThreadsRunning)
           {
+            // Each thread records its own section. They're read after the
+            // stop barrier.
+            auto start = StepStatistics::Clock::now();
             system->PostUpdate(this->currentInfo, this->entityCompMgr);
+            this->stepStats.Record(section,
+                StepStatistics::Clock::now() - start);
           }
           this->postUpdateStopBarrier->Wait();
         }
@@ -528,14 +709,25 @@ void SimulationRunner::UpdateSystems()
 
   {
     IGN_PROFILE("PreUpdate");
-    for (auto& system : this->systemsPreupdate)
-      system->PreUpdate(this->currentInfo, this->entityCompMgr);
+    for (std::size_t i = 0; i < this->systemsPreupdate.size(); ++i)
+    {
+      auto start = StepStatistics::Clock::now();
+      this->systemsPreupdate[i]->PreUpdate(this->currentInfo,
+          this->entityCompMgr);
+      this->stepStats.Record(this->preupdateSections[i],
+          StepStatistics::Clock::now() - start);
+    }
   }
 
   {
     IGN_PROFILE("Update");
-    for (auto& system : this->systemsUpdate)
-      system->Update(this->currentInfo, this->entityCompMgr);
+    for (std::size_t i = 0; i < this->systemsUpdate.size(); ++i)
+    {
+      auto start = StepStatistics::Clock::now();
+      this->systemsUpdate[i]->Update(this->currentInfo, this->entityCompMgr);
+      this->stepStats.Record(this->updateSections[i],
+          StepStatistics::Clock::now() - start);
+    }
   }
 
   {
@@ -544,8 +736,11 @@ void SimulationRunner::UpdateSystems()
     // the barriers will be uninitialized, so guard against that condition.
     if (this->postUpdateStartBarrier && this->postUpdateStopBarrier)
     {
+      // The ECM isn't modified until all PostUpdate threads are done
+      this->entityCompMgr.BeginReadOnly();
       this->postUpdateStartBarrier->Wait();
       this->postUpdateStopBarrier->Wait();
+      this->entityCompMgr.EndReadOnly();
     }
   }
 }
@@ -616,11 +811,6 @@ bool SimulationRunner::Run(const uint64_t _iterations)
   if (!this->currentInfo.paused)
     this->realTimeWatch.Start();
 
-  // Variables for time keeping.
-  std::chrono::steady_clock::time_point startTime;
-  std::chrono::steady_clock::duration sleepTime;
-  std::chrono::steady_clock::duration actualSleep;
-
   this->running = true;
 
   // Create the world statistics publisher.
@@ -660,6 +850,13 @@ bool SimulationRunner::Run(const uint64_t _iterations)
     }
   }
 
+  // Create the step times publisher.
+  if (!this->stepStatsPub.Valid())
+  {
+    this->stepStatsPub =
+        this->node->Advertise<ignition::msgs::Header>("performance");
+  }
+
   // Create the clock publisher.
   if (!this->clockPub.Valid())
     this->clockPub = this->node->Advertise<ignition::msgs::Clock>("clock");
@@ -693,6 +890,9 @@ bool SimulationRunner::Run(const uint64_t _iterations)
     }
   }
 
+  // Don't catch up the time spent outside of Run
+  this->stepPacer.Reset();
+
   // Keep number of iterations requested by caller
   uint64_t processedIterations{0};
 
@@ -706,31 +906,10 @@ bool SimulationRunner::Run(const uint64_t _iterations)
     // Update the step size and desired rtf
     this->UpdatePhysicsParams();
 
-    // Compute the time to sleep in order to match, as closely as possible,
-    // the update period.
-    sleepTime = 0ns;
-    actualSleep = 0ns;
-
-    sleepTime = std::max(0ns, this->prevUpdateRealTime +
-        this->updatePeriod - std::chrono::steady_clock::now() -
-        this->sleepOffset);
-
-    // Only sleep if needed.
-    if (sleepTime > 0ns)
-    {
-      IGN_PROFILE("Sleep");
-      // Get the current time, sleep for the duration needed to match the
-      // updatePeriod, and then record the actual time slept.
-      startTime = std::chrono::steady_clock::now();
-      std::this_thread::sleep_for(sleepTime);
-      actualSleep = std::chrono::steady_clock::now() - startTime;
-    }
-
-    // Exponentially average out the difference between expected sleep time
-    // and actual sleep time.
-    this->sleepOffset =
-      std::chrono::duration_cast<std::chrono::nanoseconds>(
-          (actualSleep - sleepTime) * 0.01 + this->sleepOffset * 0.99);
+    // Wait until the next update is due. Updates follow a fixed schedule,
+    // so a few late updates are caught up to keep the real time factor,
+    // and the rest are dropped.
+    this->stepPacer.Wait(this->updatePeriod);
 
     // Update time information. This will update the iteration count, RTF,
     // and other values.
@@ -763,6 +942,13 @@ bool SimulationRunner::Run(const uint64_t _iterations)
 
   this->running = false;
 
+  // Requests which came in after the last iteration won't be processed by
+  // ProcessMessages anymore
+  {
+    std::lock_guard<std::mutex> lock(this->msgBufferMutex);
+    this->ProcessWorldSnapshotRequests();
+  }
+
   return true;
 }
 
@@ -770,15 +956,16 @@ bool SimulationRunner::Run(const uint64_t _iterations)
 void SimulationRunner::Step(const UpdateInfo &_info)
 {
   IGN_PROFILE("SimulationRunner::Step");
+  auto stepStart = StepStatistics::Clock::now();
   this->currentInfo = _info;
 
   // Publish info
   this->PublishStats();
 
-  // Record when the update step starts.
-  this->prevUpdateRealTime = std::chrono::steady_clock::now();
-
+  auto levelsStart = StepStatistics::Clock::now();
   this->levelMgr->UpdateLevelsState();
+  this->stepStats.Record(this->levelsSection,
+      StepStatistics::Clock::now() - levelsStart);
 
   // Handle pending systems
   this->ProcessSystemQueue();
@@ -808,20 +995,74 @@ void SimulationRunner::Step(const UpdateInfo &_info)
   }
 
   // Process world control messages.
+  auto messagesStart = StepStatistics::Clock::now();
   this->ProcessMessages();
+  this->stepStats.Record(this->messagesSection,
+      StepStatistics::Clock::now() - messagesStart);
 
   // Clear all new entities
   this->entityCompMgr.ClearNewlyCreatedEntities();
 
   // Process entity removals.
+  auto removalStart = StepStatistics::Clock::now();
   this->entityCompMgr.ProcessRemoveEntityRequests();
 
   // Process components removals
   this->entityCompMgr.ClearRemovedComponents();
+  this->stepStats.Record(this->removalSection,
+      StepStatistics::Clock::now() - removalStart);
 
   // Each network manager takes care of marking its components as unchanged
   if (!this->networkMgr)
     this->entityCompMgr.SetAllComponentsUnchanged();
+
+  this->stepStats.Record(this->stepSection,
+      StepStatistics::Clock::now() - stepStart);
+
+  // After components were marked as unchanged, so the change is seen on the
+  // next step
+  this->PublishStepTimes();
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::PublishStepTimes()
+{
+  auto now = StepStatistics::Clock::now();
+  if (now - this->stepStatsStart < 1s)
+    return;
+  this->stepStatsStart = now;
+
+  IGN_PROFILE("SimulationRunner::PublishStepTimes");
+
+  this->stepStatsMsg.Clear();
+  auto simTimeSecNsec =
+    ignition::math::durationToSecNsec(this->currentInfo.simTime);
+  this->stepStatsMsg.mutable_stamp()->set_sec(simTimeSecNsec.first);
+  this->stepStatsMsg.mutable_stamp()->set_nsec(simTimeSecNsec.second);
+  this->stepStats.FillMsg(this->stepStatsMsg);
+  this->stepStats.Reset();
+
+  if (this->stepStatsPub.Valid())
+    this->stepStatsPub.Publish(this->stepStatsMsg);
+
+  auto worldEntity =
+    this->entityCompMgr.EntityByComponents(components::World());
+  if (kNullEntity == worldEntity)
+    return;
+
+  auto *stepTimesComp =
+    this->entityCompMgr.Component<components::StepTimes>(worldEntity);
+  if (nullptr == stepTimesComp)
+  {
+    this->entityCompMgr.CreateComponent(worldEntity,
+        components::StepTimes(this->stepStatsMsg));
+  }
+  else
+  {
+    stepTimesComp->Data() = this->stepStatsMsg;
+    this->entityCompMgr.SetChanged(worldEntity,
+        components::StepTimes::typeId, ComponentState::PeriodicChange);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -842,9 +1083,15 @@ void SimulationRunner::LoadPlugin(const Entity _entity,
     auto systemConfig = system.value()->QueryInterface<ISystemConfigure>();
     if (systemConfig != nullptr)
     {
+      auto configureStart = std::chrono::steady_clock::now();
       systemConfig->Configure(_entity, _sdf,
           this->entityCompMgr,
           this->eventMgr);
+      if (this->loadingWorld)
+      {
+        this->loadConfigureTimes.emplace_back(_name,
+            std::chrono::steady_clock::now() - configureStart);
+      }
     }
 
     this->AddSystem(system.value());
@@ -853,6 +1100,39 @@ void SimulationRunner::LoadPlugin(const Entity _entity,
   }
 }
 
+//////////////////////////////////////////////////
+void SimulationRunner::LogLoadTimes(
+    const std::chrono::steady_clock::duration &_creationTime) const
+{
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+
+  // Systems loaded while creating entities were configured meanwhile
+  std::chrono::steady_clock::duration configureTime{0};
+  for (const auto &system : this->loadConfigureTimes)
+    configureTime += system.second;
+  auto creationTime = std::max(_creationTime - configureTime,
+      std::chrono::steady_clock::duration::zero());
+
+  ignmsg << "Loaded world [" << this->worldName << "]: created ["
+         << this->entityCompMgr.EntityCount() << "] entities in ["
+         << Milliseconds(creationTime).count() << "] ms, configured ["
+         << this->loadConfigureTimes.size() << "] systems in ["
+         << Milliseconds(configureTime).count() << "] ms." << std::endl;
+
+  // Slowest first
+  auto systems = this->loadConfigureTimes;
+  std::stable_sort(systems.begin(), systems.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.second > _b.second;
+      });
+  for (const auto &[name, time] : systems)
+  {
+    igndbg << "Configured system [" << name << "] in ["
+           << Milliseconds(time).count() << "] ms." << std::endl;
+  }
+}
+
 //////////////////////////////////////////////////
 void SimulationRunner::LoadServerPlugins(
     const std::list<ServerConfig::PluginInfo> &_plugins)
@@ -1030,6 +1310,8 @@ void SimulationRunner::SetUpdatePeriod(
     const std::chrono::steady_clock::duration &_updatePeriod)
 {
   this->updatePeriod = _updatePeriod;
+  this->asFastAsPossible =
+      _updatePeriod <= std::chrono::steady_clock::duration::zero();
 }
 
 /////////////////////////////////////////////////
@@ -1143,6 +1425,23 @@ void SimulationRunner::ProcessMessages()
   IGN_PROFILE("SimulationRunner::ProcessMessages");
   std::lock_guard<std::mutex> lock(this->msgBufferMutex);
   this->ProcessWorldControl();
+  this->ProcessWorldSnapshotRequests();
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::ProcessWorldSnapshotRequests()
+{
+  if (this->worldSnapshotRequests.empty())
+    return;
+
+  IGN_PROFILE("SimulationRunner::ProcessWorldSnapshotRequests");
+  Entity world = this->entityCompMgr.EntityByComponents(components::World());
+  auto snapshot = sdf_generator::snapshotWorld(this->entityCompMgr, world);
+  for (auto &request : this->worldSnapshotRequests)
+  {
+    request.set_value(snapshot);
+  }
+  this->worldSnapshotRequests.clear();
 }
 
 /////////////////////////////////////////////////
@@ -1304,17 +1603,244 @@ bool SimulationRunner::GuiInfoService(ignition::msgs::GUI &_res)
 bool SimulationRunner::GenerateWorldSdf(const msgs::SdfGeneratorConfig &_req,
                                         msgs::StringMsg &_res)
 {
-  // TODO(addisu) This is not thread-safe. Wait until it is safe to access the
-  // ECM.
-  Entity world = this->entityCompMgr.EntityByComponents(components::World());
-  std::optional<std::string> genString = sdf_generator::generateWorld(
-      this->entityCompMgr, world, this->fuelUriMap, _req);
-  if (genString.has_value())
+  // The ECM can only be accessed between iterations, so while simulation is
+  // running, the simulation thread takes a snapshot of the world. Taking it
+  // only copies names, poses and pointers to the immutable SDFormat
+  // elements, and the SDFormat is then written on this thread, so simulation
+  // isn't stalled while large worlds are saved.
+  std::optional<sdf_generator::WorldSnapshot> snapshot;
+  std::future<std::optional<sdf_generator::WorldSnapshot>> future;
   {
-    _res.set_data(*genString);
-    return true;
+    std::lock_guard<std::mutex> lock(this->msgBufferMutex);
+    if (this->running)
+    {
+      this->worldSnapshotRequests.emplace_back();
+      future = this->worldSnapshotRequests.back().get_future();
+    }
+    else
+    {
+      Entity world =
+          this->entityCompMgr.EntityByComponents(components::World());
+      snapshot = sdf_generator::snapshotWorld(this->entityCompMgr, world);
+    }
   }
-  return false;
+
+  if (future.valid())
+  {
+    if (future.wait_for(std::chrono::seconds(5)) !=
+        std::future_status::ready)
+    {
+      ignerr << "Timed out waiting for a snapshot of the world to generate "
+             << "its SDFormat." << std::endl;
+      return false;
+    }
+    snapshot = future.get();
+  }
+
+  if (!snapshot.has_value())
+    return false;
+
+  std::ostringstream out;
+  if (!sdf_generator::writeWorld(out, *snapshot, this->fuelUriMap, _req))
+    return false;
+
+  _res.set_data(out.str());
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SimulationRunner::SaveCheckpoint(std::ostream &_out)
+{
+  IGN_PROFILE("SimulationRunner::SaveCheckpoint");
+
+  // Systems are only added to the runner on the next step
+  this->ProcessSystemQueue();
+
+  msgs::SerializedStateMap state;
+  this->entityCompMgr.State(state, {}, {}, true);
+  std::string stateData;
+  if (!state.SerializeToString(&stateData))
+  {
+    ignerr << "Failed to serialize the state of the ECM." << std::endl;
+    return false;
+  }
+
+  _out.write(kCheckpointMagic, sizeof(kCheckpointMagic));
+  writeCheckpointValue<int64_t>(_out, this->currentInfo.simTime.count());
+  writeCheckpointValue<uint64_t>(_out, this->currentInfo.iterations);
+  writeCheckpointValue<uint32_t>(_out, math::Rand::Seed());
+  writeCheckpointString(_out, stateData);
+
+  uint64_t systemCount{0};
+  for (const auto &system : this->systems)
+  {
+    if (system.checkpoint)
+      ++systemCount;
+  }
+  writeCheckpointValue(_out, systemCount);
+
+  for (auto &system : this->systems)
+  {
+    if (!system.checkpoint)
+      continue;
+
+    std::ostringstream systemOut(std::ios::binary);
+    system.checkpoint->SaveCheckpoint(this->entityCompMgr, systemOut);
+    writeCheckpointString(_out, system.systemPlugin->GetName());
+    writeCheckpointString(_out, systemOut.str());
+  }
+
+  return _out.good();
+}
+
+//////////////////////////////////////////////////
+bool SimulationRunner::RestoreCheckpoint(std::istream &_in)
+{
+  IGN_PROFILE("SimulationRunner::RestoreCheckpoint");
+
+  // Read everything before restoring anything, so a bad checkpoint doesn't
+  // leave simulation half restored
+  char magic[sizeof(kCheckpointMagic)];
+  _in.read(magic, sizeof(magic));
+  if (!_in.good() ||
+      0 != std::memcmp(magic, kCheckpointMagic, sizeof(magic)))
+  {
+    ignerr << "Not a simulation checkpoint, or from an unsupported version."
+           << std::endl;
+    return false;
+  }
+
+  int64_t simTime{0};
+  uint64_t iterations{0};
+  uint32_t seed{0};
+  std::string stateData;
+  uint64_t systemCount{0};
+  if (!readCheckpointValue(_in, simTime) ||
+      !readCheckpointValue(_in, iterations) ||
+      !readCheckpointValue(_in, seed) ||
+      !readCheckpointString(_in, stateData) ||
+      !readCheckpointValue(_in, systemCount))
+  {
+    ignerr << "Failed to read checkpoint: truncated header." << std::endl;
+    return false;
+  }
+
+  msgs::SerializedStateMap state;
+  if (!state.ParseFromString(stateData))
+  {
+    ignerr << "Failed to read checkpoint: invalid ECM state." << std::endl;
+    return false;
+  }
+
+  // Entries are only added once read, so a corrupt count fails at the end
+  // of the stream
+  std::vector<std::pair<std::string, std::string>> systemsData;
+  for (uint64_t i = 0; i < systemCount; ++i)
+  {
+    std::pair<std::string, std::string> systemData;
+    if (!readCheckpointString(_in, systemData.first) ||
+        !readCheckpointString(_in, systemData.second))
+    {
+      ignerr << "Failed to read checkpoint: truncated system state."
+             << std::endl;
+      return false;
+    }
+    systemsData.push_back(std::move(systemData));
+  }
+
+  // Systems are only added to the runner on the next step
+  this->ProcessSystemQueue();
+
+  // Entities and components which didn't exist when the checkpoint was
+  // saved are removed, SetState takes care of the rest. Restored components
+  // are marked as one-time changes, so they're all sent to the GUI and
+  // other listeners.
+  std::unordered_set<Entity> checkpointEntities;
+  for (const auto &entityIt : state.entities())
+    checkpointEntities.insert(entityIt.first);
+
+  std::vector<Entity> toRemove;
+  for (const auto &vertex : this->entityCompMgr.Entities().Vertices())
+  {
+    if (checkpointEntities.find(vertex.first) == checkpointEntities.end())
+      toRemove.push_back(vertex.first);
+  }
+  for (const auto &entity : toRemove)
+    this->entityCompMgr.RequestRemoveEntity(entity, false);
+
+  for (const auto &entityIt : state.entities())
+  {
+    if (!this->entityCompMgr.HasEntity(entityIt.first))
+      continue;
+
+    const auto &components = entityIt.second.components();
+    for (const auto &type : this->entityCompMgr.ComponentTypes(entityIt.first))
+    {
+      if (components.find(type) == components.end())
+        this->entityCompMgr.RemoveComponent(entityIt.first, type);
+    }
+  }
+
+  state.set_has_one_time_component_changes(true);
+  this->entityCompMgr.SetState(state);
+
+  // SetState doesn't update the entity graph
+  for (const auto &entityIt : state.entities())
+  {
+    Entity entity = entityIt.first;
+    auto parentComp =
+        this->entityCompMgr.Component<components::ParentEntity>(entity);
+    if (parentComp &&
+        this->entityCompMgr.ParentEntity(entity) != parentComp->Data())
+    {
+      this->entityCompMgr.SetParentEntity(entity, parentComp->Data());
+    }
+  }
+
+  // Time jumps to the checkpoint's, usually back. Systems which keep track
+  // of time are told about it through ISystemReset below. The next
+  // iteration steps forward from the checkpoint as usual.
+  auto previousSimTime = this->currentInfo.simTime;
+  this->currentInfo.simTime = std::chrono::steady_clock::duration(simTime);
+  this->currentInfo.iterations = iterations;
+  this->currentInfo.dt = std::chrono::steady_clock::duration::zero();
+  this->realTimes.clear();
+  this->simTimes.clear();
+
+  // Random numbers are drawn again from the same seed, so restored episodes
+  // are reproducible
+  math::Rand::Seed(seed);
+
+  // Systems are matched in the order they were added
+  std::size_t index{0};
+  for (auto &system : this->systems)
+  {
+    if (!system.checkpoint)
+      continue;
+
+    if (index >= systemsData.size() ||
+        systemsData[index].first != system.systemPlugin->GetName())
+    {
+      ignwarn << "System [" << system.systemPlugin->GetName()
+              << "] has no matching state in the checkpoint, it won't be "
+              << "restored." << std::endl;
+      continue;
+    }
+
+    std::istringstream systemIn(systemsData[index].second, std::ios::binary);
+    system.checkpoint->RestoreCheckpoint(this->entityCompMgr, systemIn);
+    ++index;
+  }
+
+  UpdateInfo resetInfo = this->currentInfo;
+  resetInfo.dt = this->currentInfo.simTime - previousSimTime;
+  for (auto &system : this->systems)
+  {
+    if (system.reset)
+      system.reset->Reset(resetInfo, this->entityCompMgr);
+  }
+
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <future>
 #include <list>
 #include <memory>
 #include <optional>
@@ -53,7 +54,10 @@
 
 #include "network/NetworkManager.hh"
 #include "LevelManager.hh"
+#include "SdfGenerator.hh"
 #include "Barrier.hh"
+#include "StepPacer.hh"
+#include "StepStatistics.hh"
 
 using namespace std::chrono_literals;
 
@@ -102,7 +106,9 @@ namespace ignition
                 system(systemPlugin->QueryInterface<System>()),
                 preupdate(systemPlugin->QueryInterface<ISystemPreUpdate>()),
                 update(systemPlugin->QueryInterface<ISystemUpdate>()),
-                postupdate(systemPlugin->QueryInterface<ISystemPostUpdate>())
+                postupdate(systemPlugin->QueryInterface<ISystemPostUpdate>()),
+                checkpoint(systemPlugin->QueryInterface<ISystemCheckpoint>()),
+                reset(systemPlugin->QueryInterface<ISystemReset>())
       {
       }
 
@@ -125,6 +131,14 @@ namespace ignition
       /// Will be nullptr if the System doesn't implement this interface.
       public: ISystemPostUpdate *postupdate = nullptr;
 
+      /// \brief Access this system via the ISystemCheckpoint interface
+      /// Will be nullptr if the System doesn't implement this interface.
+      public: ISystemCheckpoint *checkpoint = nullptr;
+
+      /// \brief Access this system via the ISystemReset interface
+      /// Will be nullptr if the System doesn't implement this interface.
+      public: ISystemReset *reset = nullptr;
+
       /// \brief Vector of queries and callbacks
       public: std::vector<EntityQueryCallback> updates;
     };
@@ -175,6 +189,10 @@ namespace ignition
       /// \brief Publish current world statistics.
       public: void PublishStats();
 
+      /// \brief Publish the wall time spent in each part of the step, and
+      /// store it in the world's StepTimes component, if a window is over.
+      private: void PublishStepTimes();
+
       /// \brief Load system plugin for a given entity.
       /// \param[in] _entity Entity
       /// \param[in] _fname Filename of the plugin library
@@ -201,6 +219,13 @@ namespace ignition
       /// \param[in] _config Configuration to load plugins from.
       public: void LoadLoggingPlugins(const ServerConfig &_config);
 
+      /// \brief Log how long loading the world took, with the time spent
+      /// creating entities and configuring each system.
+      /// \param[in] _creationTime Time spent creating entities, including
+      /// the configuration of the systems loaded meanwhile.
+      private: void LogLoadTimes(
+          const std::chrono::steady_clock::duration &_creationTime) const;
+
       /// \brief Get whether this is running. When running is true,
       /// then simulation is stepping forward.
       /// \return True if the server is running.
@@ -229,7 +254,9 @@ namespace ignition
       /// \brief Set the update period. The update period is the wall-clock
       /// time between updates of all systems. Note that even if systems
       /// are being updated, this doesn't mean sim time is increasing.
-      /// \param[in] _updatePeriod Duration between updates.
+      /// \param[in] _updatePeriod Duration between updates. Zero runs as
+      /// fast as possible, and later real time factor changes don't pace
+      /// updates until a positive period is set.
       public: void SetUpdatePeriod(
                   const std::chrono::steady_clock::duration &_updatePeriod);
 
@@ -349,6 +376,10 @@ namespace ignition
       /// \brief Process world control service messages.
       private: void ProcessWorldControl();
 
+      /// \brief Fulfill the pending world snapshot requests. Must be called
+      /// with msgBufferMutex locked and while the ECM isn't being updated.
+      private: void ProcessWorldSnapshotRequests();
+
       /// \brief Actually add system to the runner
       /// \param[in] _system System to be added
       public: void AddSystemToRunner(const SystemPluginPtr &_system);
@@ -365,6 +396,21 @@ namespace ignition
       public: bool GenerateWorldSdf(const msgs::SdfGeneratorConfig &_req,
                                     msgs::StringMsg &_res);
 
+      /// \brief Save the state of the simulation, including systems which
+      /// implement ISystemCheckpoint. This must not be called while running.
+      /// \param[out] _out Stream to write the binary checkpoint to.
+      /// \return True if successful.
+      public: bool SaveCheckpoint(std::ostream &_out);
+
+      /// \brief Restore a state saved with SaveCheckpoint. This must not be
+      /// called while running.
+      /// \param[in] _in Stream to read the binary checkpoint from.
+      /// Systems implementing ISystemReset are then told about the jump in
+      /// time.
+      /// \return True if successful. Nothing is restored if the checkpoint
+      /// can't be read.
+      public: bool RestoreCheckpoint(std::istream &_in);
+
       /// \brief Sets the file path to fuel URI map.
       /// \param[in] _map A populated map of file paths to fuel URIs.
       public: void SetFuelUriMap(
@@ -431,12 +477,8 @@ namespace ignition
       /// \brief A pool of worker threads.
       private: common::WorkerPool workerPool{2};
 
-      /// \brief Wall time of the previous update.
-      private: std::chrono::steady_clock::time_point prevUpdateRealTime;
-
-      /// \brief A duration used to account for inaccuracies associated with
-      /// sleep durations.
-      private: std::chrono::steady_clock::duration sleepOffset{0};
+      /// \brief Waits between updates so they happen every updatePeriod.
+      private: StepPacer stepPacer;
 
       /// \brief This is the rate at which the systems are updated.
       /// The default update rate is 500hz, which is a period of 2ms.
@@ -481,6 +523,10 @@ namespace ignition
       /// \brief Desired real time factor
       private: double desiredRtf{1.0};
 
+      /// \brief True if updates run as fast as possible, regardless of the
+      /// desired real time factor. Set by a zero update period.
+      private: bool asFastAsPossible{false};
+
       /// \brief Connection to the pause event.
       private: ignition::common::ConnectionPtr pauseConn;
 
@@ -497,6 +543,10 @@ namespace ignition
       /// averages.
       private: double realTimeFactor{0.0};
 
+      /// \brief Variance of the real time factor between consecutive sim and
+      /// real time samples.
+      private: double realTimeFactorVariance{0.0};
+
       /// \brief Number of simulation steps requested that haven't been
       /// executed yet.
       private: unsigned int pendingSimIterations{0};
@@ -521,6 +571,12 @@ namespace ignition
       /// \brief Mutex to protect message buffers.
       private: std::mutex msgBufferMutex;
 
+      /// \brief Pending requests for a snapshot of the world, used to
+      /// generate its SDFormat outside of the simulation thread.
+      private: std::vector<
+          std::promise<std::optional<sdf_generator::WorldSnapshot>>>
+          worldSnapshotRequests;
+
       /// \brief Keep the latest GUI message.
       public: msgs::GUI guiMsg;
 
@@ -539,12 +595,58 @@ namespace ignition
       /// \brief Barrier to signal end of PostUpdate thread execution
       private: std::unique_ptr<Barrier> postUpdateStopBarrier;
 
+      /// \brief Wall time spent in each part of the step.
+      private: StepStatistics stepStats;
+
+      /// \brief Step statistics section of each system's PreUpdate, in the
+      /// same order as systemsPreupdate.
+      private: std::vector<std::size_t> preupdateSections;
+
+      /// \brief Step statistics section of each system's Update, in the
+      /// same order as systemsUpdate.
+      private: std::vector<std::size_t> updateSections;
+
+      /// \brief Step statistics section of each system's PostUpdate, in the
+      /// same order as systemsPostupdate.
+      private: std::vector<std::size_t> postupdateSections;
+
+      /// \brief Step statistics section of the whole step.
+      private: std::size_t stepSection;
+
+      /// \brief Step statistics section of the level manager.
+      private: std::size_t levelsSection;
+
+      /// \brief Step statistics section of ProcessMessages.
+      private: std::size_t messagesSection;
+
+      /// \brief Step statistics section of entity and component removal.
+      private: std::size_t removalSection;
+
+      /// \brief Wall time at which the current step statistics window
+      /// started.
+      private: StepStatistics::Clock::time_point stepStatsStart;
+
+      /// \brief Step statistics of the last window which is over.
+      private: msgs::Header stepStatsMsg;
+
+      /// \brief Step statistics publisher.
+      private: ignition::transport::Node::Publisher stepStatsPub;
+
       /// \brief Map from file paths to Fuel URIs.
       private: std::unordered_map<std::string, std::string> fuelUriMap;
 
       /// \brief True if Server::RunOnce triggered a blocking paused step
       private: bool blockingPausedStepPending{false};
 
+      /// \brief True while the world is being loaded, when the time spent
+      /// configuring systems is recorded.
+      private: bool loadingWorld{true};
+
+      /// \brief Time spent in each system's Configure while loading the
+      /// world, with the system's name, in the order systems were loaded.
+      private: std::vector<std::pair<std::string,
+               std::chrono::steady_clock::duration>> loadConfigureTimes;
+
       friend class LevelManager;
     };
     }
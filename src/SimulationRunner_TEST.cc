@@ -1184,6 +1184,15 @@ TEST_P(SimulationRunnerTest, Time)
   EXPECT_TRUE(runner.Paused());
   EXPECT_EQ((currentSimTime + std::chrono::seconds(4)).count(),
       runner.CurrentInfo().simTime.count());
+
+  // A zero update period runs as fast as possible
+  runner.SetUpdatePeriod(0ms);
+  runner.SetPaused(false);
+  EXPECT_TRUE(runner.Run(100));
+  EXPECT_EQ(0ms, runner.UpdatePeriod());
+
+  runner.SetUpdatePeriod(1ms);
+  EXPECT_EQ(1ms, runner.UpdatePeriod());
 }
 
 /////////////////////////////////////////////////
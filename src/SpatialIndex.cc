@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/gazebo/SpatialIndex.hh"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Index used for nodes which don't exist.
+static constexpr int kNullNode = -1;
+
+/// \brief Node of the tree. Leaves hold one entity each, and internal nodes
+/// always have two children.
+struct SpatialIndexNode
+{
+  /// \brief Minimum corner of the box containing the node's subtree
+  math::Vector3d min;
+
+  /// \brief Maximum corner of the box containing the node's subtree
+  math::Vector3d max;
+
+  /// \brief Minimum corner of the entity's box, for leaves
+  math::Vector3d entityMin;
+
+  /// \brief Maximum corner of the entity's box, for leaves
+  math::Vector3d entityMax;
+
+  /// \brief Parent node
+  int parent{kNullNode};
+
+  /// \brief First child
+  int left{kNullNode};
+
+  /// \brief Second child
+  int right{kNullNode};
+
+  /// \brief Height of the subtree, zero for leaves
+  int height{0};
+
+  /// \brief Entity, for leaves
+  Entity entity{kNullEntity};
+
+  /// \brief Whether this is a leaf.
+  /// \return True for leaves
+  bool IsLeaf() const
+  {
+    return this->left == kNullNode;
+  }
+};
+
+/// \brief Private data class.
+class ignition::gazebo::SpatialIndexPrivate
+{
+  /// \brief Get a node which isn't in use.
+  /// \return Node index
+  public: int AllocateNode();
+
+  /// \brief Return a node so it can be used again.
+  /// \param[in] _node Node index
+  public: void FreeNode(int _node);
+
+  /// \brief Add a leaf to the tree, next to the leaf which makes the tree
+  /// grow the least.
+  /// \param[in] _leaf Leaf node
+  public: void InsertLeaf(int _leaf);
+
+  /// \brief Take a leaf out of the tree.
+  /// \param[in] _leaf Leaf node
+  public: void RemoveLeaf(int _leaf);
+
+  /// \brief Rotate a subtree if one of its children is more than one level
+  /// higher than the other.
+  /// \param[in] _node Root of the subtree
+  /// \return New root of the subtree
+  public: int Balance(int _node);
+
+  /// \brief Update a node's box and height from its children.
+  /// \param[in] _node Internal node
+  public: void Refit(int _node);
+
+  /// \brief Walk up from a node, balancing and refitting its ancestors.
+  /// \param[in] _node First node to fix
+  public: void FixUpwards(int _node);
+
+  /// \brief Get the entities whose boxes pass a test.
+  /// \param[in] _overlaps Function which takes a box's minimum and maximum
+  /// corners and returns true if the box overlaps the query volume.
+  /// \return Entities which overlap the query volume.
+  public: template<typename OverlapT>
+          std::vector<Entity> Query(OverlapT _overlaps) const;
+
+  /// \brief Margin added to entity boxes
+  public: double margin{0.1};
+
+  /// \brief All nodes, including unused ones
+  public: std::vector<SpatialIndexNode> nodes;
+
+  /// \brief Nodes which aren't in use
+  public: std::vector<int> freeNodes;
+
+  /// \brief Root node
+  public: int root{kNullNode};
+
+  /// \brief Leaf node of each entity
+  public: std::unordered_map<Entity, int> leaves;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the surface area of a box.
+/// \param[in] _min Minimum corner
+/// \param[in] _max Maximum corner
+/// \return Surface area
+static double area(const math::Vector3d &_min, const math::Vector3d &_max)
+{
+  auto size = _max - _min;
+  return 2.0 * (size.X() * size.Y() + size.Y() * size.Z() +
+                size.Z() * size.X());
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the per component minimum of two vectors.
+/// \param[in] _a First vector
+/// \param[in] _b Second vector
+/// \return Minimum
+static math::Vector3d lower(const math::Vector3d &_a, const math::Vector3d &_b)
+{
+  return {std::min(_a.X(), _b.X()), std::min(_a.Y(), _b.Y()),
+          std::min(_a.Z(), _b.Z())};
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the per component maximum of two vectors.
+/// \param[in] _a First vector
+/// \param[in] _b Second vector
+/// \return Maximum
+static math::Vector3d upper(const math::Vector3d &_a, const math::Vector3d &_b)
+{
+  return {std::max(_a.X(), _b.X()), std::max(_a.Y(), _b.Y()),
+          std::max(_a.Z(), _b.Z())};
+}
+
+//////////////////////////////////////////////////
+/// \brief Get whether two boxes overlap.
+/// \param[in] _minA Minimum corner of the first box
+/// \param[in] _maxA Maximum corner of the first box
+/// \param[in] _minB Minimum corner of the second box
+/// \param[in] _maxB Maximum corner of the second box
+/// \return True if they overlap, including touching
+static bool overlaps(const math::Vector3d &_minA, const math::Vector3d &_maxA,
+    const math::Vector3d &_minB, const math::Vector3d &_maxB)
+{
+  return _minA.X() <= _maxB.X() && _maxA.X() >= _minB.X() &&
+         _minA.Y() <= _maxB.Y() && _maxA.Y() >= _minB.Y() &&
+         _minA.Z() <= _maxB.Z() && _maxA.Z() >= _minB.Z();
+}
+
+//////////////////////////////////////////////////
+int SpatialIndexPrivate::AllocateNode()
+{
+  if (!this->freeNodes.empty())
+  {
+    int node = this->freeNodes.back();
+    this->freeNodes.pop_back();
+    this->nodes[node] = SpatialIndexNode();
+    return node;
+  }
+  this->nodes.emplace_back();
+  return static_cast<int>(this->nodes.size()) - 1;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::FreeNode(int _node)
+{
+  this->nodes[_node].entity = kNullEntity;
+  this->freeNodes.push_back(_node);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::Refit(int _node)
+{
+  auto &node = this->nodes[_node];
+  const auto &left = this->nodes[node.left];
+  const auto &right = this->nodes[node.right];
+  node.min = lower(left.min, right.min);
+  node.max = upper(left.max, right.max);
+  node.height = 1 + std::max(left.height, right.height);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::FixUpwards(int _node)
+{
+  int index = _node;
+  while (index != kNullNode)
+  {
+    index = this->Balance(index);
+    this->Refit(index);
+    index = this->nodes[index].parent;
+  }
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::InsertLeaf(int _leaf)
+{
+  if (this->root == kNullNode)
+  {
+    this->root = _leaf;
+    this->nodes[_leaf].parent = kNullNode;
+    return;
+  }
+
+  // Find the best sibling, the one whose box grows the tree the least
+  const auto leafMin = this->nodes[_leaf].min;
+  const auto leafMax = this->nodes[_leaf].max;
+  int index = this->root;
+  while (!this->nodes[index].IsLeaf())
+  {
+    const auto &node = this->nodes[index];
+    double nodeArea = area(node.min, node.max);
+    double combinedArea =
+        area(lower(node.min, leafMin), upper(node.max, leafMax));
+
+    // Cost of making a new parent for this node and the leaf
+    double cost = 2.0 * combinedArea;
+
+    // Minimum cost of pushing the leaf further down the tree
+    double inheritanceCost = 2.0 * (combinedArea - nodeArea);
+
+    auto childCost = [&](int _child)
+    {
+      const auto &child = this->nodes[_child];
+      double childArea =
+          area(lower(child.min, leafMin), upper(child.max, leafMax));
+      if (!child.IsLeaf())
+        childArea -= area(child.min, child.max);
+      return childArea + inheritanceCost;
+    };
+    double leftCost = childCost(node.left);
+    double rightCost = childCost(node.right);
+
+    if (cost < leftCost && cost < rightCost)
+      break;
+
+    index = leftCost < rightCost ? node.left : node.right;
+  }
+  int sibling = index;
+
+  // Make a new parent for the sibling and the leaf
+  int newParent = this->AllocateNode();
+  int oldParent = this->nodes[sibling].parent;
+  this->nodes[newParent].parent = oldParent;
+  this->nodes[newParent].left = sibling;
+  this->nodes[newParent].right = _leaf;
+  this->nodes[sibling].parent = newParent;
+  this->nodes[_leaf].parent = newParent;
+  this->Refit(newParent);
+
+  if (oldParent == kNullNode)
+  {
+    this->root = newParent;
+  }
+  else if (this->nodes[oldParent].left == sibling)
+  {
+    this->nodes[oldParent].left = newParent;
+  }
+  else
+  {
+    this->nodes[oldParent].right = newParent;
+  }
+
+  this->FixUpwards(oldParent);
+}
+
+//////////////////////////////////////////////////
+void SpatialIndexPrivate::RemoveLeaf(int _leaf)
+{
+  if (_leaf == this->root)
+  {
+    this->root = kNullNode;
+    return;
+  }
+
+  int parent = this->nodes[_leaf].parent;
+  int grandParent = this->nodes[parent].parent;
+  int sibling = this->nodes[parent].left == _leaf ?
+      this->nodes[parent].right : this->nodes[parent].left;
+
+  // The sibling takes the parent's place
+  this->nodes[sibling].parent = grandParent;
+  if (grandParent == kNullNode)
+  {
+    this->root = sibling;
+  }
+  else if (this->nodes[grandParent].left == parent)
+  {
+    this->nodes[grandParent].left = sibling;
+  }
+  else
+  {
+    this->nodes[grandParent].right = sibling;
+  }
+  this->FreeNode(parent);
+  this->nodes[_leaf].parent = kNullNode;
+
+  this->FixUpwards(grandParent);
+}
+
+//////////////////////////////////////////////////
+int SpatialIndexPrivate::Balance(int _node)
+{
+  auto &a = this->nodes[_node];
+  if (a.IsLeaf() || a.height < 2)
+    return _node;
+
+  int b = a.left;
+  int c = a.right;
+  int balance = this->nodes[c].height - this->nodes[b].height;
+
+  // Rotate the higher child up, and move its higher child under _node
+  auto rotate = [&](int _up, int _other, bool _upIsRight)
+  {
+    auto &up = this->nodes[_up];
+    int f = up.left;
+    int g = up.right;
+
+    up.left = _node;
+    up.parent = a.parent;
+    a.parent = _up;
+
+    if (up.parent == kNullNode)
+      this->root = _up;
+    else if (this->nodes[up.parent].left == _node)
+      this->nodes[up.parent].left = _up;
+    else
+      this->nodes[up.parent].right = _up;
+
+    // The higher grandchild stays with the rotated node
+    int keep = this->nodes[f].height > this->nodes[g].height ? f : g;
+    int move = keep == f ? g : f;
+    up.right = keep;
+    if (_upIsRight)
+    {
+      a.left = _other;
+      a.right = move;
+    }
+    else
+    {
+      a.left = move;
+      a.right = _other;
+    }
+    this->nodes[move].parent = _node;
+
+    this->Refit(_node);
+    this->Refit(_up);
+    return _up;
+  };
+
+  if (balance > 1)
+    return rotate(c, b, true);
+  if (balance < -1)
+    return rotate(b, c, false);
+  return _node;
+}
+
+//////////////////////////////////////////////////
+template<typename OverlapT>
+std::vector<Entity> SpatialIndexPrivate::Query(OverlapT _overlaps) const
+{
+  std::vector<Entity> result;
+  if (this->root == kNullNode)
+    return result;
+
+  std::vector<int> stack{this->root};
+  while (!stack.empty())
+  {
+    const auto &node = this->nodes[stack.back()];
+    stack.pop_back();
+
+    if (!_overlaps(node.min, node.max))
+      continue;
+
+    if (node.IsLeaf())
+    {
+      if (_overlaps(node.entityMin, node.entityMax))
+        result.push_back(node.entity);
+    }
+    else
+    {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::SpatialIndex(double _margin)
+  : dataPtr(std::make_unique<SpatialIndexPrivate>())
+{
+  this->dataPtr->margin = std::max(0.0, _margin);
+}
+
+//////////////////////////////////////////////////
+SpatialIndex::SpatialIndex(SpatialIndex &&_index) noexcept = default;
+
+//////////////////////////////////////////////////
+SpatialIndex &SpatialIndex::operator=(SpatialIndex &&_index) noexcept
+    = default;
+
+//////////////////////////////////////////////////
+SpatialIndex::~SpatialIndex() = default;
+
+//////////////////////////////////////////////////
+void SpatialIndex::Update(const Entity _entity,
+    const math::AxisAlignedBox &_box)
+{
+  int leaf;
+  auto it = this->dataPtr->leaves.find(_entity);
+  if (it != this->dataPtr->leaves.end())
+  {
+    leaf = it->second;
+    auto &node = this->dataPtr->nodes[leaf];
+    node.entityMin = _box.Min();
+    node.entityMax = _box.Max();
+
+    // Small motions stay within the enlarged box
+    if (lower(node.min, _box.Min()) == node.min &&
+        upper(node.max, _box.Max()) == node.max)
+    {
+      return;
+    }
+    this->dataPtr->RemoveLeaf(leaf);
+  }
+  else
+  {
+    leaf = this->dataPtr->AllocateNode();
+    this->dataPtr->nodes[leaf].entity = _entity;
+    this->dataPtr->nodes[leaf].entityMin = _box.Min();
+    this->dataPtr->nodes[leaf].entityMax = _box.Max();
+    this->dataPtr->leaves[_entity] = leaf;
+  }
+
+  math::Vector3d margin(this->dataPtr->margin, this->dataPtr->margin,
+      this->dataPtr->margin);
+  this->dataPtr->nodes[leaf].min = _box.Min() - margin;
+  this->dataPtr->nodes[leaf].max = _box.Max() + margin;
+  this->dataPtr->InsertLeaf(leaf);
+}
+
+//////////////////////////////////////////////////
+bool SpatialIndex::Remove(const Entity _entity)
+{
+  auto it = this->dataPtr->leaves.find(_entity);
+  if (it == this->dataPtr->leaves.end())
+    return false;
+
+  this->dataPtr->RemoveLeaf(it->second);
+  this->dataPtr->FreeNode(it->second);
+  this->dataPtr->leaves.erase(it);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SpatialIndex::Clear()
+{
+  this->dataPtr->nodes.clear();
+  this->dataPtr->freeNodes.clear();
+  this->dataPtr->leaves.clear();
+  this->dataPtr->root = kNullNode;
+}
+
+//////////////////////////////////////////////////
+bool SpatialIndex::Contains(const Entity _entity) const
+{
+  return this->dataPtr->leaves.find(_entity) != this->dataPtr->leaves.end();
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox SpatialIndex::Box(const Entity _entity) const
+{
+  auto it = this->dataPtr->leaves.find(_entity);
+  if (it == this->dataPtr->leaves.end())
+    return math::AxisAlignedBox();
+
+  const auto &node = this->dataPtr->nodes[it->second];
+  return math::AxisAlignedBox(node.entityMin, node.entityMax);
+}
+
+//////////////////////////////////////////////////
+size_t SpatialIndex::Size() const
+{
+  return this->dataPtr->leaves.size();
+}
+
+//////////////////////////////////////////////////
+std::vector<Entity> SpatialIndex::Query(const math::AxisAlignedBox &_box)
+    const
+{
+  const auto &min = _box.Min();
+  const auto &max = _box.Max();
+  return this->dataPtr->Query(
+      [&](const math::Vector3d &_min, const math::Vector3d &_max)
+      {
+        return overlaps(_min, _max, min, max);
+      });
+}
+
+//////////////////////////////////////////////////
+std::vector<Entity> SpatialIndex::Query(const math::Vector3d &_center,
+    double _radius) const
+{
+  double radiusSquared = _radius * _radius;
+  return this->dataPtr->Query(
+      [&](const math::Vector3d &_min, const math::Vector3d &_max)
+      {
+        // Distance from the center to the closest point in the box
+        auto closest = upper(_min, lower(_center, _max));
+        return (closest - _center).SquaredLength() <= radiusSquared;
+      });
+}
+
+//////////////////////////////////////////////////
+std::vector<Entity> SpatialIndex::Query(const math::Frustum &_frustum) const
+{
+  return this->dataPtr->Query(
+      [&](const math::Vector3d &_min, const math::Vector3d &_max)
+      {
+        if (_min == _max)
+          return _frustum.Contains(_min);
+        return _frustum.Contains(math::AxisAlignedBox(_min, _max));
+      });
+}
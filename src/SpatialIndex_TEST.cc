@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include <ignition/math/Angle.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Rand.hh>
+
+#include "ignition/gazebo/SpatialIndex.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Get a box of the given size centered at a point.
+math::AxisAlignedBox boxAt(const math::Vector3d &_center, double _size = 0.0)
+{
+  math::Vector3d half(_size * 0.5, _size * 0.5, _size * 0.5);
+  return math::AxisAlignedBox(_center - half, _center + half);
+}
+
+/////////////////////////////////////////////////
+/// \brief Sort entities so results can be compared.
+std::vector<Entity> sorted(std::vector<Entity> _entities)
+{
+  std::sort(_entities.begin(), _entities.end());
+  return _entities;
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndexTest, AddRemove)
+{
+  SpatialIndex index;
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_FALSE(index.Contains(1));
+  EXPECT_FALSE(index.Remove(1));
+  EXPECT_TRUE(index.Query(boxAt(math::Vector3d::Zero, 100.0)).empty());
+
+  index.Update(1, boxAt({1, 2, 3}, 1.0));
+  index.Update(2, boxAt({-5, 0, 0}));
+  EXPECT_EQ(2u, index.Size());
+  EXPECT_TRUE(index.Contains(1));
+  EXPECT_TRUE(index.Contains(2));
+  EXPECT_EQ(boxAt({1, 2, 3}, 1.0), index.Box(1));
+
+  // Updating doesn't add it twice
+  index.Update(1, boxAt({1, 2, 3.01}, 1.0));
+  EXPECT_EQ(2u, index.Size());
+  EXPECT_EQ(boxAt({1, 2, 3.01}, 1.0), index.Box(1));
+
+  EXPECT_TRUE(index.Remove(1));
+  EXPECT_FALSE(index.Contains(1));
+  EXPECT_FALSE(index.Remove(1));
+  EXPECT_EQ(1u, index.Size());
+
+  index.Clear();
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_FALSE(index.Contains(2));
+
+  // Usable after clearing
+  index.Update(3, boxAt({0, 0, 0}));
+  EXPECT_EQ(std::vector<Entity>{3},
+      index.Query(boxAt(math::Vector3d::Zero, 1.0)));
+
+  SpatialIndex moved(std::move(index));
+  EXPECT_TRUE(moved.Contains(3));
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndexTest, Queries)
+{
+  SpatialIndex index;
+  index.Update(1, boxAt({0, 0, 0}));
+  index.Update(2, boxAt({5, 0, 0}));
+  index.Update(3, boxAt({10, 0, 0}, 2.0));
+
+  // Box
+  EXPECT_EQ(std::vector<Entity>({1, 2}),
+      sorted(index.Query(math::AxisAlignedBox({-1, -1, -1}, {6, 1, 1}))));
+  EXPECT_EQ(std::vector<Entity>({3}),
+      sorted(index.Query(math::AxisAlignedBox({8.5, -1, -1}, {9.5, 1, 1}))));
+
+  // The margin isn't reported
+  EXPECT_TRUE(index.Query(
+      math::AxisAlignedBox({0.05, -1, -1}, {1, 1, 1})).empty());
+
+  // Sphere
+  EXPECT_EQ(std::vector<Entity>({1}),
+      sorted(index.Query(math::Vector3d(1, 0, 0), 2.0)));
+  EXPECT_EQ(std::vector<Entity>({2, 3}),
+      sorted(index.Query(math::Vector3d(7, 0, 0), 2.0)));
+  EXPECT_TRUE(index.Query(math::Vector3d(0, 5, 0), 1.0).empty());
+
+  // Frustum looking down +X from the origin, up to 7 m away
+  math::Frustum frustum(0.1, 7.0, math::Angle(IGN_PI_2), 1.0,
+      math::Pose3d::Zero);
+  EXPECT_EQ(std::vector<Entity>({2}), sorted(index.Query(frustum)));
+
+  frustum.SetFar(20.0);
+  EXPECT_EQ(std::vector<Entity>({2, 3}), sorted(index.Query(frustum)));
+
+  // Entities move
+  index.Update(1, boxAt({3, 0, 0}));
+  EXPECT_EQ(std::vector<Entity>({1, 2, 3}), sorted(index.Query(frustum)));
+  index.Update(3, boxAt({-10, 0, 0}));
+  EXPECT_EQ(std::vector<Entity>({1, 2}), sorted(index.Query(frustum)));
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndexTest, MatchesBruteForce)
+{
+  math::Rand::Seed(42);
+
+  SpatialIndex index;
+  std::map<Entity, math::AxisAlignedBox> boxes;
+
+  auto randomBox = []()
+  {
+    return boxAt({math::Rand::DblUniform(-50, 50),
+        math::Rand::DblUniform(-50, 50), math::Rand::DblUniform(-5, 5)},
+        math::Rand::DblUniform(0, 2));
+  };
+
+  for (Entity e = 1; e <= 500; ++e)
+  {
+    boxes[e] = randomBox();
+    index.Update(e, boxes[e]);
+  }
+
+  for (int step = 0; step < 20; ++step)
+  {
+    // Move some entities by a little and some by a lot, remove a few
+    for (auto it = boxes.begin(); it != boxes.end();)
+    {
+      int r = math::Rand::IntUniform(0, 9);
+      if (r == 0)
+      {
+        EXPECT_TRUE(index.Remove(it->first));
+        it = boxes.erase(it);
+        continue;
+      }
+      if (r < 3)
+      {
+        it->second = randomBox();
+      }
+      else
+      {
+        math::Vector3d offset(math::Rand::DblUniform(-0.05, 0.05),
+            math::Rand::DblUniform(-0.05, 0.05), 0.0);
+        it->second = math::AxisAlignedBox(it->second.Min() + offset,
+            it->second.Max() + offset);
+      }
+      index.Update(it->first, it->second);
+      ++it;
+    }
+    ASSERT_EQ(boxes.size(), index.Size());
+
+    math::Vector3d center(math::Rand::DblUniform(-50, 50),
+        math::Rand::DblUniform(-50, 50), 0.0);
+    double radius = math::Rand::DblUniform(1, 20);
+    auto query = boxAt(center, radius * 2.0);
+
+    std::vector<Entity> expectedBox;
+    std::vector<Entity> expectedSphere;
+    for (const auto &[entity, box] : boxes)
+    {
+      if (box.Intersects(query))
+        expectedBox.push_back(entity);
+
+      math::Vector3d closest(
+          std::max(box.Min().X(), std::min(center.X(), box.Max().X())),
+          std::max(box.Min().Y(), std::min(center.Y(), box.Max().Y())),
+          std::max(box.Min().Z(), std::min(center.Z(), box.Max().Z())));
+      if (closest.Distance(center) <= radius)
+        expectedSphere.push_back(entity);
+    }
+
+    EXPECT_EQ(expectedBox, sorted(index.Query(query)));
+    EXPECT_EQ(expectedSphere, sorted(index.Query(center, radius)));
+  }
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "StepPacer.hh"
+
+#include <thread>
+
+#include <ignition/common/Profiler.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+class ignition::gazebo::StepPacerPrivate
+{
+  /// \brief Maximum number of late steps which are caught up.
+  public: uint64_t maxCatchUpSteps{10};
+
+  /// \brief How long before a step is due to start spinning.
+  public: StepPacer::Clock::duration spinDuration{200us};
+
+  /// \brief Wall time at which the next step is due.
+  public: StepPacer::Clock::time_point next;
+
+  /// \brief Period used for the current schedule.
+  public: StepPacer::Clock::duration period{0};
+
+  /// \brief False until the schedule starts.
+  public: bool started{false};
+
+  /// \brief Total number of dropped steps.
+  public: uint64_t droppedSteps{0};
+};
+
+//////////////////////////////////////////////////
+StepPacer::StepPacer()
+  : dataPtr(std::make_unique<StepPacerPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+StepPacer::~StepPacer() = default;
+
+//////////////////////////////////////////////////
+void StepPacer::SetMaxCatchUpSteps(uint64_t _steps)
+{
+  this->dataPtr->maxCatchUpSteps = _steps;
+}
+
+//////////////////////////////////////////////////
+uint64_t StepPacer::MaxCatchUpSteps() const
+{
+  return this->dataPtr->maxCatchUpSteps;
+}
+
+//////////////////////////////////////////////////
+void StepPacer::SetSpinDuration(Clock::duration _duration)
+{
+  this->dataPtr->spinDuration = _duration;
+}
+
+//////////////////////////////////////////////////
+StepPacer::Clock::duration StepPacer::SpinDuration() const
+{
+  return this->dataPtr->spinDuration;
+}
+
+//////////////////////////////////////////////////
+void StepPacer::Reset()
+{
+  this->dataPtr->started = false;
+}
+
+//////////////////////////////////////////////////
+uint64_t StepPacer::Wait(Clock::duration _period)
+{
+  IGN_PROFILE("StepPacer::Wait");
+
+  auto now = Clock::now();
+  if (_period <= Clock::duration::zero())
+  {
+    this->dataPtr->started = false;
+    return 0;
+  }
+
+  if (!this->dataPtr->started)
+  {
+    this->dataPtr->started = true;
+    this->dataPtr->period = _period;
+    this->dataPtr->next = now + _period;
+    return 0;
+  }
+
+  // A new period applies from the previous step
+  if (_period != this->dataPtr->period)
+  {
+    this->dataPtr->next += _period - this->dataPtr->period;
+    this->dataPtr->period = _period;
+  }
+
+  uint64_t dropped{0};
+  if (now < this->dataPtr->next)
+  {
+    auto remaining = this->dataPtr->next - now;
+    if (remaining > this->dataPtr->spinDuration)
+    {
+      IGN_PROFILE("Sleep");
+      std::this_thread::sleep_for(remaining - this->dataPtr->spinDuration);
+    }
+
+    IGN_PROFILE("Spin");
+    while (Clock::now() < this->dataPtr->next)
+      std::this_thread::yield();
+  }
+  else
+  {
+    // Number of steps which are due, besides this one
+    auto late = static_cast<uint64_t>((now - this->dataPtr->next) / _period);
+    if (late > this->dataPtr->maxCatchUpSteps)
+    {
+      dropped = late - this->dataPtr->maxCatchUpSteps;
+      this->dataPtr->next += _period * dropped;
+      this->dataPtr->droppedSteps += dropped;
+    }
+  }
+
+  this->dataPtr->next += _period;
+  return dropped;
+}
+
+//////////////////////////////////////////////////
+uint64_t StepPacer::DroppedSteps() const
+{
+  return this->dataPtr->droppedSteps;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_STEPPACER_HH_
+#define IGNITION_GAZEBO_STEPPACER_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class StepPacerPrivate;
+
+    /// \class StepPacer StepPacer.hh
+    /// \brief Paces simulation steps on a fixed wall clock schedule.
+    ///
+    /// Step n is due at the start time plus n periods, so a step which
+    /// starts late doesn't delay the following ones: the pacer doesn't wait
+    /// until the schedule is caught up. At most a given number of late steps
+    /// are caught up this way, older ones are dropped from the schedule, so a
+    /// long stall doesn't cause a long burst of fast steps.
+    ///
+    /// To wait for a step, the pacer sleeps until shortly before the step is
+    /// due, then spins for the rest, because sleeps often overshoot by
+    /// tens of microseconds.
+    class IGNITION_GAZEBO_VISIBLE StepPacer
+    {
+      /// \brief Clock used for the schedule.
+      public: using Clock = std::chrono::steady_clock;
+
+      /// \brief Constructor
+      public: StepPacer();
+
+      /// \brief Destructor
+      public: ~StepPacer();
+
+      /// \brief Set the maximum number of late steps which are caught up.
+      /// Zero means late steps are never caught up, which guarantees that
+      /// two steps are never closer than a period.
+      /// \param[in] _steps Number of steps. Defaults to 10.
+      public: void SetMaxCatchUpSteps(uint64_t _steps);
+
+      /// \brief Get the maximum number of late steps which are caught up.
+      /// \return Number of steps.
+      public: uint64_t MaxCatchUpSteps() const;
+
+      /// \brief Set how long before a step is due the pacer stops sleeping
+      /// and starts spinning.
+      /// \param[in] _duration Spin duration. Defaults to 200 us.
+      public: void SetSpinDuration(Clock::duration _duration);
+
+      /// \brief Get how long the pacer spins before a step.
+      /// \return Spin duration.
+      public: Clock::duration SpinDuration() const;
+
+      /// \brief Restart the schedule, so the next step is due right away.
+      /// Call this after stepping was interrupted, so the interruption isn't
+      /// caught up.
+      public: void Reset();
+
+      /// \brief Wait until the next step is due.
+      /// \param[in] _period Period between steps. Zero or less means steps
+      /// aren't paced. If it differs from the previous call, the schedule
+      /// restarts from the previous step.
+      /// \return Number of late steps which were dropped from the schedule.
+      public: uint64_t Wait(Clock::duration _period);
+
+      /// \brief Get the total number of steps dropped from the schedule.
+      /// \return Number of steps.
+      public: uint64_t DroppedSteps() const;
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<StepPacerPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "StepPacer.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(StepPacerTest, Defaults)
+{
+  StepPacer pacer;
+  EXPECT_EQ(10u, pacer.MaxCatchUpSteps());
+  EXPECT_EQ(StepPacer::Clock::duration(200us), pacer.SpinDuration());
+  EXPECT_EQ(0u, pacer.DroppedSteps());
+
+  pacer.SetMaxCatchUpSteps(3);
+  EXPECT_EQ(3u, pacer.MaxCatchUpSteps());
+  pacer.SetSpinDuration(1ms);
+  EXPECT_EQ(StepPacer::Clock::duration(1ms), pacer.SpinDuration());
+}
+
+/////////////////////////////////////////////////
+TEST(StepPacerTest, Unpaced)
+{
+  StepPacer pacer;
+  auto start = StepPacer::Clock::now();
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(0u, pacer.Wait(StepPacer::Clock::duration::zero()));
+  EXPECT_LT(StepPacer::Clock::now() - start, 100ms);
+}
+
+/////////////////////////////////////////////////
+TEST(StepPacerTest, Period)
+{
+  StepPacer pacer;
+
+  // The first step is due right away
+  auto start = StepPacer::Clock::now();
+  EXPECT_EQ(0u, pacer.Wait(5ms));
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(0u, pacer.Wait(5ms));
+
+  // 10 periods, never less
+  auto elapsed = StepPacer::Clock::now() - start;
+  EXPECT_GE(elapsed, 50ms);
+  EXPECT_EQ(0u, pacer.DroppedSteps());
+}
+
+/////////////////////////////////////////////////
+TEST(StepPacerTest, CatchUp)
+{
+  StepPacer pacer;
+  pacer.SetMaxCatchUpSteps(2);
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+
+  // Stall for about 5 periods
+  std::this_thread::sleep_for(55ms);
+
+  // Only 2 late steps are caught up, the others are dropped
+  auto dropped = pacer.Wait(10ms);
+  EXPECT_GE(dropped, 2u);
+  EXPECT_EQ(dropped, pacer.DroppedSteps());
+
+  // The caught up steps don't wait
+  auto start = StepPacer::Clock::now();
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  EXPECT_LT(StepPacer::Clock::now() - start, 10ms);
+
+  // Then the schedule is back to normal
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  start = StepPacer::Clock::now();
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  EXPECT_GE(StepPacer::Clock::now() - start, 15ms);
+}
+
+/////////////////////////////////////////////////
+TEST(StepPacerTest, Reset)
+{
+  StepPacer pacer;
+  pacer.SetMaxCatchUpSteps(0);
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  std::this_thread::sleep_for(35ms);
+
+  // After a reset, the stall is neither caught up nor dropped
+  pacer.Reset();
+  auto start = StepPacer::Clock::now();
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  EXPECT_EQ(0u, pacer.Wait(10ms));
+  EXPECT_GE(StepPacer::Clock::now() - start, 10ms);
+  EXPECT_EQ(0u, pacer.DroppedSteps());
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "StepStatistics.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Number of histogram buckets. Bucket i holds durations shorter
+/// than 2^i microseconds, and the last one holds everything else.
+static constexpr std::size_t kBucketCount{24};
+
+/// \brief Durations of one section.
+struct StepSection
+{
+  /// \brief Section name
+  std::string name;
+
+  /// \brief Number of durations.
+  uint64_t count{0};
+
+  /// \brief Sum of durations.
+  StepStatistics::Clock::duration total{0};
+
+  /// \brief Longest duration.
+  StepStatistics::Clock::duration max{0};
+
+  /// \brief Number of durations in each bucket.
+  std::array<uint64_t, kBucketCount> buckets{};
+};
+
+class ignition::gazebo::StepStatisticsPrivate
+{
+  /// \brief All sections, indexed by id.
+  public: std::vector<StepSection> sections;
+};
+
+//////////////////////////////////////////////////
+/// \brief Get the bucket of a duration.
+/// \param[in] _duration Duration
+/// \return Bucket index.
+static std::size_t bucket(StepStatistics::Clock::duration _duration)
+{
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+      _duration).count();
+  std::size_t index = 0;
+  while (us > 0 && index + 1 < kBucketCount)
+  {
+    us >>= 1;
+    ++index;
+  }
+  return index;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the upper bound of a bucket.
+/// \param[in] _bucket Bucket index.
+/// \return Upper bound in microseconds.
+static int64_t bucketUpperBound(std::size_t _bucket)
+{
+  return int64_t{1} << _bucket;
+}
+
+//////////////////////////////////////////////////
+StepStatistics::StepStatistics()
+  : dataPtr(std::make_unique<StepStatisticsPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+StepStatistics::~StepStatistics() = default;
+
+//////////////////////////////////////////////////
+std::size_t StepStatistics::AddSection(const std::string &_name)
+{
+  StepSection section;
+  section.name = _name;
+  this->dataPtr->sections.push_back(section);
+  return this->dataPtr->sections.size() - 1;
+}
+
+//////////////////////////////////////////////////
+std::size_t StepStatistics::SectionCount() const
+{
+  return this->dataPtr->sections.size();
+}
+
+//////////////////////////////////////////////////
+void StepStatistics::Record(std::size_t _section, Clock::duration _duration)
+{
+  auto &section = this->dataPtr->sections[_section];
+  ++section.count;
+  section.total += _duration;
+  section.max = std::max(section.max, _duration);
+  ++section.buckets[bucket(_duration)];
+}
+
+//////////////////////////////////////////////////
+void StepStatistics::Reset()
+{
+  for (auto &section : this->dataPtr->sections)
+  {
+    section.count = 0;
+    section.total = Clock::duration::zero();
+    section.max = Clock::duration::zero();
+    section.buckets.fill(0);
+  }
+}
+
+//////////////////////////////////////////////////
+uint64_t StepStatistics::Count(std::size_t _section) const
+{
+  if (_section >= this->dataPtr->sections.size())
+    return 0;
+  return this->dataPtr->sections[_section].count;
+}
+
+//////////////////////////////////////////////////
+StepStatistics::Clock::duration StepStatistics::Percentile(
+    std::size_t _section, double _percentile) const
+{
+  if (_section >= this->dataPtr->sections.size())
+    return Clock::duration::zero();
+
+  const auto &section = this->dataPtr->sections[_section];
+  if (section.count == 0)
+    return Clock::duration::zero();
+
+  auto target = static_cast<uint64_t>(std::ceil(
+      std::clamp(_percentile, 0.0, 1.0) * section.count));
+  target = std::max<uint64_t>(target, 1);
+
+  uint64_t cumulative = 0;
+  for (std::size_t b = 0; b < kBucketCount; ++b)
+  {
+    cumulative += section.buckets[b];
+    if (cumulative >= target)
+    {
+      // The longest duration is a tighter bound for the last bucket used
+      return std::min<Clock::duration>(section.max,
+          std::chrono::microseconds(bucketUpperBound(b)));
+    }
+  }
+  return section.max;
+}
+
+//////////////////////////////////////////////////
+void StepStatistics::FillMsg(msgs::Header &_header) const
+{
+  for (std::size_t s = 0; s < this->dataPtr->sections.size(); ++s)
+  {
+    const auto &section = this->dataPtr->sections[s];
+    if (section.count == 0)
+      continue;
+
+    auto toUs = [](Clock::duration _d)
+    {
+      return std::chrono::duration<double, std::micro>(_d).count();
+    };
+
+    auto *data = _header.add_data();
+    data->set_key(section.name);
+    data->add_value("count=" + std::to_string(section.count));
+    data->add_value("mean_us=" + std::to_string(
+        toUs(section.total) / section.count));
+    data->add_value("max_us=" + std::to_string(toUs(section.max)));
+    data->add_value("p50_us=" + std::to_string(
+        toUs(this->Percentile(s, 0.5))));
+    data->add_value("p99_us=" + std::to_string(
+        toUs(this->Percentile(s, 0.99))));
+
+    std::ostringstream histogram;
+    histogram << "histogram_us=";
+    bool first = true;
+    for (std::size_t b = 0; b < kBucketCount; ++b)
+    {
+      if (section.buckets[b] == 0)
+        continue;
+      if (!first)
+        histogram << ",";
+      histogram << bucketUpperBound(b) << ":" << section.buckets[b];
+      first = false;
+    }
+    data->add_value(histogram.str());
+  }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_STEPSTATISTICS_HH_
+#define IGNITION_GAZEBO_STEPSTATISTICS_HH_
+
+#include <ignition/msgs/header.pb.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class StepStatisticsPrivate;
+
+    /// \class StepStatistics StepStatistics.hh
+    /// \brief Wall time spent in each section of a simulation step, such as
+    /// the PreUpdate of one system.
+    ///
+    /// Durations are accumulated in a histogram with power of 2 buckets,
+    /// from 1 us up to about 8 s, over a window which is started by Reset.
+    /// Sections are added before recording starts. Durations of different
+    /// sections may be recorded from different threads at the same time, as
+    /// long as they are read once those threads are synchronized.
+    class IGNITION_GAZEBO_VISIBLE StepStatistics
+    {
+      /// \brief Clock used to time sections.
+      public: using Clock = std::chrono::steady_clock;
+
+      /// \brief Constructor
+      public: StepStatistics();
+
+      /// \brief Destructor
+      public: ~StepStatistics();
+
+      /// \brief Add a section.
+      /// \param[in] _name Name of the section, such as
+      /// "PreUpdate/ignition::gazebo::systems::Physics".
+      /// \return Id used to record the section's durations.
+      public: std::size_t AddSection(const std::string &_name);
+
+      /// \brief Get the number of sections.
+      /// \return Number of sections.
+      public: std::size_t SectionCount() const;
+
+      /// \brief Record one duration of a section.
+      /// \param[in] _section Id returned by AddSection.
+      /// \param[in] _duration Wall time spent in the section.
+      public: void Record(std::size_t _section, Clock::duration _duration);
+
+      /// \brief Start a new window, clearing all durations.
+      public: void Reset();
+
+      /// \brief Get the number of durations recorded for a section in the
+      /// current window.
+      /// \param[in] _section Section id.
+      /// \return Number of durations.
+      public: uint64_t Count(std::size_t _section) const;
+
+      /// \brief Get an estimate of a percentile of a section's durations in
+      /// the current window. It's the upper bound of the histogram bucket
+      /// which holds the percentile.
+      /// \param[in] _section Section id.
+      /// \param[in] _percentile Percentile, between 0 and 1.
+      /// \return Estimated duration, zero if nothing was recorded.
+      public: Clock::duration Percentile(std::size_t _section,
+                                         double _percentile) const;
+
+      /// \brief Add the statistics of the current window to a header, one
+      /// entry per section which has been recorded. The key is the section
+      /// name, and the values are `count=`, `mean_us=`, `max_us=`,
+      /// `p50_us=`, `p99_us=` and `histogram_us=`, followed by numbers.
+      /// The histogram lists `<bucket upper bound>:<count>` pairs for the
+      /// buckets which aren't empty, separated by commas.
+      /// \param[out] _header Header to add entries to.
+      public: void FillMsg(msgs::Header &_header) const;
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<StepStatisticsPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
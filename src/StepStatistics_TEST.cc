@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "StepStatistics.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(StepStatisticsTest, Record)
+{
+  StepStatistics stats;
+  EXPECT_EQ(0u, stats.SectionCount());
+
+  auto physics = stats.AddSection("Update/Physics");
+  auto sensors = stats.AddSection("PostUpdate/Sensors");
+  EXPECT_EQ(2u, stats.SectionCount());
+  EXPECT_NE(physics, sensors);
+
+  EXPECT_EQ(0u, stats.Count(physics));
+  EXPECT_EQ(StepStatistics::Clock::duration::zero(),
+      stats.Percentile(physics, 0.5));
+
+  // 99 short durations and a long one
+  for (int i = 0; i < 99; ++i)
+    stats.Record(physics, 100us);
+  stats.Record(physics, 5ms);
+  EXPECT_EQ(100u, stats.Count(physics));
+  EXPECT_EQ(0u, stats.Count(sensors));
+
+  // 100 us falls in the bucket of durations shorter than 128 us
+  EXPECT_EQ(StepStatistics::Clock::duration(128us),
+      stats.Percentile(physics, 0.5));
+  EXPECT_EQ(StepStatistics::Clock::duration(128us),
+      stats.Percentile(physics, 0.99));
+  EXPECT_EQ(StepStatistics::Clock::duration(5ms),
+      stats.Percentile(physics, 1.0));
+
+  msgs::Header header;
+  stats.FillMsg(header);
+  ASSERT_EQ(1, header.data_size());
+  EXPECT_EQ("Update/Physics", header.data(0).key());
+  ASSERT_EQ(6, header.data(0).value_size());
+  EXPECT_EQ("count=100", header.data(0).value(0));
+  EXPECT_EQ(0u, header.data(0).value(1).find("mean_us=149.0"));
+  EXPECT_EQ(0u, header.data(0).value(2).find("max_us=5000.0"));
+  EXPECT_EQ("histogram_us=128:99,8192:1", header.data(0).value(5));
+
+  stats.Reset();
+  EXPECT_EQ(0u, stats.Count(physics));
+  EXPECT_EQ(2u, stats.SectionCount());
+
+  msgs::Header empty;
+  stats.FillMsg(empty);
+  EXPECT_EQ(0, empty.data_size());
+}
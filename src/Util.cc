@@ -62,21 +62,7 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
 math::Pose3d worldPose(const Entity &_entity,
     const EntityComponentManager &_ecm)
 {
-  // work out pose in world frame
-  math::Pose3d pose = _ecm.Component<components::Pose>(_entity)->Data();
-  auto p = _ecm.Component<components::ParentEntity>(_entity);
-  while (p)
-  {
-    // get pose of parent entity
-    auto parentPose = _ecm.Component<components::Pose>(p->Data());
-    if (!parentPose)
-      break;
-    // transform pose
-    pose = pose + parentPose->Data();
-    // keep going up the tree
-    p = _ecm.Component<components::ParentEntity>(p->Data());
-  }
-  return pose;
+  return _ecm.WorldPose(_entity);
 }
 
 //////////////////////////////////////////////////
@@ -462,6 +448,13 @@ std::string topicFromScopedName(const Entity &_entity,
   return transport::TopicUtils::AsValidTopic("/" + topic);
 }
 
+//////////////////////////////////////////////////
+std::mutex &meshManagerMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
 //////////////////////////////////////////////////
 std::string validTopic(const std::vector<std::string> &_topics)
 {
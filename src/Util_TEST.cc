@@ -16,6 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+
+#include <thread>
+
 #include <ignition/common/Console.hh>
 #include <sdf/Actor.hh>
 #include <sdf/Light.hh>
@@ -609,3 +612,18 @@ TEST_F(UtilTest, TopicFromScopedName)
   EXPECT_TRUE(topicFromScopedName(worldEntity, ecm).empty());
   EXPECT_EQ(worldName, topicFromScopedName(worldEntity, ecm, false));
 }
+
+/////////////////////////////////////////////////
+TEST_F(UtilTest, MeshManagerMutex)
+{
+  // All callers share the same mutex
+  auto *mutex = &meshManagerMutex();
+  EXPECT_EQ(mutex, &meshManagerMutex());
+
+  // Other threads wait while it's locked
+  std::lock_guard<std::mutex> lock(meshManagerMutex());
+  std::thread([]
+  {
+    EXPECT_FALSE(meshManagerMutex().try_lock());
+  }).join();
+}
@@ -15,6 +15,16 @@
  *
 */
 
+#include <QPointer>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
 #include <ignition/fuel_tools/Interface.hh>
@@ -29,14 +39,45 @@
 #include "ignition/gazebo/gui/GuiRunner.hh"
 #include "ignition/gazebo/gui/GuiSystem.hh"
 
+#include "StateMerge.hh"
+
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief A GUI system and when it was last updated.
+struct GuiSystemUpdate
+{
+  /// \brief The plugin, null once it's deleted.
+  QPointer<GuiSystem> plugin;
+
+  /// \brief Minimum time between updates, zero for no limit.
+  std::chrono::steady_clock::duration period{0};
+
+  /// \brief Time of the last update.
+  std::chrono::steady_clock::time_point lastUpdate;
+
+  /// \brief True if the plugin skipped an update while components had
+  /// changed, so the change flags are kept until it's updated.
+  bool pendingChanges{false};
+};
+
 /////////////////////////////////////////////////
 class ignition::gazebo::GuiRunner::Implementation
 {
-  /// \brief Update the plugins.
-  public: void UpdatePlugins();
+  /// \brief Update the plugins. Component change flags are cleared once
+  /// every plugin has seen them.
+  /// \param[in] _force True to update all plugins, ignoring their update
+  /// rates, because the ECM has changes which can't be dropped.
+  /// \param[in] _changed True if components changed since the previous
+  /// update, so plugins which skip this one must see them later.
+  public: void UpdatePlugins(bool _force, bool _changed);
+
+  /// \brief Apply a state message to the ECM and update the plugins.
+  /// \param[in] _msg State message.
+  public: void ApplyState(const msgs::SerializedStepMap &_msg);
+
+  /// \brief Find the GUI systems, if they may have changed.
+  public: void RefreshPlugins();
 
   /// \brief Entity-component manager.
   public: gazebo::EntityComponentManager ecm;
@@ -53,11 +94,28 @@ class ignition::gazebo::GuiRunner::Implementation
   /// \brief Flag used to end the updateThread.
   public: bool running{false};
 
-  /// \brief Mutex to protect the plugin update.
-  public: std::mutex updateMutex;
-
-  /// \brief The plugin update thread..
+  /// \brief The plugin update thread, which applies states and updates
+  /// plugins.
   public: std::thread updateThread;
+
+  /// \brief Protects pendingState, hasPendingState and running.
+  public: std::mutex stateMutex;
+
+  /// \brief Notified when a state is received or the runner stops.
+  public: std::condition_variable stateCv;
+
+  /// \brief States received since the update thread last took one, merged
+  /// into a single message.
+  public: msgs::SerializedStepMap pendingState;
+
+  /// \brief True if pendingState holds a state.
+  public: bool hasPendingState{false};
+
+  /// \brief Cached GUI systems.
+  public: std::vector<GuiSystemUpdate> plugins;
+
+  /// \brief True if plugins must be looked up again.
+  public: std::atomic<bool> pluginsDirty{true};
 };
 
 /////////////////////////////////////////////////
@@ -90,19 +148,42 @@ GuiRunner::GuiRunner(const std::string &_worldName)
 
   this->RequestState();
 
-  // Periodically update the plugins
-  // \todo(anyone) Move the global variables to GuiRunner::Implementation on v5
+  // Apply states as they arrive, and periodically update the plugins
   this->dataPtr->running = true;
   this->dataPtr->updateThread = std::thread([&]()
   {
-    while (this->dataPtr->running)
+    msgs::SerializedStepMap state;
+    while (true)
     {
+      bool hasState{false};
       {
-        std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
-        this->dataPtr->UpdatePlugins();
+        std::unique_lock<std::mutex> lock(this->dataPtr->stateMutex);
+        // This is roughly a 30Hz update rate while no state is received.
+        this->dataPtr->stateCv.wait_for(lock, std::chrono::milliseconds(33),
+            [&]
+            {
+              return this->dataPtr->hasPendingState ||
+                  !this->dataPtr->running;
+            });
+        if (!this->dataPtr->running)
+          break;
+
+        // Take the pending state, leaving the buffer of the previous one
+        // to receive the next states
+        if (this->dataPtr->hasPendingState)
+        {
+          state.Swap(&this->dataPtr->pendingState);
+          this->dataPtr->pendingState.Clear();
+          this->dataPtr->hasPendingState = false;
+          hasState = true;
+        }
       }
-      // This is roughly a 30Hz update rate.
-      std::this_thread::sleep_for(std::chrono::milliseconds(33));
+
+      this->dataPtr->RefreshPlugins();
+      if (hasState)
+        this->dataPtr->ApplyState(state);
+      else
+        this->dataPtr->UpdatePlugins(false, false);
     }
   });
 }
@@ -110,7 +191,11 @@ GuiRunner::GuiRunner(const std::string &_worldName)
 /////////////////////////////////////////////////
 GuiRunner::~GuiRunner()
 {
-  this->dataPtr->running = false;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->stateMutex);
+    this->dataPtr->running = false;
+  }
+  this->dataPtr->stateCv.notify_all();
   if (this->dataPtr->updateThread.joinable())
     this->dataPtr->updateThread.join();
 }
@@ -160,6 +245,7 @@ void GuiRunner::OnPluginAdded(const QString &_objectName)
     return;
   }
 
+  this->dataPtr->pluginsDirty = true;
   this->RequestState();
 }
 
@@ -187,25 +273,115 @@ void GuiRunner::OnStateAsyncService(const msgs::SerializedStepMap &_res)
 void GuiRunner::OnState(const msgs::SerializedStepMap &_msg)
 {
   IGN_PROFILE_THREAD_NAME("GuiRunner::OnState");
+  IGN_PROFILE("GuiRunner::OnState");
+
+  // Only queue the state here, so the transport thread isn't held up. States
+  // which arrive before the update thread takes them are merged, so the
+  // latest one is applied once.
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->stateMutex);
+    if (this->dataPtr->hasPendingState)
+    {
+      mergeState(this->dataPtr->pendingState, _msg);
+    }
+    else
+    {
+      this->dataPtr->pendingState.CopyFrom(_msg);
+      this->dataPtr->hasPendingState = true;
+    }
+  }
+  this->dataPtr->stateCv.notify_one();
+}
+
+/////////////////////////////////////////////////
+void GuiRunner::Implementation::ApplyState(const msgs::SerializedStepMap &_msg)
+{
+  IGN_PROFILE_THREAD_NAME("GuiRunner::Update");
   IGN_PROFILE("GuiRunner::Update");
 
-  std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
-  this->dataPtr->ecm.SetState(_msg.state());
+  this->ecm.SetState(_msg.state());
+
+  // Update all plugins. Plugins can only skip updates which just change
+  // component values, and they still see those changes on their next update.
+  this->updateInfo = convert<UpdateInfo>(_msg.stats());
+  this->UpdatePlugins(this->ecm.HasNewEntities() ||
+      this->ecm.HasEntitiesMarkedForRemoval() ||
+      this->ecm.HasOneTimeComponentChanges() ||
+      hasRemovals(_msg.state()), true);
+  this->ecm.ClearNewlyCreatedEntities();
+  this->ecm.ProcessRemoveEntityRequests();
+}
+
+/////////////////////////////////////////////////
+void GuiRunner::Implementation::RefreshPlugins()
+{
+  if (!this->pluginsDirty.exchange(false))
+    return;
+
+  IGN_PROFILE("GuiRunner::RefreshPlugins");
+  std::vector<GuiSystemUpdate> plugins;
+  for (auto plugin : gui::App()->findChildren<GuiSystem *>())
+  {
+    GuiSystemUpdate update;
+    update.plugin = plugin;
+
+    // Keep the update state of plugins which were already known
+    for (const auto &known : this->plugins)
+    {
+      if (known.plugin == plugin)
+      {
+        update.lastUpdate = known.lastUpdate;
+        update.pendingChanges = known.pendingChanges;
+        break;
+      }
+    }
+
+    bool ok{false};
+    double rate = plugin->property("updateRate").toDouble(&ok);
+    if (ok && rate > 0.0)
+    {
+      update.period = std::chrono::duration_cast<
+          std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / rate));
+    }
 
-  // Update all plugins
-  this->dataPtr->updateInfo = convert<UpdateInfo>(_msg.stats());
-  this->dataPtr->UpdatePlugins();
-  this->dataPtr->ecm.ClearNewlyCreatedEntities();
-  this->dataPtr->ecm.ProcessRemoveEntityRequests();
+    plugins.push_back(update);
+  }
+  this->plugins = std::move(plugins);
 }
 
 /////////////////////////////////////////////////
-void GuiRunner::Implementation::UpdatePlugins()
+void GuiRunner::Implementation::UpdatePlugins(bool _force, bool _changed)
 {
-  auto plugins = gui::App()->findChildren<GuiSystem *>();
-  for (auto plugin : plugins)
+  auto now = std::chrono::steady_clock::now();
+  bool pendingChanges{false};
+  for (auto &update : this->plugins)
+  {
+    // Plugin was deleted, find the remaining ones on the next update
+    if (update.plugin.isNull())
+    {
+      this->pluginsDirty = true;
+      continue;
+    }
+
+    if (!_force && update.period > std::chrono::steady_clock::duration::zero()
+        && now - update.lastUpdate < update.period)
+    {
+      update.pendingChanges = update.pendingChanges || _changed;
+      pendingChanges = pendingChanges || update.pendingChanges;
+      continue;
+    }
+
+    update.plugin->Update(this->updateInfo, this->ecm);
+    update.lastUpdate = now;
+    update.pendingChanges = false;
+  }
+
+  // Once all plugins have seen the changes, they shouldn't be reported as
+  // changed on the next update.
+  if (!pendingChanges)
   {
-    plugin->Update(this->updateInfo, this->ecm);
+    this->ecm.SetAllComponentsUnchanged();
+    this->ecm.ClearRemovedComponents();
   }
-  this->ecm.ClearRemovedComponents();
 }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "StateMerge.hh"
+
+//////////////////////////////////////////////////
+void ignition::gazebo::mergeState(msgs::SerializedStepMap &_pending,
+    const msgs::SerializedStepMap &_msg)
+{
+  _pending.mutable_stats()->CopyFrom(_msg.stats());
+
+  auto *state = _pending.mutable_state();
+  if (_msg.state().has_one_time_component_changes())
+    state->set_has_one_time_component_changes(true);
+
+  auto &entities = *state->mutable_entities();
+  for (const auto &entityIt : _msg.state().entities())
+  {
+    auto pendingIt = entities.find(entityIt.first);
+    if (pendingIt == entities.end() || entityIt.second.remove() ||
+        pendingIt->second.remove())
+    {
+      entities[entityIt.first] = entityIt.second;
+      continue;
+    }
+
+    auto &components = *pendingIt->second.mutable_components();
+    for (const auto &compIt : entityIt.second.components())
+      components[compIt.first] = compIt.second;
+  }
+}
+
+//////////////////////////////////////////////////
+bool ignition::gazebo::hasRemovals(const msgs::SerializedStateMap &_msg)
+{
+  for (const auto &entityIt : _msg.entities())
+  {
+    if (entityIt.second.remove())
+      return true;
+
+    for (const auto &compIt : entityIt.second.components())
+    {
+      if (compIt.second.remove())
+        return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_GUI_STATEMERGE_HH_
+#define IGNITION_GAZEBO_GUI_STATEMERGE_HH_
+
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include "ignition/gazebo/config.hh"
+#include "ignition/gazebo/gui/Export.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+/// \brief Merge a state message into an older one which hasn't been applied
+/// yet, so only the latest value of each component is applied, while
+/// entity and component creation and removal aren't lost.
+/// \param[in, out] _pending Older message, which receives the new one.
+/// \param[in] _msg New message.
+IGNITION_GAZEBO_GUI_VISIBLE
+void mergeState(msgs::SerializedStepMap &_pending,
+    const msgs::SerializedStepMap &_msg);
+
+/// \brief Check if a state message removes entities or components.
+/// \param[in] _msg State message.
+/// \return True if anything is removed.
+IGNITION_GAZEBO_GUI_VISIBLE
+bool hasRemovals(const msgs::SerializedStateMap &_msg);
+}
+}
+}
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include <string>
+
+#include "StateMerge.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Add a component to an entity of a state message.
+/// \param[in, out] _msg State message.
+/// \param[in] _entity Entity, which is added if missing.
+/// \param[in] _type Component type.
+/// \param[in] _data Serialized component.
+/// \param[in] _remove True if the component is removed.
+static void addComponent(msgs::SerializedStepMap &_msg, uint64_t _entity,
+    int64_t _type, const std::string &_data, bool _remove = false)
+{
+  auto &entity = (*_msg.mutable_state()->mutable_entities())[_entity];
+  entity.set_id(_entity);
+  auto &comp = (*entity.mutable_components())[_type];
+  comp.set_type(_type);
+  comp.set_component(_data);
+  comp.set_remove(_remove);
+}
+
+/// \brief Mark an entity of a state message as removed.
+/// \param[in, out] _msg State message.
+/// \param[in] _entity Entity.
+static void removeEntity(msgs::SerializedStepMap &_msg, uint64_t _entity)
+{
+  auto &entity = (*_msg.mutable_state()->mutable_entities())[_entity];
+  entity.set_id(_entity);
+  entity.set_remove(true);
+}
+
+/////////////////////////////////////////////////
+TEST(StateMergeTest, Changed)
+{
+  msgs::SerializedStepMap pending;
+  pending.mutable_stats()->set_iterations(1u);
+  addComponent(pending, 1u, 10, "a1");
+  addComponent(pending, 1u, 11, "b1");
+
+  msgs::SerializedStepMap msg;
+  msg.mutable_stats()->set_iterations(2u);
+  addComponent(msg, 1u, 10, "a2");
+  addComponent(msg, 1u, 12, "c2");
+
+  mergeState(pending, msg);
+
+  // Latest stats and component values, older components are kept
+  EXPECT_EQ(2u, pending.stats().iterations());
+  ASSERT_EQ(1u, pending.state().entities().size());
+  const auto &comps = pending.state().entities().at(1u).components();
+  ASSERT_EQ(3u, comps.size());
+  EXPECT_EQ("a2", comps.at(10).component());
+  EXPECT_EQ("b1", comps.at(11).component());
+  EXPECT_EQ("c2", comps.at(12).component());
+  EXPECT_FALSE(pending.state().has_one_time_component_changes());
+
+  // One time changes are kept even if the latest message has none
+  msgs::SerializedStepMap oneTime;
+  oneTime.mutable_state()->set_has_one_time_component_changes(true);
+  mergeState(pending, oneTime);
+  mergeState(pending, msg);
+  EXPECT_TRUE(pending.state().has_one_time_component_changes());
+}
+
+/////////////////////////////////////////////////
+TEST(StateMergeTest, Created)
+{
+  msgs::SerializedStepMap pending;
+  addComponent(pending, 1u, 10, "a1");
+
+  // A new entity is added with all its components
+  msgs::SerializedStepMap msg;
+  addComponent(msg, 2u, 10, "a2");
+  addComponent(msg, 2u, 11, "b2");
+  mergeState(pending, msg);
+
+  const auto &entities = pending.state().entities();
+  ASSERT_EQ(2u, entities.size());
+  EXPECT_EQ(1u, entities.at(1u).components().size());
+  ASSERT_EQ(2u, entities.at(2u).components().size());
+  EXPECT_EQ("b2", entities.at(2u).components().at(11).component());
+
+  // An entity created again after being removed replaces the removal
+  removeEntity(pending, 3u);
+  msgs::SerializedStepMap recreated;
+  addComponent(recreated, 3u, 10, "a3");
+  mergeState(pending, recreated);
+  EXPECT_FALSE(entities.at(3u).remove());
+  ASSERT_EQ(1u, entities.at(3u).components().size());
+  EXPECT_EQ("a3", entities.at(3u).components().at(10).component());
+}
+
+/////////////////////////////////////////////////
+TEST(StateMergeTest, Removed)
+{
+  msgs::SerializedStepMap pending;
+  addComponent(pending, 1u, 10, "a1");
+  addComponent(pending, 1u, 11, "b1");
+  addComponent(pending, 2u, 10, "a2");
+  EXPECT_FALSE(hasRemovals(pending.state()));
+
+  // Component removal replaces the older value
+  msgs::SerializedStepMap msg;
+  addComponent(msg, 1u, 11, " ", true);
+  EXPECT_TRUE(hasRemovals(msg.state()));
+  mergeState(pending, msg);
+  EXPECT_TRUE(hasRemovals(pending.state()));
+
+  const auto &entities = pending.state().entities();
+  const auto &comps = entities.at(1u).components();
+  ASSERT_EQ(2u, comps.size());
+  EXPECT_FALSE(comps.at(10).remove());
+  EXPECT_TRUE(comps.at(11).remove());
+
+  // Entity removal replaces the older components
+  msgs::SerializedStepMap removal;
+  removeEntity(removal, 2u);
+  EXPECT_TRUE(hasRemovals(removal.state()));
+  mergeState(pending, removal);
+  EXPECT_TRUE(entities.at(2u).remove());
+  EXPECT_TRUE(entities.at(2u).components().empty());
+}
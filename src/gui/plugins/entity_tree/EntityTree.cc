@@ -17,7 +17,10 @@
 
 #include "EntityTree.hh"
 
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 #include <ignition/common/Console.hh>
@@ -100,103 +103,252 @@ QString entityType(Entity _entity,
 /////////////////////////////////////////////////
 TreeModel::TreeModel() : QStandardItemModel()
 {
+  // Top-level entities always have items
+  this->fetchedEntities.insert(kNullEntity);
 }
 
 /////////////////////////////////////////////////
-void TreeModel::AddEntity(unsigned int _entity, const QString &_entityName,
-    unsigned int _parentEntity, const QString &_type)
+void TreeModel::QueueChanges(std::vector<EntityInfo> &&_toAdd,
+    std::vector<Entity> &&_toRemove)
 {
-  IGN_PROFILE_THREAD_NAME("Qt thread");
-  IGN_PROFILE("TreeModel::AddEntity");
-  QStandardItem *parentItem{nullptr};
+  if (_toAdd.empty() && _toRemove.empty())
+    return;
 
-  // Root
-  if (_parentEntity == kNullEntity)
+  bool wasEmpty{false};
   {
-    parentItem = this->invisibleRootItem();
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    wasEmpty = this->queuedAdditions.empty() && this->queuedRemovals.empty();
+    this->queuedAdditions.insert(this->queuedAdditions.end(),
+        std::make_move_iterator(_toAdd.begin()),
+        std::make_move_iterator(_toAdd.end()));
+    this->queuedRemovals.insert(this->queuedRemovals.end(),
+        _toRemove.begin(), _toRemove.end());
   }
 
-  // Nested
-  // TODO(louise) There should be a way to easily access these from
-  // QStandardItemModel instead of keeping our own map
-  auto item = this->entityItems.find(_parentEntity);
-  if (item != this->entityItems.end())
+  // A single call processes everything queued until it runs
+  if (wasEmpty)
+    QMetaObject::invokeMethod(this, "ProcessQueue", Qt::QueuedConnection);
+}
+
+/////////////////////////////////////////////////
+void TreeModel::ProcessQueue()
+{
+  IGN_PROFILE_THREAD_NAME("Qt thread");
+  IGN_PROFILE("TreeModel::ProcessQueue");
+  std::vector<EntityInfo> toAdd;
+  std::vector<Entity> toRemove;
   {
-    parentItem = item->second;
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    toAdd.swap(this->queuedAdditions);
+    toRemove.swap(this->queuedRemovals);
   }
 
-  if (nullptr == parentItem)
+  this->AddEntities(toAdd);
+  for (auto entity : toRemove)
+    this->RemoveEntity(entity);
+}
+
+/////////////////////////////////////////////////
+void TreeModel::AddEntity(unsigned int _entity, const QString &_entityName,
+    unsigned int _parentEntity, const QString &_type)
+{
+  this->AddEntities({{_entity, _entityName, _parentEntity, _type}});
+}
+
+/////////////////////////////////////////////////
+void TreeModel::AddEntities(const std::vector<EntityInfo> &_entities)
+{
+  IGN_PROFILE("TreeModel::AddEntities");
+
+  // New items, grouped by parent so each parent gets a single insertion
+  std::unordered_map<Entity, QList<QStandardItem *>> newItems;
+  std::vector<Entity> parentOrder;
+
+  for (const auto &info : _entities)
   {
-    this->pendingEntities.push_back(
-      {_entity, _entityName, _parentEntity, _type});
-    return;
+    if (this->entityInfos.find(info.entity) != this->entityInfos.end())
+      continue;
+
+    this->entityInfos[info.entity] = info;
+    this->entityChildren[info.parentEntity].insert(info.entity);
+
+    // Only create items for entities whose parent's children are shown. Its
+    // parent may be new in this batch too.
+    if (this->fetchedEntities.find(info.parentEntity) ==
+        this->fetchedEntities.end())
+    {
+      continue;
+    }
+
+    auto parentItems = newItems.find(info.parentEntity);
+    if (parentItems == newItems.end())
+    {
+      parentOrder.push_back(info.parentEntity);
+      parentItems = newItems.insert({info.parentEntity, {}}).first;
+    }
+    parentItems->second.append(this->CreateItem(info));
+  }
+
+  for (auto parent : parentOrder)
+  {
+    QStandardItem *parentItem{nullptr};
+    if (parent == kNullEntity)
+    {
+      parentItem = this->invisibleRootItem();
+    }
+    else
+    {
+      auto itemIt = this->entityItems.find(parent);
+      if (itemIt == this->entityItems.end())
+        continue;
+      parentItem = itemIt->second;
+    }
+    parentItem->appendRows(newItems[parent]);
   }
+}
 
-  // New entity item
-  auto entityItem = new QStandardItem(_entityName);
-  entityItem->setData(_entityName, this->roleNames().key("entityName"));
-  entityItem->setData(QString::number(_entity),
+/////////////////////////////////////////////////
+QStandardItem *TreeModel::CreateItem(const EntityInfo &_info)
+{
+  auto entityItem = new QStandardItem(_info.name);
+  entityItem->setData(_info.name, this->roleNames().key("entityName"));
+  entityItem->setData(QString::number(_info.entity),
       this->roleNames().key("entity"));
-  entityItem->setData(_type, this->roleNames().key("type"));
+  entityItem->setData(_info.type, this->roleNames().key("type"));
 
-  parentItem->appendRow(entityItem);
+  this->entityItems[_info.entity] = entityItem;
+  return entityItem;
+}
 
-  this->entityItems[_entity] = entityItem;
+/////////////////////////////////////////////////
+void TreeModel::CreateChildItems(Entity _entity)
+{
+  if (this->fetchedEntities.find(_entity) != this->fetchedEntities.end())
+    return;
 
-  // Check if there are pending children
-  auto sep = std::partition(this->pendingEntities.begin(),
-      this->pendingEntities.end(), [&_entity](const EntityInfo &_entityInfo)
-      {
-        return _entityInfo.parentEntity != _entity;
-      });
+  auto itemIt = this->entityItems.find(_entity);
+  if (itemIt == this->entityItems.end())
+    return;
+
+  IGN_PROFILE("TreeModel::CreateChildItems");
+  this->fetchedEntities.insert(_entity);
 
-  for (auto it = sep; it != this->pendingEntities.end(); ++it)
+  auto childrenIt = this->entityChildren.find(_entity);
+  if (childrenIt == this->entityChildren.end())
+    return;
+
+  QList<QStandardItem *> items;
+  for (auto child : childrenIt->second)
   {
-    this->AddEntity(it->entity, it->name, it->parentEntity, it->type);
+    auto infoIt = this->entityInfos.find(child);
+    if (infoIt != this->entityInfos.end())
+      items.append(this->CreateItem(infoIt->second));
   }
-  this->pendingEntities.erase(sep, this->pendingEntities.end());
+  itemIt->second->appendRows(items);
 }
 
 /////////////////////////////////////////////////
-void TreeModel::RemoveEntity(unsigned int _entity)
+Entity TreeModel::EntityFromIndex(const QModelIndex &_index) const
 {
-  IGN_PROFILE("TreeModel::RemoveEntity");
-  QStandardItem *item{nullptr};
-  auto itemIt = this->entityItems.find(_entity);
-  if (itemIt != this->entityItems.end())
+  if (!_index.isValid())
+    return kNullEntity;
+  return this->EntityId(_index);
+}
+
+/////////////////////////////////////////////////
+bool TreeModel::hasChildren(const QModelIndex &_parent) const
+{
+  auto entity = this->EntityFromIndex(_parent);
+  if (entity == kNullEntity)
+    return QStandardItemModel::hasChildren(_parent);
+
+  auto childrenIt = this->entityChildren.find(entity);
+  return childrenIt != this->entityChildren.end() &&
+      !childrenIt->second.empty();
+}
+
+/////////////////////////////////////////////////
+bool TreeModel::canFetchMore(const QModelIndex &_parent) const
+{
+  auto entity = this->EntityFromIndex(_parent);
+  return entity != kNullEntity &&
+      this->fetchedEntities.find(entity) == this->fetchedEntities.end() &&
+      this->hasChildren(_parent);
+}
+
+/////////////////////////////////////////////////
+void TreeModel::fetchMore(const QModelIndex &_parent)
+{
+  this->CreateChildItems(this->EntityFromIndex(_parent));
+}
+
+/////////////////////////////////////////////////
+QModelIndex TreeModel::IndexFromEntity(unsigned int _entity)
+{
+  if (this->entityInfos.find(_entity) == this->entityInfos.end())
+    return QModelIndex();
+
+  // Create the items of all ancestors, from the top
+  std::vector<Entity> ancestors;
+  for (auto infoIt = this->entityInfos.find(
+          this->entityInfos[_entity].parentEntity);
+      infoIt != this->entityInfos.end();
+      infoIt = this->entityInfos.find(infoIt->second.parentEntity))
   {
-    item = itemIt->second;
+    ancestors.push_back(infoIt->first);
   }
+  for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it)
+    this->CreateChildItems(*it);
 
-  if (nullptr == item)
-  {
-    // See if it's pending
-    auto toRemove = std::remove_if(this->pendingEntities.begin(),
-        this->pendingEntities.end(), [&_entity](const EntityInfo &_entityInfo)
-        {
-          return _entityInfo.entity == _entity;
-        });
-    this->pendingEntities.erase(toRemove, this->pendingEntities.end());
+  auto itemIt = this->entityItems.find(_entity);
+  if (itemIt == this->entityItems.end())
+    return QModelIndex();
+  return itemIt->second->index();
+}
 
+/////////////////////////////////////////////////
+void TreeModel::RemoveEntity(unsigned int _entity)
+{
+  IGN_PROFILE("TreeModel::RemoveEntity");
+  auto infoIt = this->entityInfos.find(_entity);
+  if (infoIt == this->entityInfos.end())
     return;
+
+  auto parentChildren = this->entityChildren.find(infoIt->second.parentEntity);
+  if (parentChildren != this->entityChildren.end())
+  {
+    parentChildren->second.erase(_entity);
+    if (parentChildren->second.empty())
+      this->entityChildren.erase(parentChildren);
   }
 
-  // Remove all children from our custom map
-  std::function<void(const QStandardItem *)> removeChildren =
-      [&](const QStandardItem *_item)
+  // Forget the entity and its descendants
+  std::function<void(Entity)> forget = [&](Entity _e)
   {
-    for (int i = 0; i < _item->rowCount(); ++i)
-    {
-      auto childItem = _item->child(i);
-      removeChildren(childItem);
-      this->entityItems.erase(childItem->data(
-          this->roleNames().key("entity")).toUInt());
-    }
+    this->entityInfos.erase(_e);
+    this->entityItems.erase(_e);
+    this->fetchedEntities.erase(_e);
+
+    auto childrenIt = this->entityChildren.find(_e);
+    if (childrenIt == this->entityChildren.end())
+      return;
+    auto children = std::move(childrenIt->second);
+    this->entityChildren.erase(childrenIt);
+    for (auto child : children)
+      forget(child);
   };
-  this->entityItems.erase(_entity);
-  removeChildren(item);
+
+  QStandardItem *item{nullptr};
+  auto itemIt = this->entityItems.find(_entity);
+  if (itemIt != this->entityItems.end())
+    item = itemIt->second;
+
+  forget(_entity);
 
   // Remove from the view
+  if (nullptr == item)
+    return;
+
   if (nullptr == item->parent())
     this->removeRow(item->row());
   else
@@ -288,6 +440,9 @@ void EntityTree::LoadConfig(const tinyxml2::XMLElement *)
 void EntityTree::Update(const UpdateInfo &, EntityComponentManager &_ecm)
 {
   IGN_PROFILE("EntityTree::Update");
+  std::vector<TreeModel::EntityInfo> toAdd;
+  std::vector<Entity> toRemove;
+
   // Treat all pre-existent entities as new at startup
   if (!this->dataPtr->initialized)
   {
@@ -313,19 +468,10 @@ void EntityTree::Update(const UpdateInfo &, EntityComponentManager &_ecm)
         parentEntity = parentComp->Data();
       }
 
-      // World children are top-level
-      if (this->dataPtr->worldEntity != kNullEntity &&
-          parentEntity == this->dataPtr->worldEntity)
-      {
-        parentEntity = kNullEntity;
-      }
-
-      QMetaObject::invokeMethod(&this->dataPtr->treeModel, "AddEntity",
-          Qt::QueuedConnection,
-          Q_ARG(unsigned int, _entity),
-          Q_ARG(QString, QString::fromStdString(_name->Data())),
-          Q_ARG(unsigned int, parentEntity),
-          Q_ARG(QString, entityType(_entity, _ecm)));
+      toAdd.push_back({static_cast<unsigned int>(_entity),
+          QString::fromStdString(_name->Data()),
+          static_cast<unsigned int>(parentEntity),
+          entityType(_entity, _ecm)});
       return true;
     });
 
@@ -341,34 +487,35 @@ void EntityTree::Update(const UpdateInfo &, EntityComponentManager &_ecm)
           const components::Name *_name,
           const components::ParentEntity *_parentEntity)->bool
     {
-      auto parentEntity = _parentEntity->Data();
-
-      // World children are top-level
-      if (this->dataPtr->worldEntity != kNullEntity &&
-          parentEntity == this->dataPtr->worldEntity)
-      {
-        parentEntity = kNullEntity;
-      }
-
-      QMetaObject::invokeMethod(&this->dataPtr->treeModel, "AddEntity",
-          Qt::QueuedConnection,
-          Q_ARG(unsigned int, _entity),
-          Q_ARG(QString, QString::fromStdString(_name->Data())),
-          Q_ARG(unsigned int, parentEntity),
-          Q_ARG(QString, entityType(_entity, _ecm)));
+      toAdd.push_back({static_cast<unsigned int>(_entity),
+          QString::fromStdString(_name->Data()),
+          static_cast<unsigned int>(_parentEntity->Data()),
+          entityType(_entity, _ecm)});
       return true;
     });
   }
 
+  // World children are top-level. The world may be found after some of its
+  // children on the first update.
+  for (auto &info : toAdd)
+  {
+    if (this->dataPtr->worldEntity != kNullEntity &&
+        info.parentEntity == this->dataPtr->worldEntity)
+    {
+      info.parentEntity = kNullEntity;
+    }
+  }
+
   _ecm.EachRemoved<components::Name>(
     [&](const Entity &_entity,
         const components::Name *)->bool
   {
-    QMetaObject::invokeMethod(&this->dataPtr->treeModel, "RemoveEntity",
-        Qt::QueuedConnection,
-        Q_ARG(unsigned int, _entity));
+    toRemove.push_back(_entity);
     return true;
   });
+
+  this->dataPtr->treeModel.QueueChanges(std::move(toAdd),
+      std::move(toRemove));
 }
 
 /////////////////////////////////////////////////
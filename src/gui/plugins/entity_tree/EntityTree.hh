@@ -18,8 +18,11 @@
 #ifndef IGNITION_GAZEBO_GUI_ENTITYTREE_HH_
 #define IGNITION_GAZEBO_GUI_ENTITYTREE_HH_
 
-#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <ignition/gazebo/gui/GuiSystem.hh>
@@ -30,11 +33,33 @@ namespace gazebo
 {
   class EntityTreePrivate;
 
-  /// \brief TODO
+  /// \brief Model of the entity tree.
+  ///
+  /// All entities are known to the model, but items are only created for
+  /// top-level entities and for the children of items which have been
+  /// expanded, so large worlds don't need an item per entity.
   class TreeModel : public QStandardItemModel
   {
     Q_OBJECT
 
+    /// \brief Entity information used to queue the pending entities
+    public: struct EntityInfo
+    {
+      /// \brief Entity ID
+      // cppcheck-suppress unusedStructMember
+      unsigned int entity;
+
+      /// \brief Entity name
+      QString name;
+
+      /// \brief Parent ID
+      // cppcheck-suppress unusedStructMember
+      unsigned int parentEntity;
+
+      /// \brief Entity type
+      QString type;
+    };
+
     /// \brief Constructor
     public: explicit TreeModel();
 
@@ -44,6 +69,27 @@ namespace gazebo
     // Documentation inherited
     public: QHash<int, QByteArray> roleNames() const override;
 
+    // Documentation inherited
+    public: bool hasChildren(
+        const QModelIndex &_parent = QModelIndex()) const override;
+
+    // Documentation inherited
+    public: bool canFetchMore(const QModelIndex &_parent) const override;
+
+    // Documentation inherited
+    public: void fetchMore(const QModelIndex &_parent) override;
+
+    /// \brief Queue entities to be added and removed. This can be called
+    /// from any thread, and the changes are applied in a single batch on the
+    /// Qt thread.
+    /// \param[in] _toAdd Entities to be added.
+    /// \param[in] _toRemove Entities to be removed.
+    public: void QueueChanges(std::vector<EntityInfo> &&_toAdd,
+        std::vector<Entity> &&_toRemove);
+
+    /// \brief Apply the changes queued with QueueChanges.
+    public slots: void ProcessQueue();
+
     /// \brief Add an entity to the tree.
     /// \param[in] _entity Entity to be added
     /// \param[in] _entityName Name of entity to be added
@@ -74,30 +120,54 @@ namespace gazebo
     /// \return Entity ID
     public: Q_INVOKABLE unsigned int EntityId(const QModelIndex &_index) const;
 
-    /// \brief Keep track of which item corresponds to which entity.
-    private: std::map<Entity, QStandardItem *> entityItems;
+    /// \brief Get the index of an entity, creating the items of its
+    /// ancestors' children if needed.
+    /// \param[in] _entity Entity ID
+    /// \return Model index, invalid if the entity isn't in the tree.
+    public: Q_INVOKABLE QModelIndex IndexFromEntity(unsigned int _entity);
 
-    /// \brief Entity information used to queue the pending entities
-    struct EntityInfo
-    {
-      /// \brief Entity ID
-      // cppcheck-suppress unusedStructMember
-      unsigned int entity;
+    /// \brief Add entities to the tree, creating items for those whose
+    /// parent's children are shown.
+    /// \param[in] _entities Entities to be added.
+    private: void AddEntities(const std::vector<EntityInfo> &_entities);
 
-      /// \brief Entity name
-      QString name;
+    /// \brief Create items for the children of an entity.
+    /// \param[in] _entity Parent entity, kNullEntity for top-level entities.
+    private: void CreateChildItems(Entity _entity);
 
-      /// \brief Parent ID
-      // cppcheck-suppress unusedStructMember
-      unsigned int parentEntity;
+    /// \brief Create the item of an entity, without adding it to the model.
+    /// \param[in] _info Entity information.
+    /// \return New item.
+    private: QStandardItem *CreateItem(const EntityInfo &_info);
 
-      /// \brief Entity type
-      QString type;
-    };
+    /// \brief Get the entity of an item.
+    /// \param[in] _index Model index of the item.
+    /// \return Entity, kNullEntity for the root.
+    private: Entity EntityFromIndex(const QModelIndex &_index) const;
+
+    /// \brief Information of all entities in the tree, including those
+    /// without an item.
+    private: std::unordered_map<Entity, EntityInfo> entityInfos;
+
+    /// \brief Children of each entity, kNullEntity for top-level entities.
+    /// Entities whose parent hasn't been added yet are also listed, so they
+    /// show up once their parent does.
+    private: std::unordered_map<Entity, std::set<Entity>> entityChildren;
+
+    /// \brief Keep track of which item corresponds to which entity.
+    private: std::unordered_map<Entity, QStandardItem *> entityItems;
+
+    /// \brief Entities whose children have items.
+    private: std::unordered_set<Entity> fetchedEntities;
+
+    /// \brief Protects the queued changes.
+    private: std::mutex queueMutex;
+
+    /// \brief Entities queued to be added.
+    private: std::vector<EntityInfo> queuedAdditions;
 
-    /// \brief If an entity is added before its parent, we queue it in this
-    /// vector until their parent shows up or they are deleted.
-    private: std::vector<EntityInfo> pendingEntities;
+    /// \brief Entities queued to be removed.
+    private: std::vector<Entity> queuedRemovals;
   };
 
   /// \brief Displays a tree view with all the entities in the world.
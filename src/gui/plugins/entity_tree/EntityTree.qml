@@ -61,28 +61,16 @@ Rectangle {
     tree.selection.clear()
   }
 
-  /*
-   * Iterate through item's children until the one corresponding to _entity is
-   * found and select that.
-   */
-  function selectFromCpp(_entity, itemId) {
-    if (EntityTreeModel.data(itemId, 101) == _entity) {
-      tree.selection.select(itemId, ItemSelectionModel.Select)
-      return
-    }
-    for (var i = 0; i < EntityTreeModel.rowCount(itemId); i++) {
-      selectFromCpp(_entity, EntityTreeModel.index(i, 0, itemId))
-    }
-  }
-
   /*
    * Callback when an entity selection comes from the C++ code.
    * For example, if it comes from the 3D window.
+   * Items are created lazily, so the model creates the entity's item if
+   * needed.
    */
   function onEntitySelectedFromCpp(_entity) {
-    for(var i = 0; i < EntityTreeModel.rowCount(); i++) {
-      var itemId = EntityTreeModel.index(i, 0)
-      selectFromCpp(_entity, itemId)
+    var itemId = EntityTreeModel.IndexFromEntity(_entity)
+    if (itemId.valid) {
+      tree.selection.select(itemId, ItemSelectionModel.Select)
     }
   }
 
@@ -92,6 +80,13 @@ Rectangle {
     model: EntityTreeModel
     selectionMode: SelectionMode.MultiSelection
 
+    // Children items are only created once their parent is expanded
+    onExpanded: {
+      if (EntityTreeModel.canFetchMore(index)) {
+        EntityTreeModel.fetchMore(index)
+      }
+    }
+
     // Hacky: the sibling of listView is the background(Rectangle) of TreeView
     Component.onCompleted: {
       tree.__listView.parent.children[1].color = Material.background
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "EntityTree.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Get the index of the child of a model index with a given entity.
+/// \param[in] _model Tree model
+/// \param[in] _parent Parent index
+/// \param[in] _entity Child entity
+/// \return Child index, invalid if there's no such child item
+static QModelIndex childIndex(const TreeModel &_model,
+    const QModelIndex &_parent, Entity _entity)
+{
+  for (int i = 0; i < _model.rowCount(_parent); ++i)
+  {
+    auto index = _model.index(i, 0, _parent);
+    if (_model.EntityId(index) == _entity)
+      return index;
+  }
+  return QModelIndex();
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTreeTest, LazyFetch)
+{
+  TreeModel model;
+  model.AddEntity(1u, "model", kNullEntity, "model");
+  model.AddEntity(2u, "link", 1u, "link");
+  model.AddEntity(3u, "visual", 2u, "visual");
+  model.AddEntity(4u, "other", kNullEntity, "model");
+
+  // Only top-level entities have items
+  ASSERT_EQ(2, model.rowCount());
+  auto modelIndex = childIndex(model, QModelIndex(), 1u);
+  ASSERT_TRUE(modelIndex.isValid());
+  EXPECT_EQ(QString("model"), model.EntityType(modelIndex));
+
+  // Children are known, but not created until they're fetched
+  EXPECT_TRUE(model.hasChildren(modelIndex));
+  EXPECT_EQ(0, model.rowCount(modelIndex));
+  EXPECT_TRUE(model.canFetchMore(modelIndex));
+
+  auto otherIndex = childIndex(model, QModelIndex(), 4u);
+  ASSERT_TRUE(otherIndex.isValid());
+  EXPECT_FALSE(model.hasChildren(otherIndex));
+  EXPECT_FALSE(model.canFetchMore(otherIndex));
+
+  model.fetchMore(modelIndex);
+  EXPECT_FALSE(model.canFetchMore(modelIndex));
+  ASSERT_EQ(1, model.rowCount(modelIndex));
+
+  // Only one level is fetched at a time
+  auto linkIndex = childIndex(model, modelIndex, 2u);
+  ASSERT_TRUE(linkIndex.isValid());
+  EXPECT_TRUE(model.hasChildren(linkIndex));
+  EXPECT_EQ(0, model.rowCount(linkIndex));
+  EXPECT_TRUE(model.canFetchMore(linkIndex));
+
+  // New children of fetched entities get items right away
+  model.AddEntity(5u, "link2", 1u, "link");
+  EXPECT_EQ(2, model.rowCount(modelIndex));
+  EXPECT_TRUE(childIndex(model, modelIndex, 5u).isValid());
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTreeTest, IndexFromEntity)
+{
+  TreeModel model;
+  model.AddEntity(1u, "model", kNullEntity, "model");
+  model.AddEntity(2u, "link", 1u, "link");
+  model.AddEntity(3u, "visual", 2u, "visual");
+
+  // Ancestors' children are created to reach a nested entity
+  auto visualIndex = model.IndexFromEntity(3u);
+  ASSERT_TRUE(visualIndex.isValid());
+  EXPECT_EQ(3u, model.EntityId(visualIndex));
+  EXPECT_EQ(QString("visual"), model.EntityType(visualIndex));
+  EXPECT_EQ(QString("model::link::visual"), model.ScopedName(visualIndex));
+
+  auto modelIndex = model.IndexFromEntity(1u);
+  ASSERT_TRUE(modelIndex.isValid());
+  EXPECT_FALSE(model.canFetchMore(modelIndex));
+  EXPECT_EQ(1, model.rowCount(modelIndex));
+
+  // Unknown entities
+  EXPECT_FALSE(model.IndexFromEntity(99u).isValid());
+  EXPECT_FALSE(model.IndexFromEntity(kNullEntity).isValid());
+
+  // Entities added before their parent show up once the parent is added
+  model.AddEntity(11u, "orphan", 10u, "link");
+  EXPECT_FALSE(model.IndexFromEntity(11u).isValid());
+  EXPECT_EQ(1, model.rowCount());
+
+  model.AddEntity(10u, "parent", kNullEntity, "model");
+  EXPECT_EQ(2, model.rowCount());
+  auto orphanIndex = model.IndexFromEntity(11u);
+  ASSERT_TRUE(orphanIndex.isValid());
+  EXPECT_EQ(QString("parent::orphan"), model.ScopedName(orphanIndex));
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTreeTest, Remove)
+{
+  TreeModel model;
+  model.AddEntity(1u, "model", kNullEntity, "model");
+  model.AddEntity(2u, "link", 1u, "link");
+  model.AddEntity(3u, "visual", 2u, "visual");
+  ASSERT_TRUE(model.IndexFromEntity(3u).isValid());
+
+  // Removing an entity removes its descendants and their items
+  model.RemoveEntity(2u);
+  EXPECT_FALSE(model.IndexFromEntity(2u).isValid());
+  EXPECT_FALSE(model.IndexFromEntity(3u).isValid());
+
+  auto modelIndex = model.IndexFromEntity(1u);
+  ASSERT_TRUE(modelIndex.isValid());
+  EXPECT_EQ(0, model.rowCount(modelIndex));
+  EXPECT_FALSE(model.hasChildren(modelIndex));
+
+  // Entities without items yet are removed too
+  model.AddEntity(2u, "link", 1u, "link");
+  model.AddEntity(3u, "visual", 2u, "visual");
+  model.RemoveEntity(3u);
+  auto linkIndex = model.IndexFromEntity(2u);
+  ASSERT_TRUE(linkIndex.isValid());
+  EXPECT_FALSE(model.hasChildren(linkIndex));
+  EXPECT_FALSE(model.IndexFromEntity(3u).isValid());
+
+  // Top-level entities, and unknown ones
+  model.RemoveEntity(1u);
+  model.RemoveEntity(99u);
+  EXPECT_EQ(0, model.rowCount());
+  EXPECT_FALSE(model.IndexFromEntity(2u).isValid());
+}
+
+/////////////////////////////////////////////////
+TEST(EntityTreeTest, Queue)
+{
+  TreeModel model;
+
+  // Queued changes are applied in a single batch, additions first
+  std::vector<TreeModel::EntityInfo> toAdd{
+      {1u, "model", kNullEntity, "model"},
+      {2u, "link", 1u, "link"},
+      {3u, "model2", kNullEntity, "model"}};
+  model.QueueChanges(std::move(toAdd), {3u});
+  EXPECT_EQ(0, model.rowCount());
+
+  model.ProcessQueue();
+  EXPECT_EQ(1, model.rowCount());
+  EXPECT_TRUE(model.IndexFromEntity(2u).isValid());
+  EXPECT_FALSE(model.IndexFromEntity(3u).isValid());
+
+  // Nothing is left in the queue
+  model.ProcessQueue();
+  EXPECT_EQ(1, model.rowCount());
+
+  // Entities which are already known aren't added twice
+  model.QueueChanges({{1u, "model", kNullEntity, "model"}}, {});
+  model.ProcessQueue();
+  EXPECT_EQ(1, model.rowCount());
+}
@@ -17,6 +17,13 @@
 
 #include "Plotting.hh"
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
 #include <ignition/plugin/Register.hh>
 
 #include "ignition/gazebo/components/AngularAcceleration.hh"
@@ -40,8 +47,20 @@
 
 namespace ignition::gazebo
 {
+  /// \brief How often new samples are sent to the charts.
+  static constexpr std::chrono::milliseconds kPublishPeriod{50};
+
+  /// \brief Maximum number of points sent to a chart per attribute and
+  /// publication, so the charts receive a bounded number of points per
+  /// second whatever the update rate. Samples in excess are decimated,
+  /// keeping the extremes.
+  static constexpr std::size_t kMaxPointsPerPublish{32};
+
   class PlottingPrivate
   {
+    /// \brief Send the samples taken since the last call to the charts.
+    public: void Publish();
+
     /// \brief Interface to communicate with Qml
     public: std::unique_ptr<gui::PlottingInterface> plottingIface{nullptr};
 
@@ -52,6 +71,19 @@ namespace ignition::gazebo
 
     /// \brief Mutex to protect the components map.
     public: std::recursive_mutex componentsMutex;
+
+    /// \brief Thread which sends samples to the charts, so the update thread
+    /// only records them.
+    public: std::thread publishThread;
+
+    /// \brief Mutex to protect stopPublishing.
+    public: std::mutex publishMutex;
+
+    /// \brief Notifies the publish thread to stop.
+    public: std::condition_variable publishCv;
+
+    /// \brief True when the publish thread should stop.
+    public: bool stopPublishing{false};
   };
 
   class PlotComponentPrivate
@@ -69,6 +101,10 @@ namespace ignition::gazebo
     /// ex: x,y,z attributes in Vector3d type component
     public: std::map<std::string,
       std::shared_ptr<ignition::gui::PlotData>> data;
+
+    /// \brief Samples not sent to the charts yet, for the attributes which
+    /// have charts.
+    public: std::map<std::string, std::unique_ptr<TimeSeries>> series;
   };
 }
 
@@ -148,6 +184,12 @@ void PlotComponent::RegisterChart(std::string _attribute, int _chart)
     return;
   }
   this->dataPtr->data[_attribute]->AddChart(_chart);
+
+  if (this->dataPtr->series.count(_attribute) == 0)
+  {
+    this->dataPtr->series[_attribute] =
+        std::make_unique<TimeSeries>(kMaxPointsPerPublish);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -159,6 +201,9 @@ void PlotComponent::UnRegisterChart(std::string _attribute, int _chart)
     return;
   }
   this->dataPtr->data[_attribute]->RemoveChart(_chart);
+
+  if (this->dataPtr->data[_attribute]->ChartCount() == 0)
+    this->dataPtr->series.erase(_attribute);
 }
 
 //////////////////////////////////////////////////
@@ -178,6 +223,23 @@ void PlotComponent::SetAttributeValue(std::string _attribute,
     this->dataPtr->data[_attribute]->SetValue(_value);
 }
 
+//////////////////////////////////////////////////
+void PlotComponent::Sample(double _time)
+{
+  for (auto &[attribute, series] : this->dataPtr->series)
+    series->Append(_time, this->dataPtr->data[attribute]->Value());
+}
+
+//////////////////////////////////////////////////
+std::vector<TimeSeries::Point> PlotComponent::TakePoints(
+    const std::string &_attribute)
+{
+  auto it = this->dataPtr->series.find(_attribute);
+  if (it == this->dataPtr->series.end())
+    return {};
+  return it->second->Take();
+}
+
 //////////////////////////////////////////////////
 std::map<std::string, std::shared_ptr<PlotData>> PlotComponent::Data() const
 {
@@ -215,11 +277,60 @@ Plotting::Plotting() : GuiSystem(),
 
   this->connect(this->dataPtr->plottingIface.get(),
           SIGNAL(ComponentName(uint64_t)), this, SLOT(ComponentName(uint64_t)));
+
+  this->dataPtr->publishThread = std::thread([this]()
+  {
+    IGN_PROFILE_THREAD_NAME("Plotting");
+    std::unique_lock<std::mutex> lock(this->dataPtr->publishMutex);
+    while (!this->dataPtr->publishCv.wait_for(lock, kPublishPeriod,
+        [this]{return this->dataPtr->stopPublishing;}))
+    {
+      lock.unlock();
+      this->dataPtr->Publish();
+      lock.lock();
+    }
+  });
 }
 
 //////////////////////////////////////////////////
 Plotting::~Plotting()
 {
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->publishMutex);
+    this->dataPtr->stopPublishing = true;
+  }
+  this->dataPtr->publishCv.notify_all();
+  if (this->dataPtr->publishThread.joinable())
+    this->dataPtr->publishThread.join();
+}
+
+//////////////////////////////////////////////////
+void PlottingPrivate::Publish()
+{
+  IGN_PROFILE("PlottingPrivate::Publish");
+  std::lock_guard<std::recursive_mutex> lock(this->componentsMutex);
+  for (const auto &[id, component] : this->components)
+  {
+    for (const auto &[attribute, data] : component->Data())
+    {
+      if (data->ChartCount() == 0)
+        continue;
+
+      auto points = component->TakePoints(attribute);
+      if (points.empty())
+        continue;
+
+      QString attributeName = QString::fromStdString(id + "," + attribute);
+      for (auto chart : data->Charts())
+      {
+        for (const auto &point : points)
+        {
+          emit this->plottingIface->plot(chart, attributeName, point.x,
+              point.y);
+        }
+      }
+    }
+  }
 }
 
 //////////////////////////////////////////
@@ -376,8 +487,11 @@ std::string Plotting::ComponentName(const uint64_t &_typeId)
 void Plotting::Update(const ignition::gazebo::UpdateInfo &_info,
                        ignition::gazebo::EntityComponentManager &_ecm)
 {
+  IGN_PROFILE("Plotting::Update");
+  double time = std::chrono::duration<double>(_info.simTime).count();
+
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->componentsMutex);
-  for (auto component : this->dataPtr->components)
+  for (const auto &component : this->dataPtr->components)
   {
     auto entity = component.second->Entity();
     auto typeId = component.second->TypeId();
@@ -504,19 +618,8 @@ void Plotting::Update(const ignition::gazebo::UpdateInfo &_info,
       }
     }
 
-    for (auto attribute : component.second->Data())
-    {
-      for (auto chart : attribute.second->Charts())
-      {
-        QString attributeName = QString::fromStdString(
-                    component.first + "," + attribute.first);
-        double y = attribute.second->Value();
-
-        double x = _info.simTime.count() * std::pow(10, -9);
-
-        emit this->dataPtr->plottingIface->plot(chart, attributeName, x, y);
-      }
-    }
+    // Charts are fed from the publish thread
+    component.second->Sample(time);
   }
 }
 
@@ -30,6 +30,9 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
+
+#include "TimeSeries.hh"
 
 namespace ignition {
 
@@ -73,6 +76,18 @@ class PlotComponent
   /// \param[in] _value value to be set to the attribute
   public: void SetAttributeValue(std::string _attribute, const double &_value);
 
+  /// \brief Record the current value of the attributes which have charts.
+  /// \param[in] _time Time of the sample, usually sim time in seconds.
+  public: void Sample(double _time);
+
+  /// \brief Get the samples of an attribute recorded since the previous
+  /// call, decimated to a bounded number of points.
+  /// \param[in] _attribute Component attribute.
+  /// \return Points in increasing time, empty if the attribute has no
+  /// charts.
+  public: std::vector<TimeSeries::Point> TakePoints(
+      const std::string &_attribute);
+
   /// \brief Get all attributes of the component
   /// \return component attributes
   public: std::map<std::string, std::shared_ptr<ignition::gui::PlotData>>
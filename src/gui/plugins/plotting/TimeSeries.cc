@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "TimeSeries.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ignition::gazebo
+{
+  /// \brief Minimum and maximum of consecutive samples.
+  struct TimeSeriesBucket
+  {
+    /// \brief Sample with the lowest value.
+    TimeSeries::Point min;
+
+    /// \brief Sample with the highest value.
+    TimeSeries::Point max;
+  };
+
+  class TimeSeriesPrivate
+  {
+    /// \brief Complete buckets, in increasing time.
+    public: std::vector<TimeSeriesBucket> buckets;
+
+    /// \brief Bucket still receiving samples.
+    public: TimeSeriesBucket pending;
+
+    /// \brief Number of samples in the pending bucket.
+    public: std::size_t pendingCount{0};
+
+    /// \brief Number of samples in a complete bucket.
+    public: std::size_t samplesPerBucket{1};
+
+    /// \brief Maximum number of buckets, including the pending one.
+    public: std::size_t capacity{16};
+  };
+}
+
+using namespace ignition::gazebo;
+
+/// \brief Add a bucket's samples to another bucket.
+/// \param[in, out] _into Bucket to be extended.
+/// \param[in] _bucket Later samples.
+static void mergeBucket(TimeSeriesBucket &_into,
+    const TimeSeriesBucket &_bucket)
+{
+  if (_bucket.min.y < _into.min.y)
+    _into.min = _bucket.min;
+  if (_bucket.max.y > _into.max.y)
+    _into.max = _bucket.max;
+}
+
+/// \brief Add a bucket's extremes to a list of points, in time order.
+/// \param[in] _bucket Bucket.
+/// \param[in, out] _points Points.
+static void appendExtremes(const TimeSeriesBucket &_bucket,
+    std::vector<TimeSeries::Point> &_points)
+{
+  if (_bucket.min.x == _bucket.max.x)
+  {
+    _points.push_back(_bucket.min);
+  }
+  else if (_bucket.min.x < _bucket.max.x)
+  {
+    _points.push_back(_bucket.min);
+    _points.push_back(_bucket.max);
+  }
+  else
+  {
+    _points.push_back(_bucket.max);
+    _points.push_back(_bucket.min);
+  }
+}
+
+//////////////////////////////////////////////////
+TimeSeries::TimeSeries(std::size_t _maxPoints)
+  : dataPtr(std::make_unique<TimeSeriesPrivate>())
+{
+  // Each bucket may need two points
+  this->dataPtr->capacity = std::max<std::size_t>(_maxPoints / 2, 2);
+  this->dataPtr->buckets.reserve(this->dataPtr->capacity);
+}
+
+//////////////////////////////////////////////////
+TimeSeries::~TimeSeries() = default;
+
+//////////////////////////////////////////////////
+void TimeSeries::Append(double _x, double _y)
+{
+  // NaN can't be ordered, so it can't be a minimum or maximum
+  if (std::isnan(_x) || std::isnan(_y))
+    return;
+
+  auto &d = *this->dataPtr;
+  Point point{_x, _y};
+  if (d.pendingCount == 0)
+    d.pending = {point, point};
+  else
+    mergeBucket(d.pending, {point, point});
+
+  if (++d.pendingCount < d.samplesPerBucket)
+    return;
+
+  d.buckets.push_back(d.pending);
+  d.pendingCount = 0;
+
+  // Leave room for the next pending bucket by halving the resolution
+  if (d.buckets.size() < d.capacity)
+    return;
+
+  std::size_t merged{0};
+  for (std::size_t i = 0; i < d.buckets.size(); i += 2)
+  {
+    auto bucket = d.buckets[i];
+    if (i + 1 < d.buckets.size())
+      mergeBucket(bucket, d.buckets[i + 1]);
+    d.buckets[merged++] = bucket;
+  }
+  d.buckets.resize(merged);
+  d.samplesPerBucket *= 2;
+}
+
+//////////////////////////////////////////////////
+void TimeSeries::Clear()
+{
+  this->dataPtr->buckets.clear();
+  this->dataPtr->pendingCount = 0;
+  this->dataPtr->samplesPerBucket = 1;
+}
+
+//////////////////////////////////////////////////
+bool TimeSeries::Empty() const
+{
+  return this->dataPtr->buckets.empty() && this->dataPtr->pendingCount == 0;
+}
+
+//////////////////////////////////////////////////
+std::vector<TimeSeries::Point> TimeSeries::Take()
+{
+  std::vector<Point> points;
+  points.reserve(this->dataPtr->capacity * 2);
+  for (const auto &bucket : this->dataPtr->buckets)
+    appendExtremes(bucket, points);
+  if (this->dataPtr->pendingCount > 0)
+    appendExtremes(this->dataPtr->pending, points);
+
+  this->Clear();
+  return points;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_GUI_PLUGINS_PLOTTING_TIMESERIES_HH_
+#define IGNITION_GAZEBO_GUI_PLUGINS_PLOTTING_TIMESERIES_HH_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ignition {
+
+namespace gazebo {
+
+class TimeSeriesPrivate;
+
+/// \brief Samples of a plotted value which haven't been sent to the charts
+/// yet.
+///
+/// At most a fixed number of buckets are kept. When they are all used, pairs
+/// of neighbouring buckets are merged into one, keeping the minimum and
+/// maximum of their samples, so memory and the number of points sent to the
+/// charts don't grow with the update rate, and spikes aren't lost.
+class TimeSeries
+{
+  /// \brief A sample.
+  public: struct Point
+  {
+    /// \brief Time, usually sim time in seconds.
+    double x;
+
+    /// \brief Value.
+    double y;
+  };
+
+  /// \brief Constructor
+  /// \param[in] _maxPoints Maximum number of points returned by Take, at
+  /// least 4.
+  public: explicit TimeSeries(std::size_t _maxPoints = 32);
+
+  /// \brief Destructor
+  public: ~TimeSeries();
+
+  /// \brief Add a sample. Samples are expected in increasing time.
+  /// \param[in] _x Time.
+  /// \param[in] _y Value.
+  public: void Append(double _x, double _y);
+
+  /// \brief Remove all samples.
+  public: void Clear();
+
+  /// \brief Check if there are no samples.
+  /// \return True if empty.
+  public: bool Empty() const;
+
+  /// \brief Get the samples added since the previous call, decimated to at
+  /// most the maximum number of points, and remove them.
+  /// \return Points in increasing time.
+  public: std::vector<Point> Take();
+
+  /// \brief Private data pointer
+  private: std::unique_ptr<TimeSeriesPrivate> dataPtr;
+};
+}
+}
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "TimeSeries.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(TimeSeriesTest, FullResolution)
+{
+  TimeSeries series(100);
+  EXPECT_TRUE(series.Empty());
+  EXPECT_TRUE(series.Take().empty());
+
+  for (int i = 0; i < 8; ++i)
+    series.Append(i, i * 10.0);
+  EXPECT_FALSE(series.Empty());
+
+  // Few enough samples are returned as they are
+  auto points = series.Take();
+  ASSERT_EQ(8u, points.size());
+  for (int i = 0; i < 8; ++i)
+  {
+    EXPECT_DOUBLE_EQ(i, points[i].x);
+    EXPECT_DOUBLE_EQ(i * 10.0, points[i].y);
+  }
+
+  // Taken samples are removed
+  EXPECT_TRUE(series.Empty());
+  EXPECT_TRUE(series.Take().empty());
+
+  series.Append(8.0, 80.0);
+  points = series.Take();
+  ASSERT_EQ(1u, points.size());
+  EXPECT_DOUBLE_EQ(8.0, points[0].x);
+}
+
+/////////////////////////////////////////////////
+TEST(TimeSeriesTest, Decimation)
+{
+  TimeSeries series(20);
+
+  // A single spike among many samples
+  for (int i = 0; i < 1000; ++i)
+    series.Append(i, i == 421 ? 5.0 : 0.0);
+
+  auto points = series.Take();
+  EXPECT_LE(points.size(), 20u);
+  EXPECT_GE(points.size(), 5u);
+
+  bool spike{false};
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    if (i > 0)
+    {
+      EXPECT_LT(points[i - 1].x, points[i].x);
+    }
+    if (points[i].y > 4.0)
+    {
+      EXPECT_DOUBLE_EQ(421.0, points[i].x);
+      spike = true;
+    }
+  }
+  EXPECT_TRUE(spike);
+
+  // The resolution is restored once the samples are taken
+  for (int i = 0; i < 5; ++i)
+    series.Append(1000 + i, i);
+  EXPECT_EQ(5u, series.Take().size());
+}
+
+/////////////////////////////////////////////////
+TEST(TimeSeriesTest, Bounded)
+{
+  // However many samples are added, at most the requested number of points
+  // are returned
+  for (std::size_t maxPoints : {4u, 5u, 32u})
+  {
+    TimeSeries series(maxPoints);
+    for (int i = 0; i < 12345; ++i)
+    {
+      series.Append(i, i % 7);
+      if (i % 1000 == 999)
+      {
+        EXPECT_GE(maxPoints, series.Take().size()) << maxPoints;
+      }
+    }
+    auto points = series.Take();
+    EXPECT_GE(maxPoints, points.size()) << maxPoints;
+    ASSERT_FALSE(points.empty());
+    EXPECT_GE(12344.0, points.back().x);
+    EXPECT_LT(12000.0, points.back().x);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(TimeSeriesTest, Clear)
+{
+  TimeSeries series;
+  for (int i = 0; i < 100; ++i)
+    series.Append(i, i);
+
+  // NaN is ignored
+  series.Append(100.0, std::nan(""));
+
+  series.Clear();
+  EXPECT_TRUE(series.Empty());
+  EXPECT_TRUE(series.Take().empty());
+}
@@ -18,6 +18,7 @@
 #include <ignition/msgs/contact.pb.h>
 #include <ignition/msgs/contacts.pb.h>
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -39,7 +40,7 @@
 
 #include "ignition/gazebo/components/Collision.hh"
 #include "ignition/gazebo/components/ContactSensor.hh"
-#include "ignition/gazebo/components/ContactSensorData.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
@@ -57,7 +58,7 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
   /// \brief Private data class for VisualizeContacts
   class VisualizeContactsPrivate
   {
-    /// \brief Creates ContactSensorData for Collision components without a
+    /// \brief Creates ContactSensorBuffer for Collision components without a
     /// Contact Sensor by requesting the /enable_contact service
     /// \param[in] Reference to the GUI Entity Component Manager
     public: void CreateCollisionData(EntityComponentManager &_ecm);
@@ -101,6 +102,36 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Add an octahedron to a triangle list marker.
+/// \param[in] _center Center of the octahedron.
+/// \param[in] _radius Distance from the center to the vertices.
+/// \param[in, out] _msg Triangle list marker.
+static void addOctahedron(const math::Vector3d &_center, double _radius,
+    msgs::Marker &_msg)
+{
+  const std::array<math::Vector3d, 6> vertices{
+    _center + math::Vector3d(_radius, 0, 0),
+    _center + math::Vector3d(-_radius, 0, 0),
+    _center + math::Vector3d(0, _radius, 0),
+    _center + math::Vector3d(0, -_radius, 0),
+    _center + math::Vector3d(0, 0, _radius),
+    _center + math::Vector3d(0, 0, -_radius)};
+
+  // Each face has one vertex on each axis
+  for (auto x : {0, 1})
+  {
+    for (auto y : {2, 3})
+    {
+      for (auto z : {4, 5})
+      {
+        msgs::Set(_msg.add_point(), vertices[x]);
+        msgs::Set(_msg.add_point(), vertices[y]);
+        msgs::Set(_msg.add_point(), vertices[z]);
+      }
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 VisualizeContacts::VisualizeContacts()
   : GuiSystem(), dataPtr(new VisualizeContactsPrivate)
@@ -118,14 +149,17 @@ void VisualizeContacts::LoadConfig(const tinyxml2::XMLElement *)
 
   // Configure Marker messages for position of the contacts
 
-  // Blue spheres for positions
+  // Blue octahedra for positions, all in a single marker, so there's a
+  // single service request and rendering object however many contacts
+  // there are
 
   // Create the marker message
   this->dataPtr->positionMarkerMsg.set_ns("positions");
+  this->dataPtr->positionMarkerMsg.set_id(1);
   this->dataPtr->positionMarkerMsg.set_action(
     ignition::msgs::Marker::ADD_MODIFY);
   this->dataPtr->positionMarkerMsg.set_type(
-    ignition::msgs::Marker::SPHERE);
+    ignition::msgs::Marker::TRIANGLE_LIST);
   this->dataPtr->positionMarkerMsg.set_visibility(
     ignition::msgs::Marker::GUI);
   this->dataPtr->
@@ -142,12 +176,6 @@ void VisualizeContacts::LoadConfig(const tinyxml2::XMLElement *)
   ignition::msgs::Set(
     this->dataPtr->positionMarkerMsg.mutable_material()->mutable_diffuse(),
     ignition::math::Color(0, 0, 1, 1));
-
-  // Set contact position scale
-  ignition::msgs::Set(this->dataPtr->positionMarkerMsg.mutable_scale(),
-    ignition::math::Vector3d(this->dataPtr->contactRadius,
-    this->dataPtr->contactRadius,
-    this->dataPtr->contactRadius));
 }
 
 /////////////////////////////////////////////////
@@ -221,29 +249,29 @@ void VisualizeContacts::Update(const UpdateInfo &_info,
   // Since we are setting a lifetime for the markers, we get all the
   // contacts instead of getting new and removed ones
 
-  // Variable for setting the markers id through the iteration
-  int markerID = 1;
-  _ecm.Each<components::ContactSensorData>(
+  // The radius setting used to scale unit diameter spheres
+  double radius;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->serviceMutex);
+    radius = this->dataPtr->contactRadius * 0.5;
+  }
+
+  auto &markerMsg = this->dataPtr->positionMarkerMsg;
+  markerMsg.clear_point();
+  _ecm.Each<components::ContactSensorBuffer>(
     [&](const Entity &,
-        const components::ContactSensorData *_contacts) -> bool
+        const components::ContactSensorBuffer *_contacts) -> bool
     {
-      for (const auto &contact : _contacts->Data().contact())
-      {
-        for (int i = 0; i < contact.position_size(); ++i)
-        {
-          // Set marker id, poses and request service
-          this->dataPtr->positionMarkerMsg.set_id(markerID++);
-          ignition::msgs::Set(this->dataPtr->positionMarkerMsg.mutable_pose(),
-            ignition::math::Pose3d(contact.position(i).x(),
-              contact.position(i).y(), contact.position(i).z(),
-              0, 0, 0));
-
-          this->dataPtr->node.Request(
-            "/marker", this->dataPtr->positionMarkerMsg);
-        }
-      }
+      for (const auto &position : _contacts->Data().positions)
+        addOctahedron(position, radius, markerMsg);
       return true;
     });
+
+  // Without contacts, the previous marker expires at the end of its lifetime
+  if (markerMsg.point().empty())
+    return;
+
+  this->dataPtr->node.Request("/marker", markerMsg);
 }
 
 //////////////////////////////////////////////////
@@ -257,15 +285,15 @@ void VisualizeContactsPrivate::CreateCollisionData(
     [&](const Entity &_entity,
         const components::Collision *) -> bool
     {
-      // Check if ContactSensorData has already been created
+      // Check if ContactSensorBuffer has already been created
       bool collisionHasContactSensor =
         _ecm.EntityHasComponentType(_entity,
-          components::ContactSensorData::typeId);
+          components::ContactSensorBuffer::typeId);
 
       if (collisionHasContactSensor)
       {
-        igndbg << "ContactSensorData detected in collision [" << _entity << "]"
-          << std::endl;
+        igndbg << "ContactSensorBuffer detected in collision [" << _entity
+          << "]" << std::endl;
         return true;
       }
 
@@ -290,12 +318,6 @@ void VisualizeContacts::UpdateRadius(double _radius)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->serviceMutex);
   this->dataPtr->contactRadius = _radius;
-
-  // Set scale
-  ignition::msgs::Set(this->dataPtr->positionMarkerMsg.mutable_scale(),
-    ignition::math::Vector3d(this->dataPtr->contactRadius,
-    this->dataPtr->contactRadius,
-    this->dataPtr->contactRadius));
 }
 
 //////////////////////////////////////////////////
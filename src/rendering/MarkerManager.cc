@@ -33,6 +33,8 @@
 
 #include "ignition/gazebo/rendering/MarkerManager.hh"
 
+#include "MaterialKey.hh"
+
 using namespace ignition;
 using namespace gazebo;
 
@@ -88,6 +90,10 @@ class ignition::gazebo::MarkerManagerPrivate
   public: void SetVisual(const ignition::msgs::Marker &_msg,
                          const rendering::VisualPtr &_visualPtr);
 
+  /// \brief Destroy a marker visual and forget its cached data.
+  /// \param[in] _visualPtr Marker visual.
+  public: void DestroyMarkerVisual(const rendering::VisualPtr &_visualPtr);
+
   /// \brief Sets sim time from time.
   /// \param[in] _time The time data.
   public: void SetSimTime(const std::chrono::steady_clock::duration &_time);
@@ -119,6 +125,12 @@ class ignition::gazebo::MarkerManagerPrivate
 
   /// \brief Topic name for the marker service
   public: std::string topicName = "/marker";
+
+  /// \brief Material last applied to each marker. Markers which are
+  /// updated every frame, such as those with many points, usually keep their
+  /// material, and creating a material is much more expensive than comparing
+  /// messages.
+  public: MaterialKeyCache markerMaterials;
 };
 
 /////////////////////////////////////////////////
@@ -238,7 +250,7 @@ void MarkerManagerPrivate::Update()
             (markerPtr->Lifetime() <= simTime ||
             this->simTime < this->lastSimTime))
         {
-          this->scene->DestroyVisual(it->second);
+          this->DestroyMarkerVisual(it->second);
           it = mit->second.erase(it);
           break;
         }
@@ -254,6 +266,15 @@ void MarkerManagerPrivate::Update()
   this->lastSimTime = this->simTime;
 }
 
+/////////////////////////////////////////////////
+void MarkerManagerPrivate::DestroyMarkerVisual(
+    const rendering::VisualPtr &_visualPtr)
+{
+  for (unsigned int i = 0; i < _visualPtr->GeometryCount(); ++i)
+    this->markerMaterials.Remove(_visualPtr->GeometryByIndex(i)->Name());
+  this->scene->DestroyVisual(_visualPtr);
+}
+
 /////////////////////////////////////////////////
 void MarkerManagerPrivate::SetSimTime(
     const std::chrono::steady_clock::duration &_time)
@@ -322,17 +343,23 @@ void MarkerManagerPrivate::SetMarker(const ignition::msgs::Marker &_msg,
   ignition::rendering::MarkerType markerType = MsgToType(_msg);
   _markerPtr->SetType(markerType);
 
-  // Set Marker Material
+  // Set Marker Material, unless it's the one already set
   if (_msg.has_material())
   {
-    rendering::MaterialPtr materialPtr = MsgToMaterial(_msg);
-    _markerPtr->SetMaterial(materialPtr, true /* clone */);
+    if (this->markerMaterials.Update(_markerPtr->Name(),
+        materialKey(_msg.material())))
+    {
+      rendering::MaterialPtr materialPtr = MsgToMaterial(_msg);
+      _markerPtr->SetMaterial(materialPtr, true /* clone */);
 
-    // clean up material after clone
-    this->scene->DestroyMaterial(materialPtr);
+      // clean up material after clone
+      this->scene->DestroyMaterial(materialPtr);
+    }
   }
 
-  // Assume the presence of points means we clear old ones
+  // Assume the presence of points means we clear old ones. All points go
+  // into the marker's single dynamic geometry, so a single message can
+  // carry a whole point set.
   if (_msg.point().size() > 0)
   {
     _markerPtr->ClearPoints();
@@ -345,14 +372,10 @@ void MarkerManagerPrivate::SetMarker(const ignition::msgs::Marker &_msg,
       _msg.material().diffuse().a());
 
   // Set Marker Points
-  for (int i = 0; i < _msg.point().size(); ++i)
+  for (const auto &point : _msg.point())
   {
-    math::Vector3d vector(
-        _msg.point(i).x(),
-        _msg.point(i).y(),
-        _msg.point(i).z());
-
-    _markerPtr->AddPoint(vector, color);
+    _markerPtr->AddPoint(math::Vector3d(point.x(), point.y(), point.z()),
+        color);
   }
 }
 
@@ -534,7 +557,7 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
     if (nsIter != this->visuals.end() &&
         visualIter != nsIter->second.end())
     {
-      this->scene->DestroyVisual(visualIter->second);
+      this->DestroyMarkerVisual(visualIter->second);
       this->visuals[ns].erase(visualIter);
 
       // Remove namespace if empty
@@ -563,7 +586,7 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
     {
       for (auto it : nsIter->second)
       {
-        this->scene->DestroyVisual(it.second);
+        this->DestroyMarkerVisual(it.second);
       }
       nsIter->second.clear();
       this->visuals.erase(nsIter);
@@ -576,7 +599,7 @@ bool MarkerManagerPrivate::ProcessMarkerMsg(const ignition::msgs::Marker &_msg)
       {
         for (auto it : nsIter->second)
         {
-          this->scene->DestroyVisual(it.second);
+          this->DestroyMarkerVisual(it.second);
         }
       }
       this->visuals.clear();
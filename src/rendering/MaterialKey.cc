@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "MaterialKey.hh"
+
+#include <sstream>
+
+#include <sdf/Geometry.hh>
+#include <sdf/Mesh.hh>
+#include <sdf/Pbr.hh>
+
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+//////////////////////////////////////////////////
+std::string ignition::gazebo::materialKey(const sdf::Material &_material)
+{
+  std::ostringstream key;
+  key << _material.Ambient() << "|" << _material.Diffuse() << "|"
+      << _material.Specular() << "|" << _material.Emissive() << "|"
+      << _material.RenderOrder() << "|" << _material.DoubleSided() << "|"
+      << _material.FilePath();
+
+  const sdf::Pbr *pbr = _material.PbrMaterial();
+  const sdf::PbrWorkflow *metal =
+      pbr ? pbr->Workflow(sdf::PbrWorkflowType::METAL) : nullptr;
+  if (metal)
+  {
+    key << "|" << metal->Roughness() << "|" << metal->Metalness()
+        << "|" << metal->RoughnessMap() << "|" << metal->MetalnessMap()
+        << "|" << metal->AlbedoMap() << "|" << metal->NormalMap()
+        << "|" << metal->EnvironmentMap() << "|" << metal->EmissiveMap()
+        << "|" << metal->LightMap() << "|" << metal->LightMapTexCoordSet();
+  }
+  return key.str();
+}
+
+//////////////////////////////////////////////////
+std::string ignition::gazebo::materialKey(const msgs::Material &_material)
+{
+  return _material.SerializeAsString();
+}
+
+//////////////////////////////////////////////////
+std::string ignition::gazebo::sharedMaterialKey(const sdf::Visual &_visual,
+    const std::string &_materialName)
+{
+  std::ostringstream key;
+  key << (_visual.Material() ? materialKey(*_visual.Material()) :
+      _materialName) << "|" << _visual.Transparency() << "|"
+      << _visual.CastShadows();
+  return key.str();
+}
+
+//////////////////////////////////////////////////
+std::string ignition::gazebo::visualResourceKey(const sdf::Visual &_visual)
+{
+  std::string key;
+  if (_visual.Geom())
+  {
+    key = std::to_string(static_cast<int>(_visual.Geom()->Type()));
+    if (_visual.Geom()->Type() == sdf::GeometryType::MESH &&
+        _visual.Geom()->MeshShape())
+    {
+      key += "|" + asFullPath(_visual.Geom()->MeshShape()->Uri(),
+          _visual.Geom()->MeshShape()->FilePath()) + "|" +
+          _visual.Geom()->MeshShape()->Submesh();
+    }
+  }
+  if (_visual.Material())
+    key += "|" + materialKey(*_visual.Material());
+  return key;
+}
+
+//////////////////////////////////////////////////
+bool MaterialKeyCache::Update(const std::string &_name,
+    const std::string &_key)
+{
+  auto &current = this->keys[_name];
+  if (current == _key)
+    return false;
+  current = _key;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void MaterialKeyCache::Remove(const std::string &_name)
+{
+  this->keys.erase(_name);
+}
+
+//////////////////////////////////////////////////
+std::size_t MaterialKeyCache::Size() const
+{
+  return this->keys.size();
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_RENDERING_MATERIALKEY_HH_
+#define IGNITION_GAZEBO_RENDERING_MATERIALKEY_HH_
+
+#include <string>
+#include <unordered_map>
+
+#include <ignition/msgs/material.pb.h>
+#include <sdf/Material.hh>
+#include <sdf/Visual.hh>
+
+#include "ignition/gazebo/config.hh"
+#include "ignition/gazebo/rendering/Export.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+/// \brief Get a key which is the same for all materials that would be
+/// loaded identically by SceneManager::LoadMaterial.
+/// \param[in] _material Material sdf dom
+/// \return Key for the material
+IGNITION_GAZEBO_RENDERING_VISIBLE
+std::string materialKey(const sdf::Material &_material);
+
+/// \brief Get a key which is the same for all materials that would be
+/// created identically from a material message.
+/// \param[in] _material Material message
+/// \return Key for the material
+IGNITION_GAZEBO_RENDERING_VISIBLE
+std::string materialKey(const msgs::Material &_material);
+
+/// \brief Get a key which is the same for all visuals which look the same,
+/// so they can share a single material.
+/// \param[in] _visual Visual sdf dom
+/// \param[in] _materialName Name of the material loaded for the visual,
+/// used when the visual has no material of its own.
+/// \return Key for the visual's shared material
+IGNITION_GAZEBO_RENDERING_VISIBLE
+std::string sharedMaterialKey(const sdf::Visual &_visual,
+    const std::string &_materialName);
+
+/// \brief Get a key used to group visuals which share the same geometry and
+/// material, so they're created one after the other.
+/// \param[in] _visual Visual sdf dom
+/// \return Key for the visual's resources
+IGNITION_GAZEBO_RENDERING_VISIBLE
+std::string visualResourceKey(const sdf::Visual &_visual);
+
+/// \brief Keys of the materials last applied to named objects, so a
+/// material which didn't change isn't created again.
+class IGNITION_GAZEBO_RENDERING_VISIBLE MaterialKeyCache
+{
+  /// \brief Record the key of a material about to be applied to an object.
+  /// \param[in] _name Name of the object
+  /// \param[in] _key Key of the material
+  /// \return True if the key differs from the one last recorded for the
+  /// object, so the material must be applied.
+  public: bool Update(const std::string &_name, const std::string &_key);
+
+  /// \brief Forget the material of an object, such as when it's destroyed.
+  /// \param[in] _name Name of the object
+  public: void Remove(const std::string &_name);
+
+  /// \brief Get the number of objects whose material is recorded.
+  /// \return Number of objects
+  public: std::size_t Size() const;
+
+  /// \brief Material keys, by object name.
+  private: std::unordered_map<std::string, std::string> keys;
+};
+}
+}
+}
+#endif
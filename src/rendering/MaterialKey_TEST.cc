@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <ignition/math/Color.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/msgs/material.pb.h>
+#include <sdf/Box.hh>
+#include <sdf/Geometry.hh>
+#include <sdf/Material.hh>
+#include <sdf/Mesh.hh>
+#include <sdf/Pbr.hh>
+#include <sdf/Visual.hh>
+
+#include "MaterialKey.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(MaterialKeyTest, Material)
+{
+  sdf::Material material;
+  material.SetAmbient(math::Color(0.1f, 0.2f, 0.3f));
+  material.SetDiffuse(math::Color(0.4f, 0.5f, 0.6f));
+
+  // Materials which are loaded the same way have the same key
+  sdf::Material same = material;
+  EXPECT_EQ(materialKey(material), materialKey(same));
+
+  // Any property which is loaded changes the key
+  sdf::Material diffuse = material;
+  diffuse.SetDiffuse(math::Color(0.4f, 0.5f, 0.7f));
+  EXPECT_NE(materialKey(material), materialKey(diffuse));
+
+  sdf::Material specular = material;
+  specular.SetSpecular(math::Color(1.0f, 1.0f, 1.0f));
+  EXPECT_NE(materialKey(material), materialKey(specular));
+
+  sdf::Material emissive = material;
+  emissive.SetEmissive(math::Color(1.0f, 0.0f, 0.0f));
+  EXPECT_NE(materialKey(material), materialKey(emissive));
+
+  sdf::Material doubleSided = material;
+  doubleSided.SetDoubleSided(true);
+  EXPECT_NE(materialKey(material), materialKey(doubleSided));
+
+  sdf::Material renderOrder = material;
+  renderOrder.SetRenderOrder(2.0f);
+  EXPECT_NE(materialKey(material), materialKey(renderOrder));
+
+  // PBR properties too
+  sdf::PbrWorkflow workflow;
+  workflow.SetType(sdf::PbrWorkflowType::METAL);
+  workflow.SetRoughness(0.3);
+  sdf::Pbr pbr;
+  pbr.SetWorkflow(sdf::PbrWorkflowType::METAL, workflow);
+  sdf::Material metal = material;
+  metal.SetPbrMaterial(pbr);
+  EXPECT_NE(materialKey(material), materialKey(metal));
+
+  workflow.SetAlbedoMap("albedo.png");
+  pbr.SetWorkflow(sdf::PbrWorkflowType::METAL, workflow);
+  sdf::Material albedo = material;
+  albedo.SetPbrMaterial(pbr);
+  EXPECT_NE(materialKey(metal), materialKey(albedo));
+}
+
+/////////////////////////////////////////////////
+TEST(MaterialKeyTest, SharedMaterial)
+{
+  sdf::Material material;
+  material.SetDiffuse(math::Color(0.4f, 0.5f, 0.6f));
+
+  sdf::Visual visual;
+  visual.SetName("visual");
+  visual.SetMaterial(material);
+
+  // The visual's name doesn't matter, only how it looks
+  sdf::Visual same = visual;
+  same.SetName("other");
+  EXPECT_EQ(sharedMaterialKey(visual, "mat1"),
+      sharedMaterialKey(same, "mat2"));
+
+  sdf::Visual transparent = visual;
+  transparent.SetTransparency(0.5f);
+  EXPECT_NE(sharedMaterialKey(visual, "mat"),
+      sharedMaterialKey(transparent, "mat"));
+
+  sdf::Visual shadows = visual;
+  shadows.SetCastShadows(!visual.CastShadows());
+  EXPECT_NE(sharedMaterialKey(visual, "mat"),
+      sharedMaterialKey(shadows, "mat"));
+
+  sdf::Material otherMaterial;
+  otherMaterial.SetDiffuse(math::Color(0.0f, 0.5f, 0.6f));
+  sdf::Visual other = visual;
+  other.SetMaterial(otherMaterial);
+  EXPECT_NE(sharedMaterialKey(visual, "mat"),
+      sharedMaterialKey(other, "mat"));
+
+  // Without a material of their own, visuals are told apart by the name of
+  // the material loaded for them
+  sdf::Visual noMaterial;
+  EXPECT_EQ(sharedMaterialKey(noMaterial, "default"),
+      sharedMaterialKey(noMaterial, "default"));
+  EXPECT_NE(sharedMaterialKey(noMaterial, "default"),
+      sharedMaterialKey(noMaterial, "other"));
+}
+
+/////////////////////////////////////////////////
+TEST(MaterialKeyTest, VisualResource)
+{
+  sdf::Mesh meshShape;
+  meshShape.SetUri("/tmp/mesh.dae");
+  meshShape.SetSubmesh("body");
+  sdf::Geometry mesh;
+  mesh.SetType(sdf::GeometryType::MESH);
+  mesh.SetMeshShape(meshShape);
+
+  sdf::Material material;
+  material.SetDiffuse(math::Color(0.4f, 0.5f, 0.6f));
+
+  sdf::Visual visual;
+  visual.SetName("visual");
+  visual.SetGeom(mesh);
+  visual.SetMaterial(material);
+
+  // Visuals with the same mesh and material are grouped, whatever their
+  // name and pose
+  sdf::Visual same = visual;
+  same.SetName("other");
+  same.SetRawPose(math::Pose3d(1, 2, 3, 0, 0, 0));
+  EXPECT_EQ(visualResourceKey(visual), visualResourceKey(same));
+
+  // Another submesh, mesh or material isn't
+  sdf::Mesh otherSubmesh = meshShape;
+  otherSubmesh.SetSubmesh("wheel");
+  sdf::Geometry otherSubmeshGeom = mesh;
+  otherSubmeshGeom.SetMeshShape(otherSubmesh);
+  sdf::Visual submeshVisual = visual;
+  submeshVisual.SetGeom(otherSubmeshGeom);
+  EXPECT_NE(visualResourceKey(visual), visualResourceKey(submeshVisual));
+
+  sdf::Mesh otherMesh = meshShape;
+  otherMesh.SetUri("/tmp/other.dae");
+  sdf::Geometry otherMeshGeom = mesh;
+  otherMeshGeom.SetMeshShape(otherMesh);
+  sdf::Visual meshVisual = visual;
+  meshVisual.SetGeom(otherMeshGeom);
+  EXPECT_NE(visualResourceKey(visual), visualResourceKey(meshVisual));
+
+  sdf::Material otherMaterial;
+  otherMaterial.SetDiffuse(math::Color(0.0f, 0.5f, 0.6f));
+  sdf::Visual materialVisual = visual;
+  materialVisual.SetMaterial(otherMaterial);
+  EXPECT_NE(visualResourceKey(visual), visualResourceKey(materialVisual));
+
+  // Primitive shapes are grouped by type
+  sdf::Box boxShape;
+  boxShape.SetSize(math::Vector3d(1, 2, 3));
+  sdf::Geometry box;
+  box.SetType(sdf::GeometryType::BOX);
+  box.SetBoxShape(boxShape);
+  sdf::Visual boxVisual;
+  boxVisual.SetGeom(box);
+  EXPECT_NE(visualResourceKey(visual), visualResourceKey(boxVisual));
+
+  sdf::Geometry sphere;
+  sphere.SetType(sdf::GeometryType::SPHERE);
+  sdf::Visual sphereVisual;
+  sphereVisual.SetGeom(sphere);
+  EXPECT_NE(visualResourceKey(boxVisual), visualResourceKey(sphereVisual));
+
+  boxShape.SetSize(math::Vector3d(3, 2, 1));
+  box.SetBoxShape(boxShape);
+  sdf::Visual otherBox;
+  otherBox.SetGeom(box);
+  EXPECT_EQ(visualResourceKey(boxVisual), visualResourceKey(otherBox));
+}
+
+/////////////////////////////////////////////////
+TEST(MaterialKeyTest, MaterialMsg)
+{
+  msgs::Material material;
+  material.mutable_diffuse()->set_r(0.5f);
+  material.mutable_diffuse()->set_a(1.0f);
+
+  msgs::Material same;
+  same.CopyFrom(material);
+  EXPECT_EQ(materialKey(material), materialKey(same));
+
+  msgs::Material other;
+  other.CopyFrom(material);
+  other.mutable_diffuse()->set_g(0.5f);
+  EXPECT_NE(materialKey(material), materialKey(other));
+
+  msgs::Material lighting;
+  lighting.CopyFrom(material);
+  lighting.set_lighting(true);
+  EXPECT_NE(materialKey(material), materialKey(lighting));
+}
+
+/////////////////////////////////////////////////
+TEST(MaterialKeyTest, Cache)
+{
+  MaterialKeyCache cache;
+  EXPECT_EQ(0u, cache.Size());
+
+  // The first material of an object is applied
+  EXPECT_TRUE(cache.Update("marker1", "red"));
+  EXPECT_TRUE(cache.Update("marker2", "red"));
+  EXPECT_EQ(2u, cache.Size());
+
+  // The same material isn't applied again
+  EXPECT_FALSE(cache.Update("marker1", "red"));
+  EXPECT_FALSE(cache.Update("marker1", "red"));
+
+  // A different one is
+  EXPECT_TRUE(cache.Update("marker1", "blue"));
+  EXPECT_FALSE(cache.Update("marker1", "blue"));
+  EXPECT_FALSE(cache.Update("marker2", "red"));
+
+  // A removed object gets its material applied again, such as when a marker
+  // is recreated with the same name
+  cache.Remove("marker1");
+  EXPECT_EQ(1u, cache.Size());
+  EXPECT_TRUE(cache.Update("marker1", "blue"));
+
+  // Removing unknown objects is fine
+  cache.Remove("unknown");
+  EXPECT_EQ(2u, cache.Size());
+}
@@ -15,11 +15,14 @@
  *
  */
 
+#include <functional>
+#include <future>
 #include <map>
 #include <stack>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -28,6 +31,7 @@
 #include <sdf/Element.hh>
 #include <sdf/Light.hh>
 #include <sdf/Link.hh>
+#include <sdf/Mesh.hh>
 #include <sdf/Model.hh>
 #include <sdf/parser.hh>
 #include <sdf/Scene.hh>
@@ -85,6 +89,8 @@
 
 #include "ignition/gazebo/Util.hh"
 
+#include "SensorView.hh"
+
 using namespace ignition;
 using namespace gazebo;
 
@@ -99,6 +105,21 @@ class ignition::gazebo::RenderUtilPrivate
   public: void CreateRenderingEntities(const EntityComponentManager &_ecm,
       const UpdateInfo &_info);
 
+  /// \brief Iterate over entities which have all the given components and
+  /// haven't been processed yet. All pre-existent entities are treated as
+  /// new before the first update, and only newly created entities are
+  /// visited afterwards.
+  /// \param[in] _ecm The entity-component manager
+  /// \param[in] _f Callback, see `EntityComponentManager::Each`
+  public: template<typename ...ComponentTypeTs, typename FunctionT>
+          void EachNew(const EntityComponentManager &_ecm, FunctionT _f)
+  {
+    if (this->initialized)
+      _ecm.EachNew<ComponentTypeTs...>(_f);
+    else
+      _ecm.Each<ComponentTypeTs...>(_f);
+  }
+
   /// \brief Remove rendering entities
   /// \param[in] _ecm The entity-component manager
   public: void RemoveRenderingEntities(const EntityComponentManager &_ecm,
@@ -159,6 +180,14 @@ class ignition::gazebo::RenderUtilPrivate
   /// [0] entity id, [1], SDF DOM, [2] parent entity id
   public: std::vector<std::tuple<Entity, sdf::Visual, Entity>> newVisuals;
 
+  /// \brief Full paths of all the meshes which were requested to be loaded
+  /// in the background, so each mesh is only resolved and loaded once.
+  public: std::unordered_set<std::string> requestedMeshes;
+
+  /// \brief Background mesh loading tasks which need to be complete before
+  /// the new visuals are created.
+  public: std::vector<std::future<void>> meshLoads;
+
   /// \brief New actors to be created. The elements in the tuple are:
   /// [0] entity id, [1], SDF DOM, [2] parent entity id
   public: std::vector<std::tuple<Entity, sdf::Actor, Entity>> newActors;
@@ -196,6 +225,30 @@ class ignition::gazebo::RenderUtilPrivate
   /// \brief A map of entity ids and pose updates.
   public: std::unordered_map<Entity, math::Pose3d> entityPoses;
 
+  /// \brief Entities which have a rendering node whose pose is kept in sync
+  /// with their Pose component. Actors are handled separately.
+  public: std::unordered_set<Entity> poseEntities;
+
+  /// \brief True to copy the poses of all entities in `poseEntities` on the
+  /// next update. Otherwise only poses which were marked as changed in the
+  /// ECM are copied.
+  public: bool updateAllPoses{true};
+
+  /// \brief True to hold back pose updates of models which can't be seen
+  /// by any of the culling sensors.
+  public: bool cullingEnabled{false};
+
+  /// \brief Names of the rendering sensors whose view is used for culling.
+  public: std::vector<std::string> cullingSensors;
+
+  /// \brief Pose updates held back by culling. They're applied once their
+  /// models may be seen.
+  public: std::unordered_map<Entity, math::Pose3d> deferredPoses;
+
+  /// \brief Radius of a sphere around each top level model's origin which
+  /// contains the whole model. Negative for models which can't be culled.
+  public: std::unordered_map<Entity, double> cullingRadii;
+
   /// \brief A map of entity ids and light updates.
   public: std::unordered_map<Entity, msgs::Light> entityLights;
 
@@ -341,6 +394,25 @@ class ignition::gazebo::RenderUtilPrivate
   /// sensor.
   public: void RemoveSensor(const Entity _entity);
 
+  /// \brief Hold back the pose updates of models which can't be seen by
+  /// any of the culling sensors, and release the held back updates of
+  /// models which may be seen now. This should be called in
+  /// RenderUtil::Update.
+  /// \param[in, out] _poses Pose updates to be applied on this update.
+  /// \param[in] _applyPose Function which applies a pose update. It's used
+  /// to move the models carrying the sensors before culling the rest.
+  public: void CullPoses(std::unordered_map<Entity, math::Pose3d> &_poses,
+      const std::function<void(Entity, const math::Pose3d &)> &_applyPose);
+
+  /// \brief Get the culling radius of a top level visual.
+  /// \param[in] _entity Entity of the visual
+  /// \param[in] _visual Top level visual
+  /// \return Radius of a sphere around the visual's origin which contains
+  /// it, negative if the visual must never be culled.
+  /// \sa cullingRadii
+  public: double CullingRadius(Entity _entity,
+      const rendering::VisualPtr &_visual);
+
   /// \brief A helper function that removes the bounding box associated with an
   /// entity, if an associated bounding box exists. This should be called in
   /// RenderUtil::Update.
@@ -412,7 +484,11 @@ void RenderUtil::UpdateECM(const UpdateInfo &/*_info*/,
         {
           auto poseComp = _ecm.Component<components::Pose>(_entity);
           if (poseComp)
+          {
             poseComp->Data() = msgs::Convert(_emitterCmd->Data().pose());
+            _ecm.SetChanged(_entity, components::Pose::typeId,
+                ComponentState::OneTimeChange);
+          }
         }
         // Store the entity ids to clear outside of the `Each` loop.
         this->dataPtr->particleCmdsToRemove.push_back(_entity);
@@ -593,6 +669,7 @@ void RenderUtil::Update()
   auto newModels = std::move(this->dataPtr->newModels);
   auto newLinks = std::move(this->dataPtr->newLinks);
   auto newVisuals = std::move(this->dataPtr->newVisuals);
+  auto meshLoads = std::move(this->dataPtr->meshLoads);
   auto newActors = std::move(this->dataPtr->newActors);
   auto newLights = std::move(this->dataPtr->newLights);
   auto newParticleEmitters = std::move(this->dataPtr->newParticleEmitters);
@@ -612,6 +689,7 @@ void RenderUtil::Update()
   this->dataPtr->newModels.clear();
   this->dataPtr->newLinks.clear();
   this->dataPtr->newVisuals.clear();
+  this->dataPtr->meshLoads.clear();
   this->dataPtr->newActors.clear();
   this->dataPtr->newLights.clear();
   this->dataPtr->newParticleEmitters.clear();
@@ -667,9 +745,18 @@ void RenderUtil::Update()
 
       this->dataPtr->RemoveSensor(entity.first);
       this->dataPtr->RemoveBoundingBox(entity.first);
+      this->dataPtr->deferredPoses.erase(entity.first);
     }
   }
 
+  // Adding or removing anything may change the bounds of a model
+  if (!removeEntities.empty() || !newModels.empty() || !newLinks.empty() ||
+      !newVisuals.empty() || !newActors.empty() || !newLights.empty() ||
+      !newParticleEmitters.empty() || !newSensors.empty())
+  {
+    this->dataPtr->cullingRadii.clear();
+  }
+
   // create new entities
   {
     IGN_PROFILE("RenderUtil::Update Create");
@@ -700,11 +787,11 @@ void RenderUtil::Update()
           std::get<0>(link), std::get<1>(link), std::get<2>(link));
     }
 
-    for (const auto &visual : newVisuals)
-    {
-      this->dataPtr->sceneManager.CreateVisual(
-          std::get<0>(visual), std::get<1>(visual), std::get<2>(visual));
-    }
+    // Make sure meshes loaded in the background are ready
+    for (auto &load : meshLoads)
+      load.wait();
+
+    this->dataPtr->sceneManager.CreateVisuals(newVisuals);
 
     for (const auto &actor : newActors)
     {
@@ -783,11 +870,11 @@ void RenderUtil::Update()
   // update entities' pose
   {
     IGN_PROFILE("RenderUtil::Update Poses");
-    for (const auto &pose : entityPoses)
+    auto applyPose = [this](Entity _entity, const math::Pose3d &_pose)
     {
-      auto node = this->dataPtr->sceneManager.NodeById(pose.first);
+      auto node = this->dataPtr->sceneManager.NodeById(_entity);
       if (!node)
-        continue;
+        return;
 
       // Don't move entity being manipulated (last selected)
       // TODO(anyone) Check top level visual instead of parent
@@ -804,15 +891,29 @@ void RenderUtil::Update()
         entityId = std::get<int>(vis->UserData("gazebo-entity"));
       }
       if ((this->dataPtr->transformActive &&
-          (pose.first == this->dataPtr->selectedEntities.back() ||
+          (_entity == this->dataPtr->selectedEntities.back() ||
           entityId == this->dataPtr->selectedEntities.back())) ||
           updateNode)
       {
-        continue;
+        return;
       }
 
-      node->SetLocalPose(pose.second);
+      node->SetLocalPose(_pose);
+    };
+
+    if (this->dataPtr->cullingEnabled)
+    {
+      this->dataPtr->CullPoses(entityPoses, applyPose);
     }
+    else if (!this->dataPtr->deferredPoses.empty())
+    {
+      entityPoses.insert(this->dataPtr->deferredPoses.begin(),
+          this->dataPtr->deferredPoses.end());
+      this->dataPtr->deferredPoses.clear();
+    }
+
+    for (const auto &pose : entityPoses)
+      applyPose(pose.first, pose.second);
 
     // update entities' local transformations
     if (this->dataPtr->actorManualSkeletonUpdate)
@@ -943,6 +1044,7 @@ void RenderUtilPrivate::CreateRenderingEntities(
     this->newSensors.push_back(
         std::make_tuple(_entity, std::move(sdfDataCopy), _parent));
     this->sensorEntities.insert(_entity);
+    this->poseEntities.insert(_entity);
   };
 
   const std::string cameraSuffix{"/image"};
@@ -951,466 +1053,266 @@ void RenderUtilPrivate::CreateRenderingEntities(
   const std::string thermalCameraSuffix{"/image"};
   const std::string gpuLidarSuffix{"/scan"};
 
-  // Treat all pre-existent entities as new at startup
-  // TODO(anyone) refactor Each and EachNew below to reduce duplicate code
-  if (!this->initialized)
-  {
-    // Get all the new worlds
-    // TODO(anyone) Only one scene is supported for now
-    // extend the sensor system to support mutliple scenes in the future
-    _ecm.Each<components::World, components::Scene>(
-        [&](const Entity & _entity,
-          const components::World *,
-          const components::Scene *_scene)->bool
-        {
-          this->sceneManager.SetWorldId(_entity);
-          const sdf::Scene &sceneSdf = _scene->Data();
-          this->newScenes.push_back(sceneSdf);
-          return true;
-        });
+  // Meshes which haven't been requested before
+  std::vector<std::string> newMeshes;
 
+  // Get all the new worlds
+  // TODO(anyone) Only one scene is supported for now
+  // extend the sensor system to support mutliple scenes in the future
+  this->EachNew<components::World, components::Scene>(_ecm,
+      [&](const Entity & _entity,
+        const components::World *,
+        const components::Scene *_scene)->bool
+      {
+        this->sceneManager.SetWorldId(_entity);
+        const sdf::Scene &sceneSdf = _scene->Data();
+        this->newScenes.push_back(sceneSdf);
+        return true;
+      });
 
-    _ecm.Each<components::Model, components::Name, components::Pose,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Model *,
-            const components::Name *_name,
-            const components::Pose *_pose,
-            const components::ParentEntity *_parent)->bool
-        {
-          sdf::Model model;
-          model.SetName(_name->Data());
-          model.SetRawPose(_pose->Data());
-          this->newModels.push_back(
-              std::make_tuple(_entity, model, _parent->Data(),
-              _info.iterations));
-          this->modelToModelEntities[_parent->Data()].push_back(_entity);
-          return true;
-        });
 
-    _ecm.Each<components::Link, components::Name, components::Pose,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Link *,
-            const components::Name *_name,
-            const components::Pose *_pose,
-            const components::ParentEntity *_parent)->bool
-        {
-          sdf::Link link;
-          link.SetName(_name->Data());
-          link.SetRawPose(_pose->Data());
-          this->newLinks.push_back(
-              std::make_tuple(_entity, link, _parent->Data()));
-          // used for collsions
-          this->modelToLinkEntities[_parent->Data()].push_back(_entity);
-          return true;
-        });
+  this->EachNew<components::Model, components::Name, components::Pose,
+                components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::Model *,
+          const components::Name *_name,
+          const components::Pose *_pose,
+          const components::ParentEntity *_parent)->bool
+      {
+        sdf::Model model;
+        model.SetName(_name->Data());
+        model.SetRawPose(_pose->Data());
+        this->newModels.push_back(
+            std::make_tuple(_entity, model, _parent->Data(),
+            _info.iterations));
+        this->modelToModelEntities[_parent->Data()].push_back(_entity);
+        this->poseEntities.insert(_entity);
+        return true;
+      });
 
-    // visuals
-    _ecm.Each<components::Visual, components::Name, components::Pose,
-              components::Geometry,
-              components::CastShadows,
-              components::Transparency,
-              components::VisibilityFlags,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Visual *,
-            const components::Name *_name,
-            const components::Pose *_pose,
-            const components::Geometry *_geom,
-            const components::CastShadows *_castShadows,
-            const components::Transparency *_transparency,
-            const components::VisibilityFlags *_visibilityFlags,
-            const components::ParentEntity *_parent)->bool
+  this->EachNew<components::Link, components::Name, components::Pose,
+                components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::Link *,
+          const components::Name *_name,
+          const components::Pose *_pose,
+          const components::ParentEntity *_parent)->bool
+      {
+        sdf::Link link;
+        link.SetName(_name->Data());
+        link.SetRawPose(_pose->Data());
+        this->newLinks.push_back(
+            std::make_tuple(_entity, link, _parent->Data()));
+        // used for collsions
+        this->modelToLinkEntities[_parent->Data()].push_back(_entity);
+        this->poseEntities.insert(_entity);
+        return true;
+      });
+
+  // visuals
+  this->EachNew<components::Visual, components::Name, components::Pose,
+                components::Geometry,
+                components::CastShadows,
+                components::Transparency,
+                components::VisibilityFlags,
+                components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::Visual *,
+          const components::Name *_name,
+          const components::Pose *_pose,
+          const components::Geometry *_geom,
+          const components::CastShadows *_castShadows,
+          const components::Transparency *_transparency,
+          const components::VisibilityFlags *_visibilityFlags,
+          const components::ParentEntity *_parent)->bool
+      {
+        sdf::Visual visual;
+        visual.SetName(_name->Data());
+        visual.SetRawPose(_pose->Data());
+        visual.SetGeom(_geom->Data());
+        visual.SetCastShadows(_castShadows->Data());
+        visual.SetTransparency(_transparency->Data());
+        visual.SetVisibilityFlags(_visibilityFlags->Data());
+
+        // Optional components
+        auto material = _ecm.Component<components::Material>(_entity);
+        if (material != nullptr)
         {
-          sdf::Visual visual;
-          visual.SetName(_name->Data());
-          visual.SetRawPose(_pose->Data());
-          visual.SetGeom(_geom->Data());
-          visual.SetCastShadows(_castShadows->Data());
-          visual.SetTransparency(_transparency->Data());
-          visual.SetVisibilityFlags(_visibilityFlags->Data());
-
-          // Optional components
-          auto material = _ecm.Component<components::Material>(_entity);
-          if (material != nullptr)
-          {
-            visual.SetMaterial(material->Data());
-          }
+          visual.SetMaterial(material->Data());
+        }
 
-          auto laserRetro = _ecm.Component<components::LaserRetro>(_entity);
-          if (laserRetro != nullptr)
-          {
-            visual.SetLaserRetro(laserRetro->Data());
-          }
+        auto laserRetro = _ecm.Component<components::LaserRetro>(_entity);
+        if (laserRetro != nullptr)
+        {
+          visual.SetLaserRetro(laserRetro->Data());
+        }
 
-          if (auto temp = _ecm.Component<components::Temperature>(_entity))
+        if (auto temp = _ecm.Component<components::Temperature>(_entity))
+        {
+          // get the uniform temperature for the entity
+          this->entityTemp[_entity] =
+            std::make_tuple<float, float, std::string>(
+                temp->Data().Kelvin(), 0.0, "");
+        }
+        else
+        {
+          // entity doesn't have a uniform temperature. Check if it has
+          // a heat signature with an associated temperature range
+          auto heatSignature =
+            _ecm.Component<components::SourceFilePath>(_entity);
+          auto tempRange =
+             _ecm.Component<components::TemperatureRange>(_entity);
+          if (heatSignature && tempRange)
           {
-            // get the uniform temperature for the entity
             this->entityTemp[_entity] =
               std::make_tuple<float, float, std::string>(
-                  temp->Data().Kelvin(), 0.0, "");
+                  tempRange->Data().min.Kelvin(),
+                  tempRange->Data().max.Kelvin(),
+                  std::string(heatSignature->Data()));
           }
-          else
+        }
+
+        // Start loading meshes in the background, each one only once, so
+        // they're ready by the time the visuals are created in the
+        // rendering thread.
+        if (_geom->Data().Type() == sdf::GeometryType::MESH &&
+            _geom->Data().MeshShape())
+        {
+          auto fullPath = asFullPath(_geom->Data().MeshShape()->Uri(),
+              _geom->Data().MeshShape()->FilePath());
+          if (!fullPath.empty() &&
+              this->requestedMeshes.insert(fullPath).second)
           {
-            // entity doesn't have a uniform temperature. Check if it has
-            // a heat signature with an associated temperature range
-            auto heatSignature =
-              _ecm.Component<components::SourceFilePath>(_entity);
-            auto tempRange =
-               _ecm.Component<components::TemperatureRange>(_entity);
-            if (heatSignature && tempRange)
-            {
-              this->entityTemp[_entity] =
-                std::make_tuple<float, float, std::string>(
-                    tempRange->Data().min.Kelvin(),
-                    tempRange->Data().max.Kelvin(),
-                    std::string(heatSignature->Data()));
-            }
+            newMeshes.push_back(fullPath);
           }
+        }
 
-          this->newVisuals.push_back(
-              std::make_tuple(_entity, visual, _parent->Data()));
-          return true;
-        });
+        this->newVisuals.push_back(
+            std::make_tuple(_entity, visual, _parent->Data()));
+        this->poseEntities.insert(_entity);
+        return true;
+      });
 
-    // actors
-    _ecm.Each<components::Actor, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Actor *_actor,
-            const components::ParentEntity *_parent) -> bool
-        {
-          this->newActors.push_back(
-              std::make_tuple(_entity, _actor->Data(), _parent->Data()));
-          return true;
-        });
+  // actors
+  this->EachNew<components::Actor, components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::Actor *_actor,
+          const components::ParentEntity *_parent) -> bool
+      {
+        this->newActors.push_back(
+            std::make_tuple(_entity, _actor->Data(), _parent->Data()));
+        return true;
+      });
 
-    // lights
-    _ecm.Each<components::Light, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Light *_light,
-            const components::ParentEntity *_parent) -> bool
-        {
-          this->newLights.push_back(
-              std::make_tuple(_entity, _light->Data(), _parent->Data()));
-          return true;
-        });
+  // lights
+  this->EachNew<components::Light, components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::Light *_light,
+          const components::ParentEntity *_parent) -> bool
+      {
+        this->newLights.push_back(
+            std::make_tuple(_entity, _light->Data(), _parent->Data()));
+        this->poseEntities.insert(_entity);
+        return true;
+      });
 
-    // collisions
-    _ecm.Each<components::Collision, components::Name, components::Pose,
-              components::Geometry, components::CollisionElement,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Collision *,
-            const components::Name *,
-            const components::Pose *,
-            const components::Geometry *,
-            const components::CollisionElement *_collElement,
-            const components::ParentEntity *_parent) -> bool
-        {
-          this->entityCollisions[_entity] = _collElement->Data();
-          this->linkToCollisionEntities[_parent->Data()].push_back(_entity);
-          return true;
-        });
+  // collisions
+  this->EachNew<components::Collision, components::Name, components::Pose,
+                components::Geometry, components::CollisionElement,
+                components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::Collision *,
+          const components::Name *,
+          const components::Pose *,
+          const components::Geometry *,
+          const components::CollisionElement *_collElement,
+          const components::ParentEntity *_parent) -> bool
+      {
+        this->entityCollisions[_entity] = _collElement->Data();
+        this->linkToCollisionEntities[_parent->Data()].push_back(_entity);
+        return true;
+      });
 
-    // particle emitters
-    _ecm.Each<components::ParticleEmitter, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::ParticleEmitter *_emitter,
-            const components::ParentEntity *_parent) -> bool
-        {
-          this->newParticleEmitters.push_back(
-              std::make_tuple(_entity, _emitter->Data(), _parent->Data()));
-          return true;
-        });
+  // particle emitters
+  this->EachNew<components::ParticleEmitter,
+                components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::ParticleEmitter *_emitter,
+          const components::ParentEntity *_parent) -> bool
+      {
+        this->newParticleEmitters.push_back(
+            std::make_tuple(_entity, _emitter->Data(), _parent->Data()));
+        return true;
+      });
 
-    if (this->enableSensors)
-    {
-      // Create cameras
-      _ecm.Each<components::Camera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Camera *_camera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _camera->Data(), _parent->Data(),
-                         cameraSuffix);
-            return true;
-          });
-
-      // Create depth cameras
-      _ecm.Each<components::DepthCamera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::DepthCamera *_depthCamera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _depthCamera->Data(), _parent->Data(),
-                         depthCameraSuffix);
-            return true;
-          });
-
-      // Create rgbd cameras
-      _ecm.Each<components::RgbdCamera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::RgbdCamera *_rgbdCamera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _rgbdCamera->Data(), _parent->Data(),
-                         rgbdCameraSuffix);
-            return true;
-          });
-
-      // Create gpu lidar
-      _ecm.Each<components::GpuLidar, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::GpuLidar *_gpuLidar,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _gpuLidar->Data(), _parent->Data(),
-                         gpuLidarSuffix);
-            return true;
-          });
-
-      // Create thermal camera
-      _ecm.Each<components::ThermalCamera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::ThermalCamera *_thermalCamera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _thermalCamera->Data(), _parent->Data(),
-                         thermalCameraSuffix);
-            return true;
-          });
-    }
-    this->initialized = true;
-  }
-  else
+  if (this->enableSensors)
   {
-    // Get all the new worlds
-    // TODO(anyone) Only one scene is supported for now
-    // extend the sensor system to support mutliple scenes in the future
-    _ecm.EachNew<components::World, components::Scene>(
-        [&](const Entity & _entity,
-          const components::World *,
-          const components::Scene *_scene)->bool
-        {
-          this->sceneManager.SetWorldId(_entity);
-          const sdf::Scene &sceneSdf = _scene->Data();
-          this->newScenes.push_back(sceneSdf);
-          return true;
-        });
-
-    _ecm.EachNew<components::Model, components::Name, components::Pose,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Model *,
-            const components::Name *_name,
-            const components::Pose *_pose,
-            const components::ParentEntity *_parent)->bool
-        {
-          sdf::Model model;
-          model.SetName(_name->Data());
-          model.SetRawPose(_pose->Data());
-          this->newModels.push_back(
-              std::make_tuple(_entity, model, _parent->Data(),
-              _info.iterations));
-          this->modelToModelEntities[_parent->Data()].push_back(_entity);
-          return true;
-        });
-
-    _ecm.EachNew<components::Link, components::Name, components::Pose,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Link *,
-            const components::Name *_name,
-            const components::Pose *_pose,
-            const components::ParentEntity *_parent)->bool
+    // Create cameras
+    this->EachNew<components::Camera, components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::Camera *_camera,
+          const components::ParentEntity *_parent)->bool
         {
-          sdf::Link link;
-          link.SetName(_name->Data());
-          link.SetRawPose(_pose->Data());
-          this->newLinks.push_back(
-              std::make_tuple(_entity, link, _parent->Data()));
-          // used for collsions
-          this->modelToLinkEntities[_parent->Data()].push_back(_entity);
+          addNewSensor(_entity, _camera->Data(), _parent->Data(),
+                       cameraSuffix);
           return true;
         });
 
-    // visuals
-    _ecm.EachNew<components::Visual, components::Name, components::Pose,
-              components::Geometry,
-              components::CastShadows,
-              components::Transparency,
-              components::VisibilityFlags,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Visual *,
-            const components::Name *_name,
-            const components::Pose *_pose,
-            const components::Geometry *_geom,
-            const components::CastShadows *_castShadows,
-            const components::Transparency *_transparency,
-            const components::VisibilityFlags *_visibilityFlags,
-            const components::ParentEntity *_parent)->bool
+    // Create depth cameras
+    this->EachNew<components::DepthCamera, components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::DepthCamera *_depthCamera,
+          const components::ParentEntity *_parent)->bool
         {
-          sdf::Visual visual;
-          visual.SetName(_name->Data());
-          visual.SetRawPose(_pose->Data());
-          visual.SetGeom(_geom->Data());
-          visual.SetCastShadows(_castShadows->Data());
-          visual.SetTransparency(_transparency->Data());
-          visual.SetVisibilityFlags(_visibilityFlags->Data());
-
-          // Optional components
-          auto material = _ecm.Component<components::Material>(_entity);
-          if (material != nullptr)
-          {
-            visual.SetMaterial(material->Data());
-          }
-
-          auto laserRetro = _ecm.Component<components::LaserRetro>(_entity);
-          if (laserRetro != nullptr)
-          {
-            visual.SetLaserRetro(laserRetro->Data());
-          }
-
-          if (auto temp = _ecm.Component<components::Temperature>(_entity))
-          {
-            // get the uniform temperature for the entity
-            this->entityTemp[_entity] =
-              std::make_tuple<float, float, std::string>(
-                  temp->Data().Kelvin(), 0.0, "");
-          }
-          else
-          {
-            // entity doesn't have a uniform temperature. Check if it has
-            // a heat signature with an associated temperature range
-            auto heatSignature =
-              _ecm.Component<components::SourceFilePath>(_entity);
-            auto tempRange =
-               _ecm.Component<components::TemperatureRange>(_entity);
-            if (heatSignature && tempRange)
-            {
-              this->entityTemp[_entity] =
-                std::make_tuple<float, float, std::string>(
-                    tempRange->Data().min.Kelvin(),
-                    tempRange->Data().max.Kelvin(),
-                    std::string(heatSignature->Data()));
-            }
-          }
-
-          this->newVisuals.push_back(
-              std::make_tuple(_entity, visual, _parent->Data()));
+          addNewSensor(_entity, _depthCamera->Data(), _parent->Data(),
+                       depthCameraSuffix);
           return true;
         });
 
-    // actors
-    _ecm.EachNew<components::Actor, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Actor *_actor,
-            const components::ParentEntity *_parent) -> bool
+    // Create rgbd cameras
+    this->EachNew<components::RgbdCamera, components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::RgbdCamera *_rgbdCamera,
+          const components::ParentEntity *_parent)->bool
         {
-          this->newActors.push_back(
-              std::make_tuple(_entity, _actor->Data(), _parent->Data()));
+          addNewSensor(_entity, _rgbdCamera->Data(), _parent->Data(),
+                       rgbdCameraSuffix);
           return true;
         });
 
-    // lights
-    _ecm.EachNew<components::Light, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Light *_light,
-            const components::ParentEntity *_parent) -> bool
+    // Create gpu lidar
+    this->EachNew<components::GpuLidar, components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::GpuLidar *_gpuLidar,
+          const components::ParentEntity *_parent)->bool
         {
-          this->newLights.push_back(
-              std::make_tuple(_entity, _light->Data(), _parent->Data()));
+          addNewSensor(_entity, _gpuLidar->Data(), _parent->Data(),
+                       gpuLidarSuffix);
           return true;
         });
 
-    // collisions
-    _ecm.EachNew<components::Collision, components::Name, components::Pose,
-              components::Geometry, components::CollisionElement,
-              components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Collision *,
-            const components::Name *,
-            const components::Pose *,
-            const components::Geometry *,
-            const components::CollisionElement *_collElement,
-            const components::ParentEntity *_parent) -> bool
+    // Create thermal camera
+    this->EachNew<components::ThermalCamera, components::ParentEntity>(_ecm,
+      [&](const Entity &_entity,
+          const components::ThermalCamera *_thermalCamera,
+          const components::ParentEntity *_parent)->bool
         {
-          this->entityCollisions[_entity] = _collElement->Data();
-          this->linkToCollisionEntities[_parent->Data()].push_back(_entity);
+          addNewSensor(_entity, _thermalCamera->Data(), _parent->Data(),
+                       thermalCameraSuffix);
           return true;
         });
-
-    // particle emitters
-    _ecm.EachNew<components::ParticleEmitter, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::ParticleEmitter *_emitter,
-            const components::ParentEntity *_parent) -> bool
+  }
+  if (!newMeshes.empty())
+  {
+    this->meshLoads.push_back(std::async(std::launch::async,
+        [newMeshes]()
         {
-          this->newParticleEmitters.push_back(
-              std::make_tuple(_entity, _emitter->Data(), _parent->Data()));
-          return true;
-        });
-
-    if (this->enableSensors)
-    {
-      // Create cameras
-      _ecm.EachNew<components::Camera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::Camera *_camera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _camera->Data(), _parent->Data(),
-                         cameraSuffix);
-            return true;
-          });
-
-      // Create depth cameras
-      _ecm.EachNew<components::DepthCamera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::DepthCamera *_depthCamera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _depthCamera->Data(), _parent->Data(),
-                         depthCameraSuffix);
-            return true;
-          });
-
-      // Create RGBD cameras
-      _ecm.EachNew<components::RgbdCamera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::RgbdCamera *_rgbdCamera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _rgbdCamera->Data(), _parent->Data(),
-                         rgbdCameraSuffix);
-            return true;
-          });
-
-      // Create gpu lidar
-      _ecm.EachNew<components::GpuLidar, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::GpuLidar *_gpuLidar,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _gpuLidar->Data(), _parent->Data(),
-                         gpuLidarSuffix);
-            return true;
-          });
-
-      // Create thermal camera
-      _ecm.EachNew<components::ThermalCamera, components::ParentEntity>(
-        [&](const Entity &_entity,
-            const components::ThermalCamera *_thermalCamera,
-            const components::ParentEntity *_parent)->bool
-          {
-            addNewSensor(_entity, _thermalCamera->Data(), _parent->Data(),
-                         thermalCameraSuffix);
-            return true;
-          });
-    }
+          for (const auto &mesh : newMeshes)
+            SceneManager::LoadMesh(mesh);
+        }));
   }
+
+  this->initialized = true;
 }
 
 //////////////////////////////////////////////////
@@ -1418,33 +1320,40 @@ void RenderUtilPrivate::UpdateRenderingEntities(
     const EntityComponentManager &_ecm)
 {
   IGN_PROFILE("RenderUtilPrivate::UpdateRenderingEntities");
-  _ecm.Each<components::Model, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Model *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
+  auto copyPose = [&](const Entity _entity)
+  {
+    auto pose = _ecm.Component<components::Pose>(_entity);
+    if (pose)
+      this->entityPoses[_entity] = pose->Data();
+  };
 
-  _ecm.Each<components::Link, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Link *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
+  if (this->updateAllPoses)
+  {
+    IGN_PROFILE("All poses");
+    for (const auto entity : this->poseEntities)
+      copyPose(entity);
+    this->updateAllPoses = false;
+  }
+  else
+  {
+    // Only entities which had a component modified can have a new pose, so
+    // there's no need to walk over all the models, links, visuals, etc.
+    // Newly created entities get their initial pose on creation.
+    IGN_PROFILE("Changed poses");
+    for (const auto entity : _ecm.ModifiedEntities())
+    {
+      if (this->poseEntities.find(entity) == this->poseEntities.end())
+        continue;
 
-  // visuals
-  _ecm.Each<components::Visual, components::Pose >(
-      [&](const Entity &_entity,
-        const components::Visual *,
-        const components::Pose *_pose)->bool
+      if (_ecm.ComponentState(entity, components::Pose::typeId) ==
+          ComponentState::NoChange)
       {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
+        continue;
+      }
+
+      copyPose(entity);
+    }
+  }
 
   // actors
   _ecm.Each<components::Actor, components::Pose>(
@@ -1500,66 +1409,6 @@ void RenderUtilPrivate::UpdateRenderingEntities(
           this->trajectoryPoses[_entity] = trajPoseComp->Data();
         return true;
       });
-
-  // update lights
-  _ecm.Each<components::Light, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Light *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update cameras
-  _ecm.Each<components::Camera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Camera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update depth cameras
-  _ecm.Each<components::DepthCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::DepthCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update RGBD cameras
-  _ecm.Each<components::RgbdCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::RgbdCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update gpu_lidar
-  _ecm.Each<components::GpuLidar, components::Pose>(
-      [&](const Entity &_entity,
-        const components::GpuLidar *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update thermal cameras
-  _ecm.Each<components::ThermalCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::ThermalCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
 }
 
 //////////////////////////////////////////////////
@@ -1567,6 +1416,13 @@ void RenderUtilPrivate::RemoveRenderingEntities(
     const EntityComponentManager &_ecm, const UpdateInfo &_info)
 {
   IGN_PROFILE("RenderUtilPrivate::RemoveRenderingEntities");
+  _ecm.EachRemoved<components::Pose>(
+      [&](const Entity &_entity, const components::Pose *)->bool
+      {
+        this->poseEntities.erase(_entity);
+        return true;
+      });
+
   _ecm.EachRemoved<components::Model>(
       [&](const Entity &_entity, const components::Model *)->bool
       {
@@ -1777,6 +1633,19 @@ void RenderUtil::SetSkyEnabled(bool _enabled)
   this->dataPtr->skyEnabled = _enabled;
 }
 
+/////////////////////////////////////////////////
+void RenderUtil::SetCullingEnabled(bool _enabled)
+{
+  this->dataPtr->cullingEnabled = _enabled;
+}
+
+/////////////////////////////////////////////////
+void RenderUtil::SetCullingSensors(
+    const std::vector<std::string> &_sensorNames)
+{
+  this->dataPtr->cullingSensors = _sensorNames;
+}
+
 /////////////////////////////////////////////////
 void RenderUtil::SetUseCurrentGLContext(bool _enable)
 {
@@ -1867,6 +1736,11 @@ const std::vector<Entity> &RenderUtil::SelectedEntities() const
 /////////////////////////////////////////////////
 void RenderUtil::SetTransformActive(bool _active)
 {
+  std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
+  // Entities may have been left at a preview pose which the server didn't
+  // confirm, so resync all poses once the transform is done.
+  if (this->dataPtr->transformActive && !_active)
+    this->dataPtr->updateAllPoses = true;
   this->dataPtr->transformActive = _active;
 }
 
@@ -1958,6 +1832,161 @@ void RenderUtilPrivate::RemoveSensor(const Entity _entity)
   }
 }
 
+/////////////////////////////////////////////////
+void RenderUtilPrivate::CullPoses(
+    std::unordered_map<Entity, math::Pose3d> &_poses,
+    const std::function<void(Entity, const math::Pose3d &)> &_applyPose)
+{
+  IGN_PROFILE("RenderUtilPrivate::CullPoses");
+
+  // Updates held back before are applied now unless they've been superseded
+  _poses.insert(this->deferredPoses.begin(), this->deferredPoses.end());
+  this->deferredPoses.clear();
+
+  std::vector<rendering::CameraPtr> cameras;
+  std::unordered_set<rendering::NodePtr> sensorTopLevels;
+  for (const auto &name : this->cullingSensors)
+  {
+    // Lidars are cameras too
+    auto camera = std::dynamic_pointer_cast<rendering::Camera>(
+        this->scene->SensorByName(name));
+
+    // Without knowing what a sensor sees nothing can be culled
+    if (!camera)
+      return;
+
+    cameras.push_back(camera);
+    sensorTopLevels.insert(this->sceneManager.TopLevelNode(camera));
+  }
+
+  // Models carrying the sensors are moved first, so the views are current
+  std::vector<std::pair<Entity, rendering::VisualPtr>> candidates;
+  for (auto it = _poses.begin(); it != _poses.end();)
+  {
+    auto node = this->sceneManager.NodeById(it->first);
+    auto topLevel = node ? this->sceneManager.TopLevelNode(node) : nullptr;
+    if (topLevel && sensorTopLevels.count(topLevel))
+    {
+      _applyPose(it->first, it->second);
+      it = _poses.erase(it);
+      continue;
+    }
+
+    // Only visuals are culled. Lights are seen through what they light, and
+    // actor trajectories are computed from their poses later on.
+    auto topVis = std::dynamic_pointer_cast<rendering::Visual>(topLevel);
+    if (topVis && !this->sceneManager.ActorMeshById(it->first))
+      candidates.emplace_back(it->first, topVis);
+    ++it;
+  }
+
+  // Models whose parts move relative to each other change their bounds, so
+  // they aren't culled and their radii are computed again once the parts
+  // have moved
+  std::unordered_set<rendering::VisualPtr> reshaped;
+  for (const auto &candidate : candidates)
+  {
+    auto node = this->sceneManager.NodeById(candidate.first);
+    if (node != candidate.second)
+      reshaped.insert(candidate.second);
+  }
+
+  std::vector<SensorView> views;
+  for (const auto &camera : cameras)
+  {
+    SensorView view;
+    view.position = camera->WorldPosition();
+    view.direction = camera->WorldRotation() * math::Vector3d::UnitX;
+    view.range = camera->FarClipPlane();
+
+    double hfov = camera->HFOV().Radian();
+    if (!std::dynamic_pointer_cast<rendering::GpuRays>(camera) &&
+        hfov < IGN_PI && camera->AspectRatio() > 0.0)
+    {
+      double tanH = std::tan(hfov * 0.5);
+      double tanV = tanH / camera->AspectRatio();
+      view.halfAngle = std::atan(std::sqrt(tanH * tanH + tanV * tanV));
+    }
+    views.push_back(view);
+  }
+
+  // A model may be seen if it is in view either before or after moving
+  std::unordered_map<rendering::VisualPtr, bool> topLevelSeen;
+  for (const auto &candidate : candidates)
+  {
+    const auto &topVis = candidate.second;
+    auto seenIt = topLevelSeen.find(topVis);
+    if (seenIt == topLevelSeen.end())
+    {
+      // Top level visuals without an entity, such as markers, aren't culled
+      auto userData = topVis->UserData("gazebo-entity");
+      bool seen = true;
+      if (std::holds_alternative<int>(userData))
+      {
+        auto topEntity = static_cast<Entity>(std::get<int>(userData));
+        if (reshaped.count(topVis))
+        {
+          this->cullingRadii.erase(topEntity);
+        }
+        else
+        {
+          double radius = this->CullingRadius(topEntity, topVis);
+          seen = radius < 0.0 ||
+              mayBeSeen(views, topVis->WorldPosition(), radius);
+          auto topPose = _poses.find(topEntity);
+          if (!seen && topPose != _poses.end())
+            seen = mayBeSeen(views, topPose->second.Pos(), radius);
+        }
+      }
+
+      seenIt = topLevelSeen.emplace(topVis, seen).first;
+    }
+
+    if (!seenIt->second)
+    {
+      this->deferredPoses[candidate.first] = _poses[candidate.first];
+      _poses.erase(candidate.first);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+double RenderUtilPrivate::CullingRadius(Entity _entity,
+    const rendering::VisualPtr &_visual)
+{
+  auto it = this->cullingRadii.find(_entity);
+  if (it != this->cullingRadii.end())
+    return it->second;
+
+  // Models with lights affect what's around them, so they're never culled
+  double radius{0.0};
+  std::stack<rendering::NodePtr> nodes;
+  nodes.push(_visual);
+  while (!nodes.empty() && radius >= 0.0)
+  {
+    auto node = nodes.top();
+    nodes.pop();
+    if (std::dynamic_pointer_cast<rendering::Light>(node))
+      radius = -1.0;
+
+    for (auto i = 0u; i < node->ChildCount(); ++i)
+      nodes.push(node->ChildByIndex(i));
+  }
+
+  if (radius >= 0.0)
+  {
+    auto box = _visual->BoundingBox();
+    if (box.Size().IsFinite())
+    {
+      radius = (box.Center() - _visual->WorldPosition()).Length() +
+          box.Size().Length() * 0.5;
+    }
+  }
+
+  this->cullingRadii[_entity] = radius;
+  return radius;
+}
+
 /////////////////////////////////////////////////
 void RenderUtilPrivate::RemoveBoundingBox(const Entity _entity)
 {
@@ -16,7 +16,13 @@
  */
 
 
+#include <algorithm>
 #include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <sdf/Box.hh>
 #include <sdf/Capsule.hh>
@@ -55,6 +61,8 @@
 #include "ignition/gazebo/Util.hh"
 #include "ignition/gazebo/rendering/SceneManager.hh"
 
+#include "MaterialKey.hh"
+
 using namespace ignition;
 using namespace gazebo;
 using namespace std::chrono_literals;
@@ -95,6 +103,25 @@ class ignition::gazebo::SceneManagerPrivate
   /// \brief Map of sensor entity in Gazebo to sensor pointers.
   public: std::map<Entity, rendering::SensorPtr> sensors;
 
+  /// \brief True while visuals are being created through CreateVisuals.
+  public: bool batching{false};
+
+  /// \brief Materials loaded while batching, keyed by their properties.
+  /// They're shared by all visuals in the batch and destroyed at the end.
+  public: std::map<std::string, rendering::MaterialPtr> batchMaterials;
+
+  /// \brief True if visuals which look the same share a material.
+  public: bool instancingEnabled{false};
+
+  /// \brief Materials shared among visuals when instancing is enabled,
+  /// keyed by their properties. The value holds the material and how many
+  /// visuals are using it.
+  public: std::map<std::string, std::pair<rendering::MaterialPtr, unsigned int>>
+      sharedMaterials;
+
+  /// \brief Key of the shared material used by each visual entity.
+  public: std::map<Entity, std::string> visualSharedMaterials;
+
   /// \brief Helper function to compute actor trajectory at specified tiime
   /// \param[in] _id Actor entity's unique id
   /// \param[in] _time Simulation time
@@ -308,10 +335,25 @@ rendering::VisualPtr SceneManager::CreateVisual(Entity _id,
 
     // set material
     rendering::MaterialPtr material{nullptr};
+    // True if the material is shared by a batch of visuals and will be
+    // destroyed at the end of the batch
+    bool batchMaterial{false};
     if (_visual.Geom()->Type() == sdf::GeometryType::HEIGHTMAP)
     {
       // Heightmap's material is loaded together with it.
     }
+    else if (_visual.Material() && this->dataPtr->batching)
+    {
+      auto key = materialKey(*_visual.Material());
+      auto it = this->dataPtr->batchMaterials.find(key);
+      if (it == this->dataPtr->batchMaterials.end())
+      {
+        it = this->dataPtr->batchMaterials.insert(
+            {key, this->LoadMaterial(*_visual.Material())}).first;
+      }
+      material = it->second;
+      batchMaterial = true;
+    }
     else if (_visual.Material())
     {
       material = this->LoadMaterial(*_visual.Material());
@@ -332,6 +374,11 @@ rendering::VisualPtr SceneManager::CreateVisual(Entity _id,
         material->SetRoughness(0.2f);
         material->SetMetalness(1.0f);
       }
+      if (this->dataPtr->batching)
+      {
+        this->dataPtr->batchMaterials["ign-grey"] = material;
+        batchMaterial = true;
+      }
     }
     else
     {
@@ -352,7 +399,26 @@ rendering::VisualPtr SceneManager::CreateVisual(Entity _id,
       }
     }
 
-    if (material)
+    if (material && this->dataPtr->instancingEnabled)
+    {
+      // All visuals with the same look use the same material, so the render
+      // engine can draw the ones which also share a mesh as instances.
+      auto key = sharedMaterialKey(_visual, material->Name());
+      auto &shared = this->dataPtr->sharedMaterials[key];
+      if (!shared.first)
+      {
+        shared.first = material->Clone();
+        shared.first->SetTransparency(_visual.Transparency());
+        shared.first->SetCastShadows(_visual.CastShadows());
+      }
+      ++shared.second;
+      this->dataPtr->visualSharedMaterials[_id] = key;
+
+      geom->SetMaterial(shared.first, false);
+      if (!batchMaterial)
+        this->dataPtr->scene->DestroyMaterial(material);
+    }
+    else if (material)
     {
       // set transparency
       material->SetTransparency(_visual.Transparency());
@@ -365,7 +431,8 @@ rendering::VisualPtr SceneManager::CreateVisual(Entity _id,
       // but does not take ownership of it so we need to destroy it here.
       // This is not ideal. We should let ign-rendering handle the lifetime
       // of this material
-      this->dataPtr->scene->DestroyMaterial(material);
+      if (!batchMaterial)
+        this->dataPtr->scene->DestroyMaterial(material);
     }
   }
   else
@@ -384,6 +451,55 @@ rendering::VisualPtr SceneManager::CreateVisual(Entity _id,
   return visualVis;
 }
 
+/////////////////////////////////////////////////
+std::vector<rendering::VisualPtr> SceneManager::CreateVisuals(
+    const std::vector<std::tuple<Entity, sdf::Visual, Entity>> &_visuals)
+{
+  std::vector<rendering::VisualPtr> result(_visuals.size());
+  if (!this->dataPtr->scene)
+    return result;
+
+  // Group visuals which share resources. Visuals are never parents of other
+  // visuals, so the creation order within the batch doesn't matter.
+  std::vector<std::pair<std::string, size_t>> order;
+  order.reserve(_visuals.size());
+  for (size_t i = 0; i < _visuals.size(); ++i)
+    order.emplace_back(visualResourceKey(std::get<1>(_visuals[i])), i);
+
+  std::stable_sort(order.begin(), order.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  this->dataPtr->batching = true;
+  for (const auto &entry : order)
+  {
+    const auto &visual = _visuals[entry.second];
+    result[entry.second] = this->CreateVisual(std::get<0>(visual),
+        std::get<1>(visual), std::get<2>(visual));
+  }
+  this->dataPtr->batching = false;
+
+  for (auto &material : this->dataPtr->batchMaterials)
+    this->dataPtr->scene->DestroyMaterial(material.second);
+  this->dataPtr->batchMaterials.clear();
+
+  return result;
+}
+
+/////////////////////////////////////////////////
+void SceneManager::SetInstancingEnabled(bool _enabled)
+{
+  this->dataPtr->instancingEnabled = _enabled;
+}
+
+/////////////////////////////////////////////////
+bool SceneManager::InstancingEnabled() const
+{
+  return this->dataPtr->instancingEnabled;
+}
+
 /////////////////////////////////////////////////
 rendering::VisualPtr SceneManager::VisualById(Entity _id)
 {
@@ -485,9 +601,7 @@ rendering::GeometryPtr SceneManager::LoadGeometry(const sdf::Geometry &_geom,
     descriptor.subMeshName = _geom.MeshShape()->Submesh();
     descriptor.centerSubMesh = _geom.MeshShape()->CenterSubmesh();
 
-    ignition::common::MeshManager *meshManager =
-        ignition::common::MeshManager::Instance();
-    descriptor.mesh = meshManager->Load(descriptor.meshName);
+    descriptor.mesh = SceneManager::LoadMesh(descriptor.meshName);
     geom = this->dataPtr->scene->CreateMesh(descriptor);
     scale = _geom.MeshShape()->Scale();
   }
@@ -551,6 +665,13 @@ rendering::GeometryPtr SceneManager::LoadGeometry(const sdf::Geometry &_geom,
   return geom;
 }
 
+/////////////////////////////////////////////////
+const common::Mesh *SceneManager::LoadMesh(const std::string &_fullPath)
+{
+  std::lock_guard<std::mutex> lock(meshManagerMutex());
+  return common::MeshManager::Instance()->Load(_fullPath);
+}
+
 /////////////////////////////////////////////////
 rendering::MaterialPtr SceneManager::LoadMaterial(
     const sdf::Material &_material)
@@ -724,8 +845,7 @@ rendering::VisualPtr SceneManager::CreateActor(Entity _id,
 
   rendering::MeshDescriptor descriptor;
   descriptor.meshName = asFullPath(_actor.SkinFilename(), _actor.FilePath());
-  common::MeshManager *meshManager = common::MeshManager::Instance();
-  descriptor.mesh = meshManager->Load(descriptor.meshName);
+  descriptor.mesh = SceneManager::LoadMesh(descriptor.meshName);
   if (nullptr == descriptor.mesh)
   {
     ignerr << "Actor skin mesh [" << descriptor.meshName << "] not found."
@@ -783,17 +903,21 @@ rendering::VisualPtr SceneManager::CreateActor(Entity _id,
     {
       // Load the mesh if it has not been loaded before
       const common::Mesh *animMesh = nullptr;
-      if (!meshManager->HasMesh(animFilename))
       {
-        animMesh = meshManager->Load(animFilename);
-        if (animMesh->MeshSkeleton()->AnimationCount() > 1)
+        std::lock_guard<std::mutex> lock(meshManagerMutex());
+        common::MeshManager *meshManager = common::MeshManager::Instance();
+        if (!meshManager->HasMesh(animFilename))
         {
-          ignwarn << "File [" << animFilename
-              << "] has more than one animation, but only the 1st one is used."
-              << std::endl;
+          animMesh = meshManager->Load(animFilename);
+          if (animMesh->MeshSkeleton()->AnimationCount() > 1)
+          {
+            ignwarn << "File [" << animFilename
+                << "] has more than one animation, but only the 1st one is "
+                << "used." << std::endl;
+          }
         }
+        animMesh = meshManager->MeshByName(animFilename);
       }
-      animMesh = meshManager->MeshByName(animFilename);
 
       // add the first animation
       auto firstAnim = animMesh->MeshSkeleton()->Animation(0);
@@ -1602,6 +1726,20 @@ void SceneManager::RemoveEntity(Entity _id)
     {
       this->dataPtr->scene->DestroyVisual(it->second);
       this->dataPtr->visuals.erase(it);
+
+      // Release the visual's shared material
+      auto matIt = this->dataPtr->visualSharedMaterials.find(_id);
+      if (matIt != this->dataPtr->visualSharedMaterials.end())
+      {
+        auto sharedIt = this->dataPtr->sharedMaterials.find(matIt->second);
+        if (sharedIt != this->dataPtr->sharedMaterials.end() &&
+            --sharedIt->second.second == 0u)
+        {
+          this->dataPtr->scene->DestroyMaterial(sharedIt->second.first);
+          this->dataPtr->sharedMaterials.erase(sharedIt);
+        }
+        this->dataPtr->visualSharedMaterials.erase(matIt);
+      }
       return;
     }
   }
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "SensorView.hh"
+
+#include <cmath>
+
+//////////////////////////////////////////////////
+bool ignition::gazebo::mayBeSeen(const std::vector<SensorView> &_views,
+    const math::Vector3d &_center, double _radius)
+{
+  for (const auto &view : _views)
+  {
+    auto toCenter = _center - view.position;
+    double distance = toCenter.Length();
+    if (distance <= _radius)
+      return true;
+
+    if (distance - _radius > view.range)
+      continue;
+
+    if (view.halfAngle >= IGN_PI)
+      return true;
+
+    double angle = std::acos(math::clamp(
+        view.direction.Dot(toCenter) / distance, -1.0, 1.0));
+    if (angle - std::asin(_radius / distance) <= view.halfAngle)
+      return true;
+  }
+  return false;
+}
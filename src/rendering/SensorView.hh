@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_RENDERING_SENSORVIEW_HH_
+#define IGNITION_GAZEBO_RENDERING_SENSORVIEW_HH_
+
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/gazebo/config.hh"
+#include "ignition/gazebo/rendering/Export.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+/// \brief Region of the scene which a sensor may see.
+struct SensorView
+{
+  /// \brief World position of the sensor
+  math::Vector3d position;
+
+  /// \brief World direction the sensor looks at
+  math::Vector3d direction;
+
+  /// \brief Maximum distance the sensor sees
+  double range{0.0};
+
+  /// \brief Half angle of the cone containing the sensor's field of view.
+  /// IGN_PI for sensors which may see in all directions.
+  double halfAngle{IGN_PI};
+};
+
+/// \brief Get whether a sphere may be seen by any of the given views.
+/// \param[in] _views Sensor views
+/// \param[in] _center Center of the sphere
+/// \param[in] _radius Radius of the sphere
+/// \return True if the sphere is within range and within the field of
+/// view of at least one of the views.
+IGNITION_GAZEBO_RENDERING_VISIBLE
+bool mayBeSeen(const std::vector<SensorView> &_views,
+    const math::Vector3d &_center, double _radius);
+}
+}
+}
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "SensorView.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+TEST(SensorViewTest, Range)
+{
+  // Sees in all directions up to 10 m
+  SensorView view;
+  view.position.Set(1, 0, 0);
+  view.direction = math::Vector3d::UnitX;
+  view.range = 10.0;
+  std::vector<SensorView> views{view};
+
+  EXPECT_TRUE(mayBeSeen(views, {5, 0, 0}, 0.1));
+  EXPECT_TRUE(mayBeSeen(views, {1, -9, 0}, 0.1));
+  EXPECT_FALSE(mayBeSeen(views, {1, 0, 12}, 1.0));
+
+  // Spheres which reach into the range may be seen
+  EXPECT_TRUE(mayBeSeen(views, {1, 0, 12}, 2.5));
+
+  // So do spheres containing the sensor
+  EXPECT_TRUE(mayBeSeen(views, {1, 0, 100}, 200.0));
+
+  // Nothing is seen without views
+  EXPECT_FALSE(mayBeSeen({}, {1, 0, 0}, 1.0));
+}
+
+/////////////////////////////////////////////////
+TEST(SensorViewTest, FieldOfView)
+{
+  // Looks along +X with a 45 degree half angle
+  SensorView view;
+  view.direction = math::Vector3d::UnitX;
+  view.range = 100.0;
+  view.halfAngle = IGN_PI * 0.25;
+  std::vector<SensorView> views{view};
+
+  EXPECT_TRUE(mayBeSeen(views, {10, 0, 0}, 0.5));
+  EXPECT_TRUE(mayBeSeen(views, {10, 5, 5}, 0.5));
+
+  // Behind and to the side of the sensor
+  EXPECT_FALSE(mayBeSeen(views, {-10, 0, 0}, 0.5));
+  EXPECT_FALSE(mayBeSeen(views, {1, 10, 0}, 0.5));
+
+  // Large enough to reach into the field of view
+  EXPECT_TRUE(mayBeSeen(views, {1, 10, 0}, 7.0));
+
+  // In view but out of range
+  EXPECT_FALSE(mayBeSeen(views, {110, 0, 0}, 5.0));
+
+  // Seen by any of the views
+  SensorView behind = view;
+  behind.direction = -math::Vector3d::UnitX;
+  views.push_back(behind);
+  EXPECT_TRUE(mayBeSeen(views, {-10, 0, 0}, 0.5));
+  EXPECT_FALSE(mayBeSeen(views, {1, 10, 0}, 0.5));
+}
@@ -16,12 +16,17 @@
  */
 #include <ignition/msgs/wrench.pb.h>
 
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include <ignition/common/Mesh.hh>
-#include <ignition/common/MeshManager.hh>
 #include <ignition/common/Profiler.hh>
 
 #include <ignition/plugin/Register.hh>
@@ -47,13 +52,44 @@
 #include "ignition/gazebo/Util.hh"
 
 #include "Buoyancy.hh"
+#include "MeshVolumeCache.hh"
 
 using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+/// \brief Volume of a link whose meshes are still being loaded.
+struct PendingVolume
+{
+  /// \brief Sum of the volumes of the link's other collisions.
+  double volume{0};
+
+  /// \brief Sum of the positions of the link's other collisions, in the
+  /// link frame, weighted by their volumes.
+  math::Vector3d weightedPosSum{math::Vector3d::Zero};
+
+  /// \brief Mesh collisions: the mesh's unscaled volume, the product of its
+  /// scale factors and its position in the link frame.
+  std::vector<std::tuple<std::shared_future<double>, double, math::Vector3d>>
+      meshes;
+};
+
 class ignition::gazebo::systems::BuoyancyPrivate
 {
+  /// \brief Start computing the volume and center of volume of a link.
+  /// Primitive shapes are computed right away, while meshes are loaded in
+  /// the background.
+  /// \param[in] _entity Link entity.
+  /// \param[in] _ecm Entity component manager.
+  public: void RequestVolume(const Entity _entity,
+              const EntityComponentManager &_ecm);
+
+  /// \brief Store the volume and center of volume of the links whose
+  /// meshes have been loaded.
+  /// \param[in] _ecm Entity component manager.
+  /// \param[in] _wait True to wait for all meshes to be loaded.
+  public: void StoreVolumes(EntityComponentManager &_ecm, bool _wait);
+
   /// \brief Get the fluid density based on a pose. This function can be
   /// used to adjust the fluid density based on the pose of an object in the
   /// world. This function currently returns a constant value, see the todo
@@ -70,8 +106,146 @@ class ignition::gazebo::systems::BuoyancyPrivate
   /// \brief The density of the fluid in which the object is submerged in
   /// kg/m^3. Defaults to 1000, the fluid density of water.
   public: double fluidDensity{1000};
+
+  /// \brief Links whose volume is being computed.
+  public: std::unordered_map<Entity, PendingVolume> pendingVolumes;
+
+  /// \brief Whether the system has been updated before. Links loaded with
+  /// the world wait for their volumes on the first update, so they're
+  /// buoyant from the start.
+  public: bool firstUpdate{true};
+
+  /// \brief Links which are buoyant, their volume, center of volume and
+  /// world pose. Kept across updates to avoid allocations.
+  public: std::vector<Entity> buoyantLinks;
+
+  /// \brief Volume of each link in buoyantLinks.
+  public: std::vector<double> linkVolumes;
+
+  /// \brief Center of volume of each link in buoyantLinks, in the link frame.
+  public: std::vector<math::Vector3d> linkCenters;
+
+  /// \brief World pose of each link in buoyantLinks.
+  public: std::vector<math::Pose3d> linkPoses;
 };
 
+//////////////////////////////////////////////////
+void BuoyancyPrivate::RequestVolume(const Entity _entity,
+    const EntityComponentManager &_ecm)
+{
+  std::vector<Entity> collisions = _ecm.ChildrenByComponents(
+      _entity, components::Collision());
+
+  PendingVolume pending;
+
+  // Compute the volume of the link by iterating over all the collision
+  // elements and storing each geometry's volume.
+  for (const Entity &collision : collisions)
+  {
+    double volume = 0;
+    const components::CollisionElement *coll =
+      _ecm.Component<components::CollisionElement>(collision);
+
+    if (!coll)
+    {
+      ignerr << "Invalid collision pointer. This shouldn't happen\n";
+      continue;
+    }
+
+    // Collision poses are relative to the link
+    math::Vector3d pos;
+    auto poseComp = _ecm.Component<components::Pose>(collision);
+    if (poseComp)
+      pos = poseComp->Data().Pos();
+
+    switch (coll->Data().Geom()->Type())
+    {
+      case sdf::GeometryType::BOX:
+        volume = coll->Data().Geom()->BoxShape()->Shape().Volume();
+        break;
+      case sdf::GeometryType::SPHERE:
+        volume = coll->Data().Geom()->SphereShape()->Shape().Volume();
+        break;
+      case sdf::GeometryType::CYLINDER:
+        volume = coll->Data().Geom()->CylinderShape()->Shape().Volume();
+        break;
+      case sdf::GeometryType::PLANE:
+        // Ignore plane shapes. They have no volume and are not expected
+        // to be buoyant.
+        break;
+      case sdf::GeometryType::MESH:
+        {
+          auto meshShape = coll->Data().Geom()->MeshShape();
+          std::string file = asFullPath(meshShape->Uri(),
+              meshShape->FilePath());
+          auto scale = meshShape->Scale();
+          pending.meshes.emplace_back(
+              MeshVolumeCache::Instance().Volume(file),
+              std::abs(scale.X() * scale.Y() * scale.Z()), pos);
+          continue;
+        }
+      default:
+        ignerr << "Unsupported collision geometry["
+          << static_cast<int>(coll->Data().Geom()->Type()) << "]\n";
+        break;
+    }
+
+    pending.volume += volume;
+    pending.weightedPosSum += volume * pos;
+  }
+
+  this->pendingVolumes[_entity] = std::move(pending);
+}
+
+//////////////////////////////////////////////////
+void BuoyancyPrivate::StoreVolumes(EntityComponentManager &_ecm, bool _wait)
+{
+  IGN_PROFILE("BuoyancyPrivate::StoreVolumes");
+  for (auto it = this->pendingVolumes.begin();
+       it != this->pendingVolumes.end();)
+  {
+    auto &pending = it->second;
+    bool ready{true};
+    for (const auto &mesh : pending.meshes)
+    {
+      if (_wait)
+      {
+        std::get<0>(mesh).wait();
+      }
+      else if (std::get<0>(mesh).wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready)
+      {
+        ready = false;
+        break;
+      }
+    }
+    if (!ready)
+    {
+      ++it;
+      continue;
+    }
+
+    for (const auto &[meshVolume, scale, pos] : pending.meshes)
+    {
+      double volume = meshVolume.get() * scale;
+      pending.volume += volume;
+      pending.weightedPosSum += volume * pos;
+    }
+
+    if (pending.volume > 0 && _ecm.HasEntity(it->first))
+    {
+      // Store the center of volume
+      _ecm.CreateComponent(it->first, components::CenterOfVolume(
+            pending.weightedPosSum / pending.volume));
+
+      // Store the volume
+      _ecm.CreateComponent(it->first, components::Volume(pending.volume));
+    }
+
+    it = this->pendingVolumes.erase(it);
+  }
+}
+
 //////////////////////////////////////////////////
 double BuoyancyPrivate::FluidDensity(const math::Pose3d & /*_pose*/) const
 {
@@ -130,7 +304,7 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
     return;
   }
 
-  // Compute the volume and center of volume for each new link
+  // Start computing the volume and center of volume for each new link
   _ecm.EachNew<components::Link, components::Inertial>(
       [&](const Entity &_entity,
           const components::Link *,
@@ -145,93 +319,37 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
       return true;
     }
 
-    Link link(_entity);
-
-    std::vector<Entity> collisions = _ecm.ChildrenByComponents(
-        _entity, components::Collision());
-
-    double volumeSum = 0;
-    ignition::math::Vector3d weightedPosSum =
-      ignition::math::Vector3d::Zero;
-
-    // Compute the volume of the link by iterating over all the collision
-    // elements and storing each geometry's volume.
-    for (const Entity &collision : collisions)
-    {
-      double volume = 0;
-      const components::CollisionElement *coll =
-        _ecm.Component<components::CollisionElement>(collision);
-
-      if (!coll)
-      {
-        ignerr << "Invalid collision pointer. This shouldn't happen\n";
-        continue;
-      }
-
-      switch (coll->Data().Geom()->Type())
-      {
-        case sdf::GeometryType::BOX:
-          volume = coll->Data().Geom()->BoxShape()->Shape().Volume();
-          break;
-        case sdf::GeometryType::SPHERE:
-          volume = coll->Data().Geom()->SphereShape()->Shape().Volume();
-          break;
-        case sdf::GeometryType::CYLINDER:
-          volume = coll->Data().Geom()->CylinderShape()->Shape().Volume();
-          break;
-        case sdf::GeometryType::PLANE:
-          // Ignore plane shapes. They have no volume and are not expected
-          // to be buoyant.
-          break;
-        case sdf::GeometryType::MESH:
-          {
-            std::string file = asFullPath(
-                coll->Data().Geom()->MeshShape()->Uri(),
-                coll->Data().Geom()->MeshShape()->FilePath());
-            if (common::MeshManager::Instance()->IsValidFilename(file))
-            {
-              const common::Mesh *mesh =
-                common::MeshManager::Instance()->Load(file);
-              if (mesh)
-                volume = mesh->Volume();
-              else
-                ignerr << "Unable to load mesh[" << file << "]\n";
-            }
-            else
-            {
-              ignerr << "Invalid mesh filename[" << file << "]\n";
-            }
-            break;
-          }
-        default:
-          ignerr << "Unsupported collision geometry["
-            << static_cast<int>(coll->Data().Geom()->Type()) << "]\n";
-          break;
-      }
-
-      volumeSum += volume;
-      math::Pose3d pose = worldPose(collision, _ecm);
-      weightedPosSum += volume * pose.Pos();
-    }
-
-    if (volumeSum > 0)
-    {
-      // Store the center of volume
-      math::Pose3d linkWorldPose = worldPose(_entity, _ecm);
-      _ecm.CreateComponent(_entity, components::CenterOfVolume(
-            weightedPosSum / volumeSum - linkWorldPose.Pos()));
-
-      // Store the volume
-      _ecm.CreateComponent(_entity, components::Volume(volumeSum));
-    }
+    this->dataPtr->RequestVolume(_entity, _ecm);
+    return true;
+  });
 
+  _ecm.EachRemoved<components::Link>(
+      [&](const Entity &_entity, const components::Link *) -> bool
+  {
+    this->dataPtr->pendingVolumes.erase(_entity);
     return true;
   });
 
+  // Links only become buoyant once their volume is known
+  if (!this->dataPtr->pendingVolumes.empty())
+    this->dataPtr->StoreVolumes(_ecm, this->dataPtr->firstUpdate);
+  this->dataPtr->firstUpdate = false;
+
   // Only update if not paused.
   if (_info.paused)
     return;
 
+  // Gather the buoyant links first, then compute all the wrenches in one
+  // pass over contiguous arrays.
+  auto &links = this->dataPtr->buoyantLinks;
+  auto &volumes = this->dataPtr->linkVolumes;
+  auto &centers = this->dataPtr->linkCenters;
+  auto &poses = this->dataPtr->linkPoses;
+  links.clear();
+  volumes.clear();
+  centers.clear();
+  poses.clear();
+
   _ecm.Each<components::Link,
             components::Volume,
             components::CenterOfVolume>(
@@ -240,30 +358,34 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
           const components::Volume *_volume,
           const components::CenterOfVolume *_centerOfVolume) -> bool
     {
+      links.push_back(_entity);
+      volumes.push_back(_volume->Data());
+      centers.push_back(_centerOfVolume->Data());
       // World pose of the link.
-      math::Pose3d linkWorldPose = worldPose(_entity, _ecm);
-
-      // By Archimedes' principle,
-      // buoyancy = -(mass*gravity)*fluid_density/object_density
-      // object_density = mass/volume, so the mass term cancels.
-      math::Vector3d buoyancy =
-        -this->dataPtr->FluidDensity(linkWorldPose) *
-        _volume->Data() * gravity->Data();
-
-      // Convert the center of volume to the world frame
-      math::Vector3d offsetWorld = linkWorldPose.Rot().RotateVector(
-          _centerOfVolume->Data());
-      // Compute the torque that should be applied due to buoyancy and
-      // the center of volume.
-      math::Vector3d torque = offsetWorld.Cross(buoyancy);
-
-      // Apply the wrench to the link. This wrench is applied in the
-      // Physics System.
-      Link link(_entity);
-      link.AddWorldWrench(_ecm, buoyancy, torque);
-
+      poses.push_back(worldPose(_entity, _ecm));
       return true;
   });
+
+  const math::Vector3d gravityVec = gravity->Data();
+  for (std::size_t i = 0; i < links.size(); ++i)
+  {
+    // By Archimedes' principle,
+    // buoyancy = -(mass*gravity)*fluid_density/object_density
+    // object_density = mass/volume, so the mass term cancels.
+    math::Vector3d buoyancy =
+      -this->dataPtr->FluidDensity(poses[i]) * volumes[i] * gravityVec;
+
+    // Convert the center of volume to the world frame
+    math::Vector3d offsetWorld = poses[i].Rot().RotateVector(centers[i]);
+    // Compute the torque that should be applied due to buoyancy and
+    // the center of volume.
+    math::Vector3d torque = offsetWorld.Cross(buoyancy);
+
+    // Apply the wrench to the link. This wrench is applied in the
+    // Physics System.
+    Link link(links[i]);
+    link.AddWorldWrench(_ecm, buoyancy, torque);
+  }
 }
 
 IGNITION_ADD_PLUGIN(Buoyancy,
@@ -40,6 +40,12 @@ namespace systems
   /// stored as components. During each iteration, Archimedes' principle is
   /// applied to each link with a volume and center of volume component.
   ///
+  /// Mesh volumes are computed in the background and cached for the whole
+  /// process, so spawning links with meshes doesn't stall the simulation.
+  /// Links spawned while the simulation is running are only buoyant once
+  /// their volume is known, while links loaded with the world are buoyant
+  /// from the first iteration.
+  ///
   /// Plane shapes are not handled by this plugin, and will not be affected
   /// by buoyancy.
   ///
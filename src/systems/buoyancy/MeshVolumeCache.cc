@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "MeshVolumeCache.hh"
+
+#include <mutex>
+#include <unordered_map>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/WorkerPool.hh>
+
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+class ignition::gazebo::systems::MeshVolumeCachePrivate
+{
+  /// \brief Protects volumes.
+  public: std::mutex mutex;
+
+  /// \brief Volume of each mesh file.
+  public: std::unordered_map<std::string, std::shared_future<double>>
+      volumes;
+
+  /// \brief Threads which load the meshes.
+  public: common::WorkerPool pool;
+};
+
+//////////////////////////////////////////////////
+MeshVolumeCache::MeshVolumeCache()
+  : dataPtr(std::make_unique<MeshVolumeCachePrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+MeshVolumeCache::~MeshVolumeCache()
+{
+  this->dataPtr->pool.WaitForResults();
+}
+
+//////////////////////////////////////////////////
+MeshVolumeCache &MeshVolumeCache::Instance()
+{
+  static MeshVolumeCache instance;
+  return instance;
+}
+
+//////////////////////////////////////////////////
+std::shared_future<double> MeshVolumeCache::Volume(const std::string &_file)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->volumes.find(_file);
+  if (it != this->dataPtr->volumes.end())
+    return it->second;
+
+  auto promise = std::make_shared<std::promise<double>>();
+  std::shared_future<double> volume = promise->get_future().share();
+  this->dataPtr->volumes[_file] = volume;
+
+  this->dataPtr->pool.AddWork([promise, _file]()
+  {
+    // Only loading needs the lock. Loaded meshes aren't modified, so the
+    // volume is computed without it.
+    const common::Mesh *mesh{nullptr};
+    {
+      std::lock_guard<std::mutex> meshLock(meshManagerMutex());
+      auto *meshManager = common::MeshManager::Instance();
+      if (meshManager->IsValidFilename(_file))
+      {
+        mesh = meshManager->Load(_file);
+        if (!mesh)
+          ignerr << "Unable to load mesh[" << _file << "]\n";
+      }
+      else
+      {
+        ignerr << "Invalid mesh filename[" << _file << "]\n";
+      }
+    }
+    promise->set_value(nullptr == mesh ? 0.0 : mesh->Volume());
+  });
+  return volume;
+}
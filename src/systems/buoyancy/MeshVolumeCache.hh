@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_BUOYANCY_MESHVOLUMECACHE_HH_
+#define IGNITION_GAZEBO_SYSTEMS_BUOYANCY_MESHVOLUMECACHE_HH_
+
+#include <future>
+#include <memory>
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/buoyancy-system/Export.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declarations.
+  class MeshVolumeCachePrivate;
+
+  /// \brief Volumes of the meshes loaded so far, so each mesh file is only
+  /// loaded once. Meshes are loaded on a worker pool, holding
+  /// meshManagerMutex while common::MeshManager is used, so volumes become
+  /// available some time after they're first requested.
+  class IGNITION_GAZEBO_BUOYANCY_SYSTEM_VISIBLE MeshVolumeCache
+  {
+    /// \brief Constructor
+    public: MeshVolumeCache();
+
+    /// \brief Destructor. Waits for the meshes being loaded.
+    public: ~MeshVolumeCache();
+
+    /// \brief Get the cache shared by all instances of the Buoyancy system.
+    /// \return The shared cache.
+    public: static MeshVolumeCache &Instance();
+
+    /// \brief Get the volume of a mesh, loading it if needed.
+    /// \param[in] _file Full path to the mesh file.
+    /// \return Future volume of the unscaled mesh, which is zero if it
+    /// couldn't be loaded.
+    public: std::shared_future<double> Volume(const std::string &_file);
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<MeshVolumeCachePrivate> dataPtr;
+  };
+}
+}
+}
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "ignition/gazebo/test_config.hh"
+#include "ignition/gazebo/Util.hh"
+
+#include "MeshVolumeCache.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(MeshVolumeCacheTest, Volume)
+{
+  MeshVolumeCache cache;
+  const std::string file = std::string(PROJECT_SOURCE_PATH) +
+      "/test/media/duck_collider.dae";
+
+  auto volume = cache.Volume(file);
+  EXPECT_NEAR(1.40186, volume.get(), 1e-3);
+
+  // The mesh isn't loaded again
+  auto cached = cache.Volume(file);
+  EXPECT_EQ(std::future_status::ready, cached.wait_for(0s));
+  EXPECT_DOUBLE_EQ(volume.get(), cached.get());
+
+  // Meshes which can't be loaded have no volume
+  EXPECT_DOUBLE_EQ(0.0, cache.Volume("/not/a/mesh.dae").get());
+  EXPECT_DOUBLE_EQ(0.0, cache.Volume("").get());
+}
+
+/////////////////////////////////////////////////
+TEST(MeshVolumeCacheTest, Background)
+{
+  MeshVolumeCache cache;
+  const std::string file = std::string(PROJECT_SOURCE_PATH) +
+      "/test/media/duck_collider.dae";
+
+  // Meshes are loaded in the background, and only while nobody else is
+  // using the mesh manager
+  std::shared_future<double> volume;
+  {
+    std::lock_guard<std::mutex> lock(meshManagerMutex());
+    volume = cache.Volume(file);
+    EXPECT_EQ(std::future_status::timeout, volume.wait_for(100ms));
+  }
+  EXPECT_NEAR(1.40186, volume.get(), 1e-3);
+}
@@ -15,6 +15,7 @@
  *
  */
 
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -109,6 +110,7 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
       std::weak_ptr<ignition::common::SubMesh> subm;
       math::Vector3d scale;
       math::Matrix4d matrix(worldPose);
+      std::lock_guard<std::mutex> meshLock(meshManagerMutex());
       ignition::common::MeshManager *meshManager =
           ignition::common::MeshManager::Instance();
 
@@ -37,7 +37,7 @@
 #include "ignition/gazebo/Util.hh"
 #include "ignition/gazebo/components/Collision.hh"
 #include "ignition/gazebo/components/ContactSensor.hh"
-#include "ignition/gazebo/components/ContactSensorData.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/ParentEntity.hh"
@@ -58,9 +58,9 @@ class ContactSensor
 
   /// \brief Add contacts to the list to be published
   /// \param[in] _stamp Time stamp of the sensor measurement
-  /// \param[in] _contacts A contact message to be added to the list
+  /// \param[in] _contacts Contacts of one collision to be added to the list
   public: void AddContacts(const std::chrono::steady_clock::duration &_stamp,
-                           const msgs::Contacts &_contacts);
+                           const ContactBuffer &_contacts);
 
   /// \brief Publish sensor data over ign transport
   public: void Publish();
@@ -129,14 +129,15 @@ void ContactSensor::Load(const sdf::ElementPtr &_sdf, const std::string &_topic,
 //////////////////////////////////////////////////
 void ContactSensor::AddContacts(
     const std::chrono::steady_clock::duration &_stamp,
-    const msgs::Contacts &_contacts)
+    const ContactBuffer &_contacts)
 {
   auto stamp = convert<msgs::Time>(_stamp);
-  for (const auto &contact : _contacts.contact())
+  int first = this->contactsMsg.contact_size();
+  _contacts.AppendToMsg(this->contactsMsg);
+  for (int i = first; i < this->contactsMsg.contact_size(); ++i)
   {
-    auto *newContact = this->contactsMsg.add_contact();
-    newContact->CopyFrom(contact);
-    newContact->mutable_header()->mutable_stamp()->CopyFrom(stamp);
+    this->contactsMsg.mutable_contact(i)->mutable_header()->mutable_stamp()
+        ->CopyFrom(stamp);
   }
 
   this->contactsMsg.mutable_header()->mutable_stamp()->CopyFrom(stamp);
@@ -196,7 +197,7 @@ void ContactPrivate::CreateSensors(EntityComponentManager &_ecm)
 
             // Create component to be filled by physics.
             _ecm.CreateComponent(childEntities.front(),
-                                 components::ContactSensorData());
+                                 components::ContactSensorBuffer());
           }
         }
 
@@ -220,11 +221,12 @@ void ContactPrivate::UpdateSensors(const UpdateInfo &_info,
   {
     for (const Entity &entity : item.second->collisionEntities)
     {
-      auto contacts = _ecm.Component<components::ContactSensorData>(entity);
+      auto contacts =
+          _ecm.Component<components::ContactSensorBuffer>(entity);
 
-      // We will assume that the ContactData component will have been created if
-      // this entity is in the collisionEntities list
-      if (contacts->Data().contact_size() > 0)
+      // We will assume that the ContactSensorBuffer component will have been
+      // created if this entity is in the collisionEntities list
+      if (contacts->Data().PairCount() > 0)
       {
         item.second->AddContacts(_info.simTime, contacts->Data());
       }
@@ -177,6 +177,8 @@ void FollowActor::Configure(const Entity &_entity,
     newPose.Pos().X(0);
     newPose.Pos().Y(0);
     *poseComp = components::Pose(newPose);
+    _ecm.SetChanged(_entity, components::Pose::typeId,
+        ComponentState::OneTimeChange);
   }
 
   // Having a trajectory pose prevents the actor from moving with the
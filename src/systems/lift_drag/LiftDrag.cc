@@ -18,10 +18,16 @@
 #include "LiftDrag.hh"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include <ignition/common/Profiler.hh>
+#include <ignition/math/Helpers.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 
@@ -44,8 +50,13 @@ using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+class LiftDragBatch;
+
 class ignition::gazebo::systems::LiftDragPrivate
 {
+  /// \brief Destructor. Removes the surface from the batch, if any.
+  public: ~LiftDragPrivate();
+
   // Initialize the system
   public: void Load(const EntityComponentManager &_ecm,
                     const sdf::ElementPtr &_sdf);
@@ -135,8 +146,464 @@ class ignition::gazebo::systems::LiftDragPrivate
 
   /// \brief Initialization flag
   public: bool initialized{false};
+
+  /// \brief Whether this surface is computed together with the other
+  /// batched surfaces of the world instead of on its own.
+  public: bool batched{false};
+
+  /// \brief Batch this surface belongs to, if batched.
+  public: std::shared_ptr<LiftDragBatch> batch;
+};
+
+/// \brief Three arrays of components of vectors.
+struct Vector3Array
+{
+  /// \brief Resize all components.
+  /// \param[in] _size New size
+  void Resize(std::size_t _size)
+  {
+    this->x.resize(_size);
+    this->y.resize(_size);
+    this->z.resize(_size);
+  }
+
+  /// \brief Set a vector.
+  /// \param[in] _i Index
+  /// \param[in] _v Vector
+  void Set(std::size_t _i, const math::Vector3d &_v)
+  {
+    this->x[_i] = _v.X();
+    this->y[_i] = _v.Y();
+    this->z[_i] = _v.Z();
+  }
+
+  /// \brief Get a vector.
+  /// \param[in] _i Index
+  /// \return Vector
+  math::Vector3d Get(std::size_t _i) const
+  {
+    return {this->x[_i], this->y[_i], this->z[_i]};
+  }
+
+  /// \brief X components
+  std::vector<double> x;
+
+  /// \brief Y components
+  std::vector<double> y;
+
+  /// \brief Z components
+  std::vector<double> z;
+};
+
+/// \brief All the batched lift and drag surfaces of a world, stored as a
+/// structure of arrays. The first surface to be updated in each iteration
+/// computes the forces of all of them in one pass, so the cost per surface
+/// is mostly arithmetic over contiguous arrays. Surfaces added after that
+/// pass are computed on their own pass when they're updated, so they aren't
+/// skipped on their first iteration.
+class LiftDragBatch
+{
+  /// \brief Get the batch of a world, creating it if needed.
+  /// \param[in] _ecm Entity component manager of the world
+  /// \return Batch shared by all surfaces of the world
+  public: static std::shared_ptr<LiftDragBatch> ForWorld(
+              const EntityComponentManager &_ecm);
+
+  /// \brief Add a surface. Its parameters are copied, so it must have been
+  /// loaded.
+  /// \param[in] _surface Surface to add
+  public: void Add(const LiftDragPrivate *_surface);
+
+  /// \brief Remove a surface.
+  /// \param[in] _surface Surface to remove
+  public: void Remove(const LiftDragPrivate *_surface);
+
+  /// \brief Compute and apply the forces of all surfaces, once per
+  /// iteration.
+  /// \param[in] _info Update info
+  /// \param[in] _ecm Entity component manager
+  public: void Update(const UpdateInfo &_info, EntityComponentManager &_ecm);
+
+  /// \brief Read the state of each surface's link into the arrays. Only
+  /// surfaces whose forces haven't been applied in this iteration are
+  /// activated.
+  /// \param[in] _iteration Current iteration
+  /// \param[in] _ecm Entity component manager
+  private: void Gather(uint64_t _iteration,
+      const EntityComponentManager &_ecm);
+
+  /// \brief Compute the wrench of each active surface from the arrays.
+  private: void Compute();
+
+  /// \brief Apply the wrench of each active surface.
+  /// \param[in] _ecm Entity component manager
+  private: void Scatter(EntityComponentManager &_ecm) const;
+
+  /// \brief Iteration in which the forces were last applied
+  private: uint64_t lastIteration{0};
+
+  /// \brief Whether surfaces were added since the last pass
+  private: bool hasNew{false};
+
+  /// \brief Surface which owns each entry
+  private: std::vector<const LiftDragPrivate *> owners;
+
+  /// \brief Link of each surface
+  private: std::vector<Entity> links;
+
+  /// \brief Control joint of each surface, may be null
+  private: std::vector<Entity> joints;
+
+  /// \brief Center of pressure of each surface, in the link frame
+  private: std::vector<math::Vector3d> cp;
+
+  /// \brief Forward direction of each surface, in the link frame
+  private: std::vector<math::Vector3d> forward;
+
+  /// \brief Upward direction of each surface, in the link frame
+  private: std::vector<math::Vector3d> upward;
+
+  /// \brief Whether each surface is radially symmetric
+  private: std::vector<char> radialSymmetry;
+
+  /// \brief Coefficients of each surface, see LiftDragPrivate
+  private: std::vector<double> cla, cda, alpha0, alphaStall, claStall,
+      cdaStall, rho, area, controlJointRadToCL;
+
+  /// \brief Iteration in which the force of each surface was last applied
+  private: std::vector<uint64_t> appliedIteration;
+
+  /// \brief Whether each surface has a force this iteration
+  private: std::vector<char> active;
+
+  /// \brief Control joint position of each surface, zero if it has none
+  private: std::vector<double> jointPosition;
+
+  /// \brief Center of pressure of each surface, in the world frame
+  private: Vector3Array cpWorld;
+
+  /// \brief Velocity of the center of pressure, in the world frame
+  private: Vector3Array vel;
+
+  /// \brief Forward direction of each surface, in the world frame
+  private: Vector3Array forwardWorld;
+
+  /// \brief Upward direction of each surface, in the world frame
+  private: Vector3Array upwardWorld;
+
+  /// \brief Force on each surface, in the world frame
+  private: Vector3Array force;
+
+  /// \brief Torque on each link about its origin, in the world frame
+  private: Vector3Array torque;
 };
 
+//////////////////////////////////////////////////
+/// \brief Normalize a vector the same way math::Vector3d does.
+/// \param[in, out] _x X component
+/// \param[in, out] _y Y component
+/// \param[in, out] _z Z component
+static void normalize(double &_x, double &_y, double &_z)
+{
+  double d = std::sqrt(_x * _x + _y * _y + _z * _z);
+  if (!math::equal(d, 0.0))
+  {
+    _x /= d;
+    _y /= d;
+    _z /= d;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Replace a value by zero if it's NaN or infinite, the same way
+/// math::Vector3d::Correct does.
+/// \param[in] _v Value
+/// \return Corrected value
+static double correct(double _v)
+{
+  return std::isfinite(_v) ? _v : 0.0;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<LiftDragBatch> LiftDragBatch::ForWorld(
+    const EntityComponentManager &_ecm)
+{
+  static std::mutex mutex;
+  static std::map<const EntityComponentManager *,
+      std::weak_ptr<LiftDragBatch>> batches;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto batch = batches[&_ecm].lock();
+  if (!batch)
+  {
+    batch = std::make_shared<LiftDragBatch>();
+    batches[&_ecm] = batch;
+  }
+  return batch;
+}
+
+//////////////////////////////////////////////////
+void LiftDragBatch::Add(const LiftDragPrivate *_surface)
+{
+  this->owners.push_back(_surface);
+  this->links.push_back(_surface->linkEntity);
+  this->joints.push_back(_surface->controlJointEntity);
+  this->cp.push_back(_surface->cp);
+  this->forward.push_back(_surface->forward);
+  this->upward.push_back(_surface->upward);
+  this->radialSymmetry.push_back(_surface->radialSymmetry);
+  this->cla.push_back(_surface->cla);
+  this->cda.push_back(_surface->cda);
+  this->alpha0.push_back(_surface->alpha0);
+  this->alphaStall.push_back(_surface->alphaStall);
+  this->claStall.push_back(_surface->claStall);
+  this->cdaStall.push_back(_surface->cdaStall);
+  this->rho.push_back(_surface->rho);
+  this->area.push_back(_surface->area);
+  this->controlJointRadToCL.push_back(_surface->controlJointRadToCL);
+  this->appliedIteration.push_back(std::numeric_limits<uint64_t>::max());
+  this->hasNew = true;
+}
+
+//////////////////////////////////////////////////
+void LiftDragBatch::Remove(const LiftDragPrivate *_surface)
+{
+  auto it = std::find(this->owners.begin(), this->owners.end(), _surface);
+  if (it == this->owners.end())
+    return;
+
+  // Move the last surface into the removed one's place
+  auto i = static_cast<std::size_t>(it - this->owners.begin());
+  auto removeAt = [i](auto &_array)
+  {
+    _array[i] = _array.back();
+    _array.pop_back();
+  };
+  removeAt(this->owners);
+  removeAt(this->links);
+  removeAt(this->joints);
+  removeAt(this->cp);
+  removeAt(this->forward);
+  removeAt(this->upward);
+  removeAt(this->radialSymmetry);
+  removeAt(this->cla);
+  removeAt(this->cda);
+  removeAt(this->alpha0);
+  removeAt(this->alphaStall);
+  removeAt(this->claStall);
+  removeAt(this->cdaStall);
+  removeAt(this->rho);
+  removeAt(this->area);
+  removeAt(this->controlJointRadToCL);
+  removeAt(this->appliedIteration);
+}
+
+//////////////////////////////////////////////////
+void LiftDragBatch::Update(const UpdateInfo &_info,
+    EntityComponentManager &_ecm)
+{
+  if (this->lastIteration == _info.iterations && !this->hasNew)
+    return;
+  this->lastIteration = _info.iterations;
+  this->hasNew = false;
+
+  IGN_PROFILE("LiftDragBatch::Update");
+  this->Gather(_info.iterations, _ecm);
+  this->Compute();
+  this->Scatter(_ecm);
+}
+
+//////////////////////////////////////////////////
+void LiftDragBatch::Gather(uint64_t _iteration,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("LiftDragBatch::Gather");
+  const auto count = this->links.size();
+  this->active.assign(count, 0);
+  this->jointPosition.assign(count, 0.0);
+  this->cpWorld.Resize(count);
+  this->vel.Resize(count);
+  this->forwardWorld.Resize(count);
+  this->upwardWorld.Resize(count);
+  this->force.Resize(count);
+  this->torque.Resize(count);
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    // Already applied by an earlier pass in this iteration
+    if (this->appliedIteration[i] == _iteration)
+      continue;
+    this->appliedIteration[i] = _iteration;
+
+    const auto worldLinVel =
+        _ecm.Component<components::WorldLinearVelocity>(this->links[i]);
+    const auto worldAngVel =
+        _ecm.Component<components::WorldAngularVelocity>(this->links[i]);
+    const auto worldPose =
+        _ecm.Component<components::WorldPose>(this->links[i]);
+    if (!worldLinVel || !worldAngVel || !worldPose)
+      continue;
+
+    if (this->joints[i] != kNullEntity)
+    {
+      auto joint =
+          _ecm.Component<components::JointPosition>(this->joints[i]);
+      if (joint && !joint->Data().empty())
+        this->jointPosition[i] = joint->Data()[0];
+    }
+
+    const auto &rot = worldPose->Data().Rot();
+    const auto cpW = rot.RotateVector(this->cp[i]);
+    this->cpWorld.Set(i, cpW);
+    this->vel.Set(i, worldLinVel->Data() + worldAngVel->Data().Cross(cpW));
+    this->forwardWorld.Set(i, rot.RotateVector(this->forward[i]));
+    this->upwardWorld.Set(i, rot.RotateVector(this->upward[i]));
+    this->active[i] = 1;
+  }
+}
+
+//////////////////////////////////////////////////
+void LiftDragBatch::Compute()
+{
+  IGN_PROFILE("LiftDragBatch::Compute");
+  // Same math as LiftDragPrivate::Update, see the comments there
+  const auto count = this->links.size();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const double vx = this->vel.x[i];
+    const double vy = this->vel.y[i];
+    const double vz = this->vel.z[i];
+    if (std::sqrt(vx * vx + vy * vy + vz * vz) <= 0.01)
+      this->active[i] = 0;
+    if (!this->active[i])
+      continue;
+
+    double velIx = vx, velIy = vy, velIz = vz;
+    normalize(velIx, velIy, velIz);
+
+    const double fx = this->forwardWorld.x[i];
+    const double fy = this->forwardWorld.y[i];
+    const double fz = this->forwardWorld.z[i];
+
+    double ux, uy, uz;
+    if (this->radialSymmetry[i])
+    {
+      const double tx = fy * velIz - fz * velIy;
+      const double ty = fz * velIx - fx * velIz;
+      const double tz = fx * velIy - fy * velIx;
+      ux = fy * tz - fz * ty;
+      uy = fz * tx - fx * tz;
+      uz = fx * ty - fy * tx;
+      normalize(ux, uy, uz);
+    }
+    else
+    {
+      ux = this->upwardWorld.x[i];
+      uy = this->upwardWorld.y[i];
+      uz = this->upwardWorld.z[i];
+    }
+
+    double sx = fy * uz - fz * uy;
+    double sy = fz * ux - fx * uz;
+    double sz = fx * uy - fy * ux;
+    normalize(sx, sy, sz);
+
+    const double sinSweepAngle = math::clamp(
+        sx * velIx + sy * velIy + sz * velIz, -1.0, 1.0);
+    const double cosSweepAngle = 1.0 - sinSweepAngle * sinSweepAngle;
+
+    const double vDotS = vx * sx + vy * sy + vz * sz;
+    const double px = vx - vDotS * sx;
+    const double py = vy - vDotS * sy;
+    const double pz = vz - vDotS * sz;
+
+    double dx = px, dy = py, dz = pz;
+    normalize(dx, dy, dz);
+    dx = -dx;
+    dy = -dy;
+    dz = -dz;
+
+    double lx = sy * pz - sz * py;
+    double ly = sz * px - sx * pz;
+    double lz = sx * py - sy * px;
+    normalize(lx, ly, lz);
+
+    const double cosAlpha =
+        math::clamp(lx * ux + ly * uy + lz * uz, -1.0, 1.0);
+    double alpha = this->alpha0[i] - std::acos(cosAlpha);
+    if (lx * fx + ly * fy + lz * fz >= 0.0)
+      alpha = this->alpha0[i] + std::acos(cosAlpha);
+    while (std::fabs(alpha) > 0.5 * IGN_PI)
+      alpha = alpha > 0 ? alpha - IGN_PI : alpha + IGN_PI;
+
+    const double speedSquared = px * px + py * py + pz * pz;
+    const double q = 0.5 * this->rho[i] * speedSquared;
+    const double stall = this->alphaStall[i];
+
+    double cl;
+    double cd;
+    if (alpha > stall)
+    {
+      cl = std::max(0.0, (this->cla[i] * stall +
+          this->claStall[i] * (alpha - stall)) * cosSweepAngle);
+      cd = (this->cda[i] * stall +
+          this->cdaStall[i] * (alpha - stall)) * cosSweepAngle;
+    }
+    else if (alpha < -stall)
+    {
+      cl = std::min(0.0, (-this->cla[i] * stall +
+          this->claStall[i] * (alpha + stall)) * cosSweepAngle);
+      cd = (-this->cda[i] * stall +
+          this->cdaStall[i] * (alpha + stall)) * cosSweepAngle;
+    }
+    else
+    {
+      cl = this->cla[i] * alpha * cosSweepAngle;
+      cd = (this->cda[i] * alpha) * cosSweepAngle;
+    }
+    cl = cl + this->controlJointRadToCL[i] * this->jointPosition[i];
+    cd = std::fabs(cd);
+
+    // The moment coefficient is not used yet, see LiftDragPrivate::Update
+    const double liftScale = cl * q * this->area[i];
+    const double dragScale = cd * q * this->area[i];
+    const double forceX = correct(liftScale * lx + dragScale * dx);
+    const double forceY = correct(liftScale * ly + dragScale * dy);
+    const double forceZ = correct(liftScale * lz + dragScale * dz);
+    this->force.x[i] = forceX;
+    this->force.y[i] = forceY;
+    this->force.z[i] = forceZ;
+
+    const double cx = this->cpWorld.x[i];
+    const double cy = this->cpWorld.y[i];
+    const double cz = this->cpWorld.z[i];
+    this->torque.x[i] = cy * forceZ - cz * forceY;
+    this->torque.y[i] = cz * forceX - cx * forceZ;
+    this->torque.z[i] = cx * forceY - cy * forceX;
+  }
+}
+
+//////////////////////////////////////////////////
+void LiftDragBatch::Scatter(EntityComponentManager &_ecm) const
+{
+  IGN_PROFILE("LiftDragBatch::Scatter");
+  for (std::size_t i = 0; i < this->links.size(); ++i)
+  {
+    if (!this->active[i])
+      continue;
+
+    Link link(this->links[i]);
+    link.AddWorldWrench(_ecm, this->force.Get(i), this->torque.Get(i));
+  }
+}
+
+//////////////////////////////////////////////////
+LiftDragPrivate::~LiftDragPrivate()
+{
+  if (this->batch)
+    this->batch->Remove(this);
+}
+
 //////////////////////////////////////////////////
 void LiftDragPrivate::Load(const EntityComponentManager &_ecm,
                            const sdf::ElementPtr &_sdf)
@@ -168,6 +635,8 @@ void LiftDragPrivate::Load(const EntityComponentManager &_ecm,
   this->controlJointRadToCL = _sdf->Get<double>(
       "control_joint_rad_to_cl", this->controlJointRadToCL).first;
 
+  this->batched = _sdf->Get<bool>("batched", this->batched).first;
+
   if (_sdf->HasElement("link_name"))
   {
     sdf::ElementPtr elem = _sdf->GetElement("link_name");
@@ -524,6 +993,12 @@ void LiftDrag::PreUpdate(const UpdateInfo &_info, EntityComponentManager &_ecm)
         _ecm.CreateComponent(this->dataPtr->controlJointEntity,
             components::JointPosition());
       }
+
+      if (this->dataPtr->batched)
+      {
+        this->dataPtr->batch = LiftDragBatch::ForWorld(_ecm);
+        this->dataPtr->batch->Add(this->dataPtr.get());
+      }
     }
   }
 
@@ -534,7 +1009,10 @@ void LiftDrag::PreUpdate(const UpdateInfo &_info, EntityComponentManager &_ecm)
   // above
   if (this->dataPtr->initialized && this->dataPtr->validConfig)
   {
-    this->dataPtr->Update(_ecm);
+    if (this->dataPtr->batch)
+      this->dataPtr->batch->Update(_info, _ecm);
+    else
+      this->dataPtr->Update(_ecm);
   }
 }
 
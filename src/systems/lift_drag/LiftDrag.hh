@@ -59,6 +59,10 @@ namespace systems
   ///               coefficient curve.
   /// cda_stall   : The ratio of coefficient of drag and alpha slope after
   ///               stall.
+  /// batched     : If true, this surface is computed together with all the
+  ///               other batched surfaces of the world, in a single pass
+  ///               per iteration. This is much cheaper for worlds with many
+  ///               surfaces. Defaults to false.
   class LiftDrag
       : public System,
         public ISystemConfigure,
@@ -17,6 +17,7 @@
 
 #include "LogicalAudioSensorPlugin.hh"
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <mutex>
@@ -35,6 +36,7 @@
 #include <ignition/transport.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/gazebo/SdfEntityCreator.hh>
+#include <ignition/gazebo/SpatialIndex.hh>
 #include <ignition/gazebo/Util.hh>
 #include <sdf/Element.hh>
 #include "LogicalAudio.hh"
@@ -99,6 +101,10 @@ class ignition::gazebo::systems::LogicalAudioSensorPluginPrivate
   public: std::unordered_map<Entity,
             ignition::transport::Node::Publisher> micEntities;
 
+  /// \brief Index of the regions where each audio source can be heard, so
+  /// microphones are only checked against the sources close to them.
+  public: SpatialIndex sourceIndex{0.0};
+
   /// \brief A mutex used to ensure that the play source service call does
   /// not interfere with the source's state in the PreUpdate step.
   public: std::mutex playSourceMutex;
@@ -212,48 +218,72 @@ void LogicalAudioSensorPlugin::PostUpdate(const UpdateInfo &_info,
     std::chrono::duration_cast<std::chrono::nanoseconds>(_info.simTime);
   const auto nanosecondOffset = (simNanoseconds - simSeconds).count();
 
+  if (this->dataPtr->micEntities.empty())
+    return;
+
+  // Sources can't be heard beyond their falloff distance, or their inner
+  // radius if it's larger
+  auto &sourceIndex = this->dataPtr->sourceIndex;
+  sourceIndex.Clear();
+  _ecm.Each<components::LogicalAudioSource,
+            components::LogicalAudioSourcePlayInfo>(
+    [&](const Entity &_entity,
+        const components::LogicalAudioSource *_source,
+        const components::LogicalAudioSourcePlayInfo *_playInfo)
+    {
+      if (!_playInfo->Data().playing)
+        return true;
+
+      const auto pos = worldPose(_entity, _ecm).Pos();
+      const auto range = std::max(_source->Data().innerRadius,
+          _source->Data().falloffDistance);
+      const math::Vector3d extent(range, range, range);
+      sourceIndex.Update(_entity,
+          math::AxisAlignedBox(pos - extent, pos + extent));
+      return true;
+    });
+
   for (auto & [micEntity, detectionPub] : this->dataPtr->micEntities)
   {
     const auto micPose = worldPose(micEntity, _ecm);
     const auto micInfo = _ecm.Component<components::LogicalMicrophone>(
         micEntity)->Data();
 
-    _ecm.Each<components::LogicalAudioSource,
-              components::LogicalAudioSourcePlayInfo>(
-      [&, &publisher = detectionPub](const Entity &_entity,
-          const components::LogicalAudioSource *_source,
-          const components::LogicalAudioSourcePlayInfo *_playInfo)
+    // Publish in entity order, regardless of the index's order
+    auto sources = sourceIndex.Query(micPose.Pos(), 0.0);
+    std::sort(sources.begin(), sources.end());
+    for (const auto &sourceEntity : sources)
+    {
+      const auto &source = _ecm.Component<components::LogicalAudioSource>(
+          sourceEntity)->Data();
+      const auto sourcePose = worldPose(sourceEntity, _ecm);
+      const auto vol = logical_audio::computeVolume(
+          true,
+          source.attFunc,
+          source.attShape,
+          source.emissionVolume,
+          source.innerRadius,
+          source.falloffDistance,
+          sourcePose,
+          micPose);
+
+      if (logical_audio::detect(vol, micInfo.volumeDetectionThreshold))
       {
-        const auto sourcePose = worldPose(_entity, _ecm);
-        const auto vol = logical_audio::computeVolume(
-            _playInfo->Data().playing,
-            _source->Data().attFunc,
-            _source->Data().attShape,
-            _source->Data().emissionVolume,
-            _source->Data().innerRadius,
-            _source->Data().falloffDistance,
-            sourcePose,
-            micPose);
-
-        if (logical_audio::detect(vol, micInfo.volumeDetectionThreshold))
-        {
-          // publish the source that the microphone heard, along with the
-          // volume level the microphone detected. The detected source's
-          // ID is embedded in the message's header
-          ignition::msgs::Double msg;
-          auto header = msg.mutable_header();
-          auto timeStamp = header->mutable_stamp();
-          timeStamp->set_sec(simSeconds.count());
-          timeStamp->set_nsec(nanosecondOffset);
-          auto headerData = header->add_data();
-          headerData->set_key(scopedName(_entity, _ecm));
-          msg.set_data(vol);
-
-          publisher.Publish(msg);
-        }
-
-        return true;
-      });
+        // publish the source that the microphone heard, along with the
+        // volume level the microphone detected. The detected source's
+        // ID is embedded in the message's header
+        ignition::msgs::Double msg;
+        auto header = msg.mutable_header();
+        auto timeStamp = header->mutable_stamp();
+        timeStamp->set_sec(simSeconds.count());
+        timeStamp->set_nsec(nanosecondOffset);
+        auto headerData = header->add_data();
+        headerData->set_key(scopedName(sourceEntity, _ecm));
+        msg.set_data(vol);
+
+        detectionPub.Publish(msg);
+      }
+    }
   }
 }
 
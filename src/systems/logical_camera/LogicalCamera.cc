@@ -29,6 +29,7 @@
 
 #include <sdf/Sensor.hh>
 
+#include <ignition/math/Frustum.hh>
 #include <ignition/math/Helpers.hh>
 #include <ignition/transport/Node.hh>
 
@@ -37,7 +38,6 @@
 
 #include "ignition/gazebo/components/LogicalCamera.hh"
 #include "ignition/gazebo/components/Name.hh"
-#include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/Sensor.hh"
@@ -177,20 +177,7 @@ void LogicalCameraPrivate::UpdateLogicalCameras(
     const EntityComponentManager &_ecm)
 {
   IGN_PROFILE("LogicalCameraPrivate::UpdateLogicalCameras");
-  std::map<std::string, math::Pose3d> modelPoses;
-
-  _ecm.Each<components::Model, components::Name, components::Pose>(
-      [&](const Entity &,
-        const components::Model *,
-        const components::Name *_name,
-        const components::Pose *_pose)->bool
-      {
-        /// todo(anyone) We currently assume there are only top level models
-        /// Update to retrieve world pose when nested models are supported.
-        modelPoses[_name->Data()] = _pose->Data();
-        return true;
-      });
-
+  const auto &modelIndex = _ecm.ModelSpatialIndex();
 
   _ecm.Each<components::LogicalCamera, components::WorldPose>(
     [&](const Entity &_entity,
@@ -202,9 +189,21 @@ void LogicalCameraPrivate::UpdateLogicalCameras(
         {
           const math::Pose3d &worldPose = _worldPose->Data();
           it->second->SetPose(worldPose);
-          // Make a copy of modelPoses s.t. SetModelPoses can take ownership
-          auto modelPoses_ = modelPoses;
-          it->second->SetModelPoses(std::move(modelPoses_));
+
+          // Only pass the models which may be within the camera's frustum,
+          // the sensor does the exact test. Nested models are passed at
+          // their world pose, like top level models.
+          math::Frustum frustum(it->second->Near(), it->second->Far(),
+              it->second->HorizontalFOV(), it->second->AspectRatio(),
+              worldPose);
+          std::map<std::string, math::Pose3d> modelPoses;
+          for (const auto &model : modelIndex.Query(frustum))
+          {
+            auto name = _ecm.Component<components::Name>(model);
+            if (name)
+              modelPoses[name->Data()] = _ecm.WorldPose(model);
+          }
+          it->second->SetModelPoses(std::move(modelPoses));
         }
         else
         {
@@ -276,11 +276,28 @@ void OdometryPublisherPrivate::UpdateOdometry(
   this->odomPub.Publish(msg);
 }
 
+//////////////////////////////////////////////////
+void OdometryPublisher::Reset(const UpdateInfo &_info,
+    EntityComponentManager &_ecm)
+{
+  // Velocities aren't estimated across the jump, and publishing restarts
+  // at the new time
+  this->dataPtr->linearMean.first.Clear();
+  this->dataPtr->linearMean.second.Clear();
+  this->dataPtr->angularMean.Clear();
+  this->dataPtr->lastUpdatePose = worldPose(this->dataPtr->model.Entity(),
+      _ecm);
+  this->dataPtr->lastUpdateTime =
+      std::chrono::steady_clock::time_point(_info.simTime);
+  this->dataPtr->lastOdomPubTime = std::chrono::steady_clock::duration::zero();
+}
+
 IGNITION_ADD_PLUGIN(OdometryPublisher,
                     ignition::gazebo::System,
                     OdometryPublisher::ISystemConfigure,
                     OdometryPublisher::ISystemPreUpdate,
-                    OdometryPublisher::ISystemPostUpdate)
+                    OdometryPublisher::ISystemPostUpdate,
+                    OdometryPublisher::ISystemReset)
 
 IGNITION_ADD_PLUGIN_ALIAS(OdometryPublisher,
                           "ignition::gazebo::systems::OdometryPublisher")
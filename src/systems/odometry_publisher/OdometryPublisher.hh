@@ -56,7 +56,8 @@ namespace systems
       : public System,
         public ISystemConfigure,
         public ISystemPreUpdate,
-        public ISystemPostUpdate
+        public ISystemPostUpdate,
+        public ISystemReset
   {
     /// \brief Constructor
     public: OdometryPublisher();
@@ -80,6 +81,10 @@ namespace systems
                 const UpdateInfo &_info,
                 const EntityComponentManager &_ecm) override;
 
+    // Documentation inherited
+    public: void Reset(const UpdateInfo &_info,
+                       EntityComponentManager &_ecm) override;
+
     /// \brief Private data pointer
     private: std::unique_ptr<OdometryPublisherPrivate> dataPtr;
   };
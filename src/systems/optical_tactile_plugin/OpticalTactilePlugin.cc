@@ -29,7 +29,7 @@
 #include <sdf/Element.hh>
 
 #include "ignition/gazebo/components/ContactSensor.hh"
-#include "ignition/gazebo/components/ContactSensorData.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/Collision.hh"
 #include "ignition/gazebo/components/DepthCamera.hh"
 #include "ignition/gazebo/components/Link.hh"
@@ -385,13 +385,12 @@ void OpticalTactilePlugin::PreUpdate(const UpdateInfo &_info,
   {
     // Get the first object being touched by the sensor
     // We assume there's only one object being touched
-    auto csd = _ecm.Component<components::ContactSensorData>(
+    auto csb = _ecm.Component<components::ContactSensorBuffer>(
       this->dataPtr->sensorCollisionEntity);
-    for (const auto &contact : csd->Data().contact())
+    if (csb->Data().PairCount() > 0)
     {
       this->dataPtr->objectCollisionEntity =
-        contact.collision2().id();
-      break;
+        csb->Data().collisions2.front();
     }
 
     // Get the tactile sensor pose, i.e. the model pose
@@ -426,7 +425,7 @@ void OpticalTactilePlugin::PostUpdate(
   if (this->dataPtr->visualizeContacts)
   {
     auto *contacts =
-      _ecm.Component<components::ContactSensorData>(
+      _ecm.Component<components::ContactSensorBuffer>(
         this->dataPtr->sensorCollisionEntity);
 
     if (nullptr != contacts)
@@ -499,7 +498,7 @@ void OpticalTactilePluginPrivate::Load(const EntityComponentManager &_ecm)
   for (const Entity &colEntity : linkCollisions)
   {
     if (_ecm.EntityHasComponentType(colEntity,
-        components::ContactSensorData::typeId))
+        components::ContactSensorBuffer::typeId))
     {
       this->sensorCollisionEntity = colEntity;
 
@@ -104,18 +104,20 @@ void OpticalTactilePluginVisualization::InitializeContactsMarkerMsg(
 }
 
 //////////////////////////////////////////////////
-void OpticalTactilePluginVisualization::AddContactToMarkerMsg(
-  ignition::msgs::Contact const &_contact,
+void OpticalTactilePluginVisualization::AddContactsToMarkerMsg(
+  ContactBuffer const &_contacts,
   ignition::msgs::Marker &_contactMarkerMsg)
 {
-  // todo(anyone) once available, use normal field in the Contact message
-  ignition::math::Vector3d contactNormal(0, 0, 0.03);
-
   // For each contact, add a line marker starting from the contact position,
-  // ending at the endpoint of the normal.
-  for (auto const &position : _contact.position())
+  // ending at the endpoint of the normal. Not all physics engines give
+  // normals, so default to the sensor's up direction.
+  for (std::size_t i = 0; i < _contacts.PointCount(); ++i)
   {
-    ignition::math::Vector3d startPoint = ignition::msgs::Convert(position);
+    ignition::math::Vector3d contactNormal(0, 0, 0.03);
+    if (!_contacts.normals.empty())
+      contactNormal = _contacts.normals[i] * 0.03;
+
+    ignition::math::Vector3d startPoint = _contacts.positions[i];
     ignition::math::Vector3d endPoint = startPoint + contactNormal;
 
     ignition::msgs::Set(_contactMarkerMsg.add_point(), startPoint);
@@ -125,15 +127,12 @@ void OpticalTactilePluginVisualization::AddContactToMarkerMsg(
 
 //////////////////////////////////////////////////
 void OpticalTactilePluginVisualization::RequestContactsMarkerMsg(
-  const components::ContactSensorData *_contacts)
+  const components::ContactSensorBuffer *_contacts)
 {
   ignition::msgs::Marker contactsMarkerMsg;
   this->InitializeContactsMarkerMsg(contactsMarkerMsg);
 
-  for (const auto &contact : _contacts->Data().contact())
-  {
-    this->AddContactToMarkerMsg(contact, contactsMarkerMsg);
-  }
+  this->AddContactsToMarkerMsg(_contacts->Data(), contactsMarkerMsg);
 
   this->node.Request("/marker", contactsMarkerMsg);
 }
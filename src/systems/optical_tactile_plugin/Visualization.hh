@@ -25,7 +25,7 @@
 #include <ignition/gazebo/System.hh>
 #include <ignition/msgs/marker.pb.h>
 
-#include "ignition/gazebo/components/ContactSensorData.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 
 namespace ignition
 {
@@ -82,18 +82,18 @@ namespace optical_tactile_sensor
     private: void InitializeContactsMarkerMsg(
         ignition::msgs::Marker &_contactsMarkerMsg);
 
-    /// \brief Add a contact to the marker message representing the contacts
-    /// from the contact sensor based on physics
-    /// \param[in] _contact Contact to be added
+    /// \brief Add the contacts from the contact sensor based on physics to
+    /// the marker message representing them
+    /// \param[in] _contacts Contacts to be added
     /// \param[out] _contactsMarkerMsg Message for visualizing the contacts
-    public: void AddContactToMarkerMsg(
-        ignition::msgs::Contact const &_contact,
+    public: void AddContactsToMarkerMsg(
+        ContactBuffer const &_contacts,
         ignition::msgs::Marker &_contactsMarkerMsg);
 
     /// \brief Request the "/marker" service for the contacts marker.
     /// \param[in] _contacts Contacts to visualize
     public: void RequestContactsMarkerMsg(
-        components::ContactSensorData const *_contacts);
+        components::ContactSensorBuffer const *_contacts);
 
     /// \brief Initialize the marker messages representing the normal forces
     /// \param[out] _positionMarkerMsg Message for visualizing the contact
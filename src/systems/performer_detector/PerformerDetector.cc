@@ -17,6 +17,8 @@
 
 #include <ignition/msgs/pose.pb.h>
 
+#include <set>
+
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Vector3.hh>
@@ -159,43 +161,111 @@ void PerformerDetector::PostUpdate(
   auto region = this->detectorGeometry -
     (-(modelPose.Pos() + modelPose.Rot() * this->poseOffset.Pos()));
 
-  _ecm.Each<components::Performer, components::Geometry,
-            components::ParentEntity>(
-      [&](const Entity &_entity, const components::Performer *,
-          const components::Geometry *_geometry,
-          const components::ParentEntity *_parent) -> bool
+  this->UpdatePerformers(_ecm);
+
+  // Only models whose origin is within the region grown by the largest
+  // performer can have performers within the region. Detected performers
+  // are also checked, in case they left.
+  math::AxisAlignedBox broadRegion(
+      region.Min() - this->maxPerformerSize / 2,
+      region.Max() + this->maxPerformerSize / 2);
+  std::set<Entity> performers(this->detectedEntities.begin(),
+      this->detectedEntities.end());
+  for (const auto &modelEntity :
+      _ecm.ModelSpatialIndex().Query(broadRegion))
+  {
+    auto it = this->modelPerformers.find(modelEntity);
+    if (it != this->modelPerformers.end())
+      performers.insert(it->second.begin(), it->second.end());
+  }
+
+  for (const auto &entity : performers)
+  {
+    auto geometry = _ecm.Component<components::Geometry>(entity);
+    auto parent = _ecm.Component<components::ParentEntity>(entity);
+    if (nullptr == geometry || nullptr == parent)
+    {
+      // The performer was removed
+      this->RemoveFromDetected(entity);
+      continue;
+    }
+
+    auto pose = _ecm.Component<components::Pose>(parent->Data())->Data();
+    auto name = _ecm.Component<components::Name>(parent->Data())->Data();
+    const math::Pose3d relPose = modelPose.Inverse() * pose;
+
+    // We assume the geometry contains a box.
+    auto perfBox = geometry->Data().BoxShape();
+    if (nullptr == perfBox)
+    {
+      ignerr << "Internal error: geometry of performer [" << entity
+             << "] missing box." << std::endl;
+      continue;
+    }
+
+    math::AxisAlignedBox performerVolume{pose.Pos() - perfBox->Size() / 2,
+                                         pose.Pos() + perfBox->Size() / 2};
+
+    bool alreadyDetected = this->IsAlreadyDetected(entity);
+    if (region.Intersects(performerVolume))
+    {
+      if (!alreadyDetected)
       {
-        auto pose = _ecm.Component<components::Pose>(_parent->Data())->Data();
-        auto name = _ecm.Component<components::Name>(_parent->Data())->Data();
-        const math::Pose3d relPose = modelPose.Inverse() * pose;
+        this->AddToDetected(entity);
+        this->Publish(entity, name, true, relPose, _info.simTime);
+      }
+    }
+    else if (alreadyDetected)
+    {
+      this->RemoveFromDetected(entity);
+      this->Publish(entity, name, false, relPose, _info.simTime);
+    }
+  }
+}
 
-        // We assume the geometry contains a box.
-        auto perfBox = _geometry->Data().BoxShape();
-        if (nullptr == perfBox)
-        {
-          ignerr << "Internal error: geometry of performer [" << _entity
-                 << "] missing box." << std::endl;
-          return true;
-        }
+//////////////////////////////////////////////////
+void PerformerDetector::UpdatePerformers(const EntityComponentManager &_ecm)
+{
+  auto addPerformer = [&](const Entity &_entity, const components::Performer *,
+      const components::Geometry *_geometry,
+      const components::ParentEntity *_parent) -> bool
+  {
+    this->performerModels[_entity] = _parent->Data();
+    this->modelPerformers[_parent->Data()].insert(_entity);
 
-        math::AxisAlignedBox performerVolume{pose.Pos() - perfBox->Size() / 2,
-                                             pose.Pos() + perfBox->Size() / 2};
+    auto perfBox = _geometry->Data().BoxShape();
+    if (nullptr != perfBox)
+      this->maxPerformerSize.Max(perfBox->Size());
+    return true;
+  };
 
-        bool alreadyDetected = this->IsAlreadyDetected(_entity);
-        if (region.Intersects(performerVolume))
-        {
-          if (!alreadyDetected)
-          {
-            this->AddToDetected(_entity);
-            this->Publish(_entity, name, true, relPose, _info.simTime);
-          }
-        }
-        else if (alreadyDetected)
+  if (!this->performersLoaded)
+  {
+    _ecm.Each<components::Performer, components::Geometry,
+              components::ParentEntity>(addPerformer);
+    this->performersLoaded = true;
+  }
+  else
+  {
+    _ecm.EachNew<components::Performer, components::Geometry,
+                 components::ParentEntity>(addPerformer);
+  }
+
+  _ecm.EachRemoved<components::Performer>(
+      [&](const Entity &_entity, const components::Performer *) -> bool
+      {
+        auto it = this->performerModels.find(_entity);
+        if (it == this->performerModels.end())
+          return true;
+
+        auto modelIt = this->modelPerformers.find(it->second);
+        if (modelIt != this->modelPerformers.end())
         {
-          this->RemoveFromDetected(_entity);
-          this->Publish(_entity, name, false, relPose, _info.simTime);
+          modelIt->second.erase(_entity);
+          if (modelIt->second.empty())
+            this->modelPerformers.erase(modelIt);
         }
-
+        this->performerModels.erase(it);
         return true;
       });
 }
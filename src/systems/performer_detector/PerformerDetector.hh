@@ -21,6 +21,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <ignition/transport/Node.hh>
@@ -125,6 +126,26 @@ namespace systems
     /// \brief Keeps a set of detected entities
     private: std::unordered_set<Entity> detectedEntities;
 
+    /// \brief Update the performers being tracked with the ones which
+    /// were created or removed.
+    /// \param[in] _ecm Entity component manager
+    private: void UpdatePerformers(const EntityComponentManager &_ecm);
+
+    /// \brief Model containing each performer.
+    private: std::unordered_map<Entity, Entity> performerModels;
+
+    /// \brief Performers contained by each model.
+    private: std::unordered_map<Entity, std::unordered_set<Entity>>
+        modelPerformers;
+
+    /// \brief Size of the largest performer, used to find the models which
+    /// may have performers within the region.
+    private: math::Vector3d maxPerformerSize;
+
+    /// \brief Whether the performers created before the first update have
+    /// been loaded.
+    private: bool performersLoaded{false};
+
     /// \brief The model associated with this system.
     private: Model model;
 
@@ -23,9 +23,10 @@
 #include <ignition/msgs/Utility.hh>
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -94,6 +95,7 @@
 #include "ignition/gazebo/components/CanonicalLink.hh"
 #include "ignition/gazebo/components/ChildLinkName.hh"
 #include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/ContactSensorData.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Gravity.hh"
@@ -137,6 +139,52 @@ using namespace ignition::gazebo::systems;
 using namespace ignition::gazebo::systems::physics_system;
 namespace components = ignition::gazebo::components;
 
+/// \brief Write a value to a checkpoint, in host byte order.
+/// \param[out] _out Checkpoint stream.
+/// \param[in] _value Value to write.
+template<typename T>
+static void writeCheckpointValue(std::ostream &_out, const T &_value)
+{
+  _out.write(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+/// \brief Read a value written by writeCheckpointValue.
+/// \param[in] _in Checkpoint stream.
+/// \param[out] _value Value read.
+/// \return True if the whole value could be read.
+template<typename T>
+static bool readCheckpointValue(std::istream &_in, T &_value)
+{
+  _in.read(reinterpret_cast<char *>(&_value), sizeof(T));
+  return _in.gcount() == static_cast<std::streamsize>(sizeof(T));
+}
+
+/// \brief Write a vector to a checkpoint.
+/// \param[out] _out Checkpoint stream.
+/// \param[in] _vec Vector to write.
+static void writeCheckpointVector(std::ostream &_out,
+    const math::Vector3d &_vec)
+{
+  writeCheckpointValue(_out, _vec.X());
+  writeCheckpointValue(_out, _vec.Y());
+  writeCheckpointValue(_out, _vec.Z());
+}
+
+/// \brief Read a vector written by writeCheckpointVector.
+/// \param[in] _in Checkpoint stream.
+/// \param[out] _vec Vector read.
+/// \return True if the whole vector could be read.
+static bool readCheckpointVector(std::istream &_in, math::Vector3d &_vec)
+{
+  double x, y, z;
+  if (!readCheckpointValue(_in, x) || !readCheckpointValue(_in, y) ||
+      !readCheckpointValue(_in, z))
+  {
+    return false;
+  }
+  _vec.Set(x, y, z);
+  return true;
+}
 
 // Private data class.
 class ignition::gazebo::systems::PhysicsPrivate
@@ -314,6 +362,20 @@ class ignition::gazebo::systems::PhysicsPrivate
   /// deleted the following iteration.
   public: std::unordered_set<Entity> worldPoseCmdsToRemove;
 
+  /// \brief Set the state of physics entities from the ECM and the
+  /// velocities read from a checkpoint.
+  /// \param[in] _ecm Constant reference to the restored ECM.
+  public: void ApplyCheckpoint(const EntityComponentManager &_ecm);
+
+  /// \brief Whether a restored checkpoint still needs to be applied to the
+  /// physics engine.
+  public: bool checkpointPending{false};
+
+  /// \brief World linear and angular velocities of top-level models, read
+  /// from a checkpoint.
+  public: std::unordered_map<Entity,
+          std::pair<math::Vector3d, math::Vector3d>> checkpointVelocities;
+
   /// \brief used to store whether physics objects have been created.
   public: bool initialized = false;
 
@@ -380,6 +442,34 @@ class ignition::gazebo::systems::PhysicsPrivate
                       return true;
                     }};
 
+  /// \brief A contact from the last step, seen from one of its collisions.
+  public: struct ContactRef
+  {
+    /// \brief Collision which sees the contact.
+    Entity collision1;
+
+    /// \brief Other collision of the contact.
+    Entity collision2;
+
+    /// \brief Index of the contact in the physics engine's output.
+    std::size_t index;
+
+    /// \brief True if collision1 is the second collision of the contact in
+    /// the physics engine's output, so normals and forces must be flipped.
+    bool flipped;
+  };
+
+  /// \brief Contacts of the last step, sorted by collision pair. Kept
+  /// between steps to reuse its memory.
+  public: std::vector<ContactRef> contactRefs;
+
+  /// \brief Buffer filled for each collision before being swapped into its
+  /// component. Kept between steps to reuse its memory.
+  public: ContactBuffer contactScratch;
+
+  /// \brief Message reused to fill ContactSensorData components.
+  public: msgs::Contacts contactsScratchMsg;
+
   /// \brief Environment variable which holds paths to look for engine plugins
   public: std::string pluginPathEnv = "IGN_GAZEBO_PHYSICS_ENGINE_PATH";
 
@@ -730,6 +820,8 @@ void Physics::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
   if (this->dataPtr->engine)
   {
     this->dataPtr->CreatePhysicsEntities(_ecm);
+    if (this->dataPtr->checkpointPending)
+      this->dataPtr->ApplyCheckpoint(_ecm);
     this->dataPtr->UpdatePhysics(_ecm);
     ignition::physics::ForwardStep::Output stepOutput;
     // Only step if not paused.
@@ -747,6 +839,176 @@ void Physics::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
   }
 }
 
+//////////////////////////////////////////////////
+void Physics::SaveCheckpoint(const EntityComponentManager &_ecm,
+    std::ostream &_out)
+{
+  // Poses and joint states are already in the ECM, only the velocities of
+  // free bodies are held by the engine alone
+  std::vector<std::pair<Entity, physics::FrameData3d>> bodies;
+  _ecm.Each<components::Model>(
+      [&](const Entity &_entity, const components::Model *) -> bool
+      {
+        if (topLevelModel(_entity, _ecm) != _entity)
+          return true;
+
+        auto modelPtrPhys = this->dataPtr->entityModelMap.Get(_entity);
+        if (nullptr == modelPtrPhys)
+          return true;
+
+        auto freeGroup = modelPtrPhys->FindFreeGroup();
+        if (!freeGroup)
+          return true;
+
+        bodies.emplace_back(_entity, freeGroup->FrameDataRelativeToWorld());
+        return true;
+      });
+
+  writeCheckpointValue(_out, static_cast<uint64_t>(bodies.size()));
+  for (const auto &[entity, frameData] : bodies)
+  {
+    writeCheckpointValue(_out, static_cast<uint64_t>(entity));
+    writeCheckpointVector(_out, math::eigen3::convert(
+        frameData.linearVelocity));
+    writeCheckpointVector(_out, math::eigen3::convert(
+        frameData.angularVelocity));
+  }
+}
+
+//////////////////////////////////////////////////
+void Physics::RestoreCheckpoint(EntityComponentManager &/*_ecm*/,
+    std::istream &_in)
+{
+  this->dataPtr->checkpointVelocities.clear();
+
+  uint64_t count{0};
+  if (!readCheckpointValue(_in, count))
+  {
+    ignerr << "Failed to read physics checkpoint." << std::endl;
+    return;
+  }
+
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    uint64_t entity{0};
+    math::Vector3d linearVel;
+    math::Vector3d angularVel;
+    if (!readCheckpointValue(_in, entity) ||
+        !readCheckpointVector(_in, linearVel) ||
+        !readCheckpointVector(_in, angularVel))
+    {
+      ignerr << "Physics checkpoint is truncated, velocities won't be "
+             << "restored." << std::endl;
+      this->dataPtr->checkpointVelocities.clear();
+      break;
+    }
+    this->dataPtr->checkpointVelocities[entity] = {linearVel, angularVel};
+  }
+
+  // Physics entities for models recreated by the restore only exist after
+  // the next CreatePhysicsEntities, so the state is applied then
+  this->dataPtr->checkpointPending = true;
+}
+
+//////////////////////////////////////////////////
+void PhysicsPrivate::ApplyCheckpoint(const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("PhysicsPrivate::ApplyCheckpoint");
+
+  this->checkpointPending = false;
+
+  // Cached poses are from before the restore
+  this->linkWorldPoses.clear();
+  this->modelWorldPoses.clear();
+
+  _ecm.Each<components::Model, components::Pose>(
+      [&](const Entity &_entity, const components::Model *,
+          const components::Pose *_pose) -> bool
+      {
+        if (topLevelModel(_entity, _ecm) != _entity)
+          return true;
+
+        auto modelPtrPhys = this->entityModelMap.Get(_entity);
+        if (nullptr == modelPtrPhys)
+          return true;
+
+        auto freeGroup = modelPtrPhys->FindFreeGroup();
+        if (!freeGroup)
+          return true;
+
+        const auto linkEntity =
+            this->entityLinkMap.Get(freeGroup->RootLink());
+        if (linkEntity == kNullEntity)
+          return true;
+
+        // The pose of a top-level model is its world pose
+        math::Pose3d linkPose =
+            this->RelativePose(_entity, linkEntity, _ecm);
+        freeGroup->SetWorldPose(math::eigen3::convert(_pose->Data() *
+                                linkPose));
+
+        if (this->staticEntities.find(_entity) == this->staticEntities.end())
+          this->modelWorldPoses[_entity] = _pose->Data();
+
+        auto velIt = this->checkpointVelocities.find(_entity);
+        if (velIt == this->checkpointVelocities.end())
+          return true;
+
+        this->entityFreeGroupMap.AddEntity(_entity, freeGroup);
+        auto worldVelFeature =
+            this->entityFreeGroupMap
+                .EntityCast<WorldVelocityCommandFeatureList>(_entity);
+        if (!worldVelFeature)
+        {
+          static bool informed{false};
+          if (!informed)
+          {
+            igndbg << "Attempting to restore model velocities, but the "
+                   << "physics engine doesn't support velocity commands. "
+                   << "Velocities won't be restored."
+                   << std::endl;
+            informed = true;
+          }
+          return true;
+        }
+
+        worldVelFeature->SetWorldLinearVelocity(
+            math::eigen3::convert(velIt->second.first));
+        worldVelFeature->SetWorldAngularVelocity(
+            math::eigen3::convert(velIt->second.second));
+
+        return true;
+      });
+
+  _ecm.Each<components::Joint, components::JointPosition>(
+      [&](const Entity &_entity, const components::Joint *,
+          const components::JointPosition *_position) -> bool
+      {
+        auto jointPhys = this->entityJointMap.Get(_entity);
+        if (nullptr == jointPhys)
+          return true;
+
+        const auto &position = _position->Data();
+        std::size_t nDofs = std::min(
+            position.size(), jointPhys->GetDegreesOfFreedom());
+        for (std::size_t i = 0; i < nDofs; ++i)
+          jointPhys->SetPosition(i, position[i]);
+
+        auto velocityComp = _ecm.Component<components::JointVelocity>(_entity);
+        if (velocityComp)
+        {
+          const auto &velocity = velocityComp->Data();
+          nDofs = std::min(velocity.size(), jointPhys->GetDegreesOfFreedom());
+          for (std::size_t i = 0; i < nDofs; ++i)
+            jointPhys->SetVelocity(i, velocity[i]);
+        }
+
+        return true;
+      });
+
+  this->checkpointVelocities.clear();
+}
+
 //////////////////////////////////////////////////
 void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
 {
@@ -1080,9 +1342,12 @@ void PhysicsPrivate::CreateCollisionEntities(const EntityComponentManager &_ecm)
             return true;
           }
 
-          auto &meshManager = *ignition::common::MeshManager::Instance();
           auto fullPath = asFullPath(meshSdf->Uri(), meshSdf->FilePath());
-          auto *mesh = meshManager.Load(fullPath);
+          const common::Mesh *mesh{nullptr};
+          {
+            std::lock_guard<std::mutex> lock(meshManagerMutex());
+            mesh = ignition::common::MeshManager::Instance()->Load(fullPath);
+          }
           if (nullptr == mesh)
           {
             ignwarn << "Failed to load mesh from [" << fullPath
@@ -2770,9 +3035,12 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
 void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
 {
   IGN_PROFILE("PhysicsPrivate::UpdateCollisions");
-  // Quit early if the ContactData component hasn't been created. This means
+  // Quit early if no contact component has been created. This means
   // there are no systems that need contact information
-  if (!_ecm.HasComponentType(components::ContactSensorData::typeId))
+  bool hasBuffers =
+      _ecm.HasComponentType(components::ContactSensorBuffer::typeId);
+  bool hasMsgs = _ecm.HasComponentType(components::ContactSensorData::typeId);
+  if (!hasBuffers && !hasMsgs)
     return;
 
   // TODO(addisu) If systems are assumed to only have one world, we should
@@ -2809,81 +3077,129 @@ void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
 
   // Each contact object we get from ign-physics contains the EntityPtrs of the
   // two colliding entities and other data about the contact such as the
-  // position. This map groups contacts so that it is easy to query all the
-  // contacts of one entity.
-  using EntityContactMap = std::unordered_map<Entity,
-      std::deque<const WorldShapeType::ContactPoint *>>;
-
-  // This data structure is essentially a mapping between a pair of entities and
-  // a list of pointers to their contact object. We use a map inside a map to
-  // create msgs::Contact objects conveniently later on.
-  std::unordered_map<Entity, EntityContactMap> entityContactMap;
-
-  // Note that we are temporarily storing pointers to elements in this
-  // ("allContacts") container. Thus, we must make sure it doesn't get destroyed
-  // until the end of this function.
+  // position. Each contact is listed once for each of its collisions, and the
+  // list is sorted so that the contacts of one collision, grouped by the
+  // other collision, are next to each other.
   auto allContacts = worldCollisionFeature->GetContactsFromLastStep();
-  for (const auto &contactComposite : allContacts)
+  this->contactRefs.clear();
+  for (std::size_t i = 0; i < allContacts.size(); ++i)
   {
-    const auto &contact = contactComposite.Get<WorldShapeType::ContactPoint>();
+    const auto &contact =
+        allContacts[i].Get<WorldShapeType::ContactPoint>();
     auto coll1Entity =
       this->entityCollisionMap.Get(ShapePtrType(contact.collision1));
     auto coll2Entity =
       this->entityCollisionMap.Get(ShapePtrType(contact.collision2));
 
-
     if (coll1Entity != kNullEntity && coll2Entity != kNullEntity)
     {
-      entityContactMap[coll1Entity][coll2Entity].push_back(&contact);
-      entityContactMap[coll2Entity][coll1Entity].push_back(&contact);
+      this->contactRefs.push_back({coll1Entity, coll2Entity, i, false});
+      this->contactRefs.push_back({coll2Entity, coll1Entity, i, true});
     }
   }
+  std::stable_sort(this->contactRefs.begin(), this->contactRefs.end(),
+      [](const ContactRef &_a, const ContactRef &_b)
+      {
+        return _a.collision1 < _b.collision1 ||
+            (_a.collision1 == _b.collision1 && _a.collision2 < _b.collision2);
+      });
+
+  // Fill a buffer with the contacts of one collision
+  auto fillBuffer = [&](const Entity _collEntity1, ContactBuffer &_buffer)
+  {
+    _buffer.Clear();
+    _buffer.collision = _collEntity1;
+
+    auto range = std::equal_range(
+        this->contactRefs.begin(), this->contactRefs.end(),
+        ContactRef{_collEntity1, kNullEntity, 0, false},
+        [](const ContactRef &_a, const ContactRef &_b)
+        {
+          return _a.collision1 < _b.collision1;
+        });
+
+    bool hasExtraData{true};
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (_buffer.collisions2.empty() ||
+          _buffer.collisions2.back() != it->collision2)
+      {
+        _buffer.AddPair(it->collision2);
+      }
+
+      const auto &contactComposite = allContacts[it->index];
+      const auto &contact =
+          contactComposite.Get<WorldShapeType::ContactPoint>();
+      _buffer.positions.push_back(math::eigen3::convert(contact.point));
+
+      const auto *extraData =
+          contactComposite.Query<WorldShapeType::ExtraContactData>();
+      hasExtraData = hasExtraData && nullptr != extraData;
+      if (hasExtraData)
+      {
+        double sign = it->flipped ? -1.0 : 1.0;
+        _buffer.normals.push_back(
+            math::eigen3::convert(extraData->normal) * sign);
+        _buffer.depths.push_back(extraData->depth);
+        _buffer.forces.push_back(
+            math::eigen3::convert(extraData->force) * sign);
+      }
+    }
+
+    if (!hasExtraData)
+    {
+      _buffer.normals.clear();
+      _buffer.depths.clear();
+      _buffer.forces.clear();
+    }
+  };
+
+  // Go through each collision entity that has a ContactSensorBuffer and fill
+  // it with the contacts of that collision. The buffer is filled in place,
+  // and only swapped into the component if it changed.
+  if (hasBuffers)
+  {
+    _ecm.Each<components::Collision, components::ContactSensorBuffer>(
+        [&](const Entity &_collEntity1, components::Collision *,
+            components::ContactSensorBuffer *_buffer) -> bool
+        {
+          fillBuffer(_collEntity1, this->contactScratch);
+
+          auto state = ComponentState::NoChange;
+          if (this->contactScratch != _buffer->Data())
+          {
+            std::swap(this->contactScratch, _buffer->Data());
+            state = ComponentState::OneTimeChange;
+          }
+          _ecm.SetChanged(
+              _collEntity1, components::ContactSensorBuffer::typeId, state);
+          return true;
+        });
+  }
 
   // Go through each collision entity that has a ContactData component and
   // set the component value to the list of contacts that correspond to
-  // the collision entity
-  _ecm.Each<components::Collision, components::ContactSensorData>(
-      [&](const Entity &_collEntity1, components::Collision *,
-          components::ContactSensorData *_contacts) -> bool
-      {
-        msgs::Contacts contactsComp;
-        if (entityContactMap.find(_collEntity1) == entityContactMap.end())
+  // the collision entity. This component is kept for compatibility, new
+  // consumers should use ContactSensorBuffer.
+  if (hasMsgs)
+  {
+    _ecm.Each<components::Collision, components::ContactSensorData>(
+        [&](const Entity &_collEntity1, components::Collision *,
+            components::ContactSensorData *_contacts) -> bool
         {
-          // Clear the last contact data
-          auto state = _contacts->SetData(contactsComp,
+          fillBuffer(_collEntity1, this->contactScratch);
+          this->contactScratch.ToMsg(this->contactsScratchMsg);
+
+          auto state = _contacts->SetData(this->contactsScratchMsg,
             this->contactsEql) ?
             ComponentState::OneTimeChange :
             ComponentState::NoChange;
           _ecm.SetChanged(
             _collEntity1, components::ContactSensorData::typeId, state);
-          return true;
-        }
 
-        const auto &contactMap = entityContactMap[_collEntity1];
-
-        for (const auto &[collEntity2, contactData] : contactMap)
-        {
-          msgs::Contact *contactMsg = contactsComp.add_contact();
-          contactMsg->mutable_collision1()->set_id(_collEntity1);
-          contactMsg->mutable_collision2()->set_id(collEntity2);
-          for (const auto &contact : contactData)
-          {
-            auto *position = contactMsg->add_position();
-            position->set_x(contact->point.x());
-            position->set_y(contact->point.y());
-            position->set_z(contact->point.z());
-          }
-        }
-
-        auto state = _contacts->SetData(contactsComp,
-          this->contactsEql) ?
-          ComponentState::OneTimeChange :
-          ComponentState::NoChange;
-        _ecm.SetChanged(
-          _collEntity1, components::ContactSensorData::typeId, state);
-
-        return true;
-      });
+          return true;
+        });
+  }
 }
 
 physics::FrameData3d PhysicsPrivate::LinkFrameDataAtOffset(
@@ -2898,6 +3214,7 @@ physics::FrameData3d PhysicsPrivate::LinkFrameDataAtOffset(
 IGNITION_ADD_PLUGIN(Physics,
                     ignition::gazebo::System,
                     Physics::ISystemConfigure,
-                    Physics::ISystemUpdate)
+                    Physics::ISystemUpdate,
+                    Physics::ISystemCheckpoint)
 
 IGNITION_ADD_PLUGIN_ALIAS(Physics, "ignition::gazebo::systems::Physics")
@@ -67,7 +67,8 @@ namespace systems
   class Physics:
     public System,
     public ISystemConfigure,
-    public ISystemUpdate
+    public ISystemUpdate,
+    public ISystemCheckpoint
   {
     /// \brief Constructor
     public: explicit Physics();
@@ -85,6 +86,14 @@ namespace systems
     public: void Update(const UpdateInfo &_info,
                 EntityComponentManager &_ecm) final;
 
+    // Documentation inherited
+    public: void SaveCheckpoint(const EntityComponentManager &_ecm,
+                std::ostream &_out) final;
+
+    // Documentation inherited
+    public: void RestoreCheckpoint(EntityComponentManager &_ecm,
+                std::istream &_in) final;
+
     /// \brief Private data pointer.
     private: std::unique_ptr<PhysicsPrivate> dataPtr;
   };
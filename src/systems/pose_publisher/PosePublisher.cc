@@ -549,10 +549,20 @@ void PosePublisherPrivate::PublishPoses(
     _publisher.Publish(this->poseVMsg);
 }
 
+//////////////////////////////////////////////////
+void PosePublisher::Reset(const UpdateInfo &, EntityComponentManager &)
+{
+  // Publish on the next update, at the new time
+  this->dataPtr->lastPosePubTime = std::chrono::steady_clock::duration::zero();
+  this->dataPtr->lastStaticPosePubTime =
+      std::chrono::steady_clock::duration::zero();
+}
+
 IGNITION_ADD_PLUGIN(PosePublisher,
                     System,
                     PosePublisher::ISystemConfigure,
-                    PosePublisher::ISystemPostUpdate)
+                    PosePublisher::ISystemPostUpdate,
+                    PosePublisher::ISystemReset)
 
 IGNITION_ADD_PLUGIN_ALIAS(PosePublisher,
                           "ignition::gazebo::systems::PosePublisher")
@@ -65,7 +65,8 @@ namespace systems
   class PosePublisher
       : public System,
         public ISystemConfigure,
-        public ISystemPostUpdate
+        public ISystemPostUpdate,
+        public ISystemReset
   {
     /// \brief Constructor
     public: PosePublisher();
@@ -84,6 +85,10 @@ namespace systems
                 const UpdateInfo &_info,
                 const EntityComponentManager &_ecm) override;
 
+    // Documentation inherited
+    public: void Reset(const UpdateInfo &_info,
+                       EntityComponentManager &_ecm) override;
+
     /// \brief Private data pointer
     private: std::unique_ptr<PosePublisherPrivate> dataPtr;
   };
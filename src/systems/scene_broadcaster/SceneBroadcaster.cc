@@ -21,6 +21,7 @@
 
 #include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <string>
 #include <unordered_set>
 
@@ -203,9 +204,35 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   public: std::chrono::duration<int64_t, std::ratio<1, 1000>>
       statePublishPeriod{std::chrono::milliseconds(1000/60)};
 
-  /// \brief Flag used to indicate if the state service was called.
+  /// \brief Flag used to indicate if the async state service was called.
   public: bool stateServiceRequest{false};
 
+  /// \brief Flag used to indicate if the state service is waiting for a
+  /// snapshot. Protected by stateMutex.
+  public: bool stateSnapshotRequest{false};
+
+  /// \brief Number of state service calls waiting for a snapshot.
+  /// Protected by stateMutex.
+  public: int stateSnapshotWaiters{0};
+
+  /// \brief Latest snapshot taken for the state service, which serializes
+  /// it on its own thread. It's released once all waiting calls have it, so
+  /// its storage copies can be reused by the next snapshot. Protected by
+  /// stateMutex.
+  public: std::shared_ptr<const EntityComponentManager> stateSnapshot;
+
+  /// \brief Simulation info when stateSnapshot was taken. Protected by
+  /// stateMutex.
+  public: msgs::WorldStatistics stateSnapshotStats;
+
+  /// \brief Info of the latest iteration whose PostUpdate has run, which
+  /// is the state of the ECM during the following PreUpdate.
+  public: UpdateInfo lastInfo;
+
+  /// \brief True if time jumped since the last PostUpdate, which makes it
+  /// publish the full state.
+  public: bool timeJumped{false};
+
   /// \brief A list of async state requests
   public: std::unordered_set<std::string> stateRequests;
 };
@@ -249,6 +276,25 @@ void SceneBroadcaster::Configure(
   }
 }
 
+//////////////////////////////////////////////////
+void SceneBroadcaster::PreUpdate(const UpdateInfo &,
+    EntityComponentManager &_manager)
+{
+  IGN_PROFILE("SceneBroadcaster::PreUpdate");
+
+  // Snapshot for the state service, so the full state is serialized on the
+  // service's thread instead of stalling simulation. Snapshots must be taken
+  // on the simulation thread, so that's done here rather than in PostUpdate.
+  std::lock_guard<std::mutex> lock(this->dataPtr->stateMutex);
+  if (this->dataPtr->stateSnapshotRequest)
+  {
+    this->dataPtr->stateSnapshot = _manager.Snapshot();
+    set(&this->dataPtr->stateSnapshotStats, this->dataPtr->lastInfo);
+    this->dataPtr->stateSnapshotRequest = false;
+    this->dataPtr->stateCv.notify_all();
+  }
+}
+
 //////////////////////////////////////////////////
 void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
     const EntityComponentManager &_manager)
@@ -269,6 +315,8 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
     this->dataPtr->PoseUpdate(_info, _manager);
   }
 
+  this->dataPtr->lastInfo = _info;
+
   // call SceneGraphRemoveEntities at the end of this update cycle so that
   // removed entities are removed from the scene graph for the next update cycle
   this->dataPtr->SceneGraphRemoveEntities(_manager);
@@ -281,7 +329,9 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
   //     * jump back in time
   // Throttle here instead of using transport::AdvertiseMessageOptions so that
   // we can skip the ECM serialization
-  bool jumpBackInTime = _info.dt < std::chrono::steady_clock::duration::zero();
+  bool jumpBackInTime = this->dataPtr->timeJumped ||
+      _info.dt < std::chrono::steady_clock::duration::zero();
+  this->dataPtr->timeJumped = false;
   bool changeEvent = _manager.HasEntitiesMarkedForRemoval() ||
     _manager.HasNewEntities() || _manager.HasOneTimeComponentChanges() ||
     jumpBackInTime;
@@ -592,21 +642,35 @@ bool SceneBroadcasterPrivate::StateService(
 {
   _res.Clear();
 
-  // Lock and wait for an iteration to be run and fill the state
-  std::unique_lock<std::mutex> lock(this->stateMutex);
-
-  this->stateServiceRequest = true;
-  auto success = this->stateCv.wait_for(lock, 5s, [&]
+  // Wait for an iteration to be run and take a snapshot
+  std::shared_ptr<const EntityComponentManager> snapshot;
   {
-    return this->stepMsg.has_state() && !this->stateServiceRequest;
-  });
+    std::unique_lock<std::mutex> lock(this->stateMutex);
+
+    this->stateSnapshotRequest = true;
+    ++this->stateSnapshotWaiters;
+    auto success = this->stateCv.wait_for(lock, 5s, [&]
+    {
+      return !this->stateSnapshotRequest;
+    });
+    --this->stateSnapshotWaiters;
+
+    if (!success)
+    {
+      if (this->stateSnapshotWaiters == 0)
+        this->stateSnapshotRequest = false;
+      ignerr << "Timed out waiting for state" << std::endl;
+      return false;
+    }
 
-  if (success)
-    _res.CopyFrom(this->stepMsg);
-  else
-    ignerr << "Timed out waiting for state" << std::endl;
+    snapshot = this->stateSnapshot;
+    _res.mutable_stats()->CopyFrom(this->stateSnapshotStats);
+    if (this->stateSnapshotWaiters == 0)
+      this->stateSnapshot.reset();
+  }
 
-  return success;
+  snapshot->State(*_res.mutable_state(), {}, {}, true);
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -974,10 +1038,20 @@ void SceneBroadcasterPrivate::RemoveFromGraph(const Entity _entity,
 }
 
 
+//////////////////////////////////////////////////
+void SceneBroadcaster::Reset(const UpdateInfo &_info,
+    EntityComponentManager &)
+{
+  this->dataPtr->lastInfo = _info;
+  this->dataPtr->timeJumped = true;
+}
+
 IGNITION_ADD_PLUGIN(SceneBroadcaster,
                     ignition::gazebo::System,
                     SceneBroadcaster::ISystemConfigure,
-                    SceneBroadcaster::ISystemPostUpdate)
+                    SceneBroadcaster::ISystemPreUpdate,
+                    SceneBroadcaster::ISystemPostUpdate,
+                    SceneBroadcaster::ISystemReset)
 
 // Add plugin alias so that we can refer to the plugin without the version
 // namespace
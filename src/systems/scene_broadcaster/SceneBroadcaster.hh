@@ -40,7 +40,9 @@ namespace systems
   class SceneBroadcaster:
     public System,
     public ISystemConfigure,
-    public ISystemPostUpdate
+    public ISystemPreUpdate,
+    public ISystemPostUpdate,
+    public ISystemReset
   {
     /// \brief Constructor
     public: SceneBroadcaster();
@@ -54,10 +56,18 @@ namespace systems
                            EntityComponentManager &_ecm,
                            EventManager &_eventMgr) final;
 
+    // Documentation inherited
+    public: void PreUpdate(const UpdateInfo &_info,
+                EntityComponentManager &_ecm) final;
+
     // Documentation inherited
     public: void PostUpdate(const UpdateInfo &_info,
                 const EntityComponentManager &_ecm) final;
 
+    // Documentation inherited
+    public: void Reset(const UpdateInfo &_info,
+                EntityComponentManager &_ecm) final;
+
     /// \brief Private data pointer
     private: std::unique_ptr<SceneBroadcasterPrivate> dataPtr;
   };
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -32,6 +33,7 @@
 
 #include <ignition/rendering/Scene.hh>
 #include <ignition/sensors/CameraSensor.hh>
+#include <ignition/sensors/DepthCameraSensor.hh>
 #include <ignition/sensors/RenderingSensor.hh>
 #include <ignition/sensors/ThermalCameraSensor.hh>
 #include <ignition/sensors/Manager.hh>
@@ -49,6 +51,9 @@
 
 #include "ignition/gazebo/rendering/Events.hh"
 #include "ignition/gazebo/rendering/RenderUtil.hh"
+#include "ignition/gazebo/rendering/SceneManager.hh"
+
+#include "ShmImageWriter.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -125,6 +130,17 @@ class ignition::gazebo::systems::SensorsPrivate
   /// \brief Sensors to include in the next rendering iteration
   public: std::vector<sensors::RenderingSensor *> activeSensors;
 
+  /// \brief Sensors to update in the next rendering iteration even though
+  /// their own schedule isn't due, see resetUpdateTimes.
+  public: std::vector<sensors::RenderingSensor *> forcedSensors;
+
+  /// \brief Next update times of sensors whose own schedule was left ahead
+  /// of sim time when it jumped back. They're updated on this schedule
+  /// instead, until sim time catches up with theirs. Protected by
+  /// sensorMaskMutex.
+  public: std::map<sensors::SensorId,
+    std::chrono::steady_clock::duration> resetUpdateTimes;
+
   /// \brief Mutex to protect sensorMask
   public: std::mutex sensorMaskMutex;
 
@@ -135,6 +151,22 @@ class ignition::gazebo::systems::SensorsPrivate
   /// \brief Pointer to the event manager
   public: EventManager *eventManager{nullptr};
 
+  /// \brief Number of slots of the shared memory image outputs. Zero if
+  /// images aren't written to shared memory.
+  public: unsigned int shmSlots{0u};
+
+  /// \brief Shared memory image output of each sensor, together with the
+  /// connection which feeds it.
+  public: std::map<sensors::SensorId, std::pair<
+      std::unique_ptr<ShmImageWriter>, common::ConnectionPtr>> shmOutputs;
+
+  /// \brief Write the images of a sensor to shared memory, in addition to
+  /// publishing them.
+  /// \param[in] _sensor Sensor
+  /// \param[in] _sdf SDF description of the sensor
+  public: void AddShmOutput(sensors::Sensor *_sensor,
+      const sdf::Sensor &_sdf);
+
   /// \brief Wait for initialization to happen
   private: void WaitForInit();
 
@@ -223,11 +255,17 @@ void SensorsPrivate::RunOnce()
   IGN_PROFILE("SensorsPrivate::RunOnce");
   {
     IGN_PROFILE("Update");
+    std::vector<std::string> cullingSensors;
+    for (const auto &sensor : this->activeSensors)
+      cullingSensors.push_back(sensor->Name());
+    for (const auto &sensor : this->forcedSensors)
+      cullingSensors.push_back(sensor->Name());
+    this->renderUtil.SetCullingSensors(cullingSensors);
     this->renderUtil.Update();
   }
 
 
-  if (!this->activeSensors.empty())
+  if (!this->activeSensors.empty() || !this->forcedSensors.empty())
   {
     this->sensorMaskMutex.lock();
     // Check the active sensors against masked sensors.
@@ -262,10 +300,13 @@ void SensorsPrivate::RunOnce()
       // publish data
       IGN_PROFILE("RunOnce");
       this->sensorManager.RunOnce(this->updateTime);
+      for (const auto &sensor : this->forcedSensors)
+        sensor->Update(this->updateTime, true);
       this->eventManager->Emit<events::PostRender>();
     }
 
     this->activeSensors.clear();
+    this->forcedSensors.clear();
   }
 
   this->updateAvailable = false;
@@ -273,6 +314,49 @@ void SensorsPrivate::RunOnce()
   this->renderCv.notify_one();
 }
 
+//////////////////////////////////////////////////
+void SensorsPrivate::AddShmOutput(sensors::Sensor *_sensor,
+    const sdf::Sensor &_sdf)
+{
+  auto writer = std::make_unique<ShmImageWriter>(_sensor->Topic(),
+      this->shmSlots);
+  auto write = [w = writer.get()](const msgs::Image &_msg)
+  {
+    w->Write(_msg);
+  };
+
+  // Depth and thermal cameras are camera sensors with their own image events
+  common::ConnectionPtr conn;
+  if (_sdf.Type() == sdf::SensorType::RGBD_CAMERA)
+  {
+    // RGBD cameras don't expose their images
+  }
+  else if (auto depth = dynamic_cast<sensors::DepthCameraSensor *>(_sensor))
+  {
+    conn = depth->ConnectImageCallback(write);
+  }
+  else if (auto thermal =
+      dynamic_cast<sensors::ThermalCameraSensor *>(_sensor))
+  {
+    conn = thermal->ConnectImageCallback(write);
+  }
+  else if (auto camera = dynamic_cast<sensors::CameraSensor *>(_sensor))
+  {
+    conn = camera->ConnectImageCallback(write);
+  }
+
+  if (!conn)
+  {
+    ignwarn << "Shared memory output is not supported for sensor ["
+            << _sensor->Name() << "]" << std::endl;
+    return;
+  }
+
+  ignmsg << "Writing images of sensor [" << _sensor->Name()
+         << "] to shared memory [" << writer->ShmName() << "]" << std::endl;
+  this->shmOutputs[_sensor->Id()] = {std::move(writer), conn};
+}
+
 //////////////////////////////////////////////////
 void SensorsPrivate::RenderThread()
 {
@@ -344,8 +428,16 @@ void Sensors::RemoveSensor(const Entity &_entity)
       {
         this->dataPtr->activeSensors.erase(activeSensorIt);
       }
+      auto forcedSensorIt = std::find(this->dataPtr->forcedSensors.begin(),
+          this->dataPtr->forcedSensors.end(), rs);
+      if (forcedSensorIt != this->dataPtr->forcedSensors.end())
+      {
+        this->dataPtr->forcedSensors.erase(forcedSensorIt);
+      }
+      this->dataPtr->resetUpdateTimes.erase(idIter->second);
     }
     this->dataPtr->sensorIds.erase(idIter->second);
+    this->dataPtr->shmOutputs.erase(idIter->second);
     this->dataPtr->sensorManager.Remove(idIter->second);
     this->dataPtr->entityToIdMap.erase(idIter);
   }
@@ -374,6 +466,23 @@ void Sensors::Configure(const Entity &/*_id*/,
       _sdf->Get<std::string>("render_engine", "ogre2").first;
 
   this->dataPtr->renderUtil.SetEngineName(engineName);
+
+  // Sensors don't edit visual materials, so visuals which look the same can
+  // share them and be drawn as instances
+  bool instancing = _sdf->Get<bool>("instancing", true).first;
+  this->dataPtr->renderUtil.SceneManager().SetInstancingEnabled(instancing);
+
+  // Only move what the sensors about to render may see
+  bool culling = _sdf->Get<bool>("culling", false).first;
+  this->dataPtr->renderUtil.SetCullingEnabled(culling);
+
+  // Images written to shared memory for consumers on the same host
+  if (_sdf->HasElement("shared_memory"))
+  {
+    auto shmElem = _sdf->GetElementImpl("shared_memory");
+    this->dataPtr->shmSlots =
+        shmElem->Get<unsigned int>("slots", 3u).first;
+  }
   this->dataPtr->renderUtil.SetEnableSensors(true,
       std::bind(&Sensors::CreateSensor, this,
       std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
@@ -458,6 +567,7 @@ void Sensors::PostUpdate(const UpdateInfo &_info,
     auto t = math::secNsecToDuration(time.first, time.second);
 
     std::vector<sensors::RenderingSensor *> activeSensors;
+    std::vector<sensors::RenderingSensor *> forcedSensors;
 
     this->dataPtr->sensorMaskMutex.lock();
     for (auto id : this->dataPtr->sensorIds)
@@ -478,14 +588,40 @@ void Sensors::PostUpdate(const UpdateInfo &_info,
         }
       }
 
-      if (rs && rs->NextDataUpdateTime() <= t)
+      if (!rs)
+        continue;
+
+      // After time jumped back, sensors are updated on their own schedule
+      // again once sim time catches up with it
+      auto resetIt = this->dataPtr->resetUpdateTimes.find(id);
+      if (resetIt != this->dataPtr->resetUpdateTimes.end())
+      {
+        if (rs->NextDataUpdateTime() > t)
+        {
+          if (resetIt->second <= t)
+          {
+            forcedSensors.push_back(rs);
+            resetIt->second = t;
+            if (rs->UpdateRate() > 0.0)
+            {
+              resetIt->second += std::chrono::duration_cast<
+                  std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>(1.0 / rs->UpdateRate()));
+            }
+          }
+          continue;
+        }
+        this->dataPtr->resetUpdateTimes.erase(resetIt);
+      }
+
+      if (rs->NextDataUpdateTime() <= t)
       {
         activeSensors.push_back(rs);
       }
     }
     this->dataPtr->sensorMaskMutex.unlock();
 
-    if (!activeSensors.empty() ||
+    if (!activeSensors.empty() || !forcedSensors.empty() ||
         this->dataPtr->renderUtil.PendingSensors() > 0)
     {
       std::unique_lock<std::mutex> lock(this->dataPtr->renderMutex);
@@ -498,6 +634,7 @@ void Sensors::PostUpdate(const UpdateInfo &_info,
       }
 
       this->dataPtr->activeSensors = std::move(activeSensors);
+      this->dataPtr->forcedSensors = std::move(forcedSensors);
       this->dataPtr->updateTime = t;
       this->dataPtr->updateAvailable = true;
       this->dataPtr->renderCv.notify_one();
@@ -604,13 +741,35 @@ std::string Sensors::CreateSensor(const Entity &_entity,
            << " Kelvin." << std::endl;
   }
 
+  if (this->dataPtr->shmSlots > 0u)
+    this->dataPtr->AddShmOutput(sensor, _sdf);
+
   return sensor->Name();
 }
 
+//////////////////////////////////////////////////
+void Sensors::Reset(const UpdateInfo &_info, EntityComponentManager &)
+{
+  IGN_PROFILE("Sensors::Reset");
+  std::lock_guard<std::mutex> lock(this->dataPtr->sensorMaskMutex);
+
+  // Masks and schedules ahead of the new time would hold sensors back until
+  // sim time catches up with them
+  this->dataPtr->sensorMask.clear();
+  this->dataPtr->resetUpdateTimes.clear();
+  for (auto id : this->dataPtr->sensorIds)
+  {
+    sensors::Sensor *s = this->dataPtr->sensorManager.Sensor(id);
+    if (s && s->NextDataUpdateTime() > _info.simTime)
+      this->dataPtr->resetUpdateTimes[id] = _info.simTime;
+  }
+}
+
 IGNITION_ADD_PLUGIN(Sensors, System,
   Sensors::ISystemConfigure,
   Sensors::ISystemUpdate,
-  Sensors::ISystemPostUpdate
+  Sensors::ISystemPostUpdate,
+  Sensors::ISystemReset
 )
 
 IGNITION_ADD_PLUGIN_ALIAS(Sensors, "ignition::gazebo::systems::Sensors")
@@ -38,11 +38,29 @@ namespace systems
   /// \class Sensors Sensors.hh ignition/gazebo/systems/Sensors.hh
   /// \brief TODO(louise) Have one system for all sensors, or one per
   /// sensor / sensor type?
+  ///
+  /// ## System Parameters
+  ///
+  /// - `<render_engine>`: Name of the render engine, defaults to `ogre2`.
+  /// - `<instancing>`: True to share materials among visuals which look the
+  /// same, so the render engine can draw repeated meshes as instances.
+  /// Defaults to true.
+  /// - `<culling>`: True to only update the poses of models which may be
+  /// seen by the sensors about to render, given their range and field of
+  /// view. Other updates are held back until the models may be seen, so
+  /// anything else looking at the sensors' scene may see stale poses.
+  /// Defaults to false.
+  /// - `<shared_memory>`: If present, the images of camera, depth camera
+  /// and thermal camera sensors are also written to a ring buffer in shared
+  /// memory, announced on `<sensor topic>/shm`. See ShmImageWriter for the
+  /// layout. Its `<slots>` child sets the ring buffer's size, defaults
+  /// to 3.
   class Sensors:
     public System,
     public ISystemConfigure,
     public ISystemUpdate,
-    public ISystemPostUpdate
+    public ISystemPostUpdate,
+    public ISystemReset
   {
     /// \brief Constructor
     public: explicit Sensors();
@@ -64,6 +82,10 @@ namespace systems
     public: void PostUpdate(const UpdateInfo &_info,
                             const EntityComponentManager &_ecm) final;
 
+    // Documentation inherited
+    public: void Reset(const UpdateInfo &_info,
+                       EntityComponentManager &_ecm) final;
+
     /// \brief Create a rendering sensor from sdf
     /// \param[in] _entity Entity of the sensor
     /// \param[in] _sdf SDF description of the sensor
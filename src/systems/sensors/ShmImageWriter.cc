@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ShmImageWriter.hh"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/transport/Node.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Alignment of the slots within the segment, in bytes.
+static constexpr size_t kSlotAlignment = 64u;
+
+/// \brief Number of writers created by this process, used to give each
+/// one its own segment.
+static std::atomic<unsigned int> writerCount{0u};
+
+/// \brief Private data class.
+class ignition::gazebo::systems::ShmImageWriterPrivate
+{
+  /// \brief Create the segment. Fails if it already exists, unless it was
+  /// left behind by a process which had the same id.
+  /// \return True if the segment was created
+  public: bool Create();
+
+  /// \brief Create or grow the segment so each slot holds _slotSize bytes.
+  /// \param[in] _slotSize Number of bytes of image data per slot
+  /// \return True if the segment is mapped
+  public: bool Map(uint64_t _slotSize);
+
+  /// \brief Unmap the segment, if mapped.
+  public: void Unmap();
+
+  /// \brief Get a slot of the mapped segment.
+  /// \param[in] _index Slot index
+  /// \return Pointer to the slot's header
+  public: ShmImageSlot *Slot(unsigned int _index) const;
+
+  /// \brief Number of bytes from the start of a slot to the next.
+  /// \return Slot stride
+  public: size_t SlotStride() const;
+
+  /// \brief Name of the shared memory segment
+  public: std::string shmName;
+
+  /// \brief Number of slots in the ring buffer
+  public: unsigned int slotCount{1u};
+
+  /// \brief Number of bytes of image data per slot
+  public: uint64_t slotSize{0u};
+
+  /// \brief Slot which will be written next
+  public: unsigned int nextSlot{0u};
+
+  /// \brief Sequence number the slots start with when they're (re)created.
+  /// It keeps increasing across growths, so readers never see a sequence
+  /// number twice.
+  public: uint64_t baseSequence{0u};
+
+  /// \brief File descriptor of the segment
+  public: int fd{-1};
+
+  /// \brief Start of the mapped segment
+  public: void *data{nullptr};
+
+  /// \brief Number of bytes mapped
+  public: size_t mappedSize{0u};
+
+  /// \brief True if the segment couldn't be created, so nothing is written
+  public: bool failed{false};
+
+  /// \brief Transport node
+  public: transport::Node node;
+
+  /// \brief Publisher of the metadata of each image written
+  public: transport::Node::Publisher pub;
+};
+
+//////////////////////////////////////////////////
+size_t ShmImageWriterPrivate::SlotStride() const
+{
+  size_t size = sizeof(ShmImageSlot) + this->slotSize;
+  return (size + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+//////////////////////////////////////////////////
+ShmImageSlot *ShmImageWriterPrivate::Slot(unsigned int _index) const
+{
+  return reinterpret_cast<ShmImageSlot *>(
+      static_cast<char *>(this->data) + kSlotAlignment +
+      _index * this->SlotStride());
+}
+
+//////////////////////////////////////////////////
+bool ShmImageWriterPrivate::Create()
+{
+#ifdef _WIN32
+  return false;
+#else
+  this->fd = shm_open(this->shmName.c_str(), O_CREAT | O_EXCL | O_RDWR,
+      0600);
+
+  // The name has this process's id, so a segment which already exists was
+  // left behind by a process that crashed before unlinking it
+  if (this->fd < 0 && errno == EEXIST)
+  {
+    ignwarn << "Removing stale shared memory [" << this->shmName << "]"
+            << std::endl;
+    shm_unlink(this->shmName.c_str());
+    this->fd = shm_open(this->shmName.c_str(), O_CREAT | O_EXCL | O_RDWR,
+        0600);
+  }
+
+  if (this->fd < 0)
+  {
+    ignerr << "Failed to create shared memory [" << this->shmName << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+bool ShmImageWriterPrivate::Map(uint64_t _slotSize)
+{
+#ifdef _WIN32
+  (void)_slotSize;
+  ignerr << "Shared memory image output is not supported on Windows."
+         << std::endl;
+  return false;
+#else
+  if (this->fd < 0 && !this->Create())
+    return false;
+
+  bool created = this->data == nullptr;
+  if (!created)
+  {
+    // Readers see a zero slot size while the segment grows, and readers
+    // in the middle of reading a slot see its sequence change
+    auto header = static_cast<ShmImageHeader *>(this->data);
+    header->slotSize = 0u;
+    for (unsigned int i = 0; i < this->slotCount; ++i)
+    {
+      auto sequence = this->Slot(i)->sequence.load(std::memory_order_relaxed);
+      this->Slot(i)->sequence.store(sequence | 1u, std::memory_order_relaxed);
+
+      // The new slots start after every sequence seen so far, and even
+      this->baseSequence = std::max(this->baseSequence, (sequence | 1u) + 1u);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  this->Unmap();
+
+  this->slotSize = _slotSize;
+  size_t size = kSlotAlignment + this->slotCount * this->SlotStride();
+  if (ftruncate(this->fd, size) != 0)
+  {
+    ignerr << "Failed to resize shared memory [" << this->shmName << "] to "
+           << size << " bytes: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+      this->fd, 0);
+  if (data == MAP_FAILED)
+  {
+    ignerr << "Failed to map shared memory [" << this->shmName << "]: "
+           << std::strerror(errno) << std::endl;
+    return false;
+  }
+  this->data = data;
+  this->mappedSize = size;
+
+  for (unsigned int i = 0; i < this->slotCount; ++i)
+  {
+    auto slot = new (this->Slot(i)) ShmImageSlot();
+    slot->sequence.store(this->baseSequence, std::memory_order_relaxed);
+  }
+
+  // The header is only initialized once, the segment is this writer's own
+  auto header = static_cast<ShmImageHeader *>(this->data);
+  if (created)
+  {
+    header = new (this->data) ShmImageHeader();
+    header->version = ShmImageWriter::kVersion;
+    header->slotCount = this->slotCount;
+  }
+
+  // Written last, so readers which see the new size see the new slots
+  std::atomic_thread_fence(std::memory_order_release);
+  header->slotSize = this->slotSize;
+  return true;
+#endif
+}
+
+//////////////////////////////////////////////////
+void ShmImageWriterPrivate::Unmap()
+{
+#ifndef _WIN32
+  if (this->data)
+    munmap(this->data, this->mappedSize);
+#endif
+  this->data = nullptr;
+  this->mappedSize = 0u;
+}
+
+//////////////////////////////////////////////////
+ShmImageWriter::ShmImageWriter(const std::string &_topic,
+    unsigned int _slots)
+  : dataPtr(std::make_unique<ShmImageWriterPrivate>())
+{
+  // Shared memory names can't have slashes other than the leading one. The
+  // process id and a counter keep writers of different servers apart, even
+  // if they publish to the same topic.
+  std::string name = _topic;
+  std::replace(name.begin(), name.end(), '/', '_');
+  this->dataPtr->shmName = "/ign_gazebo_";
+#ifndef _WIN32
+  this->dataPtr->shmName += std::to_string(getpid()) + "_";
+#endif
+  this->dataPtr->shmName += std::to_string(writerCount++) + name;
+  this->dataPtr->slotCount = std::max(1u, _slots);
+
+  this->dataPtr->pub =
+      this->dataPtr->node.Advertise<msgs::Image>(_topic + "/shm");
+}
+
+//////////////////////////////////////////////////
+ShmImageWriter::~ShmImageWriter()
+{
+  this->dataPtr->Unmap();
+#ifndef _WIN32
+  if (this->dataPtr->fd >= 0)
+  {
+    close(this->dataPtr->fd);
+    shm_unlink(this->dataPtr->shmName.c_str());
+  }
+#endif
+}
+
+//////////////////////////////////////////////////
+void ShmImageWriter::Write(const msgs::Image &_msg)
+{
+  if (this->dataPtr->failed)
+    return;
+
+  const auto &bytes = _msg.data();
+  if (!this->dataPtr->data || bytes.size() > this->dataPtr->slotSize)
+  {
+    if (!this->dataPtr->Map(bytes.size()))
+    {
+      this->dataPtr->failed = true;
+      return;
+    }
+  }
+
+  unsigned int index = this->dataPtr->nextSlot;
+  this->dataPtr->nextSlot = (index + 1) % this->dataPtr->slotCount;
+
+  // Odd sequence while writing, so readers know the slot is being changed
+  auto slot = this->dataPtr->Slot(index);
+  uint64_t sequence = slot->sequence.load(std::memory_order_relaxed) + 1;
+  slot->sequence.store(sequence, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot->width = _msg.width();
+  slot->height = _msg.height();
+  slot->step = _msg.step();
+  slot->pixelFormat = _msg.pixel_format_type();
+  slot->size = bytes.size();
+  slot->sec = _msg.header().stamp().sec();
+  slot->nsec = _msg.header().stamp().nsec();
+  std::memcpy(reinterpret_cast<char *>(slot) + sizeof(ShmImageSlot),
+      bytes.data(), bytes.size());
+
+  slot->sequence.store(++sequence, std::memory_order_release);
+
+  if (!this->dataPtr->pub.HasConnections())
+    return;
+
+  msgs::Image meta;
+  *meta.mutable_header() = _msg.header();
+  meta.set_width(_msg.width());
+  meta.set_height(_msg.height());
+  meta.set_step(_msg.step());
+  meta.set_pixel_format_type(_msg.pixel_format_type());
+
+  auto data = meta.mutable_header()->add_data();
+  data->set_key("shm_name");
+  data->add_value(this->dataPtr->shmName);
+  data = meta.mutable_header()->add_data();
+  data->set_key("slot");
+  data->add_value(std::to_string(index));
+  data = meta.mutable_header()->add_data();
+  data->set_key("sequence");
+  data->add_value(std::to_string(sequence));
+
+  this->dataPtr->pub.Publish(meta);
+}
+
+//////////////////////////////////////////////////
+const std::string &ShmImageWriter::ShmName() const
+{
+  return this->dataPtr->shmName;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMS_SENSORS_SHMIMAGEWRITER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_SENSORS_SHMIMAGEWRITER_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/msgs/image.pb.h>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/sensors-system/Export.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declarations.
+  class ShmImageWriterPrivate;
+
+  /// \brief Header at the start of the shared memory segment.
+  struct ShmImageHeader
+  {
+    /// \brief Version of the segment layout, ShmImageWriter::kVersion
+    uint32_t version;
+
+    /// \brief Number of slots in the ring buffer
+    uint32_t slotCount;
+
+    /// \brief Number of bytes of image data each slot can hold
+    uint64_t slotSize;
+  };
+
+  /// \brief Header at the start of each slot, followed by the image data.
+  struct ShmImageSlot
+  {
+    /// \brief Odd while the slot is being written, even once it's done.
+    /// Readers should check that it's even and that it didn't change while
+    /// they were reading the slot.
+    std::atomic<uint64_t> sequence;
+
+    /// \brief Image width in pixels
+    uint32_t width;
+
+    /// \brief Image height in pixels
+    uint32_t height;
+
+    /// \brief Number of bytes per row
+    uint32_t step;
+
+    /// \brief Pixel format, see msgs::PixelFormatType
+    uint32_t pixelFormat;
+
+    /// \brief Number of bytes of image data
+    uint64_t size;
+
+    /// \brief Seconds of the image's time stamp
+    int64_t sec;
+
+    /// \brief Nanoseconds of the image's time stamp
+    int32_t nsec;
+  };
+
+  /// \brief Writes images to a ring buffer in POSIX shared memory, so that
+  /// processes on the same host can read them without having them
+  /// serialized and copied by ign-transport.
+  ///
+  /// Each writer creates its own segment, named after the process id, a
+  /// per-process counter and the sensor's topic, and unlinks it when it's
+  /// destroyed. The segment is made of a ShmImageHeader followed by the
+  /// slots. Each slot is a ShmImageSlot
+  /// followed by the image data, and starts at a multiple of 64 bytes.
+  /// Every image written is announced on `<topic>/shm` with an image
+  /// message that has no data. Its header has the keys `shm_name`, `slot`
+  /// and `sequence`, which tell readers where to find the image.
+  ///
+  /// The segment grows when larger images are written. The header's slot
+  /// size is zero while it grows, and sequence numbers keep increasing
+  /// across growths. Readers should map it again when the slot size
+  /// changes.
+  class IGNITION_GAZEBO_SENSORS_SYSTEM_VISIBLE ShmImageWriter
+  {
+    /// \brief Version of the shared memory layout.
+    public: static constexpr uint32_t kVersion = 1u;
+
+    /// \brief Constructor
+    /// \param[in] _topic Topic the sensor publishes images to
+    /// \param[in] _slots Number of slots in the ring buffer
+    public: ShmImageWriter(const std::string &_topic, unsigned int _slots);
+
+    /// \brief Destructor. Unlinks the shared memory segment.
+    public: ~ShmImageWriter();
+
+    /// \brief Write an image to the next slot and announce it.
+    /// \param[in] _msg Image to write
+    public: void Write(const msgs::Image &_msg);
+
+    /// \brief Name of the shared memory segment.
+    /// \return Name which can be passed to shm_open
+    public: const std::string &ShmName() const;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<ShmImageWriterPrivate> dataPtr;
+  };
+}
+}
+}
+}
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <ignition/msgs/image.pb.h>
+
+#include "ShmImageWriter.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+#ifndef _WIN32
+/// \brief Read-only mapping of a writer's segment.
+class ShmReader
+{
+  /// \brief Constructor
+  /// \param[in] _name Name of the segment
+  public: explicit ShmReader(const std::string &_name)
+  {
+    int fd = shm_open(_name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+      return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+      this->size = static_cast<size_t>(st.st_size);
+      void *mapped = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+      if (mapped != MAP_FAILED)
+        this->data = static_cast<const char *>(mapped);
+    }
+    close(fd);
+  }
+
+  /// \brief Destructor
+  public: ~ShmReader()
+  {
+    if (this->data)
+      munmap(const_cast<char *>(this->data), this->size);
+  }
+
+  /// \brief Get the segment header.
+  /// \return Header, null if the segment couldn't be mapped
+  public: const ShmImageHeader *Header() const
+  {
+    return reinterpret_cast<const ShmImageHeader *>(this->data);
+  }
+
+  /// \brief Get a slot.
+  /// \param[in] _index Slot index
+  /// \return Slot header, followed by its image data
+  public: const ShmImageSlot *Slot(unsigned int _index) const
+  {
+    size_t stride = (sizeof(ShmImageSlot) + this->Header()->slotSize + 63u) /
+        64u * 64u;
+    return reinterpret_cast<const ShmImageSlot *>(
+        this->data + 64u + _index * stride);
+  }
+
+  /// \brief Start of the mapping
+  public: const char *data{nullptr};
+
+  /// \brief Size of the mapping
+  public: size_t size{0u};
+};
+
+/// \brief Create an image filled with a value.
+/// \param[in] _width Width in pixels, of one byte each
+/// \param[in] _value Value of every pixel
+/// \return Image message
+static msgs::Image makeImage(unsigned int _width, char _value)
+{
+  msgs::Image msg;
+  msg.set_width(_width);
+  msg.set_height(1u);
+  msg.set_step(_width);
+  msg.set_pixel_format_type(msgs::PixelFormatType::L_INT8);
+  msg.set_data(std::string(_width, _value));
+  return msg;
+}
+
+/////////////////////////////////////////////////
+TEST(ShmImageWriterTest, UniqueSegments)
+{
+  const std::string topic = "/world/shm_test/camera";
+  auto writer1 = std::make_unique<ShmImageWriter>(topic, 2u);
+  auto writer2 = std::make_unique<ShmImageWriter>(topic, 2u);
+  EXPECT_NE(writer1->ShmName(), writer2->ShmName());
+  EXPECT_NE(std::string::npos, writer1->ShmName().find(
+      std::to_string(getpid())));
+
+  writer1->Write(makeImage(4u, 1));
+  writer2->Write(makeImage(4u, 2));
+
+  {
+    ShmReader reader1(writer1->ShmName());
+    ShmReader reader2(writer2->ShmName());
+    ASSERT_NE(nullptr, reader1.Header());
+    ASSERT_NE(nullptr, reader2.Header());
+    EXPECT_EQ(1, reader1.data[64u + sizeof(ShmImageSlot)]);
+    EXPECT_EQ(2, reader2.data[64u + sizeof(ShmImageSlot)]);
+  }
+
+  // Destroying one writer leaves the other's segment alone
+  std::string name1 = writer1->ShmName();
+  writer1.reset();
+  EXPECT_LT(shm_open(name1.c_str(), O_RDONLY, 0), 0);
+
+  ShmReader reader2(writer2->ShmName());
+  ASSERT_NE(nullptr, reader2.Header());
+  EXPECT_EQ(2, reader2.data[64u + sizeof(ShmImageSlot)]);
+}
+
+/////////////////////////////////////////////////
+TEST(ShmImageWriterTest, Write)
+{
+  ShmImageWriter writer("/world/shm_test/write", 2u);
+  writer.Write(makeImage(8u, 3));
+
+  {
+    ShmReader reader(writer.ShmName());
+    ASSERT_NE(nullptr, reader.Header());
+    EXPECT_EQ(ShmImageWriter::kVersion, reader.Header()->version);
+    EXPECT_EQ(2u, reader.Header()->slotCount);
+    EXPECT_EQ(8u, reader.Header()->slotSize);
+
+    auto slot = reader.Slot(0u);
+    EXPECT_EQ(2u, slot->sequence.load());
+    EXPECT_EQ(8u, slot->width);
+    EXPECT_EQ(1u, slot->height);
+    EXPECT_EQ(8u, slot->size);
+    auto pixels = reinterpret_cast<const char *>(slot) + sizeof(ShmImageSlot);
+    EXPECT_EQ(std::string(8u, 3), std::string(pixels, 8u));
+
+    // Not written yet
+    EXPECT_EQ(0u, reader.Slot(1u)->sequence.load());
+  }
+
+  // A larger image grows the segment, and sequence numbers keep increasing
+  writer.Write(makeImage(200u, 4));
+  {
+    ShmReader reader(writer.ShmName());
+    ASSERT_NE(nullptr, reader.Header());
+    EXPECT_EQ(200u, reader.Header()->slotSize);
+
+    EXPECT_EQ(4u, reader.Slot(0u)->sequence.load());
+    auto slot = reader.Slot(1u);
+    EXPECT_EQ(6u, slot->sequence.load());
+    EXPECT_EQ(200u, slot->size);
+    auto pixels = reinterpret_cast<const char *>(slot) + sizeof(ShmImageSlot);
+    EXPECT_EQ(std::string(200u, 4), std::string(pixels, 200u));
+  }
+}
+#endif
@@ -29,7 +29,7 @@
 #include <sdf/Element.hh>
 
 #include "ignition/gazebo/components/ContactSensor.hh"
-#include "ignition/gazebo/components/ContactSensorData.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/Collision.hh"
 #include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Name.hh"
@@ -138,8 +138,8 @@ void TouchPluginPrivate::Load(const EntityComponentManager &_ecm,
   this->AddTargetEntities(_ecm, potentialEntities);
 
   // Create a list of collision entities that have been marked as contact
-  // sensors in this model. These are collisions that have a ContactSensorData
-  // component
+  // sensors in this model. These are collisions that have a
+  // ContactSensorBuffer component
   auto allLinks =
       _ecm.ChildrenByComponents(this->model.Entity(), components::Link());
 
@@ -150,7 +150,7 @@ void TouchPluginPrivate::Load(const EntityComponentManager &_ecm,
     for (const Entity colEntity : linkCollisions)
     {
       if (_ecm.EntityHasComponentType(colEntity,
-                                      components::ContactSensorData::typeId))
+                                      components::ContactSensorBuffer::typeId))
       {
         this->collisionEntities.push_back(colEntity);
       }
@@ -258,19 +258,24 @@ void TouchPluginPrivate::Update(const UpdateInfo &_info,
   // between the target entity and this model
   for (const Entity colEntity : this->collisionEntities)
   {
-    auto *contacts = _ecm.Component<components::ContactSensorData>(colEntity);
+    auto *contacts =
+        _ecm.Component<components::ContactSensorBuffer>(colEntity);
     if (contacts)
     {
+      const auto &buffer = contacts->Data();
+      if (buffer.PairCount() == 0)
+        continue;
+
       // Check if the contacts include one of the target entities.
-      for (const auto &contact : contacts->Data().contact())
+      if (std::binary_search(this->targetEntities.begin(),
+          this->targetEntities.end(), buffer.collision))
+      {
+        touching = true;
+      }
+      for (const Entity collision2 : buffer.collisions2)
       {
-        bool col1Target = std::binary_search(this->targetEntities.begin(),
-            this->targetEntities.end(),
-            contact.collision1().id());
-        bool col2Target = std::binary_search(this->targetEntities.begin(),
-            this->targetEntities.end(),
-            contact.collision2().id());
-        if (col1Target || col2Target)
+        if (std::binary_search(this->targetEntities.begin(),
+            this->targetEntities.end(), collision2))
         {
           touching = true;
         }
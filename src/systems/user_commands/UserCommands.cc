@@ -20,11 +20,15 @@
 #include <google/protobuf/message.h>
 #include <ignition/msgs/boolean.pb.h>
 #include <ignition/msgs/entity_factory.pb.h>
+#include <ignition/msgs/entity_factory_v.pb.h>
 #include <ignition/msgs/light.pb.h>
 #include <ignition/msgs/pose.pb.h>
 #include <ignition/msgs/physics.pb.h>
 
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -53,7 +57,7 @@
 #include "ignition/gazebo/Conversions.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/SdfEntityCreator.hh"
-#include "ignition/gazebo/components/ContactSensorData.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/ContactSensor.hh"
 #include "ignition/gazebo/components/Sensor.hh"
 
@@ -128,6 +132,22 @@ class CreateCommand : public UserCommandBase
   public: bool Execute() final;
 };
 
+/// \brief Command to spawn many entities into simulation at once. Each SDF
+/// is parsed once, and entries of the request which don't set the `from`
+/// field spawn another copy of the previous entry's SDF, with their own
+/// name and pose.
+class CreateMultipleCommand : public UserCommandBase
+{
+  /// \brief Constructor
+  /// \param[in] _msg Vector of factory messages.
+  /// \param[in] _iface Pointer to user commands interface.
+  public: CreateMultipleCommand(msgs::EntityFactory_V *_msg,
+      std::shared_ptr<UserCommandsInterface> &_iface);
+
+  // Documentation inherited
+  public: bool Execute() final;
+};
+
 /// \brief Command to remove an entity from simulation.
 class RemoveCommand : public UserCommandBase
 {
@@ -517,14 +537,14 @@ void UserCommands::PreUpdate(const UpdateInfo &/*_info*/,
 bool UserCommandsPrivate::CreateServiceMultiple(
     const msgs::EntityFactory_V &_req, msgs::Boolean &_res)
 {
-  std::lock_guard<std::mutex> lock(this->pendingMutex);
-  for (int i = 0; i < _req.data_size(); ++i)
-  {
-    const msgs::EntityFactory &msg = _req.data(i);
-    // Create command and push it to queue
-    auto msgCopy = msg.New();
-    msgCopy->CopyFrom(msg);
-    auto cmd = std::make_unique<CreateCommand>(msgCopy, this->iface);
+  // Create command and push it to queue
+  auto msg = _req.New();
+  msg->CopyFrom(_req);
+  auto cmd = std::make_unique<CreateMultipleCommand>(msg, this->iface);
+
+  // Push to pending
+  {
+    std::lock_guard<std::mutex> lock(this->pendingMutex);
     this->pendingCmds.push_back(std::move(cmd));
   }
 
@@ -687,29 +707,25 @@ CreateCommand::CreateCommand(msgs::EntityFactory *_msg,
 }
 
 //////////////////////////////////////////////////
-bool CreateCommand::Execute()
+/// \brief Load the SDF which a factory message spawns.
+/// \param[in] _msg Factory message.
+/// \param[out] _root Loaded SDF, if the message holds SDF.
+/// \param[out] _light Loaded light, if the message holds a light message.
+/// \return True if loaded without errors.
+static bool loadFactorySdf(const msgs::EntityFactory &_msg, sdf::Root &_root,
+    sdf::Light &_light)
 {
-  auto createMsg = dynamic_cast<const msgs::EntityFactory *>(this->msg);
-  if (nullptr == createMsg)
-  {
-    ignerr << "Internal error, null create message" << std::endl;
-    return false;
-  }
-
-  // Load SDF
-  sdf::Root root;
-  sdf::Light lightSdf;
   sdf::Errors errors;
-  switch (createMsg->from_case())
+  switch (_msg.from_case())
   {
     case msgs::EntityFactory::kSdf:
     {
-      errors = root.LoadSdfString(createMsg->sdf());
+      errors = _root.LoadSdfString(_msg.sdf());
       break;
     }
     case msgs::EntityFactory::kSdfFilename:
     {
-      errors = root.Load(createMsg->sdf_filename());
+      errors = _root.Load(_msg.sdf_filename());
       break;
     }
     case msgs::EntityFactory::kModel:
@@ -720,7 +736,7 @@ bool CreateCommand::Execute()
     }
     case msgs::EntityFactory::kLight:
     {
-      lightSdf = convert<sdf::Light>(createMsg->light());
+      _light = convert<sdf::Light>(_msg.light());
       break;
     }
     case msgs::EntityFactory::kCloneName:
@@ -742,27 +758,43 @@ bool CreateCommand::Execute()
       ignerr << err << std::endl;
     return false;
   }
+  return true;
+}
 
+//////////////////////////////////////////////////
+/// \brief Spawn the top-level entity of loaded SDF into the world.
+/// \param[in] _iface User commands interface.
+/// \param[in] _root SDF loaded by loadFactorySdf.
+/// \param[in] _light Light loaded by loadFactorySdf.
+/// \param[in] _msg Factory message with the name and pose.
+/// \param[in] _nameTaken Function which checks if there's already a
+/// top-level entity with a given name.
+/// \return The new entity, or kNullEntity if nothing was spawned.
+static Entity spawnFactorySdf(UserCommandsInterface &_iface,
+    const sdf::Root &_root, const sdf::Light &_light,
+    const msgs::EntityFactory &_msg,
+    const std::function<bool(const std::string &)> &_nameTaken)
+{
   bool isModel{false};
   bool isLight{false};
   bool isActor{false};
   bool isRoot{false};
-  if (nullptr != root.Model())
+  if (nullptr != _root.Model())
   {
     isRoot = true;
     isModel = true;
   }
-  else if (nullptr != root.Light())
+  else if (nullptr != _root.Light())
   {
     isRoot = true;
     isLight = true;
   }
-  else if (nullptr != root.Actor())
+  else if (nullptr != _root.Actor())
   {
     isRoot = true;
     isActor = true;
   }
-  else if (!lightSdf.Name().empty())
+  else if (!_light.Name().empty())
   {
     isLight = true;
   }
@@ -770,7 +802,7 @@ bool CreateCommand::Execute()
   {
     ignerr << "Expected exactly one top-level <model>, <light> or <actor> on"
            << " SDF." << std::endl;
-    return false;
+    return kNullEntity;
   }
 
   if ((isModel && isLight) || (isModel && isActor) || (isLight && isActor))
@@ -781,46 +813,42 @@ bool CreateCommand::Execute()
 
   // Check the name of the entity being spawned
   std::string desiredName;
-  if (!createMsg->name().empty())
+  if (!_msg.name().empty())
   {
-    desiredName = createMsg->name();
+    desiredName = _msg.name();
   }
   else if (isModel)
   {
-    desiredName = root.Model()->Name();
+    desiredName = _root.Model()->Name();
   }
   else if (isLight && isRoot)
   {
-    desiredName = root.Light()->Name();
+    desiredName = _root.Light()->Name();
   }
   else if (isLight)
   {
-    desiredName = lightSdf.Name();
+    desiredName = _light.Name();
   }
   else if (isActor)
   {
-    desiredName = root.Actor()->Name();
+    desiredName = _root.Actor()->Name();
   }
 
   // Check if there's already a top-level entity with the given name
-  if (kNullEntity != this->iface->ecm->EntityByComponents(
-      components::Name(desiredName),
-      components::ParentEntity(this->iface->worldEntity)))
+  if (_nameTaken(desiredName))
   {
-    if (!createMsg->allow_renaming())
+    if (!_msg.allow_renaming())
     {
       ignwarn << "Entity named [" << desiredName << "] already exists and "
               << "[allow_renaming] is false. Entity not spawned."
               << std::endl;
-      return false;
+      return kNullEntity;
     }
 
     // Generate unique name
     std::string newName = desiredName;
     int i = 0;
-    while (kNullEntity != this->iface->ecm->EntityByComponents(
-      components::Name(newName),
-      components::ParentEntity(this->iface->worldEntity)))
+    while (_nameTaken(newName))
     {
       newName = desiredName + "_" + std::to_string(i++);
     }
@@ -831,41 +859,145 @@ bool CreateCommand::Execute()
   Entity entity{kNullEntity};
   if (isModel)
   {
-    auto model = *root.Model();
+    auto model = *_root.Model();
     model.SetName(desiredName);
-    entity = this->iface->creator->CreateEntities(&model);
+    entity = _iface.creator->CreateEntities(&model);
   }
   else if (isLight && isRoot)
   {
-    auto light = *root.Light();
+    auto light = *_root.Light();
     light.SetName(desiredName);
-    entity = this->iface->creator->CreateEntities(&light);
+    entity = _iface.creator->CreateEntities(&light);
   }
   else if (isLight)
   {
-    lightSdf.SetName(desiredName);
-    entity = this->iface->creator->CreateEntities(&lightSdf);
+    auto light = _light;
+    light.SetName(desiredName);
+    entity = _iface.creator->CreateEntities(&light);
   }
   else if (isActor)
   {
-    auto actor = *root.Actor();
+    auto actor = *_root.Actor();
     actor.SetName(desiredName);
-    entity = this->iface->creator->CreateEntities(&actor);
+    entity = _iface.creator->CreateEntities(&actor);
   }
 
-  this->iface->creator->SetParent(entity, this->iface->worldEntity);
+  _iface.creator->SetParent(entity, _iface.worldEntity);
 
   // Pose
-  if (createMsg->has_pose())
+  if (_msg.has_pose())
   {
-    auto poseComp = this->iface->ecm->Component<components::Pose>(entity);
-    *poseComp = components::Pose(msgs::Convert(createMsg->pose()));
+    auto poseComp = _iface.ecm->Component<components::Pose>(entity);
+    *poseComp = components::Pose(msgs::Convert(_msg.pose()));
+    _iface.ecm->SetChanged(entity, components::Pose::typeId,
+        ComponentState::OneTimeChange);
   }
 
   igndbg << "Created entity [" << entity << "] named [" << desiredName << "]"
          << std::endl;
 
-  return true;
+  return entity;
+}
+
+//////////////////////////////////////////////////
+bool CreateCommand::Execute()
+{
+  auto createMsg = dynamic_cast<const msgs::EntityFactory *>(this->msg);
+  if (nullptr == createMsg)
+  {
+    ignerr << "Internal error, null create message" << std::endl;
+    return false;
+  }
+
+  // Load SDF
+  sdf::Root root;
+  sdf::Light lightSdf;
+  if (!loadFactorySdf(*createMsg, root, lightSdf))
+    return false;
+
+  auto nameTaken = [&](const std::string &_name)
+  {
+    return kNullEntity != this->iface->ecm->EntityByComponents(
+        components::Name(_name),
+        components::ParentEntity(this->iface->worldEntity));
+  };
+
+  return kNullEntity != spawnFactorySdf(*this->iface, root, lightSdf,
+      *createMsg, nameTaken);
+}
+
+//////////////////////////////////////////////////
+CreateMultipleCommand::CreateMultipleCommand(msgs::EntityFactory_V *_msg,
+    std::shared_ptr<UserCommandsInterface> &_iface)
+    : UserCommandBase(_msg, _iface)
+{
+}
+
+//////////////////////////////////////////////////
+bool CreateMultipleCommand::Execute()
+{
+  IGN_PROFILE("CreateMultipleCommand::Execute");
+  auto createMsg = dynamic_cast<const msgs::EntityFactory_V *>(this->msg);
+  if (nullptr == createMsg)
+  {
+    ignerr << "Internal error, null create message" << std::endl;
+    return false;
+  }
+
+  // Names of top-level entities, gathered once instead of searching the ECM
+  // for each new entity
+  std::unordered_set<std::string> names;
+  this->iface->ecm->Each<components::Name, components::ParentEntity>(
+      [&](const Entity &, const components::Name *_name,
+          const components::ParentEntity *_parent) -> bool
+      {
+        if (_parent->Data() == this->iface->worldEntity)
+          names.insert(_name->Data());
+        return true;
+      });
+
+  auto nameTaken = [&](const std::string &_name)
+  {
+    return names.find(_name) != names.end();
+  };
+
+  // sdf::Root can't be copied, so it's replaced for each new source
+  std::unique_ptr<sdf::Root> root;
+  sdf::Light lightSdf;
+  bool loaded{false};
+
+  bool result{true};
+  for (int i = 0; i < createMsg->data_size(); ++i)
+  {
+    const auto &entityMsg = createMsg->data(i);
+
+    // Entries without a source spawn the previous source again
+    if (entityMsg.from_case() != msgs::EntityFactory::FROM_NOT_SET || !loaded)
+    {
+      root = std::make_unique<sdf::Root>();
+      lightSdf = sdf::Light();
+      loaded = loadFactorySdf(entityMsg, *root, lightSdf);
+      if (!loaded)
+      {
+        result = false;
+        continue;
+      }
+    }
+
+    auto entity = spawnFactorySdf(*this->iface, *root, lightSdf, entityMsg,
+        nameTaken);
+    if (kNullEntity == entity)
+    {
+      result = false;
+      continue;
+    }
+
+    auto nameComp = this->iface->ecm->Component<components::Name>(entity);
+    if (nullptr != nameComp)
+      names.insert(nameComp->Data());
+  }
+
+  return result;
 }
 
 //////////////////////////////////////////////////
@@ -1163,10 +1295,10 @@ bool EnableCollisionCommand::Execute()
     return false;
   }
 
-  // Create ContactSensorData component
+  // Create ContactSensorBuffer component
   auto contactDataComp =
     this->iface->ecm->Component<
-      components::ContactSensorData>(entityMsg->id());
+      components::ContactSensorBuffer>(entityMsg->id());
   if (contactDataComp)
   {
     ignwarn << "Can't create component that already exists" << std::endl;
@@ -1174,7 +1306,7 @@ bool EnableCollisionCommand::Execute()
   }
 
   this->iface->ecm->
-    CreateComponent(entityMsg->id(), components::ContactSensorData());
+    CreateComponent(entityMsg->id(), components::ContactSensorBuffer());
   igndbg << "Enabled collision [" << entityMsg->id() << "]" << std::endl;
 
   return true;
@@ -1213,19 +1345,19 @@ bool DisableCollisionCommand::Execute()
     return false;
   }
 
-  // Remove ContactSensorData component
+  // Remove ContactSensorBuffer component
   auto *contactDataComp =
     this->iface->ecm->Component<
-      components::ContactSensorData>(entityMsg->id());
+      components::ContactSensorBuffer>(entityMsg->id());
   if (!contactDataComp)
   {
-    ignwarn << "No ContactSensorData detected inside entity " << entityMsg->id()
-      << std::endl;
+    ignwarn << "No ContactSensorBuffer detected inside entity "
+      << entityMsg->id() << std::endl;
     return false;
   }
 
   this->iface->ecm->
-    RemoveComponent(entityMsg->id(), components::ContactSensorData::typeId);
+    RemoveComponent(entityMsg->id(), components::ContactSensorBuffer::typeId);
 
   igndbg << "Disabled collision [" << entityMsg->id() << "]" << std::endl;
 
@@ -49,6 +49,11 @@ namespace systems
   /// This service can spawn multiple entities in the same iteration,
   /// thereby eliminating simulation steps between entity spawn times.
   ///
+  /// To spawn many copies of the same model, set the SDF on the first
+  /// entry only, and leave the `from` field of the following entries unset.
+  /// Those spawn another copy of the previous entry's SDF with their own
+  /// name and pose, without parsing it again.
+  ///
   /// * **Service**: `/world/<world name>/create_multiple`
   /// * **Request type*: ignition.msgs.EntityFactory_V
   /// * **Response type*: ignition.msgs.Boolean
@@ -21,6 +21,7 @@
 #include <ignition/msgs/boolean.pb.h>
 #include <ignition/msgs/entity_factory.pb.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -48,6 +49,9 @@
 #include "ignition/gazebo/components/WindMode.hh"
 
 #include "ignition/gazebo/Link.hh"
+#include "ignition/gazebo/Util.hh"
+
+#include "WindField.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -161,6 +165,25 @@ class ignition::gazebo::systems::WindEffectsPrivate
   /// \brief Current wind velocity seed and global enable/disable state.
   /// This is set by a transport message.
   public: msgs::Wind currentWindInfo;
+
+  /// \brief Spatially varying wind added to the uniform wind, if any.
+  public: std::unique_ptr<WindField> windField;
+
+  /// \brief Links affected by the wind in the current update.
+  public: std::vector<Entity> windLinks;
+
+  /// \brief Mass of each link in windLinks, scaled by
+  /// forceApproximationScalingFactor.
+  public: std::vector<double> windLinkMasses;
+
+  /// \brief Linear velocity of each link in windLinks.
+  public: std::vector<math::Vector3d> windLinkVelocities;
+
+  /// \brief World position of each link in windLinks.
+  public: std::vector<math::Vector3d> windLinkPositions;
+
+  /// \brief Wind field velocity at each link in windLinks.
+  public: std::vector<math::Vector3d> windFieldVelocities;
 };
 
 /////////////////////////////////////////////////
@@ -285,6 +308,17 @@ void WindEffectsPrivate::Load(EntityComponentManager &_ecm,
     this->forceApproximationScalingFactor = sdfForceApprox->Get<double>();
   }
 
+  if (_sdf->HasElement("wind_field"))
+  {
+    this->windField = std::make_unique<WindField>();
+    if (!this->windField->Load(_sdf->GetElementImpl("wind_field")))
+    {
+      ignerr << "Failed to load <wind_field>, only the uniform wind will be "
+             << "applied." << std::endl;
+      this->windField.reset();
+    }
+  }
+
   // If the forceApproximationScalingFactor is very small don't update.
   // It doesn't make sense to be negative, that would be negative wind drag.
   if (std::fabs(this->forceApproximationScalingFactor) < 1e-6)
@@ -400,7 +434,7 @@ void WindEffectsPrivate::UpdateWindVelocity(const UpdateInfo &_info,
 }
 
 //////////////////////////////////////////////////
-void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &,
+void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &_info,
                                         EntityComponentManager &_ecm)
 {
   IGN_PROFILE("WindEffectsPrivate::ApplyWindForce");
@@ -409,7 +443,11 @@ void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &,
   if (!windVel)
     return;
 
-  Link link;
+  // Gather the links first, so the wind field is sampled in one pass
+  this->windLinks.clear();
+  this->windLinkMasses.clear();
+  this->windLinkVelocities.clear();
+  this->windLinkPositions.clear();
 
   _ecm.Each<components::Link, components::Inertial, components::WindMode,
             components::WorldLinearVelocity>(
@@ -425,17 +463,38 @@ void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &,
           return true;
         }
 
-        link.ResetEntity(_entity);
-
-        math::Vector3d windForce = _inertial->Data().MassMatrix().Mass() *
-                                   this->forceApproximationScalingFactor *
-                                   (windVel->Data() - _linkVel->Data());
-
-        // Apply force at center of mass
-        link.AddWorldForce(_ecm, windForce);
+        this->windLinks.push_back(_entity);
+        this->windLinkMasses.push_back(
+            _inertial->Data().MassMatrix().Mass() *
+            this->forceApproximationScalingFactor);
+        this->windLinkVelocities.push_back(_linkVel->Data());
+        if (this->windField)
+          this->windLinkPositions.push_back(worldPose(_entity, _ecm).Pos());
 
         return true;
       });
+
+  if (this->windField)
+  {
+    this->windField->Sample(this->windLinkPositions,
+        std::chrono::duration<double>(_info.simTime).count(),
+        this->windFieldVelocities);
+  }
+
+  Link link;
+  for (std::size_t i = 0; i < this->windLinks.size(); ++i)
+  {
+    math::Vector3d wind = windVel->Data();
+    if (this->windField)
+      wind += this->windFieldVelocities[i];
+
+    math::Vector3d windForce = this->windLinkMasses[i] *
+                               (wind - this->windLinkVelocities[i]);
+
+    // Apply force at center of mass
+    link.ResetEntity(this->windLinks[i]);
+    link.AddWorldForce(_ecm, windForce);
+  }
 }
 
 
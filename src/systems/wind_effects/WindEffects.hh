@@ -86,6 +86,10 @@ namespace systems
   /// <vertical><noise>
   /// Parameters for the noise that is added to the vertical wind velocity
   /// magnitude.
+  ///
+  /// <wind_field>
+  /// Optional gridded wind field which is sampled at each link and added to
+  /// the uniform wind, see WindField for its parameters.
   class WindEffects:
     public System,
     public ISystemConfigure,
@@ -0,0 +1,660 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "WindField.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <initializer_list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/common/WorkerPool.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Version of the binary file format.
+static constexpr uint32_t kWindFieldVersion = 1u;
+
+/// \brief Identifies a tile of one frame.
+struct WindTileKey
+{
+  /// \brief Tile index along each axis, and frame
+  int64_t x, y, z, frame;
+
+  /// \brief Equality operator.
+  /// \param[in] _other Key to compare to
+  /// \return True if equal
+  bool operator==(const WindTileKey &_other) const
+  {
+    return this->x == _other.x && this->y == _other.y &&
+           this->z == _other.z && this->frame == _other.frame;
+  }
+};
+
+/// \brief Hash of a tile key.
+struct WindTileKeyHash
+{
+  /// \brief Hash a key.
+  /// \param[in] _key Key
+  /// \return Hash
+  std::size_t operator()(const WindTileKey &_key) const
+  {
+    std::size_t hash = std::hash<int64_t>()(_key.x);
+    for (auto v : {_key.y, _key.z, _key.frame})
+      hash ^= std::hash<int64_t>()(v) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+  }
+};
+
+/// \brief Velocities of the nodes of a tile.
+struct WindTile
+{
+  /// \brief X, Y and Z velocity of each node, ordered by Z, Y and X
+  std::vector<float> velocities;
+
+  /// \brief Sample call in which the tile was last used
+  uint64_t lastUsed{0};
+};
+
+/// \brief Tile of a file being read on the worker pool.
+struct WindTileRequest
+{
+  /// \brief Velocities of the tile, see WindTile
+  std::future<std::vector<float>> velocities;
+
+  /// \brief Sample call in which the tile was requested
+  uint64_t requested{0};
+};
+
+/// \brief Private data class.
+class ignition::gazebo::systems::WindFieldPrivate
+{
+  /// \brief Destructor. Waits for the tiles being read.
+  public: ~WindFieldPrivate();
+
+  /// \brief Open a binary wind field file and read its header.
+  /// \param[in] _path Path to the file
+  /// \return True if the file is valid
+  public: bool Open(const std::string &_path);
+
+  /// \brief Get the velocity of a grid node.
+  /// \param[in] _x Node index along X
+  /// \param[in] _y Node index along Y
+  /// \param[in] _z Node index along Z
+  /// \param[in] _frame Frame index
+  /// \return Velocity
+  public: math::Vector3d Node(int64_t _x, int64_t _y, int64_t _z,
+                              int64_t _frame);
+
+  /// \brief Interpolate the velocity within a cell.
+  /// \param[in] _cell Index of the cell's first node along each axis
+  /// \param[in] _t Position within the cell, from 0 to 1 along each axis
+  /// \param[in] _frame Frame index
+  /// \return Velocity
+  public: math::Vector3d Interpolate(const int64_t _cell[3],
+                                     const math::Vector3d &_t,
+                                     int64_t _frame);
+
+  /// \brief Fill a tile with velocities, waiting for it to be read if
+  /// it comes from a file.
+  /// \param[in] _key Tile to fill
+  /// \param[out] _tile Tile
+  public: void LoadTile(const WindTileKey &_key, WindTile &_tile);
+
+  /// \brief Read a tile from the file. Called from the worker pool.
+  /// \param[in] _key Tile to read
+  /// \return Velocities of the tile, see WindTile
+  public: std::vector<float> ReadTile(const WindTileKey &_key);
+
+  /// \brief Start reading a tile on the worker pool, unless it's already
+  /// being read.
+  /// \param[in] _key Tile to read
+  public: void Request(const WindTileKey &_key);
+
+  /// \brief Request the tiles which are likely to be sampled next: the next
+  /// frame and the neighbors of the tiles used in the last call.
+  public: void Prefetch();
+
+  /// \brief Remove the least recently used tiles above the limit, and the
+  /// oldest requests when there's no room for new ones.
+  public: void Evict();
+
+  /// \brief True for procedural turbulence, false for a file
+  public: bool procedural{false};
+
+  /// \brief Wind field file
+  public: std::ifstream file;
+
+  /// \brief Protects file, which is read from the worker pool
+  public: std::mutex fileMutex;
+
+  /// \brief Offset of the velocities within the file
+  public: std::streamoff dataOffset{0};
+
+  /// \brief Number of nodes along each axis, for files
+  public: int64_t size[3]{0, 0, 0};
+
+  /// \brief Number of frames, for files
+  public: int64_t frameCount{1};
+
+  /// \brief Position of the first node
+  public: math::Vector3d origin{math::Vector3d::Zero};
+
+  /// \brief Distance between nodes along each axis
+  public: math::Vector3d spacing{math::Vector3d::One};
+
+  /// \brief Time between frames in seconds, zero for a static field
+  public: double framePeriod{0.0};
+
+  /// \brief Amplitude of the turbulence
+  public: double amplitude{1.0};
+
+  /// \brief Seed of the turbulence
+  public: uint64_t seed{0u};
+
+  /// \brief Number of nodes along each side of a tile
+  public: int64_t tileSize{16};
+
+  /// \brief Maximum number of tiles kept in memory
+  public: std::size_t maxTiles{64u};
+
+  /// \brief Tiles in memory
+  public: std::unordered_map<WindTileKey, WindTile, WindTileKeyHash> tiles;
+
+  /// \brief Number of Sample calls so far
+  public: uint64_t sampleCount{0u};
+
+  /// \brief Key of the last tile used, to skip the lookup for neighboring
+  /// nodes
+  public: WindTileKey lastKey{0, 0, 0, -1};
+
+  /// \brief Last tile used
+  public: WindTile *lastTile{nullptr};
+
+  /// \brief Tiles of the file being read, or read but not sampled yet
+  public: std::unordered_map<WindTileKey, WindTileRequest, WindTileKeyHash>
+      requests;
+
+  /// \brief Threads which read the tiles of the file
+  public: common::WorkerPool pool;
+};
+
+//////////////////////////////////////////////////
+/// \brief Integer division rounding towards negative infinity.
+/// \param[in] _a Dividend
+/// \param[in] _b Divisor, greater than zero
+/// \return Quotient
+static int64_t floorDiv(int64_t _a, int64_t _b)
+{
+  return _a >= 0 ? _a / _b : -((-_a + _b - 1) / _b);
+}
+
+//////////////////////////////////////////////////
+/// \brief Random value in [-1, 1] from integer coordinates.
+/// \param[in] _values Coordinates
+/// \return Random value
+static double noise(std::initializer_list<uint64_t> _values)
+{
+  // splitmix64 over the coordinates
+  uint64_t h = 0x9e3779b97f4a7c15ull;
+  for (auto v : _values)
+  {
+    h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    h = h ^ (h >> 31);
+  }
+  return static_cast<double>(h >> 11) / static_cast<double>(1ull << 52) - 1.0;
+}
+
+//////////////////////////////////////////////////
+bool WindFieldPrivate::Open(const std::string &_path)
+{
+  this->file.open(_path, std::ios::binary);
+  if (!this->file)
+  {
+    ignerr << "Failed to open wind field [" << _path << "]" << std::endl;
+    return false;
+  }
+
+  char magic[4];
+  uint32_t version{0u};
+  uint32_t counts[4]{0u, 0u, 0u, 0u};
+  double origin[3];
+  double spacing[3];
+  double period{0.0};
+  this->file.read(magic, sizeof(magic));
+  this->file.read(reinterpret_cast<char *>(&version), sizeof(version));
+  this->file.read(reinterpret_cast<char *>(counts), sizeof(counts));
+  this->file.read(reinterpret_cast<char *>(origin), sizeof(origin));
+  this->file.read(reinterpret_cast<char *>(spacing), sizeof(spacing));
+  this->file.read(reinterpret_cast<char *>(&period), sizeof(period));
+
+  if (!this->file || std::memcmp(magic, "IGWF", 4) != 0)
+  {
+    ignerr << "[" << _path << "] is not a wind field file." << std::endl;
+    return false;
+  }
+  if (version != kWindFieldVersion)
+  {
+    ignerr << "Wind field [" << _path << "] has version [" << version
+           << "], only version [" << kWindFieldVersion << "] is supported."
+           << std::endl;
+    return false;
+  }
+  if (counts[0] == 0u || counts[1] == 0u || counts[2] == 0u ||
+      counts[3] == 0u || spacing[0] <= 0 || spacing[1] <= 0 ||
+      spacing[2] <= 0)
+  {
+    ignerr << "Wind field [" << _path << "] has an empty grid." << std::endl;
+    return false;
+  }
+
+  for (int i = 0; i < 3; ++i)
+    this->size[i] = counts[i];
+  this->frameCount = counts[3];
+  this->origin.Set(origin[0], origin[1], origin[2]);
+  this->spacing.Set(spacing[0], spacing[1], spacing[2]);
+  this->framePeriod = this->frameCount > 1 ? std::max(0.0, period) : 0.0;
+  this->dataOffset = this->file.tellg();
+
+  // Check the file holds all the velocities
+  this->file.seekg(0, std::ios::end);
+  std::streamoff expected = this->dataOffset + static_cast<std::streamoff>(
+      this->size[0] * this->size[1] * this->size[2] * this->frameCount * 3 *
+      sizeof(float));
+  if (this->file.tellg() < expected)
+  {
+    ignerr << "Wind field [" << _path << "] is truncated." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+WindFieldPrivate::~WindFieldPrivate()
+{
+  this->pool.WaitForResults();
+}
+
+//////////////////////////////////////////////////
+void WindFieldPrivate::LoadTile(const WindTileKey &_key, WindTile &_tile)
+{
+  IGN_PROFILE("WindFieldPrivate::LoadTile");
+  if (!this->procedural)
+  {
+    // Usually the tile was requested ahead and is ready by now
+    this->Request(_key);
+    auto it = this->requests.find(_key);
+    _tile.velocities = it->second.velocities.get();
+    this->requests.erase(it);
+    return;
+  }
+
+  const int64_t t = this->tileSize;
+  _tile.velocities.assign(t * t * t * 3, 0.0f);
+  for (int64_t z = 0; z < t; ++z)
+  {
+    for (int64_t y = 0; y < t; ++y)
+    {
+      for (int64_t x = 0; x < t; ++x)
+      {
+        const uint64_t nx = _key.x * t + x;
+        const uint64_t ny = _key.y * t + y;
+        const uint64_t nz = _key.z * t + z;
+        const uint64_t f = _key.frame;
+        float *v = &_tile.velocities[((z * t + y) * t + x) * 3];
+        for (uint64_t c = 0; c < 3; ++c)
+        {
+          v[c] = static_cast<float>(this->amplitude *
+              noise({this->seed, nx, ny, nz, f, c}));
+        }
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+std::vector<float> WindFieldPrivate::ReadTile(const WindTileKey &_key)
+{
+  IGN_PROFILE("WindFieldPrivate::ReadTile");
+  const int64_t t = this->tileSize;
+  std::vector<float> velocities(t * t * t * 3, 0.0f);
+
+  // Read the rows of the tile which are within the grid
+  const int64_t x0 = _key.x * t;
+  const int64_t xCount = std::min(t, this->size[0] - x0);
+  std::lock_guard<std::mutex> lock(this->fileMutex);
+  this->file.clear();
+  for (int64_t z = 0; z < t && _key.z * t + z < this->size[2]; ++z)
+  {
+    for (int64_t y = 0; y < t && _key.y * t + y < this->size[1]; ++y)
+    {
+      const int64_t row = (_key.frame * this->size[2] + _key.z * t + z) *
+          this->size[1] + _key.y * t + y;
+      const std::streamoff offset = this->dataOffset +
+          static_cast<std::streamoff>((row * this->size[0] + x0) * 3 *
+          sizeof(float));
+      this->file.seekg(offset);
+      this->file.read(reinterpret_cast<char *>(
+          &velocities[((z * t + y) * t) * 3]),
+          xCount * 3 * sizeof(float));
+    }
+  }
+  if (!this->file)
+    ignerr << "Failed to read wind field tile." << std::endl;
+  return velocities;
+}
+
+//////////////////////////////////////////////////
+void WindFieldPrivate::Request(const WindTileKey &_key)
+{
+  if (this->requests.find(_key) != this->requests.end())
+    return;
+
+  auto promise = std::make_shared<std::promise<std::vector<float>>>();
+  auto &request = this->requests[_key];
+  request.velocities = promise->get_future();
+  request.requested = this->sampleCount;
+
+  this->pool.AddWork([this, promise, _key]()
+  {
+    promise->set_value(this->ReadTile(_key));
+  });
+}
+
+//////////////////////////////////////////////////
+void WindFieldPrivate::Prefetch()
+{
+  if (this->procedural)
+    return;
+
+  IGN_PROFILE("WindFieldPrivate::Prefetch");
+  std::vector<WindTileKey> used;
+  for (const auto &[key, tile] : this->tiles)
+  {
+    if (tile.lastUsed == this->sampleCount)
+      used.push_back(key);
+  }
+
+  const int64_t t = this->tileSize;
+  const int64_t tileCount[3]{(this->size[0] + t - 1) / t,
+      (this->size[1] + t - 1) / t, (this->size[2] + t - 1) / t};
+  for (const auto &key : used)
+  {
+    WindTileKey next = key;
+    next.frame = (key.frame + 1) % this->frameCount;
+    for (const auto &candidate : {next,
+        WindTileKey{key.x - 1, key.y, key.z, key.frame},
+        WindTileKey{key.x + 1, key.y, key.z, key.frame},
+        WindTileKey{key.x, key.y - 1, key.z, key.frame},
+        WindTileKey{key.x, key.y + 1, key.z, key.frame},
+        WindTileKey{key.x, key.y, key.z - 1, key.frame},
+        WindTileKey{key.x, key.y, key.z + 1, key.frame}})
+    {
+      if (candidate.x < 0 || candidate.y < 0 || candidate.z < 0 ||
+          candidate.x >= tileCount[0] || candidate.y >= tileCount[1] ||
+          candidate.z >= tileCount[2] ||
+          this->tiles.find(candidate) != this->tiles.end())
+      {
+        continue;
+      }
+
+      // Keep requests which are still likely to be sampled
+      auto it = this->requests.find(candidate);
+      if (it != this->requests.end())
+        it->second.requested = this->sampleCount;
+      else if (this->requests.size() < this->maxTiles)
+        this->Request(candidate);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+math::Vector3d WindFieldPrivate::Node(int64_t _x, int64_t _y, int64_t _z,
+    int64_t _frame)
+{
+  if (!this->procedural)
+  {
+    // Files are bounded in space and repeat in time
+    if (_x < 0 || _y < 0 || _z < 0 || _x >= this->size[0] ||
+        _y >= this->size[1] || _z >= this->size[2])
+    {
+      return math::Vector3d::Zero;
+    }
+    _frame = ((_frame % this->frameCount) + this->frameCount) %
+        this->frameCount;
+  }
+
+  const int64_t t = this->tileSize;
+  WindTileKey key{floorDiv(_x, t), floorDiv(_y, t), floorDiv(_z, t),
+      _frame};
+  if (!this->lastTile || !(key == this->lastKey))
+  {
+    auto it = this->tiles.find(key);
+    if (it == this->tiles.end())
+    {
+      it = this->tiles.emplace(key, WindTile()).first;
+      this->LoadTile(key, it->second);
+    }
+    this->lastKey = key;
+    this->lastTile = &it->second;
+  }
+  this->lastTile->lastUsed = this->sampleCount;
+
+  const int64_t lx = _x - key.x * t;
+  const int64_t ly = _y - key.y * t;
+  const int64_t lz = _z - key.z * t;
+  const float *v = &this->lastTile->velocities[((lz * t + ly) * t + lx) * 3];
+  return {v[0], v[1], v[2]};
+}
+
+//////////////////////////////////////////////////
+math::Vector3d WindFieldPrivate::Interpolate(const int64_t _cell[3],
+    const math::Vector3d &_t, int64_t _frame)
+{
+  math::Vector3d result;
+  for (int64_t dz = 0; dz <= 1; ++dz)
+  {
+    const double wz = dz ? _t.Z() : 1.0 - _t.Z();
+    for (int64_t dy = 0; dy <= 1; ++dy)
+    {
+      const double wy = dy ? _t.Y() : 1.0 - _t.Y();
+      for (int64_t dx = 0; dx <= 1; ++dx)
+      {
+        const double wx = dx ? _t.X() : 1.0 - _t.X();
+        const double w = wx * wy * wz;
+        if (w <= 0.0)
+          continue;
+        result += w * this->Node(_cell[0] + dx, _cell[1] + dy,
+            _cell[2] + dz, _frame);
+      }
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+void WindFieldPrivate::Evict()
+{
+  if (this->tiles.size() <= this->maxTiles)
+    return;
+
+  // Tiles used in the last call are kept even if that's above the limit
+  std::vector<std::pair<uint64_t, WindTileKey>> candidates;
+  for (const auto &[key, tile] : this->tiles)
+  {
+    if (tile.lastUsed != this->sampleCount)
+      candidates.emplace_back(tile.lastUsed, key);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first < _b.first;
+      });
+
+  for (const auto &candidate : candidates)
+  {
+    if (this->tiles.size() <= this->maxTiles)
+      break;
+    this->tiles.erase(candidate.second);
+  }
+  this->lastTile = nullptr;
+
+  // Make room for new requests by dropping the ones which weren't renewed
+  // in the last call. Tiles still being read are finished by the pool and
+  // dropped.
+  if (this->requests.size() < this->maxTiles)
+    return;
+
+  candidates.clear();
+  for (const auto &[key, request] : this->requests)
+  {
+    if (request.requested != this->sampleCount)
+      candidates.emplace_back(request.requested, key);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return _a.first < _b.first;
+      });
+  for (const auto &candidate : candidates)
+  {
+    if (this->requests.size() < this->maxTiles)
+      break;
+    this->requests.erase(candidate.second);
+  }
+}
+
+//////////////////////////////////////////////////
+WindField::WindField()
+  : dataPtr(std::make_unique<WindFieldPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+WindField::~WindField() = default;
+
+//////////////////////////////////////////////////
+bool WindField::Load(const sdf::ElementPtr &_sdf)
+{
+  this->dataPtr->tileSize = std::max(2,
+      _sdf->Get<int>("tile_size", 16).first);
+  this->dataPtr->maxTiles = static_cast<std::size_t>(std::max(1,
+      _sdf->Get<int>("max_tiles", 64).first));
+
+  if (_sdf->HasElement("file"))
+  {
+    if (!this->dataPtr->Open(_sdf->Get<std::string>("file")))
+      return false;
+
+    // Read small fields entirely ahead of the first sample
+    const int64_t t = this->dataPtr->tileSize;
+    const int64_t tileCount[3]{(this->dataPtr->size[0] + t - 1) / t,
+        (this->dataPtr->size[1] + t - 1) / t,
+        (this->dataPtr->size[2] + t - 1) / t};
+    if (tileCount[0] * tileCount[1] * tileCount[2] *
+        this->dataPtr->frameCount <=
+        static_cast<int64_t>(this->dataPtr->maxTiles))
+    {
+      for (int64_t f = 0; f < this->dataPtr->frameCount; ++f)
+        for (int64_t z = 0; z < tileCount[2]; ++z)
+          for (int64_t y = 0; y < tileCount[1]; ++y)
+            for (int64_t x = 0; x < tileCount[0]; ++x)
+              this->dataPtr->Request({x, y, z, f});
+    }
+    return true;
+  }
+
+  if (_sdf->HasElement("turbulence"))
+  {
+    auto turbulence = _sdf->GetElement("turbulence");
+    this->dataPtr->procedural = true;
+    this->dataPtr->amplitude = turbulence->Get<double>("amplitude", 1.0).first;
+    double cellSize = turbulence->Get<double>("cell_size", 10.0).first;
+    if (cellSize <= 0)
+    {
+      ignerr << "<wind_field><turbulence><cell_size> must be greater than 0"
+             << std::endl;
+      return false;
+    }
+    this->dataPtr->spacing.Set(cellSize, cellSize, cellSize);
+    this->dataPtr->framePeriod = std::max(0.0,
+        turbulence->Get<double>("frame_period", 1.0).first);
+    this->dataPtr->seed = static_cast<uint64_t>(
+        turbulence->Get<int>("seed", 0).first);
+    return true;
+  }
+
+  ignerr << "<wind_field> needs either a <file> or <turbulence>"
+         << std::endl;
+  return false;
+}
+
+//////////////////////////////////////////////////
+void WindField::Sample(const std::vector<math::Vector3d> &_positions,
+    double _time, std::vector<math::Vector3d> &_velocities)
+{
+  IGN_PROFILE("WindField::Sample");
+  ++this->dataPtr->sampleCount;
+  _velocities.resize(_positions.size());
+
+  double frame = 0.0;
+  if (this->dataPtr->framePeriod > 0)
+    frame = _time / this->dataPtr->framePeriod;
+  const double frameFloor = std::floor(frame);
+  const auto frame0 = static_cast<int64_t>(frameFloor);
+  const double frameT = frame - frameFloor;
+
+  for (std::size_t i = 0; i < _positions.size(); ++i)
+  {
+    const auto grid = (_positions[i] - this->dataPtr->origin) /
+        this->dataPtr->spacing;
+    const math::Vector3d cellFloor(std::floor(grid.X()),
+        std::floor(grid.Y()), std::floor(grid.Z()));
+    const int64_t cell[3]{static_cast<int64_t>(cellFloor.X()),
+        static_cast<int64_t>(cellFloor.Y()),
+        static_cast<int64_t>(cellFloor.Z())};
+    const auto t = grid - cellFloor;
+
+    auto velocity = this->dataPtr->Interpolate(cell, t, frame0);
+    if (frameT > 0.0)
+    {
+      velocity = (1.0 - frameT) * velocity +
+          frameT * this->dataPtr->Interpolate(cell, t, frame0 + 1);
+    }
+    _velocities[i] = velocity;
+  }
+
+  this->dataPtr->Prefetch();
+  this->dataPtr->Evict();
+}
+
+//////////////////////////////////////////////////
+std::size_t WindField::TileCount() const
+{
+  return this->dataPtr->tiles.size();
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMS_WIND_EFFECTS_WINDFIELD_HH_
+#define IGNITION_GAZEBO_SYSTEMS_WIND_EFFECTS_WINDFIELD_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sdf/Element.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/wind-effects-system/Export.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declarations.
+  class WindFieldPrivate;
+
+  /// \brief A gridded, time varying wind field which is added to the
+  /// uniform wind of the WindEffects system.
+  ///
+  /// The grid is split in cubic tiles, which are loaded the first time a
+  /// position within them is sampled. Only the most recently used tiles are
+  /// kept, so large fields can be used as long as the links are close to
+  /// each other. Velocities are interpolated trilinearly between grid
+  /// nodes, and linearly between frames.
+  ///
+  /// Tiles of files are read on a worker pool, so sampling doesn't wait on
+  /// the disk as long as the tiles were read ahead: fields with no more
+  /// tiles than `<max_tiles>` are read entirely when loaded, and after each
+  /// sample the next frame and the neighbors of the tiles in use are
+  /// requested. Sampling a tile which isn't ready yet waits for it.
+  ///
+  /// The field comes from one of:
+  ///
+  /// * A binary file. It starts with the 4 characters `IGWF`, followed by
+  /// these little endian values: uint32 version (1), uint32 number of nodes
+  /// along X, Y and Z, uint32 number of frames, 3 float64 for the position
+  /// of the first node, 3 float64 for the distance between nodes along each
+  /// axis and a float64 frame period in seconds. Then come float32 X, Y and
+  /// Z velocities, ordered by frame, Z, Y and X. The field is zero outside
+  /// of the grid, and the frames repeat.
+  ///
+  /// * Procedural turbulence, which is random noise smoothed by the
+  /// interpolation, with no bounds.
+  ///
+  /// ## Parameters
+  ///
+  /// `<file>`: Path to a binary wind field file.
+  ///
+  /// `<turbulence>`: Generate the field instead, with the child elements
+  /// `<amplitude>` (m/s, defaults to 1), `<cell_size>` (m, defaults to 10),
+  /// `<frame_period>` (s, defaults to 1) and `<seed>` (defaults to 0).
+  ///
+  /// `<tile_size>`: Number of nodes along each side of a tile. Defaults
+  /// to 16.
+  ///
+  /// `<max_tiles>`: Number of tiles kept in memory. Defaults to 64.
+  class IGNITION_GAZEBO_WIND_EFFECTS_SYSTEM_VISIBLE WindField
+  {
+    /// \brief Constructor
+    public: WindField();
+
+    /// \brief Destructor. Waits for the tiles being read.
+    public: ~WindField();
+
+    /// \brief Load the field.
+    /// \param[in] _sdf The `<wind_field>` element.
+    /// \return True if the field was loaded.
+    public: bool Load(const sdf::ElementPtr &_sdf);
+
+    /// \brief Sample the field at many positions at once.
+    /// \param[in] _positions Positions in the world frame.
+    /// \param[in] _time Simulation time in seconds.
+    /// \param[out] _velocities Wind velocity at each position.
+    public: void Sample(const std::vector<math::Vector3d> &_positions,
+                        double _time,
+                        std::vector<math::Vector3d> &_velocities);
+
+    /// \brief Number of tiles in memory which have been sampled. Tiles
+    /// read ahead aren't counted until they're sampled.
+    /// \return Tile count
+    public: std::size_t TileCount() const;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<WindFieldPrivate> dataPtr;
+  };
+}
+}
+}
+}
+#endif
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
+
+#include "ignition/gazebo/test_config.hh"
+
+#include "WindField.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Get a `<wind_field>` element.
+/// \param[in] _content Children of the element
+/// \return The element
+static sdf::ElementPtr windFieldElement(const std::string &_content)
+{
+  const std::string sdfStr =
+      "<?xml version=\"1.0\" ?>"
+      "<sdf version=\"1.6\">"
+      "  <world name=\"wind\">"
+      "    <plugin filename=\"ignition-gazebo-wind-effects-system\""
+      "            name=\"ignition::gazebo::systems::WindEffects\">"
+      "      <wind_field>" + _content + "</wind_field>"
+      "    </plugin>"
+      "  </world>"
+      "</sdf>";
+  sdf::Root root;
+  EXPECT_TRUE(root.LoadSdfString(sdfStr).empty());
+  return root.WorldByIndex(0)->Element()->GetElement("plugin")->
+      GetElement("wind_field");
+}
+
+/// \brief Write a wind field file whose velocity at node (x, y, z) of frame
+/// f is (x, 2y, z + 10f), so interpolating it is exact.
+/// \param[in] _path Path of the file
+/// \param[in] _size Number of nodes along each axis
+/// \param[in] _frames Number of frames
+/// \param[in] _truncate Number of velocities left out at the end
+static void writeWindField(const std::string &_path, uint32_t _size,
+    uint32_t _frames, uint32_t _truncate = 0u)
+{
+  std::ofstream file(_path, std::ios::binary);
+  auto write = [&file](auto _value)
+  {
+    file.write(reinterpret_cast<const char *>(&_value), sizeof(_value));
+  };
+
+  file.write("IGWF", 4);
+  write(uint32_t{1u});
+  for (int i = 0; i < 3; ++i)
+    write(_size);
+  write(_frames);
+  for (int i = 0; i < 3; ++i)
+    write(0.0);
+  for (int i = 0; i < 3; ++i)
+    write(1.0);
+  write(1.0);
+
+  uint32_t count = _size * _size * _size * _frames;
+  for (uint32_t i = 0; i + _truncate < count; ++i)
+  {
+    uint32_t x = i % _size;
+    uint32_t y = (i / _size) % _size;
+    uint32_t z = (i / _size / _size) % _size;
+    uint32_t f = i / _size / _size / _size;
+    write(static_cast<float>(x));
+    write(static_cast<float>(2 * y));
+    write(static_cast<float>(z + 10 * f));
+  }
+}
+
+/// \brief Test fixture which removes the wind field file.
+class WindFieldTest : public ::testing::Test
+{
+  // Documentation inherited
+  protected: void TearDown() override
+  {
+    std::remove(this->path.c_str());
+  }
+
+  /// \brief Path of the wind field file
+  protected: const std::string path = common::joinPaths(
+      std::string(PROJECT_BINARY_PATH), "wind_field_test.bin");
+};
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, FileInterpolation)
+{
+  writeWindField(this->path, 4u, 2u);
+
+  WindField field;
+  ASSERT_TRUE(field.Load(windFieldElement(
+      "<file>" + this->path + "</file><tile_size>2</tile_size>")));
+
+  const std::vector<math::Vector3d> positions{
+      {1.5, 0.25, 2.0},
+      {3.0, 3.0, 3.0},
+      {-5.0, 0.0, 0.0},
+      {1.0, 1.0, 10.0}};
+  std::vector<math::Vector3d> velocities;
+
+  // Between nodes
+  field.Sample(positions, 0.0, velocities);
+  ASSERT_EQ(positions.size(), velocities.size());
+  EXPECT_EQ(math::Vector3d(1.5, 0.5, 2.0), velocities[0]);
+
+  // On the last node
+  EXPECT_EQ(math::Vector3d(3.0, 6.0, 3.0), velocities[1]);
+
+  // Outside of the grid
+  EXPECT_EQ(math::Vector3d::Zero, velocities[2]);
+  EXPECT_EQ(math::Vector3d::Zero, velocities[3]);
+
+  // Between frames
+  field.Sample(positions, 0.5, velocities);
+  EXPECT_EQ(math::Vector3d(1.5, 0.5, 7.0), velocities[0]);
+
+  // Second frame, then the frames repeat
+  field.Sample(positions, 1.0, velocities);
+  EXPECT_EQ(math::Vector3d(1.5, 0.5, 12.0), velocities[0]);
+  field.Sample(positions, 2.0, velocities);
+  EXPECT_EQ(math::Vector3d(1.5, 0.5, 2.0), velocities[0]);
+  field.Sample(positions, 1.5, velocities);
+  EXPECT_EQ(math::Vector3d(1.5, 0.5, 7.0), velocities[0]);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, TileLoading)
+{
+  writeWindField(this->path, 8u, 1u);
+
+  // 64 tiles of 2 nodes, which don't all fit in memory
+  WindField field;
+  ASSERT_TRUE(field.Load(windFieldElement("<file>" + this->path +
+      "</file><tile_size>2</tile_size><max_tiles>4</max_tiles>")));
+  EXPECT_EQ(0u, field.TileCount());
+
+  // Move across the grid, each position touches up to 2 tiles
+  std::vector<math::Vector3d> positions(1);
+  std::vector<math::Vector3d> velocities;
+  for (int i = 0; i < 7; ++i)
+  {
+    positions[0].Set(i + 0.5, 0.5, 0.5);
+    field.Sample(positions, 0.0, velocities);
+    ASSERT_EQ(1u, velocities.size());
+    EXPECT_EQ(math::Vector3d(i + 0.5, 1.0, 0.5), velocities[0]) << i;
+    EXPECT_GE(4u, field.TileCount()) << i;
+  }
+
+  // The first tiles were evicted, and are read again
+  positions[0].Set(0.5, 6.5, 6.5);
+  field.Sample(positions, 0.0, velocities);
+  EXPECT_EQ(math::Vector3d(0.5, 13.0, 6.5), velocities[0]);
+  positions[0].Set(0.5, 0.5, 0.5);
+  field.Sample(positions, 0.0, velocities);
+  EXPECT_EQ(math::Vector3d(0.5, 1.0, 0.5), velocities[0]);
+  EXPECT_GE(4u, field.TileCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, InvalidFile)
+{
+  WindField missing;
+  EXPECT_FALSE(missing.Load(windFieldElement(
+      "<file>/not/a/wind_field.bin</file>")));
+
+  // Truncated velocities
+  writeWindField(this->path, 4u, 1u, 1u);
+  WindField truncated;
+  EXPECT_FALSE(truncated.Load(windFieldElement(
+      "<file>" + this->path + "</file>")));
+
+  // Not a wind field
+  {
+    std::ofstream file(this->path, std::ios::binary);
+    file << "not a wind field file, but long enough to hold a header";
+  }
+  WindField invalid;
+  EXPECT_FALSE(invalid.Load(windFieldElement(
+      "<file>" + this->path + "</file>")));
+
+  // Neither a file nor turbulence
+  WindField empty;
+  EXPECT_FALSE(empty.Load(windFieldElement("<tile_size>2</tile_size>")));
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, Turbulence)
+{
+  const std::string turbulence =
+      "<turbulence>"
+      "  <amplitude>2</amplitude>"
+      "  <cell_size>5</cell_size>"
+      "  <seed>3</seed>"
+      "</turbulence>";
+
+  WindField field1;
+  WindField field2;
+  ASSERT_TRUE(field1.Load(windFieldElement(turbulence)));
+  ASSERT_TRUE(field2.Load(windFieldElement(turbulence)));
+
+  WindField otherSeed;
+  ASSERT_TRUE(otherSeed.Load(windFieldElement(
+      "<turbulence><amplitude>2</amplitude><cell_size>5</cell_size>"
+      "<seed>4</seed></turbulence>")));
+
+  const std::vector<math::Vector3d> positions{
+      {0.0, 0.0, 0.0},
+      {12.3, -45.6, 7.8},
+      {-1000.0, 2000.0, -3000.0}};
+  std::vector<math::Vector3d> velocities1;
+  std::vector<math::Vector3d> velocities2;
+  std::vector<math::Vector3d> velocitiesOther;
+  field1.Sample(positions, 0.7, velocities1);
+  field2.Sample(positions, 0.7, velocities2);
+  otherSeed.Sample(positions, 0.7, velocitiesOther);
+
+  // The field only depends on the seed, and is bounded by the amplitude
+  ASSERT_EQ(positions.size(), velocities1.size());
+  for (std::size_t i = 0; i < positions.size(); ++i)
+  {
+    EXPECT_EQ(velocities1[i], velocities2[i]) << i;
+    EXPECT_NE(velocities1[i], velocitiesOther[i]) << i;
+    EXPECT_GE(2.0, std::abs(velocities1[i].X())) << i;
+    EXPECT_GE(2.0, std::abs(velocities1[i].Y())) << i;
+    EXPECT_GE(2.0, std::abs(velocities1[i].Z())) << i;
+  }
+
+  // Unbounded, so tiles are generated wherever it's sampled
+  EXPECT_LT(0u, field1.TileCount());
+}
@@ -0,0 +1,499 @@
+/*
+ * Copyright (C) 2021 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <ignition/msgs/boolean.pb.h>
+#include <ignition/msgs/entity_factory_v.pb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/transport/Node.hh>
+#include <sdf/Root.hh>
+
+#include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/EventManager.hh"
+#include "ignition/gazebo/SdfEntityCreator.hh"
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/ServerConfig.hh"
+#include "ignition/gazebo/test_config.hh"  // NOLINT(build/include)
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/// \brief Number of simulation steps timed by each benchmark iteration of
+/// the server benchmarks.
+constexpr const int kStepIterations {10};
+
+/// \brief Name of the generated worlds.
+constexpr const char kWorldName[] {"benchmark"};
+
+/// \brief Physics system plugin.
+static const char kPhysicsPlugin[] = R"(
+  <plugin filename="ignition-gazebo-physics-system"
+          name="ignition::gazebo::systems::Physics">
+  </plugin>)";
+
+/// \brief Scene broadcaster system plugin.
+static const char kSceneBroadcasterPlugin[] = R"(
+  <plugin filename="ignition-gazebo-scene-broadcaster-system"
+          name="ignition::gazebo::systems::SceneBroadcaster">
+  </plugin>)";
+
+/// \brief User commands system plugin.
+static const char kUserCommandsPlugin[] = R"(
+  <plugin filename="ignition-gazebo-user-commands-system"
+          name="ignition::gazebo::systems::UserCommands">
+  </plugin>)";
+
+/// \brief Directory where the log record benchmark writes.
+static const std::string kLogPath{common::joinPaths(PROJECT_BINARY_PATH,
+    "test", "benchmark_log")};
+
+/////////////////////////////////////////////////
+/// \brief Generate a model. It's a chain of boxes connected by revolute
+/// joints, with an IMU on the first box.
+/// \param[in] _name Model name.
+/// \param[in] _x X position of the model.
+/// \param[in] _y Y position of the model.
+/// \param[in] _links Number of links.
+/// \return The model's SDF, without the <sdf> tag.
+static std::string GenerateModel(const std::string &_name, double _x,
+    double _y, int _links)
+{
+  std::ostringstream out;
+  out << "<model name='" << _name << "'>"
+      << "<pose>" << _x << " " << _y << " 0.5 0 0 0</pose>";
+
+  for (int l = 0; l < _links; ++l)
+  {
+    out << "<link name='link_" << l << "'>"
+        << "<pose>" << l * 0.5 << " 0 0 0 0 0</pose>"
+        << "<inertial><mass>1</mass><inertia>"
+        << "<ixx>0.017</ixx><iyy>0.017</iyy><izz>0.017</izz>"
+        << "</inertia></inertial>"
+        << "<collision name='collision'><geometry><box>"
+        << "<size>0.4 0.4 0.4</size></box></geometry></collision>"
+        << "<visual name='visual'><geometry><box>"
+        << "<size>0.4 0.4 0.4</size></box></geometry></visual>";
+    if (l == 0)
+    {
+      out << "<sensor name='imu' type='imu'>"
+          << "<update_rate>100</update_rate></sensor>";
+    }
+    out << "</link>";
+
+    if (l > 0)
+    {
+      out << "<joint name='joint_" << l << "' type='revolute'>"
+          << "<parent>link_" << l - 1 << "</parent>"
+          << "<child>link_" << l << "</child>"
+          << "<axis><xyz>0 1 0</xyz></axis>"
+          << "</joint>";
+    }
+  }
+  out << "</model>";
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Generate a world with models on a grid over a ground plane.
+/// \param[in] _models Number of models.
+/// \param[in] _links Number of links in each model.
+/// \param[in] _plugins System plugins to add to the world.
+/// \param[in] _levels True to add one level per model, and make the first
+/// model a performer.
+/// \return The world's SDF.
+static std::string GenerateWorld(int _models, int _links,
+    const std::string &_plugins, bool _levels = false)
+{
+  const int columns = std::max(1,
+      static_cast<int>(std::ceil(std::sqrt(_models))));
+  const double spacing = 0.5 * _links + 2.0;
+
+  std::ostringstream out;
+  out << "<?xml version='1.0' ?><sdf version='1.6'>"
+      << "<world name='" << kWorldName << "'>"
+      << _plugins
+      << "<model name='ground_plane'><static>true</static>"
+      << "<link name='link'><collision name='collision'><geometry><plane>"
+      << "<normal>0 0 1</normal><size>1000 1000</size>"
+      << "</plane></geometry></collision></link></model>";
+
+  for (int m = 0; m < _models; ++m)
+  {
+    out << GenerateModel("model_" + std::to_string(m),
+        (m % columns) * spacing, (m / columns) * spacing, _links);
+  }
+
+  if (_levels)
+  {
+    out << "<plugin name='ignition::gazebo' filename='dummy'>"
+        << "<performer name='performer'><ref>model_0</ref>"
+        << "<geometry><box><size>2 2 2</size></box></geometry>"
+        << "</performer>";
+    for (int m = 0; m < _models; ++m)
+    {
+      out << "<level name='level_" << m << "'>"
+          << "<pose>" << (m % columns) * spacing << " "
+          << (m / columns) * spacing << " 0 0 0 0</pose>"
+          << "<geometry><box><size>" << spacing << " " << spacing
+          << " 10</size></box></geometry>"
+          << "<ref>model_" << m << "</ref>"
+          << "<buffer>1.0</buffer>"
+          << "</level>";
+    }
+    out << "</plugin>";
+  }
+
+  out << "</world></sdf>";
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Set the counters shared by all benchmarks.
+/// \param[in] _st Benchmark state.
+/// \param[in] _entities Number of entities in the world.
+static void SetCounters(benchmark::State &_st, std::size_t _entities)
+{
+  _st.counters["num_models"] = _st.range(0);
+  _st.counters["num_links_per_model"] = _st.range(1);
+  _st.counters["num_entities"] = _entities;
+}
+
+/////////////////////////////////////////////////
+/// \brief Load a server and time its steps.
+/// \param[in] _st Benchmark state. The first argument is the number of
+/// models and the second is the number of links per model.
+/// \param[in] _plugins System plugins to load.
+/// \param[in] _config Server configuration. The SDF is set by this
+/// function.
+static void RunServer(benchmark::State &_st, const std::string &_plugins,
+    ServerConfig _config = ServerConfig())
+{
+  common::Console::SetVerbosity(0);
+  common::setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+      (std::string(PROJECT_BINARY_PATH) + "/lib").c_str());
+
+  _config.SetSdfString(GenerateWorld(_st.range(0), _st.range(1), _plugins,
+      _config.UseLevels()));
+
+  Server server(_config);
+  server.SetUpdatePeriod(1ns);
+
+  // The first iterations load the systems and physics entities
+  server.Run(true, 2, false);
+
+  for (auto _ : _st)
+  {
+    server.Run(true, kStepIterations, false);
+  }
+
+  SetCounters(_st, server.EntityCount().value_or(0));
+  _st.SetItemsProcessed(_st.iterations() * kStepIterations);
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_Physics(benchmark::State &_st)
+{
+  RunServer(_st, kPhysicsPlugin);
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_SceneBroadcaster(benchmark::State &_st)
+{
+  RunServer(_st, std::string(kPhysicsPlugin) + kSceneBroadcasterPlugin);
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_LogRecord(benchmark::State &_st)
+{
+  common::removeAll(kLogPath);
+
+  std::string logPlugin =
+      "<plugin filename='ignition-gazebo-log-system' "
+      "name='ignition::gazebo::systems::LogRecord'>"
+      "<record_path>" + kLogPath + "</record_path></plugin>";
+  RunServer(_st, std::string(kPhysicsPlugin) + logPlugin);
+
+  common::removeAll(kLogPath);
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_LevelManager(benchmark::State &_st)
+{
+  ServerConfig config;
+  config.SetUseLevels(true);
+  RunServer(_st, kPhysicsPlugin, config);
+}
+
+/////////////////////////////////////////////////
+/// \brief Spawn all models at once through UserCommands.
+/// \param[in] _st Benchmark state.
+/// \param[in] _copies True to send the SDF once and spawn copies of it,
+/// false to send the SDF of each model.
+static void SpawnModels(benchmark::State &_st, bool _copies)
+{
+  common::Console::SetVerbosity(0);
+  common::setenv("IGN_GAZEBO_SYSTEM_PLUGIN_PATH",
+      (std::string(PROJECT_BINARY_PATH) + "/lib").c_str());
+
+  const int models = _st.range(0);
+  const int links = _st.range(1);
+
+  msgs::EntityFactory_V req;
+  for (int m = 0; m < models; ++m)
+  {
+    auto *factory = req.add_data();
+    if (!_copies)
+    {
+      factory->set_sdf("<?xml version='1.0' ?><sdf version='1.6'>" +
+          GenerateModel("spawned_" + std::to_string(m), m * 3.0, 0.0, links) +
+          "</sdf>");
+      continue;
+    }
+
+    if (m == 0)
+    {
+      factory->set_sdf("<?xml version='1.0' ?><sdf version='1.6'>" +
+          GenerateModel("spawned", 0.0, 0.0, links) + "</sdf>");
+    }
+    factory->set_name("spawned_" + std::to_string(m));
+    factory->mutable_pose()->mutable_position()->set_x(m * 3.0);
+  }
+
+  ServerConfig config;
+  config.SetSdfString(GenerateWorld(0, links, kUserCommandsPlugin));
+
+  transport::Node node;
+  const std::string service =
+      std::string("/world/") + kWorldName + "/create_multiple";
+
+  std::size_t entities{0};
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto server = std::make_unique<Server>(config);
+    server->SetUpdatePeriod(1ns);
+    server->Run(true, 1, false);
+    _st.ResumeTiming();
+
+    // The entities are created on the next iteration
+    msgs::Boolean res;
+    bool result{false};
+    if (!node.Request(service, req, 5000, res, result) || !result)
+    {
+      _st.SkipWithError("Failed to request entity creation");
+      break;
+    }
+    server->Run(true, 1, false);
+
+    _st.PauseTiming();
+    entities = server->EntityCount().value_or(0);
+    if (!server->HasEntity("spawned_" + std::to_string(models - 1)))
+      _st.SkipWithError("Failed to spawn entities");
+    server.reset();
+    _st.ResumeTiming();
+  }
+
+  SetCounters(_st, entities);
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_UserCommandsSpawn(benchmark::State &_st)
+{
+  SpawnModels(_st, false);
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_UserCommandsSpawnCopies(benchmark::State &_st)
+{
+  SpawnModels(_st, true);
+}
+
+/////////////////////////////////////////////////
+// NOLINTNEXTLINE
+void BM_SdfEntityCreatorLoad(benchmark::State &_st)
+{
+  sdf::Root root;
+  auto errors = root.LoadSdfString(
+      GenerateWorld(_st.range(0), _st.range(1), ""));
+  if (!errors.empty() || root.WorldCount() == 0)
+  {
+    _st.SkipWithError("Failed to load generated world");
+    return;
+  }
+
+  std::size_t entities{0};
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto ecm = std::make_unique<EntityComponentManager>();
+    EventManager eventManager;
+    _st.ResumeTiming();
+
+    SdfEntityCreator creator(*ecm, eventManager);
+    creator.CreateEntities(root.WorldByIndex(0));
+
+    _st.PauseTiming();
+    entities = ecm->EntityCount();
+    ecm.reset();
+    _st.ResumeTiming();
+  }
+
+  SetCounters(_st, entities);
+}
+
+/////////////////////////////////////////////////
+/// \brief Fixture with an ECM loaded from a generated world.
+class WorldEcmFixture: public benchmark::Fixture
+{
+  protected: void SetUp(const ::benchmark::State &_state) override
+  {
+    sdf::Root root;
+    root.LoadSdfString(GenerateWorld(_state.range(0), _state.range(1), ""));
+
+    this->ecm = std::make_unique<EntityComponentManager>();
+    SdfEntityCreator creator(*this->ecm, this->eventManager);
+    creator.CreateEntities(root.WorldByIndex(0));
+  }
+
+  protected: void TearDown(const ::benchmark::State &) override
+  {
+    this->ecm.reset();
+  }
+
+  protected: EventManager eventManager;
+
+  protected: std::unique_ptr<EntityComponentManager> ecm;
+};
+
+/////////////////////////////////////////////////
+BENCHMARK_DEFINE_F(WorldEcmFixture, State)
+(benchmark::State &_st)
+{
+  std::size_t serializedSize = 0;
+  for (auto _ : _st)
+  {
+    auto stateMsg = this->ecm->State();
+#if GOOGLE_PROTOBUF_VERSION >= 3004000
+    serializedSize = stateMsg.ByteSizeLong();
+#else
+    serializedSize = stateMsg.ByteSize();
+#endif
+  }
+
+  SetCounters(_st, this->ecm->EntityCount());
+  _st.counters["serialized_size"] = serializedSize;
+}
+
+/////////////////////////////////////////////////
+BENCHMARK_DEFINE_F(WorldEcmFixture, SetState)
+(benchmark::State &_st)
+{
+  auto stateMsg = this->ecm->State();
+  for (auto _ : _st)
+  {
+    _st.PauseTiming();
+    auto target = std::make_unique<EntityComponentManager>();
+    _st.ResumeTiming();
+
+    target->SetState(stateMsg);
+
+    _st.PauseTiming();
+    target.reset();
+    _st.ResumeTiming();
+  }
+
+  SetCounters(_st, this->ecm->EntityCount());
+}
+
+/////////////////////////////////////////////////
+/// Method to generate test argument combinations: number of models and
+/// links per model, up to worlds with about 10k entities.
+static void WorldArgs(benchmark::internal::Benchmark *_b)
+{
+  for (int models : {10, 100, 1000})
+  {
+    _b->Args({models, 1});
+    _b->Args({models, 4});
+  }
+}
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_Physics)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_SceneBroadcaster)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_LogRecord)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_LevelManager)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_UserCommandsSpawn)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_UserCommandsSpawnCopies)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+// NOLINTNEXTLINE
+BENCHMARK(BM_SdfEntityCreatorLoad)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(WorldEcmFixture, State)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_REGISTER_F(WorldEcmFixture, SetState)
+  ->Apply(WorldArgs)
+  ->Unit(benchmark::kMillisecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
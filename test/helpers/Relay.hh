@@ -89,6 +89,14 @@ class Relay
     return *this;
   }
 
+  /// \brief Wrapper around system's reset callback
+  /// \param[in] _cb Function to be called on reset
+  public: Relay &OnReset(MockSystem::CallbackType _cb)
+  {
+    this->mockSystem->resetCallback = std::move(_cb);
+    return *this;
+  }
+
   /// \brief Pointer to underlying syste,
   public: SystemPluginPtr systemPtr;
 
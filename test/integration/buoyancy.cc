@@ -151,7 +151,8 @@ TEST_F(BuoyancyTest, Movement)
     // Check the duck volume and center of volume
     auto duckVolume = _ecm.Component<components::Volume>(duckLink);
     ASSERT_NE(duckVolume, nullptr);
-    EXPECT_NEAR(1.40186, duckVolume->Data(), 1e-3);
+    // The mesh volume is 1.40186, scaled by 0.5 on each axis
+    EXPECT_NEAR(1.40186 * 0.125, duckVolume->Data(), 1e-3);
     auto duckCenterOfVolume =
       _ecm.Component<components::CenterOfVolume>(duckLink);
     ASSERT_NE(duckCenterOfVolume, nullptr);
@@ -191,7 +192,7 @@ TEST_F(BuoyancyTest, Movement)
     {
       EXPECT_NEAR(-1.63, submarineSinkingPose->Data().Pos().Z(), 1e-2);
       EXPECT_NEAR(4.90, submarineBuoyantPose->Data().Pos().Z(), 1e-2);
-      EXPECT_NEAR(171.4, duckPose->Data().Pos().Z(), 1e-2);
+      EXPECT_NEAR(17.13, duckPose->Data().Pos().Z(), 1e-2);
       finished = true;
     }
   });
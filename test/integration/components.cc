@@ -40,6 +40,7 @@
 #include "ignition/gazebo/components/CanonicalLink.hh"
 #include "ignition/gazebo/components/ChildLinkName.hh"
 #include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/DetachableJoint.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Gravity.hh"
@@ -379,6 +380,71 @@ TEST_F(ComponentsTest, Collision)
   comp3.Deserialize(istr);
 }
 
+/////////////////////////////////////////////////
+TEST_F(ComponentsTest, ContactSensorBuffer)
+{
+  ContactBuffer buffer1;
+  buffer1.collision = 1;
+  buffer1.AddPair(2);
+  buffer1.positions.push_back({1, 2, 3});
+  buffer1.positions.push_back({4, 5, 6});
+  buffer1.AddPair(3);
+  buffer1.positions.push_back({7, 8, 9});
+  EXPECT_EQ(2u, buffer1.PairCount());
+  EXPECT_EQ(3u, buffer1.PointCount());
+  EXPECT_EQ(2u, buffer1.PairEnd(0));
+  EXPECT_EQ(3u, buffer1.PairEnd(1));
+
+  ContactBuffer buffer2 = buffer1;
+  buffer2.positions.back().Z(10);
+
+  // Create components
+  auto comp1 = components::ContactSensorBuffer(buffer1);
+  auto comp2 = components::ContactSensorBuffer(buffer2);
+
+  // Equality operators
+  EXPECT_NE(comp1, comp2);
+  EXPECT_FALSE(comp1 == comp2);
+  EXPECT_TRUE(comp1 != comp2);
+
+  // Conversion to message
+  msgs::Contacts msg;
+  buffer1.ToMsg(msg);
+  ASSERT_EQ(2, msg.contact_size());
+  EXPECT_EQ(1u, msg.contact(0).collision1().id());
+  EXPECT_EQ(2u, msg.contact(0).collision2().id());
+  EXPECT_EQ(2, msg.contact(0).position_size());
+  EXPECT_EQ(0, msg.contact(0).normal_size());
+  EXPECT_EQ(3u, msg.contact(1).collision2().id());
+  EXPECT_EQ(1, msg.contact(1).position_size());
+  EXPECT_EQ(math::Vector3d(7, 8, 9),
+      msgs::Convert(msg.contact(1).position(0)));
+
+  // Stream operators
+  std::ostringstream ostr;
+  comp1.Serialize(ostr);
+
+  std::istringstream istr(ostr.str());
+  components::ContactSensorBuffer comp3;
+  comp3.Deserialize(istr);
+  EXPECT_EQ(comp1, comp3);
+
+  // Optional data
+  buffer1.normals.assign(3, math::Vector3d::UnitZ);
+  buffer1.depths.assign(3, 0.01);
+  buffer1.forces.assign(3, math::Vector3d(0, 0, 5));
+  auto comp4 = components::ContactSensorBuffer(buffer1);
+
+  std::ostringstream ostr2;
+  comp4.Serialize(ostr2);
+
+  std::istringstream istr2(ostr2.str());
+  components::ContactSensorBuffer comp5;
+  comp5.Deserialize(istr2);
+  EXPECT_EQ(comp4, comp5);
+  EXPECT_EQ(3u, comp5.Data().normals.size());
+}
+
 /////////////////////////////////////////////////
 TEST_F(ComponentsTest, DetachableJoint)
 {
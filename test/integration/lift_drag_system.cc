@@ -17,6 +17,12 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <ignition/msgs/double.pb.h>
 #include <ignition/msgs/Utility.hh>
 
@@ -213,3 +219,102 @@ TEST_F(LiftDragTestFixture, VerifyVerticalForce)
     EXPECT_GT(vertForce, 0);
   }
 }
+
+/////////////////////////////////////////////////
+/// Run the lift drag world and record the forces on both wings.
+/// \param[in] _batched Whether the surfaces are batched
+/// \param[in] _iterations Number of iterations to run
+/// \return Forces on wing_1 and wing_2 for each iteration
+static std::vector<std::pair<math::Vector3d, math::Vector3d>> wingForces(
+    bool _batched, std::size_t _iterations)
+{
+  using namespace std::chrono_literals;
+
+  const auto sdfFile =
+      std::string(PROJECT_SOURCE_PATH) + "/test/worlds/lift_drag.sdf";
+  std::ifstream file(sdfFile);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  std::string sdfString = buffer.str();
+
+  if (_batched)
+  {
+    const std::string tag = "<link_name>";
+    const std::string batched = "<batched>true</batched>\n        ";
+    for (auto pos = sdfString.find(tag); pos != std::string::npos;
+         pos = sdfString.find(tag, pos + batched.size() + tag.size()))
+    {
+      sdfString.insert(pos, batched);
+    }
+  }
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfString(sdfString);
+
+  Server server(serverConfig);
+  server.SetUpdatePeriod(0ns);
+
+  // Push the body along the prismatic joint so the wings have an inflow
+  test::Relay testSystem;
+  testSystem.OnPreUpdate(
+      [&](const gazebo::UpdateInfo &, gazebo::EntityComponentManager &_ecm)
+      {
+        auto joint = _ecm.EntityByComponents(components::Joint(),
+                                             components::Name("body_joint"));
+        if (nullptr == _ecm.Component<components::JointForceCmd>(joint))
+          _ecm.CreateComponent(joint, components::JointForceCmd({-20.0}));
+        else
+          _ecm.Component<components::JointForceCmd>(joint)->Data()[0] = -20.0;
+      });
+  server.AddSystem(testSystem.systemPtr);
+
+  std::vector<std::pair<math::Vector3d, math::Vector3d>> forces;
+  test::Relay wrenchRecorder;
+  wrenchRecorder.OnPreUpdate([&](const gazebo::UpdateInfo &,
+                              const gazebo::EntityComponentManager &_ecm)
+      {
+        auto force = [&](const std::string &_name)
+        {
+          auto link = _ecm.EntityByComponents(components::Link(),
+                                              components::Name(_name));
+          auto wrenchComp =
+              _ecm.Component<components::ExternalWorldWrenchCmd>(link);
+          if (!wrenchComp)
+            return math::Vector3d::Zero;
+          return msgs::Convert(wrenchComp->Data().force());
+        };
+        forces.emplace_back(force("wing_1"), force("wing_2"));
+      });
+  server.AddSystem(wrenchRecorder.systemPtr);
+
+  server.Run(true, _iterations, false);
+  return forces;
+}
+
+/////////////////////////////////////////////////
+/// The batched surfaces must apply the same forces as the per surface path,
+/// including on the first iteration, when the surfaces are added.
+TEST_F(LiftDragTestFixture, BatchedMatchesScalar)
+{
+  const std::size_t iterations = 500;
+  auto scalar = wingForces(false, iterations);
+  auto batched = wingForces(true, iterations);
+
+  ASSERT_EQ(iterations, scalar.size());
+  ASSERT_EQ(iterations, batched.size());
+
+  bool nonZero{false};
+  for (std::size_t i = 0; i < iterations; ++i)
+  {
+    EXPECT_NEAR(scalar[i].first.X(), batched[i].first.X(), TOL) << i;
+    EXPECT_NEAR(scalar[i].first.Y(), batched[i].first.Y(), TOL) << i;
+    EXPECT_NEAR(scalar[i].first.Z(), batched[i].first.Z(), TOL) << i;
+    EXPECT_NEAR(scalar[i].second.X(), batched[i].second.X(), TOL) << i;
+    EXPECT_NEAR(scalar[i].second.Y(), batched[i].second.Y(), TOL) << i;
+    EXPECT_NEAR(scalar[i].second.Z(), batched[i].second.Z(), TOL) << i;
+    nonZero = nonZero || scalar[i].first != math::Vector3d::Zero;
+  }
+
+  // Make sure the comparison isn't trivially between zero forces
+  EXPECT_TRUE(nonZero);
+}
@@ -17,6 +17,11 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <ignition/msgs/logical_camera_image.pb.h>
 
 #include <ignition/common/Console.hh>
@@ -192,3 +197,70 @@ TEST_F(LogicalCameraTest, LogicalCameraBox)
   EXPECT_EQ(boxPoseCamera2Frame, ignition::msgs::Convert(img2.model(0).pose()));
   mutex.unlock();
 }
+
+/////////////////////////////////////////////////
+// This test checks that nested models are seen at their world pose.
+TEST_F(LogicalCameraTest, NestedModel)
+{
+  // The parent model is out of range, its nested model isn't
+  const std::string sdfStr = R"(
+    <?xml version="1.0" ?>
+    <sdf version="1.6">
+      <world name="logical_camera_nested">
+        <plugin
+          filename="ignition-gazebo-logical-camera-system"
+          name="ignition::gazebo::systems::LogicalCamera">
+        </plugin>
+        <model name="camera">
+          <static>true</static>
+          <pose>0 0 0.5 0 0 0</pose>
+          <link name="link">
+            <sensor name="logical_camera" type="logical_camera">
+              <topic>nested_logical_camera</topic>
+              <update_rate>10</update_rate>
+              <logical_camera>
+                <near>0.1</near>
+                <far>5</far>
+                <horizontal_fov>1.04719755</horizontal_fov>
+                <aspect_ratio>1.778</aspect_ratio>
+              </logical_camera>
+              <always_on>1</always_on>
+            </sensor>
+          </link>
+        </model>
+        <model name="parent">
+          <static>true</static>
+          <pose>100 0 0.5 0 0 0</pose>
+          <link name="link"/>
+          <model name="nested">
+            <pose>-98 0 0 0 0 0</pose>
+            <link name="link"/>
+          </model>
+        </model>
+      </world>
+    </sdf>)";
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfString(sdfStr);
+  Server server(serverConfig);
+
+  std::vector<msgs::LogicalCameraImage> images;
+  std::function<void(const msgs::LogicalCameraImage &)> cb =
+      [&](const msgs::LogicalCameraImage &_msg)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        images.push_back(_msg);
+      };
+  transport::Node node;
+  node.Subscribe("/nested_logical_camera", cb);
+
+  server.Run(true, 1000u, false);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_FALSE(images.empty());
+  const auto &img = images.back();
+  ASSERT_EQ(1, img.model().size());
+  EXPECT_EQ("nested", img.model(0).name());
+  EXPECT_EQ(math::Pose3d(2, 0, 0, 0, 0, 0),
+      msgs::Convert(img.model(0).pose()));
+}
@@ -18,6 +18,8 @@
 #include <gtest/gtest.h>
 #include <chrono>
 #include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "ignition/msgs.hh"
 #include "ignition/transport.hh"
@@ -141,3 +143,50 @@ TEST(PlayPause, PlayPause)
   worldControl(false, 10);
   testPaused(false);
 }
+
+/////////////////////////////////////////////////
+TEST(PlayPause, StatsHeader)
+{
+  ServerConfig serverConfig;
+  Server server(serverConfig);
+  server.SetUpdatePeriod(1ms);
+  server.Run(false);
+  worldControl(false, 0);
+
+  // Wait for the step times of a complete window
+  std::this_thread::sleep_for(1500ms);
+
+  std::condition_variable condition;
+  std::mutex mutex;
+  transport::Node node;
+  ignition::msgs::WorldStatistics stats;
+  bool received{false};
+
+  std::function<void(const ignition::msgs::WorldStatistics &)> cb =
+      [&](const ignition::msgs::WorldStatistics &_msg)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    stats = _msg;
+    received = true;
+    condition.notify_all();
+  };
+
+  std::unique_lock<std::mutex> lock(mutex);
+  node.Subscribe("/world/default/stats", cb);
+  ASSERT_TRUE(condition.wait_for(lock, 5s, [&] { return received; }));
+
+  // The header is stamped with the message's own sim time, not the time
+  // of the last step times window
+  EXPECT_EQ(stats.sim_time().sec(), stats.header().stamp().sec());
+  EXPECT_EQ(stats.sim_time().nsec(), stats.header().stamp().nsec());
+
+  bool hasStep{false};
+  bool hasRtf{false};
+  for (const auto &data : stats.header().data())
+  {
+    hasStep = hasStep || data.key() == "Step";
+    hasRtf = hasRtf || data.key() == "RealTimeFactor";
+  }
+  EXPECT_TRUE(hasStep);
+  EXPECT_TRUE(hasRtf);
+}
@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 
 #include <ignition/msgs/entity_factory.pb.h>
+#include <ignition/msgs/entity_factory_v.pb.h>
 #include <ignition/msgs/light.pb.h>
 #include <ignition/msgs/physics.pb.h>
 
@@ -335,6 +336,115 @@ TEST_F(UserCommandsTest, Create)
       components::Name("test_model")));
 }
 
+/////////////////////////////////////////////////
+TEST_F(UserCommandsTest, CreateMultiple)
+{
+  // Start server
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/examples/worlds/empty.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+
+  // Create a system just to get the ECM
+  EntityComponentManager *ecm{nullptr};
+  test::Relay testSystem;
+  testSystem.OnPreUpdate([&](const gazebo::UpdateInfo &,
+                             gazebo::EntityComponentManager &_ecm)
+      {
+        ecm = &_ecm;
+      });
+
+  server.AddSystem(testSystem.systemPtr);
+
+  server.Run(true, 1, false);
+  ASSERT_NE(nullptr, ecm);
+
+  auto entityCount = ecm->EntityCount();
+
+  auto modelStr = std::string("<?xml version=\"1.0\" ?>") +
+      "<sdf version='1.6'>" +
+      "<model name='parcel'>" +
+      "<link name='link'>" +
+      "<visual name='visual'>" +
+      "<geometry><box><size>1 1 1</size></box></geometry>" +
+      "</visual>" +
+      "<collision name='collision'>" +
+      "<geometry><box><size>1 1 1</size></box></geometry>" +
+      "</collision>" +
+      "</link>" +
+      "</model>" +
+      "</sdf>";
+
+  // The SDF is only set on the first entry, the others spawn copies of it
+  msgs::EntityFactory_V req;
+  const int copies{10};
+  for (int i = 0; i < copies; ++i)
+  {
+    auto data = req.add_data();
+    if (i == 0)
+      data->set_sdf(modelStr);
+    if (i > 0 && i < 5)
+      data->set_name("parcel_named_" + std::to_string(i));
+    data->set_allow_renaming(true);
+    data->mutable_pose()->mutable_position()->set_x(i);
+  }
+
+  // A light with a new source, followed by a copy of it
+  auto lightData = req.add_data();
+  lightData->mutable_light()->set_name("batch_light");
+  lightData->mutable_light()->set_parent_id(1);
+  req.add_data()->set_allow_renaming(true);
+
+  msgs::Boolean res;
+  bool result;
+  unsigned int timeout = 5000;
+  std::string service{"/world/empty/create_multiple"};
+
+  transport::Node node;
+  EXPECT_TRUE(node.Request(service, req, timeout, res, result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(res.data());
+
+  // Run an iteration and check all were created
+  server.Run(true, 1, false);
+  EXPECT_EQ(entityCount + copies * 4 + 2, ecm->EntityCount());
+
+  auto parcel = ecm->EntityByComponents(components::Model(),
+      components::Name("parcel"));
+  EXPECT_NE(kNullEntity, parcel);
+
+  for (int i = 1; i < copies; ++i)
+  {
+    auto name = i < 5 ? "parcel_named_" + std::to_string(i) :
+        "parcel_" + std::to_string(i - 5);
+    auto model = ecm->EntityByComponents(components::Model(),
+        components::Name(name));
+    ASSERT_NE(kNullEntity, model) << name;
+
+    auto poseComp = ecm->Component<components::Pose>(model);
+    ASSERT_NE(nullptr, poseComp);
+    EXPECT_EQ(math::Pose3d(i, 0, 0, 0, 0, 0), poseComp->Data());
+  }
+
+  EXPECT_NE(kNullEntity, ecm->EntityByComponents(
+      components::Name("batch_light")));
+  EXPECT_NE(kNullEntity, ecm->EntityByComponents(
+      components::Name("batch_light_0")));
+
+  // An entry without a source and nothing before it isn't spawned
+  req.Clear();
+  req.add_data()->set_name("orphan");
+
+  EXPECT_TRUE(node.Request(service, req, timeout, res, result));
+  EXPECT_TRUE(result);
+
+  entityCount = ecm->EntityCount();
+  server.Run(true, 1, false);
+  EXPECT_EQ(entityCount, ecm->EntityCount());
+}
+
 /////////////////////////////////////////////////
 TEST_F(UserCommandsTest, Remove)
 {
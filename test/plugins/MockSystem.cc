@@ -5,5 +5,6 @@
 IGNITION_ADD_PLUGIN(ignition::gazebo::MockSystem, ignition::gazebo::System,
     ignition::gazebo::MockSystem::ISystemPreUpdate,
     ignition::gazebo::MockSystem::ISystemUpdate,
-    ignition::gazebo::MockSystem::ISystemPostUpdate)
+    ignition::gazebo::MockSystem::ISystemPostUpdate,
+    ignition::gazebo::MockSystem::ISystemReset)
 
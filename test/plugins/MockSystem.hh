@@ -27,13 +27,15 @@ namespace ignition {
       public gazebo::System,
       public gazebo::ISystemPreUpdate,
       public gazebo::ISystemUpdate,
-      public gazebo::ISystemPostUpdate
+      public gazebo::ISystemPostUpdate,
+      public gazebo::ISystemReset
     {
       public: MockSystem() = default;
       public: ~MockSystem() = default;
       public: size_t preUpdateCallCount {0};
       public: size_t updateCallCount {0};
       public: size_t postUpdateCallCount {0};
+      public: size_t resetCallCount {0};
 
       public: using CallbackType = std::function<void(
               const gazebo::UpdateInfo &, gazebo::EntityComponentManager &)>;
@@ -45,6 +47,7 @@ namespace ignition {
       public: CallbackType preUpdateCallback;
       public: CallbackType updateCallback;
       public: CallbackTypeConst postUpdateCallback;
+      public: CallbackType resetCallback;
 
 
       public: void PreUpdate(const gazebo::UpdateInfo &_info,
@@ -70,6 +73,14 @@ namespace ignition {
                 if (this->postUpdateCallback)
                   this->postUpdateCallback(_info, _manager);
               }
+
+      public: void Reset(const gazebo::UpdateInfo &_info,
+                    gazebo::EntityComponentManager &_manager) override final
+              {
+                ++this->resetCallCount;
+                if (this->resetCallback)
+                  this->resetCallback(_info, _manager);
+              }
     };
   }
 }